@@ -0,0 +1,74 @@
+/*
+ * ArrivalTimeout.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "ArrivalTimeout.h"
+
+#include <string.h>
+
+ArrivalTimeout::ArrivalTimeout() :
+    settings(NULL),
+    count(0),
+    samples(0),
+    timeout_ms(0) {
+  memset(buckets, 0, sizeof(buckets));
+}
+
+void ArrivalTimeout::configure(const ArrivalTimeoutSettings *settings) {
+  this->settings = settings;
+  memset(buckets, 0, sizeof(buckets));
+  count = 0;
+  samples = 0;
+  timeout_ms = settings->initial_ms;
+}
+
+void ArrivalTimeout::record(uint32_t interval_ms) {
+  if (settings->max_ms < interval_ms) {
+    return;
+  }
+  size_t bucket = interval_ms / ARRIVAL_TIMEOUT_BUCKET_MS;
+  if (ARRIVAL_TIMEOUT_BUCKETS <= bucket) {
+    bucket = ARRIVAL_TIMEOUT_BUCKETS - 1;
+  }
+  ++buckets[bucket];
+  ++samples;
+  if (++count == ARRIVAL_TIMEOUT_DECAY_COUNT) {
+    count = 0;
+    for (size_t i = 0; i < ARRIVAL_TIMEOUT_BUCKETS; ++i) {
+      buckets[i] >>= 1;
+      count += buckets[i];
+    }
+  }
+  if (ARRIVAL_TIMEOUT_MIN_SAMPLES <= samples
+      && !(samples % ARRIVAL_TIMEOUT_UPDATE_SAMPLES)) {
+    update_timeout();
+  }
+}
+
+uint32_t ArrivalTimeout::percentile_ms(void) const {
+  if (!count) {
+    return 0;
+  }
+  // Smallest rank that covers the percentile, rounded up.
+  uint32_t rank = (count * settings->percent + 99) / 100;
+  uint32_t seen = 0;
+  for (size_t i = 0; i < ARRIVAL_TIMEOUT_BUCKETS - 1; ++i) {
+    seen += buckets[i];
+    if (rank <= seen) {
+      return (i + 1) * ARRIVAL_TIMEOUT_BUCKET_MS;
+    }
+  }
+  // The last bucket has no upper bound short of the maximum.
+  return settings->max_ms;
+}
+
+void ArrivalTimeout::update_timeout(void) {
+  // Allow one whole interval for a lost message.
+  uint32_t learned_ms = 2 * percentile_ms() + settings->margin_ms;
+  timeout_ms = learned_ms < settings->min_ms
+      ? settings->min_ms
+      : settings->max_ms < learned_ms ? settings->max_ms : learned_ms;
+}
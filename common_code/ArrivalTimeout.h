@@ -0,0 +1,92 @@
+/*
+ * ArrivalTimeout.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Learns how long to wait for a sender's next message from the intervals
+ * between the messages already received. The timeout is twice a high
+ * percentile of the recent intervals plus a margin, kept within bounds,
+ * so that a steady link is declared down soon after it falls silent, and
+ * neither a single lost message nor jitter makes it flap.
+ *
+ * Intervals go into a histogram of ARRIVAL_TIMEOUT_BUCKETS linear
+ * buckets, ARRIVAL_TIMEOUT_BUCKET_MS wide. Every
+ * ARRIVAL_TIMEOUT_DECAY_COUNT intervals, the counts are halved, so old
+ * behavior fades with a half-life of that many intervals. Intervals
+ * longer than the maximum timeout are outages, not jitter, and are not
+ * learned. Until ARRIVAL_TIMEOUT_MIN_SAMPLES intervals have been learned,
+ * the timeout is the configured initial value.
+ *
+ * The class has no Arduino or FreeRTOS dependencies.
+ */
+
+#ifndef ARRIVALTIMEOUT_H_
+#define ARRIVALTIMEOUT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARRIVAL_TIMEOUT_BUCKETS 64
+#define ARRIVAL_TIMEOUT_BUCKET_MS 50  // Covers 3.2 s; the last bucket, more
+#define ARRIVAL_TIMEOUT_DECAY_COUNT 256
+#define ARRIVAL_TIMEOUT_MIN_SAMPLES 16
+#define ARRIVAL_TIMEOUT_UPDATE_SAMPLES 8  // Intervals between recalculations
+
+/**
+ * Timeout policy, shared by every sender.
+ */
+struct ArrivalTimeoutSettings {
+  uint32_t percent;     // Percentile of the intervals to cover, [0, 100]
+  uint32_t margin_ms;   // Added to twice the percentile
+  uint32_t min_ms;      // Shortest timeout
+  uint32_t max_ms;      // Longest timeout
+  uint32_t initial_ms;  // Timeout while learning
+};
+
+class ArrivalTimeout {
+  const ArrivalTimeoutSettings *settings;
+  uint16_t buckets[ARRIVAL_TIMEOUT_BUCKETS];
+  uint32_t count;    // Sum of the buckets
+  uint32_t samples;  // Intervals learned since configure()
+  uint32_t timeout_ms;
+
+  /**
+   * Recalculates the timeout from the histogram.
+   */
+  void update_timeout(void);
+
+public:
+  ArrivalTimeout();
+
+  /**
+   * Sets the timeout policy and forgets everything learned. Call before
+   * any other method.
+   */
+  void configure(const ArrivalTimeoutSettings *settings);
+
+  /**
+   * Learns the interval between two consecutive messages.
+   */
+  void record(uint32_t interval_ms);
+
+  /**
+   * Returns the upper bound of the bucket that holds the configured
+   * percentile of the learned intervals, or 0 if none are learned.
+   */
+  uint32_t percentile_ms(void) const;
+
+  /**
+   * Returns how long to wait for the next message before declaring the
+   * sender silent.
+   */
+  uint32_t get_timeout_ms(void) const {
+    return timeout_ms;
+  }
+
+  uint32_t get_samples(void) const {
+    return samples;
+  }
+};
+
+#endif /* ARRIVALTIMEOUT_H_ */
@@ -0,0 +1,113 @@
+/*
+ * BufferedI2cLcd.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "BufferedI2cLcd.h"
+
+#include <string.h>
+
+static_assert(
+    BUFFERED_LCD_TRANSACTION_BYTES <= I2C_BUS_BATCH_BYTES,
+    "LCD transactions must fit in the Wire buffer.");
+
+// Waits from the HD44780 data sheet, in microseconds.
+#define POWER_ON_WAIT_US 50000
+#define FIRST_RESET_WAIT_US 4500
+#define SECOND_RESET_WAIT_US 150
+#define CLEAR_WAIT_US 2000
+
+BufferedI2cLcd::BufferedI2cLcd(
+    I2cBusManager *bus,
+    uint8_t address,
+    uint32_t clock_hz) :
+        bus(bus),
+        device("LCD", address, clock_hz, true),
+        encoder(transaction, sizeof(transaction)),
+        transactions(0),
+        bytes_sent(0) {
+}
+
+BufferedI2cLcd::~BufferedI2cLcd() {
+}
+
+bool BufferedI2cLcd::send(void) {
+  bool status = true;
+  size_t length = encoder.get_length();
+  if (length) {
+    status = bus->write(
+        device,
+        encoder.get_bytes(),
+        length,
+        I2C_PRIORITY_NORMAL,
+        I2C_NO_DEADLINE) == I2C_OK;
+    ++transactions;
+    bytes_sent += length;
+    encoder.clear();
+  }
+  return status;
+}
+
+void BufferedI2cLcd::init(void) {
+  encoder.clear();
+  encoder.set_backlight(true);
+  delayMicroseconds(POWER_ON_WAIT_US);
+
+  // Reset by instruction: three 8-bit function sets whatever mode the
+  // controller is in, then switch to 4-bit mode.
+  encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+  send();
+  delayMicroseconds(FIRST_RESET_WAIT_US);
+  encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+  send();
+  delayMicroseconds(SECOND_RESET_WAIT_US);
+  encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+  encoder.nibble(HD44780_FUNCTION_SET);
+  encoder.command(HD44780_FUNCTION_SET | HD44780_TWO_LINES);
+  encoder.command(HD44780_DISPLAY_CONTROL | HD44780_DISPLAY_ON);
+  encoder.command(HD44780_ENTRY_MODE_SET | HD44780_ENTRY_INCREMENT);
+  send();
+  clear();
+}
+
+void BufferedI2cLcd::backlight(bool on) {
+  send();
+  encoder.set_backlight(on);
+  // The backlight is a plain output; writing it alone strobes nothing.
+  uint8_t value = encoder.get_backlight();
+  bus->write(device, &value, 1, I2C_PRIORITY_NORMAL, I2C_NO_DEADLINE);
+  ++transactions;
+  ++bytes_sent;
+}
+
+void BufferedI2cLcd::clear(void) {
+  encoder.command(HD44780_CLEAR_DISPLAY);
+  send();
+  delayMicroseconds(CLEAR_WAIT_US);
+}
+
+void BufferedI2cLcd::set_cursor(uint8_t column, uint8_t row) {
+  if (!encoder.get_room()) {
+    send();
+  }
+  encoder.set_cursor(column, row);
+}
+
+void BufferedI2cLcd::print(const char *text) {
+  write(text, strlen(text));
+}
+
+void BufferedI2cLcd::write(const char *text, size_t length) {
+  for (;;) {
+    size_t count = encoder.text(text, length);
+    text += count;
+    length -= count;
+    if (!length) {
+      break;
+    }
+    send();
+  }
+  send();
+}
@@ -0,0 +1,102 @@
+/*
+ * BufferedI2cLcd.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * HD44780 character LCD on a PCF8574 I2C backpack that sends each
+ * update as one buffered I2C write through an I2cBusManager. A cursor
+ * move and the string that follows it go out together, so a 16
+ * character row costs a single START/STOP cycle instead of one per
+ * nibble and strobe. See Hd44780Encoder.h for the byte stream.
+ *
+ * No delays are needed between transfers: at 100 kHz or 400 kHz, the
+ * three bytes of a nibble take far longer than the 37 us that the
+ * controller needs per command or character. Only clear() waits.
+ *
+ * The PCF8574 is specified for 100 kHz; most backpacks run fine at
+ * 400 kHz, but drop the clock if the display garbles.
+ *
+ * Do NOT use from more than one task.
+ */
+
+#ifndef BUFFEREDI2CLCD_H_
+#define BUFFEREDI2CLCD_H_
+
+#include "Arduino.h"
+
+#include "Hd44780Encoder.h"
+#include "I2cBusManager.h"
+#include "LcdWriter.h"
+
+// Transaction buffer size: 20 transfers, within the Wire buffer.
+#define BUFFERED_LCD_TRANSACTION_BYTES (20 * HD44780_BYTES_PER_TRANSFER)
+
+class BufferedI2cLcd : public LcdWriter {
+  I2cBusManager *bus;
+  I2cDevice device;
+  uint8_t transaction[BUFFERED_LCD_TRANSACTION_BYTES];
+  Hd44780Encoder encoder;
+  uint32_t transactions;  // I2C writes sent
+  uint32_t bytes_sent;  // Payload bytes, excluding addresses
+
+  /**
+   * Sends the encoded bytes, if any, as one I2C write. Returns false on
+   * a bus error.
+   */
+  bool send(void);
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * bus                 The I2C bus. Start it before init().
+   * address             The backpack's I2C address, e.g. 0x27
+   * clock_hz            Bus clock, e.g. I2C_FAST_MODE_HZ
+   */
+  BufferedI2cLcd(I2cBusManager *bus, uint8_t address, uint32_t clock_hz);
+  virtual ~BufferedI2cLcd();
+
+  /**
+   * Initializes the display: two lines, display on, cursor off, left to
+   * right entry, cleared, with the backlight on.
+   */
+  void init(void);
+
+  /**
+   * Turns the backlight on or off.
+   */
+  void backlight(bool on);
+
+  /**
+   * Clears the display and moves the cursor home.
+   */
+  void clear(void);
+
+  /**
+   * Moves the cursor. The move goes out with the next print() or
+   * write().
+   */
+  virtual void set_cursor(uint8_t column, uint8_t row);
+
+  /**
+   * Writes a NUL-terminated string at the cursor.
+   */
+  void print(const char *text);
+
+  virtual void write(const char *text, size_t length);
+
+  uint32_t get_transactions(void) const {
+    return transactions;
+  }
+
+  uint32_t get_bytes_sent(void) const {
+    return bytes_sent;
+  }
+};
+
+#endif /* BUFFEREDI2CLCD_H_ */
@@ -0,0 +1,84 @@
+/*
+ * ComplementaryOrientationFilter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "ComplementaryOrientationFilter.h"
+
+#include <math.h>
+
+#define DEGREES_TO_RADIANS_D (3.14159265358979323846 / 180.0)
+
+ComplementaryOrientationFilter::ComplementaryOrientationFilter(
+    uint16_t sample_rate_hz,
+    float gyro_weight) :
+      OrientationFilter(sample_rate_hz),
+      gyro_weight_q15((int32_t) lroundf(gyro_weight * 32768.0f)),
+      radians_per_lsb_q32(0),
+      scaled_gravity_x(0),
+      scaled_gravity_y(0),
+      scaled_gravity_z(0) {
+  on_calibrated();
+}
+
+const char *ComplementaryOrientationFilter::get_name(void) const {
+  return "Q15 complementary";
+}
+
+void ComplementaryOrientationFilter::on_calibrated(void) {
+  radians_per_lsb_q32 = llround(
+      DEGREES_TO_RADIANS_D * 4294967296.0
+          / (gyro_lsb_per_degree_per_second * get_sample_rate_hz()));
+}
+
+void ComplementaryOrientationFilter::initialize(const Sample& sample) {
+  // Multiply rather than shift: shifting a negative value left is
+  // undefined.
+  scaled_gravity_x = sample.accel_x * (1 << GRAVITY_SHIFT);
+  scaled_gravity_y = sample.accel_y * (1 << GRAVITY_SHIFT);
+  scaled_gravity_z = sample.accel_z * (1 << GRAVITY_SHIFT);
+  gravity_x = sample.accel_x;
+  gravity_y = sample.accel_y;
+  gravity_z = sample.accel_z;
+}
+
+/**
+ * Blends a rotated gravity component with an accelerometer reading.
+ */
+static inline int32_t blend(
+    int64_t rotated,
+    int32_t accel,
+    int32_t gyro_weight_q15) {
+  int64_t scaled_accel =
+      (int64_t) accel * (1 << ComplementaryOrientationFilter::GRAVITY_SHIFT);
+  return (int32_t) (
+      (rotated * gyro_weight_q15 + scaled_accel * (32768 - gyro_weight_q15))
+          >> 15);
+}
+
+void ComplementaryOrientationFilter::filter(const Sample& sample) {
+  int64_t x = scaled_gravity_x;
+  int64_t y = scaled_gravity_y;
+  int64_t z = scaled_gravity_z;
+
+  // A vector that is fixed in the world turns opposite to the body, so
+  // it changes by g x omega * dt in the sensor frame.
+  int64_t rotated_x =
+      x + (((y * sample.gyro_z - z * sample.gyro_y) * radians_per_lsb_q32)
+          >> 32);
+  int64_t rotated_y =
+      y + (((z * sample.gyro_x - x * sample.gyro_z) * radians_per_lsb_q32)
+          >> 32);
+  int64_t rotated_z =
+      z + (((x * sample.gyro_y - y * sample.gyro_x) * radians_per_lsb_q32)
+          >> 32);
+
+  scaled_gravity_x = blend(rotated_x, sample.accel_x, gyro_weight_q15);
+  scaled_gravity_y = blend(rotated_y, sample.accel_y, gyro_weight_q15);
+  scaled_gravity_z = blend(rotated_z, sample.accel_z, gyro_weight_q15);
+  gravity_x = scaled_gravity_x >> GRAVITY_SHIFT;
+  gravity_y = scaled_gravity_y >> GRAVITY_SHIFT;
+  gravity_z = scaled_gravity_z >> GRAVITY_SHIFT;
+}
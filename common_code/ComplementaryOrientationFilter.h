@@ -0,0 +1,59 @@
+/*
+ * ComplementaryOrientationFilter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Integer complementary filter that tracks the gravity vector directly.
+ * Each sample rotates the estimate by the gyroscope reading, then blends
+ * it with the accelerometer reading using a Q15 weight. The update uses
+ * only integer multiplies and shifts, so it never touches the FPU.
+ */
+
+#ifndef COMPLEMENTARYORIENTATIONFILTER_H_
+#define COMPLEMENTARYORIENTATIONFILTER_H_
+
+#include <stdint.h>
+
+#include "OrientationFilter.h"
+
+class ComplementaryOrientationFilter : public OrientationFilter {
+  const int32_t gyro_weight_q15;
+  int64_t radians_per_lsb_q32;  // Rotation per gyro LSB per sample
+  int32_t scaled_gravity_x;     // Gravity << GRAVITY_SHIFT
+  int32_t scaled_gravity_y;
+  int32_t scaled_gravity_z;
+
+protected:
+  virtual void on_calibrated(void);
+
+  virtual void initialize(const Sample& sample);
+
+  virtual void filter(const Sample& sample);
+
+public:
+  /**
+   * Extra fractional bits kept in the gravity estimate.
+   */
+  static const unsigned GRAVITY_SHIFT = 8;
+
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                   Contents
+   * ---------------------- -------------------------------------------------
+   * sample_rate_hz         The rate at which samples arrive.
+   * gyro_weight            Weight given to the rotated estimate, in
+   *                        [0, 1). The accelerometer gets the remainder.
+   *                        Converted to Q15 at construction.
+   */
+  ComplementaryOrientationFilter(
+      uint16_t sample_rate_hz,
+      float gyro_weight);
+
+  virtual const char *get_name(void) const;
+};
+
+#endif /* COMPLEMENTARYORIENTATIONFILTER_H_ */
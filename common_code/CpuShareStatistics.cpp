@@ -0,0 +1,38 @@
+/*
+ * CpuShareStatistics.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "CpuShareStatistics.h"
+
+#define FULL_SHARE 1000
+
+CpuShareStatistics::CpuShareStatistics() {
+  clear();
+}
+
+void CpuShareStatistics::record(uint32_t busy_time, uint32_t window_time) {
+  if (!window_time) {
+    return;
+  }
+  uint64_t share = (uint64_t) busy_time * FULL_SHARE / window_time;
+  last_share = share < FULL_SHARE ? (uint16_t) share : FULL_SHARE;
+  if (!windows || last_share < min_share) {
+    min_share = last_share;
+  }
+  if (max_share < last_share) {
+    max_share = last_share;
+  }
+  share_sum += last_share;
+  ++windows;
+}
+
+void CpuShareStatistics::clear(void) {
+  windows = 0;
+  share_sum = 0;
+  min_share = 0;
+  max_share = 0;
+  last_share = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * CpuShareStatistics.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Minimum, maximum, and mean of a task's CPU share over a series of
+ * sampling windows. Shares are in tenths of a percent of one core's
+ * time, so a task that keeps one core busy has a share of 1000.
+ *
+ * The statistics have no Arduino or FreeRTOS dependencies.
+ */
+
+#ifndef CPUSHARESTATISTICS_H_
+#define CPUSHARESTATISTICS_H_
+
+#include <stdint.h>
+
+class CpuShareStatistics {
+  uint32_t windows;
+  uint32_t share_sum;
+  uint16_t min_share;
+  uint16_t max_share;
+  uint16_t last_share;
+
+public:
+  CpuShareStatistics();
+
+  /**
+   * Records a window's share.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * busy_time           Time that the task ran during the window, in run
+   *                     time counter ticks
+   * window_time         Length of the window in run time counter ticks
+   */
+  void record(uint32_t busy_time, uint32_t window_time);
+
+  /**
+   * Forgets all windows.
+   */
+  void clear(void);
+
+  uint32_t get_windows(void) const {
+    return windows;
+  }
+
+  /**
+   * The following return 0 if no windows have been recorded.
+   */
+  uint16_t get_min_share(void) const {
+    return windows ? min_share : 0;
+  }
+
+  uint16_t get_max_share(void) const {
+    return max_share;
+  }
+
+  uint16_t get_mean_share(void) const {
+    return windows ? share_sum / windows : 0;
+  }
+
+  uint16_t get_last_share(void) const {
+    return last_share;
+  }
+};
+
+#endif /* CPUSHARESTATISTICS_H_ */
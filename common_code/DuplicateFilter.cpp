@@ -0,0 +1,43 @@
+/*
+ * DuplicateFilter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "DuplicateFilter.h"
+
+#define DUPLICATE_FILTER_WINDOW 32
+
+DuplicateFilter::DuplicateFilter() :
+    boot_id(0),
+    highest_sequence(0),
+    seen(0),
+    started(false),
+    duplicates(0) {
+}
+
+bool DuplicateFilter::is_new(uint16_t sequence, uint16_t boot_id) {
+  if (boot_id != this->boot_id) {
+    // The sender restarted.
+    started = false;
+    this->boot_id = boot_id;
+  }
+  int16_t ahead = (int16_t) (uint16_t) (sequence - highest_sequence);
+  if (!started || 0 < ahead || ahead <= -DUPLICATE_FILTER_WINDOW) {
+    // Newer than anything seen, or the sender restarted.
+    seen = (started && 0 < ahead && ahead < DUPLICATE_FILTER_WINDOW)
+        ? (seen << ahead) | 1
+        : 1;
+    highest_sequence = sequence;
+    started = true;
+    return true;
+  }
+  uint32_t bit = (uint32_t) 1 << -ahead;
+  if (seen & bit) {
+    ++duplicates;
+    return false;
+  }
+  seen |= bit;
+  return true;
+}
@@ -0,0 +1,55 @@
+/*
+ * DuplicateFilter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Receiver half of the acknowledged delivery protocol. Recognizes frames
+ * that have already been received, i.e. retransmissions whose original
+ * acknowledgment was lost, by their 16 bit sequence numbers. Tracks the
+ * highest sequence number seen and a bitmap of the 32 before it, so
+ * frames may arrive out of order. A new boot identifier means that the
+ * sender restarted and its sequence numbers started over, and resets the
+ * filter. Senders that predate boot identifiers send 0, and for them a
+ * sequence number far behind the window is taken as a restart.
+ *
+ * The filter has no Arduino or FreeRTOS dependencies.
+ */
+
+#ifndef DUPLICATEFILTER_H_
+#define DUPLICATEFILTER_H_
+
+#include <stdint.h>
+
+class DuplicateFilter {
+  uint16_t boot_id;
+  uint16_t highest_sequence;
+  uint32_t seen;  // Bit n set: highest_sequence - n has been received
+  bool started;
+  uint32_t duplicates;
+
+public:
+  DuplicateFilter();
+
+  /**
+   * Returns true and records the sequence number if it has not been
+   * received before, false if the frame is a duplicate.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * sequence            The frame's sequence number
+   * boot_id             The frame's boot identifier, 0 if it has none
+   */
+  bool is_new(uint16_t sequence, uint16_t boot_id);
+
+  /**
+   * Returns the number of duplicates rejected.
+   */
+  uint32_t get_duplicates(void) const {
+    return duplicates;
+  }
+};
+
+#endif /* DUPLICATEFILTER_H_ */
@@ -0,0 +1,227 @@
+/*
+ * EventStore.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Bounded store of timestamped notifications that a sender owes its
+ * receivers: status changes made while a receiver was unreachable, and
+ * those in frames that a receiver never acknowledged. Each notification
+ * records the receivers still owed it, and each receiver takes its
+ * notifications in the order that they happened. When the store is full,
+ * the oldest notification makes room for the newest.
+ *
+ * The store is meant to live in memory that survives a restart, such as
+ * ESP32 RTC memory declared RTC_NOINIT_ATTR, so it has no constructor:
+ * one would erase the retained contents at startup. Call restore() once
+ * at startup instead. It keeps the contents if they pass a CRC check and
+ * clears them otherwise, e.g. after power on.
+ *
+ * Notification timestamps are sender milliseconds at the time they were
+ * stored, so notifications retained across a restart carry timestamps
+ * from the previous run.
+ *
+ * The store has no Arduino or FreeRTOS dependencies, so it builds on a
+ * host. Only one task may use it.
+ */
+
+#ifndef EVENTSTORE_H_
+#define EVENTSTORE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FrameSink.h"
+#include "NotificationBatch.h"
+#include "WireFormat.h"
+
+#define EVENT_STORE_MAGIC 0x45565432  // "EVT2"
+
+/**
+ * A stored notification and the receivers that are still owed it.
+ */
+struct StoredEvent {
+  TimestampedNotification notification;
+  PeerSet peers;
+};
+
+template <size_t CAPACITY> class EventStore {
+  static_assert(
+      0 < CAPACITY && CAPACITY <= UINT16_MAX,
+      "Event store capacity must fit in 16 bits.");
+
+  uint16_t crc;  // Covers everything that follows
+  uint16_t count;
+  uint32_t magic;
+  uint32_t dropped;  // Notifications overwritten since power on
+  StoredEvent events[CAPACITY];  // Oldest first
+
+  const uint8_t *checked_bytes(void) const {
+    return reinterpret_cast<const uint8_t *>(&count);
+  }
+
+  size_t checked_size(void) const {
+    return reinterpret_cast<const uint8_t *>(this + 1) - checked_bytes();
+  }
+
+  void seal(void) {
+    crc = WireFormat::crc16(checked_bytes(), checked_size());
+  }
+
+  /**
+   * Removes the notification at the specified position.
+   */
+  void remove(size_t index) {
+    --count;
+    for (size_t i = index; i < count; ++i) {
+      events[i] = events[i + 1];
+    }
+  }
+
+public:
+  /**
+   * Validates retained contents, clearing the store if they are missing
+   * or corrupt. Returns true if the contents were kept.
+   */
+  bool restore(void) {
+    if (magic == EVENT_STORE_MAGIC
+        && count <= CAPACITY
+        && crc == WireFormat::crc16(checked_bytes(), checked_size())) {
+      return true;
+    }
+    dropped = 0;
+    clear();
+    return false;
+  }
+
+  /**
+   * Discards all notifications.
+   */
+  void clear(void) {
+    magic = EVENT_STORE_MAGIC;
+    count = 0;
+    seal();
+  }
+
+  /**
+   * Stores a notification for a set of receivers. If the store already
+   * holds the same notification for other receivers, adds these to it.
+   * Otherwise places it behind every notification owed to any of them
+   * that is not newer, and overwrites the oldest notification if the
+   * store is full. Does nothing if peers is empty.
+   */
+  void push(const TimestampedNotification& notification, PeerSet peers) {
+    if (!peers) {
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (events[i].notification.timestamp_ms == notification.timestamp_ms
+          && events[i].notification.message.status
+              == notification.message.status) {
+        events[i].peers |= peers;
+        seal();
+        return;
+      }
+    }
+    if (count == CAPACITY) {
+      remove(0);
+      ++dropped;
+    }
+    size_t index = count;
+    for (size_t i = 0; i < count && index == count; ++i) {
+      if ((events[i].peers & peers)
+          && 0 < (int32_t) (events[i].notification.timestamp_ms
+              - notification.timestamp_ms)) {
+        index = i;
+      }
+    }
+    for (size_t i = count; index < i; --i) {
+      events[i] = events[i - 1];
+    }
+    events[index].notification = notification;
+    events[index].peers = peers;
+    ++count;
+    seal();
+  }
+
+  /**
+   * Takes a receiver's oldest notifications, removing it from the
+   * receivers they are owed to, and removes notifications that no
+   * receiver is owed. Skips and removes notifications no newer than a
+   * status change that the receiver has since acknowledged, since
+   * replaying them would set the receiver back. Returns the number of
+   * notifications taken.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * peer                The receiver
+   * has_delivered       True if the receiver has acknowledged a status
+   *                     change
+   * delivered_ms        The timestamp of the newest status change that
+   *                     it acknowledged, if any
+   * taken               Receives the notifications, oldest first
+   * max_count           The most notifications to take
+   */
+  size_t take(
+      size_t peer,
+      bool has_delivered,
+      uint32_t delivered_ms,
+      TimestampedNotification *taken,
+      size_t max_count) {
+    PeerSet peer_bit = peer_set_of(peer);
+    size_t taken_count = 0;
+    for (size_t i = 0; i < count && taken_count < max_count; ++i) {
+      StoredEvent& event = events[i];
+      if (!(event.peers & peer_bit)) {
+        continue;
+      }
+      if (!has_delivered
+          || 0 < (int32_t) (event.notification.timestamp_ms - delivered_ms)) {
+        taken[taken_count++] = event.notification;
+      }
+      event.peers &= ~peer_bit;
+    }
+    for (size_t i = count; i--; ) {
+      if (!events[i].peers) {
+        remove(i);
+      }
+    }
+    seal();
+    return taken_count;
+  }
+
+  /**
+   * Returns the receivers that are owed notifications.
+   */
+  PeerSet get_owed_peers(void) const {
+    PeerSet peers = 0;
+    for (size_t i = 0; i < count; ++i) {
+      peers |= events[i].peers;
+    }
+    return peers;
+  }
+
+  bool is_empty(void) const {
+    return !count;
+  }
+
+  size_t get_count(void) const {
+    return count;
+  }
+
+  /**
+   * Returns the number of notifications overwritten because the store
+   * was full.
+   */
+  uint32_t get_dropped(void) const {
+    return dropped;
+  }
+
+  static size_t get_capacity(void) {
+    return CAPACITY;
+  }
+};
+
+#endif /* EVENTSTORE_H_ */
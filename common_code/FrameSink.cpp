@@ -0,0 +1,32 @@
+/*
+ * FrameSink.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "FrameSink.h"
+
+FrameSink::FrameSink() {
+}
+
+FrameSink::~FrameSink() {
+}
+
+void FrameSink::on_frame_acknowledged(
+    const uint8_t *frame,
+    size_t frame_size,
+    size_t peer) {
+  (void) frame;
+  (void) frame_size;
+  (void) peer;
+}
+
+void FrameSink::on_frame_abandoned(
+    const uint8_t *frame,
+    size_t frame_size,
+    PeerSet unacknowledged) {
+  (void) frame;
+  (void) frame_size;
+  (void) unacknowledged;
+}
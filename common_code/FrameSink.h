@@ -0,0 +1,81 @@
+/*
+ * FrameSink.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Destination for outgoing frames. The transmitter implements it on
+ * ESP-NOW, and a host program can substitute a simulated link.
+ *
+ * A sink may serve several peers, numbered from 0. A PeerSet names some
+ * of them, one bit per peer.
+ */
+
+#ifndef FRAMESINK_H_
+#define FRAMESINK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_SINK_MAX_PEERS 8  // Bits in a PeerSet
+
+typedef uint8_t PeerSet;  // Bit n set: peer n
+
+/**
+ * Returns the set that holds only the specified peer.
+ */
+inline PeerSet peer_set_of(size_t peer) {
+  return (PeerSet) (1 << peer);
+}
+
+class FrameSink {
+public:
+  FrameSink();
+  virtual ~FrameSink();
+
+  /**
+   * Sends a frame to the specified peers. Returns true if the frame was
+   * accepted for sending to all of them.
+   */
+  virtual bool send_frame(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers) = 0;
+
+  /**
+   * Learns that a peer acknowledged a frame, e.g. to record what that
+   * peer has received. Does nothing by default. Must not track frames.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * frame               The frame
+   * frame_size          Its size in bytes
+   * peer                The peer that acknowledged it
+   */
+  virtual void on_frame_acknowledged(
+      const uint8_t *frame,
+      size_t frame_size,
+      size_t peer);
+
+  /**
+   * Takes back a frame that ran out of attempts before every peer
+   * acknowledged it, e.g. to keep its contents for a later attempt to
+   * reach those peers. Does nothing by default. Must not track frames.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * frame               The frame
+   * frame_size          Its size in bytes
+   * unacknowledged      The peers that did not acknowledge it
+   */
+  virtual void on_frame_abandoned(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet unacknowledged);
+};
+
+#endif /* FRAMESINK_H_ */
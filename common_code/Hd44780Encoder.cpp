@@ -0,0 +1,69 @@
+/*
+ * Hd44780Encoder.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "Hd44780Encoder.h"
+
+// DDRAM address of the first column of each row.
+static const uint8_t ROW_OFFSETS[HD44780_MAX_ROWS] = {
+  0x00, 0x40, 0x14, 0x54,
+};
+
+Hd44780Encoder::Hd44780Encoder(uint8_t *buffer, size_t capacity) :
+    buffer(buffer),
+    capacity(capacity),
+    length(0),
+    backlight(HD44780_PCF8574_BACKLIGHT) {
+}
+
+void Hd44780Encoder::append_nibble(uint8_t high_nibble, uint8_t mode) {
+  uint8_t value = (high_nibble & 0xF0) | mode | backlight;
+  buffer[length++] = value;
+  buffer[length++] = value | HD44780_PCF8574_EN;
+  buffer[length++] = value;
+}
+
+bool Hd44780Encoder::nibble(uint8_t high_nibble) {
+  bool has_room = length + HD44780_BYTES_PER_NIBBLE <= capacity;
+  if (has_room) {
+    append_nibble(high_nibble, 0);
+  }
+  return has_room;
+}
+
+bool Hd44780Encoder::command(uint8_t value) {
+  bool has_room = 0 < get_room();
+  if (has_room) {
+    append_nibble(value, 0);
+    append_nibble(value << 4, 0);
+  }
+  return has_room;
+}
+
+bool Hd44780Encoder::data(uint8_t value) {
+  bool has_room = 0 < get_room();
+  if (has_room) {
+    append_nibble(value, HD44780_PCF8574_RS);
+    append_nibble(value << 4, HD44780_PCF8574_RS);
+  }
+  return has_room;
+}
+
+bool Hd44780Encoder::set_cursor(uint8_t column, uint8_t row) {
+  if (HD44780_MAX_ROWS <= row) {
+    row = HD44780_MAX_ROWS - 1;
+  }
+  return command(HD44780_SET_DDRAM_ADDRESS | (column + ROW_OFFSETS[row]));
+}
+
+size_t Hd44780Encoder::text(const char *text, size_t text_length) {
+  size_t room = get_room();
+  size_t count = text_length < room ? text_length : room;
+  for (size_t i = 0; i < count; ++i) {
+    data((uint8_t) text[i]);
+  }
+  return count;
+}
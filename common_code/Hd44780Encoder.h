@@ -0,0 +1,148 @@
+/*
+ * Hd44780Encoder.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Encodes HD44780 character LCD commands and data as the byte stream
+ * that drives the controller through a PCF8574 I2C backpack in 4-bit
+ * mode. The backpack wires its outputs as follows:
+ *
+ *   Bit  Signal
+ *   ---  ------------------------------------
+ *   0    RS, 0 for commands, 1 for data
+ *   1    R/W, always 0 (write)
+ *   2    EN, the controller latches on its falling edge
+ *   3    Backlight
+ *   4-7  D4-D7
+ *
+ * Each nibble takes three bytes: data with EN low, data with EN high,
+ * and data with EN low again, so a command or character takes six.
+ * Since the PCF8574 updates its outputs after every byte, a whole string
+ * fits in one I2C write; the encoder fills a caller-supplied buffer
+ * that the caller sends in a single transaction.
+ *
+ * The encoder has no Arduino dependencies, so it builds on a host.
+ */
+
+#ifndef HD44780ENCODER_H_
+#define HD44780ENCODER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HD44780_PCF8574_RS 0x01
+#define HD44780_PCF8574_EN 0x04
+#define HD44780_PCF8574_BACKLIGHT 0x08
+
+#define HD44780_BYTES_PER_NIBBLE 3
+#define HD44780_BYTES_PER_TRANSFER (2 * HD44780_BYTES_PER_NIBBLE)
+
+// Commands
+#define HD44780_CLEAR_DISPLAY 0x01  // Takes 1.52 ms
+#define HD44780_RETURN_HOME 0x02  // Takes 1.52 ms
+#define HD44780_ENTRY_MODE_SET 0x04
+#define HD44780_DISPLAY_CONTROL 0x08
+#define HD44780_FUNCTION_SET 0x20
+#define HD44780_SET_DDRAM_ADDRESS 0x80
+
+// Command flags
+#define HD44780_ENTRY_INCREMENT 0x02  // ENTRY_MODE_SET: cursor moves right
+#define HD44780_DISPLAY_ON 0x04  // DISPLAY_CONTROL
+#define HD44780_TWO_LINES 0x08  // FUNCTION_SET, 4-bit bus, 5x8 dots
+
+#define HD44780_MAX_ROWS 4
+
+class Hd44780Encoder {
+  uint8_t *buffer;
+  size_t capacity;
+  size_t length;
+  uint8_t backlight;  // HD44780_PCF8574_BACKLIGHT or 0
+
+  /**
+   * Appends one nibble's write, strobe, and release.
+   */
+  void append_nibble(uint8_t high_nibble, uint8_t mode);
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * buffer              Receives the encoded bytes
+   * capacity            Buffer size in bytes
+   */
+  Hd44780Encoder(uint8_t *buffer, size_t capacity);
+
+  /**
+   * Empties the buffer.
+   */
+  void clear(void) {
+    length = 0;
+  }
+
+  /**
+   * Turns the backlight bit on or off in every byte encoded from now on.
+   */
+  void set_backlight(bool on) {
+    backlight = on ? HD44780_PCF8574_BACKLIGHT : 0;
+  }
+
+  /**
+   * Returns the backlight bit, the byte that keeps the backlight as set
+   * with every other output low.
+   */
+  uint8_t get_backlight(void) const {
+    return backlight;
+  }
+
+  /**
+   * Appends a single nibble with RS low. The initialization sequence
+   * uses it while the controller is still in 8-bit mode. Returns false
+   * if the buffer is full.
+   */
+  bool nibble(uint8_t high_nibble);
+
+  /**
+   * Appends a command. Returns false if the buffer is full.
+   */
+  bool command(uint8_t value);
+
+  /**
+   * Appends a character. Returns false if the buffer is full.
+   */
+  bool data(uint8_t value);
+
+  /**
+   * Appends the command that moves the cursor. Columns and rows start
+   * at 0. Returns false if the buffer is full.
+   */
+  bool set_cursor(uint8_t column, uint8_t row);
+
+  /**
+   * Appends as many characters as fit in the buffer and returns the
+   * number appended.
+   */
+  size_t text(const char *text, size_t text_length);
+
+  /**
+   * Returns the number of transfers (commands or characters) that fit
+   * in the remaining space.
+   */
+  size_t get_room(void) const {
+    return (capacity - length) / HD44780_BYTES_PER_TRANSFER;
+  }
+
+  const uint8_t *get_bytes(void) const {
+    return buffer;
+  }
+
+  size_t get_length(void) const {
+    return length;
+  }
+};
+
+#endif /* HD44780ENCODER_H_ */
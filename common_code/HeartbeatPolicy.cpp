@@ -0,0 +1,68 @@
+/*
+ * HeartbeatPolicy.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "HeartbeatPolicy.h"
+
+HeartbeatPolicy::HeartbeatPolicy(
+    uint32_t min_interval_ms,
+    uint32_t max_interval_ms) :
+      min_interval_ms(min_interval_ms),
+      max_interval_ms(max_interval_ms),
+      interval_ms(min_interval_ms),
+      last_send_ms(0),
+      last_status(PING),
+      has_sent(false),
+      notifications_sent(0),
+      notifications_suppressed(0),
+      deliveries_failed(0) {
+}
+
+bool HeartbeatPolicy::should_send(MotionStatus status, uint32_t now_ms) {
+  bool result = is_change(status) || !ms_until_heartbeat(now_ms);
+  if (!result) {
+    ++notifications_suppressed;
+  }
+  return result;
+}
+
+void HeartbeatPolicy::on_sent(MotionStatus status, uint32_t now_ms) {
+  if (status != PING) {
+    last_status = status;
+  }
+  last_send_ms = now_ms;
+  has_sent = true;
+  ++notifications_sent;
+}
+
+void HeartbeatPolicy::on_delivery_results(
+    uint32_t delivered,
+    uint32_t failed) {
+  if (failed) {
+    deliveries_failed += failed;
+    interval_ms = min_interval_ms;
+  } else if (delivered) {
+    interval_ms = max_interval_ms / 2 < interval_ms
+        ? max_interval_ms
+        : interval_ms * 2;
+  }
+}
+
+void HeartbeatPolicy::set_max_interval_ms(uint32_t max_interval_ms) {
+  this->max_interval_ms = max_interval_ms < min_interval_ms
+      ? min_interval_ms
+      : max_interval_ms;
+  if (this->max_interval_ms < interval_ms) {
+    interval_ms = this->max_interval_ms;
+  }
+}
+
+uint32_t HeartbeatPolicy::ms_until_heartbeat(uint32_t now_ms) const {
+  uint32_t elapsed_ms = now_ms - last_send_ms;
+  return !has_sent || interval_ms <= elapsed_ms
+      ? 0
+      : interval_ms - elapsed_ms;
+}
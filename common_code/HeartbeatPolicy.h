@@ -0,0 +1,105 @@
+/*
+ * HeartbeatPolicy.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Decides when the sender transmits. A status change goes out at once.
+ * Otherwise the sender is silent except for a heartbeat that keeps the
+ * receiver's watchdog fed. The heartbeat interval doubles after each
+ * delivered heartbeat, up to a maximum that must stay below the receiver
+ * watchdog timeout, and drops to the minimum when a delivery fails.
+ *
+ * PING carries no news, so it never counts as a change. The policy has
+ * no Arduino or FreeRTOS dependencies and works in milliseconds from any
+ * monotonic clock.
+ */
+
+#ifndef HEARTBEATPOLICY_H_
+#define HEARTBEATPOLICY_H_
+
+#include <stdint.h>
+
+#include "MotionNotificationMessage.h"
+
+class HeartbeatPolicy {
+  const uint32_t min_interval_ms;
+  uint32_t max_interval_ms;
+  uint32_t interval_ms;
+  uint32_t last_send_ms;
+  MotionStatus last_status;  // Last status sent, never PING
+  bool has_sent;
+  uint32_t notifications_sent;
+  uint32_t notifications_suppressed;
+  uint32_t deliveries_failed;
+
+public:
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * min_interval_ms     Heartbeat interval after a failed delivery
+   * max_interval_ms     Longest heartbeat interval. Must be below the
+   *                     receiver's watchdog timeout.
+   */
+  HeartbeatPolicy(uint32_t min_interval_ms, uint32_t max_interval_ms);
+
+  /**
+   * Returns true if a message with the specified status should be sent
+   * now, either because the status changed or because the heartbeat is
+   * due. Counts suppressed messages.
+   */
+  bool should_send(MotionStatus status, uint32_t now_ms);
+
+  /**
+   * Returns true if the specified status differs from the last one sent.
+   * A heartbeat that repeats the last status is not a change.
+   */
+  bool is_change(MotionStatus status) const {
+    return status != PING && status != last_status;
+  }
+
+  /**
+   * Records that a message with the specified status was sent.
+   */
+  void on_sent(MotionStatus status, uint32_t now_ms);
+
+  /**
+   * Adapts the heartbeat interval to delivery results reported since the
+   * previous call.
+   */
+  void on_delivery_results(uint32_t delivered, uint32_t failed);
+
+  /**
+   * Changes the longest heartbeat interval, shortening the current one
+   * if it is longer, e.g. while delivery cannot be confirmed. Never
+   * below the minimum.
+   */
+  void set_max_interval_ms(uint32_t max_interval_ms);
+
+  /**
+   * Returns the time remaining until the next heartbeat, 0 if due.
+   */
+  uint32_t ms_until_heartbeat(uint32_t now_ms) const;
+
+  uint32_t get_interval_ms(void) const {
+    return interval_ms;
+  }
+
+  uint32_t get_notifications_sent(void) const {
+    return notifications_sent;
+  }
+
+  uint32_t get_notifications_suppressed(void) const {
+    return notifications_suppressed;
+  }
+
+  uint32_t get_deliveries_failed(void) const {
+    return deliveries_failed;
+  }
+};
+
+#endif /* HEARTBEATPOLICY_H_ */
@@ -0,0 +1,378 @@
+/*
+ * I2cBusManager.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "I2cBusManager.h"
+
+#include <string.h>
+
+// Half of a 100 kHz clock period, for bus recovery.
+#define RECOVERY_HALF_PERIOD_US 5
+
+// A slave can hold SDA low for at most the rest of one byte and its
+// acknowledge bit.
+#define RECOVERY_MAX_PULSES 9
+
+// Zero initialized before any constructor runs, so devices may register
+// in any order.
+I2cDevice *I2cDevice::first_device = NULL;
+
+I2cDevice::I2cDevice(
+    const char *name,
+    uint8_t address,
+    uint32_t clock_hz,
+    bool batch_writes) :
+        next_device(first_device),
+        name(name),
+        address(address),
+        clock_hz(clock_hz),
+        batch_writes(batch_writes),
+        transactions(0),
+        failures(0),
+        deadline_misses(0),
+        batched(0),
+        max_latency_us(0),
+        total_latency_us(0) {
+  first_device = this;
+}
+
+void I2cDevice::record(I2cStatus status, uint32_t latency_us) {
+  ++transactions;
+  switch (status) {
+    case I2C_OK:
+    case I2C_QUEUE_FULL:
+      break;
+    case I2C_DEADLINE_MISSED:
+      ++deadline_misses;
+      break;
+    case I2C_NACK:
+    case I2C_BUS_ERROR:
+    case I2C_SHORT_READ:
+      ++failures;
+      break;
+  }
+  total_latency_us += latency_us;
+  if (max_latency_us < latency_us) {
+    max_latency_us = latency_us;
+  }
+}
+
+uint32_t I2cDevice::get_mean_latency_us(void) const {
+  return transactions ? (uint32_t) (total_latency_us / transactions) : 0;
+}
+
+I2cOperation::I2cOperation() {
+}
+
+I2cOperation::~I2cOperation() {
+}
+
+/**
+ * Converts a Wire endTransmission() result to a status.
+ */
+static I2cStatus end_transmission_status(uint8_t result) {
+  switch (result) {
+    case 0:
+      return I2C_OK;
+    case 2:  // Address NACK
+    case 3:  // Data NACK
+      return I2C_NACK;
+    default:  // Too long, timeout, or other error
+      return I2C_BUS_ERROR;
+  }
+}
+
+I2cBusManager::I2cBusManager(TwoWire *wire, int sda_pin, int scl_pin) :
+    StaticTask("I2C bus", TASK_ROLE_I2C_BUS),
+    wire(wire),
+    sda_pin(sda_pin),
+    scl_pin(scl_pin),
+    clock_hz(I2C_STANDARD_MODE_HZ),
+    recoveries(0),
+    request_queue(),
+    h_request_queue(NULL),
+    waiting_count(0) {
+  memset(waiting, 0, sizeof(waiting));
+}
+
+I2cBusManager::~I2cBusManager() {
+}
+
+void I2cBusManager::begin_bus(void) {
+  wire->begin(sda_pin, scl_pin, clock_hz);
+  wire->setTimeOut(I2C_BUS_TIMEOUT_MS);
+}
+
+TaskHandle_t I2cBusManager::start(void) {
+  h_request_queue = request_queue.create();
+  begin_bus();
+  return create_and_start_task();
+}
+
+I2cStatus I2cBusManager::submit(
+    Transaction &transaction,
+    I2cDevice &device,
+    I2cPriority priority,
+    uint32_t deadline_ms) {
+  StaticSemaphore_t done_buffer;
+  transaction.device = &device;
+  transaction.priority = priority;
+  transaction.has_deadline = deadline_ms != I2C_NO_DEADLINE;
+  transaction.deadline = xTaskGetTickCount() + pdMS_TO_TICKS(deadline_ms);
+  transaction.submitted_us = (uint32_t) esp_timer_get_time();
+  transaction.status = I2C_OK;
+  transaction.h_done = xSemaphoreCreateBinaryStatic(&done_buffer);
+  Transaction *p_transaction = &transaction;
+  if (xQueueSendToBack(h_request_queue, &p_transaction, 0) != pdTRUE) {
+    return I2C_QUEUE_FULL;
+  }
+  // The transaction lives on this stack, so wait for it no matter what.
+  // Its deadline and the Wire timeout bound the wait.
+  xSemaphoreTake(transaction.h_done, portMAX_DELAY);
+  return transaction.status;
+}
+
+I2cStatus I2cBusManager::write(
+    I2cDevice &device,
+    const uint8_t *data,
+    size_t length,
+    I2cPriority priority,
+    uint32_t deadline_ms) {
+  Transaction transaction;
+  memset(&transaction, 0, sizeof(transaction));
+  transaction.write_data = data;
+  transaction.write_length = length;
+  return submit(transaction, device, priority, deadline_ms);
+}
+
+I2cStatus I2cBusManager::write_read(
+    I2cDevice &device,
+    const uint8_t *write_data,
+    size_t write_length,
+    uint8_t *read_data,
+    size_t read_length,
+    I2cPriority priority,
+    uint32_t deadline_ms) {
+  Transaction transaction;
+  memset(&transaction, 0, sizeof(transaction));
+  transaction.write_data = write_data;
+  transaction.write_length = write_length;
+  transaction.read_data = read_data;
+  transaction.read_length = read_length;
+  return submit(transaction, device, priority, deadline_ms);
+}
+
+I2cStatus I2cBusManager::perform(
+    I2cDevice &device,
+    I2cOperation &operation,
+    I2cPriority priority,
+    uint32_t deadline_ms) {
+  Transaction transaction;
+  memset(&transaction, 0, sizeof(transaction));
+  transaction.operation = &operation;
+  return submit(transaction, device, priority, deadline_ms);
+}
+
+bool I2cBusManager::is_batchable(const Transaction *transaction) {
+  return transaction->device->batch_writes
+      && !transaction->operation
+      && !transaction->read_length;
+}
+
+void I2cBusManager::complete(Transaction *transaction, I2cStatus status) {
+  transaction->device->record(
+      status,
+      (uint32_t) esp_timer_get_time() - transaction->submitted_us);
+  transaction->status = status;
+  // The submitter may return at once, so this must come last.
+  xSemaphoreGive(transaction->h_done);
+}
+
+void I2cBusManager::expire(void) {
+  TickType_t now = xTaskGetTickCount();
+  size_t kept = 0;
+  for (size_t i = 0; i < waiting_count; ++i) {
+    Transaction *transaction = waiting[i];
+    if (transaction->has_deadline
+        && 0 < (int32_t) (now - transaction->deadline)) {
+      complete(transaction, I2C_DEADLINE_MISSED);
+    } else {
+      waiting[kept++] = transaction;
+    }
+  }
+  waiting_count = kept;
+}
+
+size_t I2cBusManager::select(void) const {
+  size_t best = 0;
+  for (size_t i = 1; i < waiting_count; ++i) {
+    const Transaction *candidate = waiting[i];
+    const Transaction *incumbent = waiting[best];
+    if (candidate->priority != incumbent->priority) {
+      if (incumbent->priority < candidate->priority) {
+        best = i;
+      }
+    } else if (candidate->has_deadline
+        && (!incumbent->has_deadline
+            || (int32_t) (candidate->deadline - incumbent->deadline) < 0)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void I2cBusManager::run(size_t index) {
+  Transaction *first = waiting[index];
+  I2cDevice *device = first->device;
+  if (clock_hz != device->clock_hz) {
+    clock_hz = device->clock_hz;
+    wire->setClock(clock_hz);
+  }
+
+  // Gather the writes to the same device that arrived right after this
+  // one.
+  size_t end = index + 1;
+  size_t length = first->write_length;
+  if (is_batchable(first)) {
+    while (end < waiting_count) {
+      const Transaction *next = waiting[end];
+      if (next->device != device
+          || !is_batchable(next)
+          || sizeof(batch) < length + next->write_length) {
+        break;
+      }
+      length += next->write_length;
+      ++end;
+    }
+  }
+
+  I2cStatus status;
+  if (end - index == 1) {
+    status = execute(first);
+    complete(first, status);
+  } else {
+    size_t offset = 0;
+    for (size_t i = index; i < end; ++i) {
+      memcpy(&batch[offset], waiting[i]->write_data, waiting[i]->write_length);
+      offset += waiting[i]->write_length;
+    }
+    status = send(device->address, batch, length);
+    device->batched += end - index - 1;
+    for (size_t i = index; i < end; ++i) {
+      complete(waiting[i], status);
+    }
+  }
+
+  memmove(
+      &waiting[index],
+      &waiting[end],
+      (waiting_count - end) * sizeof(waiting[0]));
+  waiting_count -= end - index;
+
+  if (status == I2C_BUS_ERROR) {
+    recover();
+  }
+}
+
+I2cStatus I2cBusManager::send(
+    uint8_t address,
+    const uint8_t *data,
+    size_t length) {
+  wire->beginTransmission(address);
+  wire->write(data, length);
+  return end_transmission_status(wire->endTransmission());
+}
+
+I2cStatus I2cBusManager::execute(Transaction *transaction) {
+  uint8_t address = transaction->device->address;
+  if (transaction->operation) {
+    return transaction->operation->run(wire, address);
+  }
+  if (!transaction->read_length) {
+    return send(address, transaction->write_data, transaction->write_length);
+  }
+  if (transaction->write_length) {
+    wire->beginTransmission(address);
+    wire->write(transaction->write_data, transaction->write_length);
+    I2cStatus status = end_transmission_status(wire->endTransmission(false));
+    if (status != I2C_OK) {
+      return status;
+    }
+  }
+  size_t received =
+      wire->requestFrom(address, (uint8_t) transaction->read_length);
+  for (size_t i = 0; i < received; ++i) {
+    transaction->read_data[i] = wire->read();
+  }
+  return received < transaction->read_length ? I2C_SHORT_READ : I2C_OK;
+}
+
+void I2cBusManager::recover(void) {
+  wire->end();
+  pinMode(sda_pin, INPUT_PULLUP);
+  pinMode(scl_pin, OUTPUT_OPEN_DRAIN);
+  digitalWrite(scl_pin, HIGH);
+  delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+  for (int pulse = 0;
+      pulse < RECOVERY_MAX_PULSES && digitalRead(sda_pin) == LOW;
+      ++pulse) {
+    digitalWrite(scl_pin, LOW);
+    delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+    digitalWrite(scl_pin, HIGH);
+    delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+  }
+  // STOP: SDA rises while SCL is high.
+  digitalWrite(scl_pin, LOW);
+  pinMode(sda_pin, OUTPUT_OPEN_DRAIN);
+  digitalWrite(sda_pin, LOW);
+  delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+  digitalWrite(scl_pin, HIGH);
+  delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+  digitalWrite(sda_pin, HIGH);
+  delayMicroseconds(RECOVERY_HALF_PERIOD_US);
+  begin_bus();
+  ++recoveries;
+}
+
+void I2cBusManager::task_loop(void) {
+  Transaction *transaction;
+  for (;;) {
+    if (!waiting_count
+        && xQueueReceive(h_request_queue, &transaction, portMAX_DELAY)
+            == pdTRUE) {
+      waiting[waiting_count++] = transaction;
+    }
+    while (waiting_count < I2C_BUS_QUEUE_LENGTH
+        && xQueueReceive(h_request_queue, &transaction, 0) == pdTRUE) {
+      waiting[waiting_count++] = transaction;
+    }
+    expire();
+    if (waiting_count) {
+      run(select());
+    }
+  }
+}
+
+void I2cBusManager::print_report(void) const {
+  Serial.printf("I2C bus: %u recoveries\n", (unsigned) recoveries);
+  Serial.println(
+      "Device           Addr  Transactions Failed Missed Batched"
+      " Mean us  Max us");
+  for (I2cDevice *device = I2cDevice::first_device;
+      device;
+      device = device->next_device) {
+    Serial.printf(
+        "%-16.16s 0x%02x %13u %6u %6u %7u %7u %7u\n",
+        device->name,
+        (unsigned) device->address,
+        (unsigned) device->transactions,
+        (unsigned) device->failures,
+        (unsigned) device->deadline_misses,
+        (unsigned) device->batched,
+        (unsigned) device->get_mean_latency_us(),
+        (unsigned) device->max_latency_us);
+  }
+}
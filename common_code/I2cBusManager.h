@@ -0,0 +1,337 @@
+/*
+ * I2cBusManager.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Task that owns an I2C bus and runs every transaction on it, one at a
+ * time, so that devices on a shared bus no longer corrupt or stall each
+ * other. Clients describe each device with an I2cDevice and submit
+ * transactions with write(), write_read(), or perform(). Each call
+ * blocks until the manager has finished the transaction, then returns
+ * its status.
+ *
+ * The manager runs waiting transactions by priority and, within a
+ * priority, by deadline, then by arrival. It fails a transaction that
+ * is still waiting when its deadline passes. Consecutive plain writes
+ * to a device that allows it are sent as one bus write. The manager sets
+ * the bus clock for each device, and when a transaction fails with a
+ * bus error or timeout, it clocks out any slave that holds SDA low and
+ * restarts the bus.
+ *
+ * Every device keeps its own counts and latency, measured from
+ * submission to completion. See print_report().
+ *
+ * Do NOT submit transactions from an ISR or from the manager itself.
+ */
+
+#ifndef I2CBUSMANAGER_H_
+#define I2CBUSMANAGER_H_
+
+#include "Arduino.h"
+#include "Wire.h"
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+#include "StaticQueue.h"
+#include "StaticTask.h"
+
+#define I2C_STANDARD_MODE_HZ 100000
+#define I2C_FAST_MODE_HZ 400000
+
+#define I2C_BUS_QUEUE_LENGTH 8  // Maximum number of waiting transactions
+#define I2C_BUS_TIMEOUT_MS 20  // Wire timeout for a single transaction
+#define I2C_NO_DEADLINE 0  // Deadline: wait as long as necessary
+
+#ifdef I2C_BUFFER_LENGTH
+#define I2C_BUS_BATCH_BYTES I2C_BUFFER_LENGTH
+#else
+#define I2C_BUS_BATCH_BYTES 128
+#endif
+
+enum I2cStatus {
+  I2C_OK,
+  I2C_NACK,  // The device did not acknowledge
+  I2C_BUS_ERROR,  // Arbitration loss, timeout, or other bus failure
+  I2C_SHORT_READ,  // The device sent fewer bytes than requested
+  I2C_DEADLINE_MISSED,  // The transaction waited past its deadline
+  I2C_QUEUE_FULL,  // Too many waiting transactions
+};
+
+enum I2cPriority {
+  I2C_PRIORITY_LOW,
+  I2C_PRIORITY_NORMAL,
+  I2C_PRIORITY_HIGH,
+};
+
+/**
+ * A device on the bus: its address, clock, and statistics. Devices
+ * register themselves when they are constructed, so declare them
+ * globally or as members of global objects.
+ */
+class I2cDevice {
+  friend class I2cBusManager;
+
+  static I2cDevice *first_device;  // Registered devices, newest first
+
+  I2cDevice *next_device;
+  const char *name;
+  const uint8_t address;
+  const uint32_t clock_hz;
+  const bool batch_writes;
+  uint32_t transactions;  // Completed transactions, including failures
+  uint32_t failures;  // Bus errors, NACKs, and short reads
+  uint32_t deadline_misses;
+  uint32_t batched;  // Writes sent along with an earlier write
+  uint32_t max_latency_us;
+  uint64_t total_latency_us;
+
+  /**
+   * Records a completed transaction.
+   */
+  void record(I2cStatus status, uint32_t latency_us);
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * name                Device name for the report. Must outlive the device.
+   * address             7-bit I2C address
+   * clock_hz            Fastest clock that the device supports
+   * batch_writes        True if consecutive writes may be sent as one, i.e.
+   *                     the device treats a long write like several short
+   *                     ones. True for a PCF8574; false for register based
+   *                     devices like the DS3231.
+   */
+  I2cDevice(
+      const char *name,
+      uint8_t address,
+      uint32_t clock_hz,
+      bool batch_writes);
+
+  uint8_t get_address(void) const {
+    return address;
+  }
+
+  uint32_t get_clock_hz(void) const {
+    return clock_hz;
+  }
+
+  uint32_t get_transactions(void) const {
+    return transactions;
+  }
+
+  uint32_t get_failures(void) const {
+    return failures;
+  }
+
+  uint32_t get_deadline_misses(void) const {
+    return deadline_misses;
+  }
+
+  uint32_t get_max_latency_us(void) const {
+    return max_latency_us;
+  }
+
+  /**
+   * Returns the mean latency in microseconds, or 0 if no transaction has
+   * completed.
+   */
+  uint32_t get_mean_latency_us(void) const;
+};
+
+/**
+ * A transaction that needs more than a single write or write then read,
+ * e.g. a third party driver that talks to the bus directly. The manager
+ * runs it in its own task with exclusive use of the bus.
+ */
+class I2cOperation {
+public:
+  I2cOperation();
+  virtual ~I2cOperation();
+
+  /**
+   * Runs the operation on the bus and returns its status.
+   */
+  virtual I2cStatus run(TwoWire *wire, uint8_t address) = 0;
+};
+
+class I2cBusManager : public StaticTask<3072> {
+  /**
+   * A submitted transaction. It lives on the submitting task's stack,
+   * which blocks until the manager signals completion.
+   */
+  struct Transaction {
+    I2cDevice *device;
+    const uint8_t *write_data;
+    size_t write_length;
+    uint8_t *read_data;
+    size_t read_length;
+    I2cOperation *operation;  // Replaces write and read if not NULL
+    I2cPriority priority;
+    bool has_deadline;
+    TickType_t deadline;  // Tick count
+    uint32_t submitted_us;
+    I2cStatus status;
+    SemaphoreHandle_t h_done;
+  };
+
+  TwoWire *wire;
+  const int sda_pin;
+  const int scl_pin;
+  uint32_t clock_hz;  // Current bus clock
+  uint32_t recoveries;  // Bus recoveries performed
+  StaticQueue<Transaction *, I2C_BUS_QUEUE_LENGTH> request_queue;
+  QueueHandle_t h_request_queue;
+  Transaction *waiting[I2C_BUS_QUEUE_LENGTH];  // In arrival order
+  size_t waiting_count;
+  uint8_t batch[I2C_BUS_BATCH_BYTES];
+
+  /**
+   * Queues a transaction and waits for it to complete.
+   */
+  I2cStatus submit(
+      Transaction &transaction,
+      I2cDevice &device,
+      I2cPriority priority,
+      uint32_t deadline_ms);
+
+  /**
+   * Returns true if a transaction is a plain write that may share a bus
+   * write with its neighbors.
+   */
+  static bool is_batchable(const Transaction *transaction);
+
+  /**
+   * Signals a transaction's completion and records its statistics.
+   */
+  void complete(Transaction *transaction, I2cStatus status);
+
+  /**
+   * Fails the waiting transactions whose deadlines have passed.
+   */
+  void expire(void);
+
+  /**
+   * Returns the index of the waiting transaction to run next.
+   */
+  size_t select(void) const;
+
+  /**
+   * Runs the waiting transaction at the specified index along with any
+   * writes that can go with it, and removes them from the waiting list.
+   */
+  void run(size_t index);
+
+  /**
+   * Runs a single transaction on the bus.
+   */
+  I2cStatus execute(Transaction *transaction);
+
+  /**
+   * Writes the specified bytes to a device in one bus write.
+   */
+  I2cStatus send(uint8_t address, const uint8_t *data, size_t length);
+
+  /**
+   * Frees a bus that a slave holds by clocking SCL until it releases SDA,
+   * sends a STOP, and restarts the bus.
+   */
+  void recover(void);
+
+  /**
+   * Starts the bus at the current clock.
+   */
+  void begin_bus(void);
+
+  virtual void task_loop(void);
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * wire                The bus to own. Nothing else may use it.
+   * sda_pin             The bus's data pin, for recovery
+   * scl_pin             The bus's clock pin, for recovery
+   */
+  I2cBusManager(TwoWire *wire, int sda_pin, int scl_pin);
+  virtual ~I2cBusManager();
+
+  /**
+   * Starts the bus and the manager.
+   */
+  TaskHandle_t start(void);
+
+  /**
+   * Writes bytes to a device.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * device              The target device
+   * data                Bytes to write
+   * length              Number of bytes to write, at most
+   *                     I2C_BUS_BATCH_BYTES
+   * priority            Transaction priority
+   * deadline_ms         Maximum wait before the transaction starts, or
+   *                     I2C_NO_DEADLINE
+   */
+  I2cStatus write(
+      I2cDevice &device,
+      const uint8_t *data,
+      size_t length,
+      I2cPriority priority,
+      uint32_t deadline_ms);
+
+  /**
+   * Writes bytes to a device, typically a register address, then reads
+   * its response after a repeated START. Parameters are as in write(),
+   * plus:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * read_data           Receives the response
+   * read_length         Number of bytes to read
+   */
+  I2cStatus write_read(
+      I2cDevice &device,
+      const uint8_t *write_data,
+      size_t write_length,
+      uint8_t *read_data,
+      size_t read_length,
+      I2cPriority priority,
+      uint32_t deadline_ms);
+
+  /**
+   * Runs an operation with exclusive use of the bus, at the device's
+   * clock. Parameters are as in write().
+   */
+  I2cStatus perform(
+      I2cDevice &device,
+      I2cOperation &operation,
+      I2cPriority priority,
+      uint32_t deadline_ms);
+
+  uint32_t get_recoveries(void) const {
+    return recoveries;
+  }
+
+  /**
+   * Prints the bus recoveries and one line per registered device over
+   * serial.
+   */
+  void print_report(void) const;
+};
+
+#endif /* I2CBUSMANAGER_H_ */
@@ -0,0 +1,49 @@
+/*
+ * LatencyHistogram.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LatencyHistogram.h"
+
+LatencyHistogram::LatencyHistogram() {
+  clear();
+}
+
+void LatencyHistogram::record(uint32_t latency_ms) {
+  size_t bucket = latency_ms ? 32 - __builtin_clz(latency_ms) : 0;
+  if (LATENCY_HISTOGRAM_BUCKETS <= bucket) {
+    bucket = LATENCY_HISTOGRAM_BUCKETS - 1;
+  }
+  ++buckets[bucket];
+  ++count;
+  if (max_ms < latency_ms) {
+    max_ms = latency_ms;
+  }
+}
+
+void LatencyHistogram::clear(void) {
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i) {
+    buckets[i] = 0;
+  }
+  count = 0;
+  max_ms = 0;
+}
+
+uint32_t LatencyHistogram::percentile_ms(uint32_t percent) const {
+  if (!count) {
+    return 0;
+  }
+  // Smallest rank that covers the percentile, rounded up.
+  uint64_t rank = ((uint64_t) count * percent + 99) / 100;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS - 1; ++i) {
+    seen += buckets[i];
+    if (rank <= seen) {
+      uint32_t limit_ms = bucket_limit_ms(i);
+      return limit_ms < max_ms ? limit_ms : max_ms;
+    }
+  }
+  return max_ms;
+}
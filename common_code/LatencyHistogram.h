@@ -0,0 +1,68 @@
+/*
+ * LatencyHistogram.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Power of two latency histogram. Bucket 0 counts latencies of 0 ms, and
+ * bucket n > 0 counts latencies in [2^(n-1), 2^n) ms. The last bucket
+ * also holds everything longer. Recording costs a count leading zeros
+ * and an increment, so it is cheap enough for the send path.
+ *
+ * The histogram has no Arduino or FreeRTOS dependencies.
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LATENCY_HISTOGRAM_BUCKETS 16
+
+class LatencyHistogram {
+  uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+  uint32_t count;
+  uint32_t max_ms;
+
+public:
+  LatencyHistogram();
+
+  /**
+   * Records a latency.
+   */
+  void record(uint32_t latency_ms);
+
+  /**
+   * Clears all counts.
+   */
+  void clear(void);
+
+  /**
+   * Returns the upper bound of the bucket that holds the specified
+   * percentile, [0, 100], capped at the maximum recorded latency, or 0 if
+   * the histogram is empty.
+   */
+  uint32_t percentile_ms(uint32_t percent) const;
+
+  /**
+   * Returns the exclusive upper bound of a bucket in milliseconds.
+   */
+  static uint32_t bucket_limit_ms(size_t bucket) {
+    return (uint32_t) 1 << bucket;
+  }
+
+  uint32_t get_bucket(size_t bucket) const {
+    return buckets[bucket];
+  }
+
+  uint32_t get_count(void) const {
+    return count;
+  }
+
+  uint32_t get_max_ms(void) const {
+    return max_ms;
+  }
+};
+
+#endif /* LATENCYHISTOGRAM_H_ */
@@ -0,0 +1,77 @@
+/*
+ * LatestValue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Lock-free single value cell. One task publishes values and any number
+ * of tasks read the most recent one. The cell is a sequence lock: the
+ * writer makes the sequence odd while it copies, and readers retry when
+ * the sequence is odd or changes under them. Neither side blocks, takes
+ * a mutex, or disables interrupts, and a read costs one copy of the
+ * value unless it races a write.
+ *
+ * The value type must be trivially copyable. Only one task may write.
+ */
+
+#ifndef LATESTVALUE_H_
+#define LATESTVALUE_H_
+
+#include <atomic>
+#include <stdint.h>
+
+template <typename T> class LatestValue {
+  std::atomic<uint32_t> sequence;
+  T value;
+
+public:
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * initial_value       Value that readers see before the first publish.
+   */
+  explicit LatestValue(const T& initial_value) :
+      sequence(0),
+      value(initial_value) {
+  }
+
+  /**
+   * Replaces the value. Only one task may publish.
+   */
+  void publish(const T& new_value) {
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    value = new_value;
+    sequence.store(current + 2, std::memory_order_release);
+  }
+
+  /**
+   * Returns the most recently published value.
+   */
+  T read(void) const {
+    T copy;
+    uint32_t before;
+    uint32_t after;
+    do {
+      before = sequence.load(std::memory_order_acquire);
+      copy = value;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) || before != after);
+    return copy;
+  }
+
+  /**
+   * Returns the number of values published since construction.
+   */
+  uint32_t get_publish_count(void) const {
+    return sequence.load(std::memory_order_relaxed) / 2;
+  }
+};
+
+#endif /* LATESTVALUE_H_ */
@@ -0,0 +1,97 @@
+/*
+ * LcdFramebuffer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LcdFramebuffer.h"
+
+#include <string.h>
+
+LcdFramebuffer::LcdFramebuffer() :
+    column(0),
+    row(0),
+    cursor_known(false),
+    cursor_column(0),
+    cursor_row(0),
+    requested_transfers(0),
+    sent_transfers(0) {
+  memset(frame, ' ', sizeof(frame));
+  memset(shown, ' ', sizeof(shown));
+}
+
+void LcdFramebuffer::reset(void) {
+  memset(frame, ' ', sizeof(frame));
+  memset(shown, ' ', sizeof(shown));
+  column = 0;
+  row = 0;
+  cursor_known = true;
+  cursor_column = 0;
+  cursor_row = 0;
+}
+
+void LcdFramebuffer::clear(void) {
+  memset(frame, ' ', sizeof(frame));
+  column = 0;
+  row = 0;
+  ++requested_transfers;
+}
+
+void LcdFramebuffer::set_cursor(uint8_t column, uint8_t row) {
+  this->column = column;
+  this->row = row;
+  ++requested_transfers;
+}
+
+void LcdFramebuffer::print(const char *text) {
+  size_t length = strlen(text);
+  requested_transfers += length;
+  if (LCD_FRAMEBUFFER_ROWS <= row || LCD_FRAMEBUFFER_COLUMNS <= column) {
+    return;
+  }
+  size_t room = LCD_FRAMEBUFFER_COLUMNS - column;
+  size_t count = length < room ? length : room;
+  memcpy(&frame[row][column], text, count);
+  column += count;
+}
+
+void LcdFramebuffer::flush(LcdWriter &writer) {
+  for (uint8_t r = 0; r < LCD_FRAMEBUFFER_ROWS; ++r) {
+    const char *wanted = frame[r];
+    char *displayed = shown[r];
+    uint8_t c = 0;
+    while (c < LCD_FRAMEBUFFER_COLUMNS) {
+      if (wanted[c] == displayed[c]) {
+        ++c;
+        continue;
+      }
+      uint8_t start = c;
+      uint8_t end = c + 1;
+      for (uint8_t next = end;
+          next < LCD_FRAMEBUFFER_COLUMNS
+              && next - end <= LCD_FRAMEBUFFER_MAX_GAP;
+          ++next) {
+        if (wanted[next] != displayed[next]) {
+          end = next + 1;
+        }
+      }
+      if (!cursor_known || cursor_row != r || cursor_column != start) {
+        writer.set_cursor(start, r);
+        ++sent_transfers;
+      }
+      writer.write(&wanted[start], end - start);
+      sent_transfers += end - start;
+      memcpy(&displayed[start], &wanted[start], end - start);
+      // Past the last column, the cursor leaves the visible row.
+      cursor_known = end < LCD_FRAMEBUFFER_COLUMNS;
+      cursor_column = end;
+      cursor_row = r;
+      c = end;
+    }
+  }
+}
+
+bool LcdFramebuffer::is_dirty(void) const {
+  return memcmp(frame, shown, sizeof(frame)) != 0;
+}
@@ -0,0 +1,112 @@
+/*
+ * LcdFramebuffer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Shadow framebuffer for a character LCD. Commands such as set_cursor()
+ * and print() update the buffer only; flush() compares the buffer with
+ * what the display shows and sends just the runs of cells that changed,
+ * moving the cursor only when a run does not start where the last one
+ * ended. Redrawing an unchanged time of day or status line costs nothing.
+ *
+ * The buffer counts the transfers, i.e. characters and cursor moves,
+ * that writing each command straight to the display would have cost,
+ * and those that flush() actually sent. Multiply by the backend's bus
+ * bytes per transfer for the bus traffic saved.
+ *
+ * Text that runs past the end of a row is clipped; it does not wrap.
+ *
+ * The buffer has no Arduino or FreeRTOS dependencies, so it builds on a
+ * host. It is not thread safe; use it from one task.
+ */
+
+#ifndef LCDFRAMEBUFFER_H_
+#define LCDFRAMEBUFFER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LcdWriter.h"
+
+#define LCD_FRAMEBUFFER_ROWS 2
+#define LCD_FRAMEBUFFER_COLUMNS 16
+
+// Runs separated by at most this many unchanged cells merge, since
+// rewriting them costs no more than moving the cursor past them.
+#define LCD_FRAMEBUFFER_MAX_GAP 1
+
+class LcdFramebuffer {
+  char frame[LCD_FRAMEBUFFER_ROWS][LCD_FRAMEBUFFER_COLUMNS];  // Wanted
+  char shown[LCD_FRAMEBUFFER_ROWS][LCD_FRAMEBUFFER_COLUMNS];  // Displayed
+  uint8_t column;  // Write position
+  uint8_t row;
+  bool cursor_known;  // The display cursor position is known
+  uint8_t cursor_column;  // Display cursor position, if known
+  uint8_t cursor_row;
+  uint32_t requested_transfers;  // Cost of writing commands directly
+  uint32_t sent_transfers;  // Cost of the flushes
+
+public:
+  LcdFramebuffer();
+
+  /**
+   * Records that the display was just cleared, e.g. by its
+   * initialization, so that it shows blanks with the cursor at home.
+   */
+  void reset(void);
+
+  /**
+   * Blanks the buffer and moves the write position home. The display
+   * changes on the next flush().
+   */
+  void clear(void);
+
+  /**
+   * Sets the write position. Columns and rows start at 0.
+   */
+  void set_cursor(uint8_t column, uint8_t row);
+
+  /**
+   * Writes a NUL-terminated string at the write position, which
+   * advances past it.
+   */
+  void print(const char *text);
+
+  /**
+   * Sends the changed cells to the display.
+   */
+  void flush(LcdWriter &writer);
+
+  /**
+   * Returns true if the buffer differs from the display.
+   */
+  bool is_dirty(void) const;
+
+  /**
+   * Returns the number of transfers that writing every command straight
+   * to the display would have cost.
+   */
+  uint32_t get_requested_transfers(void) const {
+    return requested_transfers;
+  }
+
+  /**
+   * Returns the number of transfers that flush() sent.
+   */
+  uint32_t get_sent_transfers(void) const {
+    return sent_transfers;
+  }
+
+  /**
+   * Returns the number of transfers saved, or 0 if flush() sent more
+   * than direct writes would have.
+   */
+  uint32_t get_saved_transfers(void) const {
+    return sent_transfers < requested_transfers
+        ? requested_transfers - sent_transfers
+        : 0;
+  }
+};
+
+#endif /* LCDFRAMEBUFFER_H_ */
@@ -0,0 +1,14 @@
+/*
+ * LcdWriter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LcdWriter.h"
+
+LcdWriter::LcdWriter() {
+}
+
+LcdWriter::~LcdWriter() {
+}
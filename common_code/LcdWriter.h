@@ -0,0 +1,33 @@
+/*
+ * LcdWriter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Destination for character LCD updates. The receiver implements it on
+ * its I2C display, and a host program can substitute a simulated one.
+ */
+
+#ifndef LCDWRITER_H_
+#define LCDWRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+class LcdWriter {
+public:
+  LcdWriter();
+  virtual ~LcdWriter();
+
+  /**
+   * Moves the display cursor. Columns and rows start at 0.
+   */
+  virtual void set_cursor(uint8_t column, uint8_t row) = 0;
+
+  /**
+   * Writes characters at the cursor, which advances past them.
+   */
+  virtual void write(const char *text, size_t length) = 0;
+};
+
+#endif /* LCDWRITER_H_ */
@@ -0,0 +1,104 @@
+/*
+ * LedPatternEngine.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LedPatternEngine.h"
+
+LedPatternEngine::LedPatternEngine(const uint8_t *pins, size_t pin_count) :
+    pins(pins),
+    pin_count(
+        pin_count < LED_SEQUENCER_CHANNELS
+            ? pin_count
+            : LED_SEQUENCER_CHANNELS),
+    sequencer(),
+    h_timer(NULL),
+    last_advance_us(0),
+    requests_pending(false) {
+}
+
+LedPatternEngine::~LedPatternEngine() {
+}
+
+void LedPatternEngine::on_timer(void *engine) {
+  static_cast<LedPatternEngine *>(engine)->advance();
+}
+
+bool LedPatternEngine::begin(void) {
+  for (size_t i = 0; i < pin_count; ++i) {
+    pinMode(pins[i], OUTPUT);
+    digitalWrite(pins[i], LOW);
+  }
+  esp_timer_create_args_t timer_args;
+  memset(&timer_args, 0, sizeof(timer_args));
+  timer_args.callback = on_timer;
+  timer_args.arg = this;
+  timer_args.dispatch_method = ESP_TIMER_TASK;
+  timer_args.name = "LED patterns";
+  if (esp_timer_create(&timer_args, &h_timer) != ESP_OK) {
+    h_timer = NULL;
+    return false;
+  }
+  last_advance_us = esp_timer_get_time();
+  wake();
+  return true;
+}
+
+void LedPatternEngine::wake(void) {
+  requests_pending.store(true);
+  if (h_timer) {
+    // Fails harmlessly if another task or advance() armed the timer
+    // since the stop; advance() then sees the pending request.
+    esp_timer_stop(h_timer);
+    esp_timer_start_once(h_timer, 0);
+  }
+}
+
+void LedPatternEngine::advance(void) {
+  do {
+    requests_pending.store(false);
+    int64_t now_us = esp_timer_get_time();
+    int64_t elapsed_ms = (now_us - last_advance_us) / 1000;
+    if (LED_SEQUENCER_IDLE <= elapsed_ms) {
+      elapsed_ms = LED_SEQUENCER_IDLE - 1;
+    }
+    last_advance_us += elapsed_ms * 1000;
+    uint32_t changed_channels;
+    uint32_t next_change_ms =
+        sequencer.advance((uint32_t) elapsed_ms, &changed_channels);
+    for (size_t i = 0; i < pin_count; ++i) {
+      if (changed_channels & ((uint32_t) 1 << i)) {
+        digitalWrite(pins[i], sequencer.get_level(i));
+      }
+    }
+    esp_timer_stop(h_timer);
+    if (next_change_ms != LED_SEQUENCER_IDLE) {
+      // The sequencer's time lags now_us by the sub-millisecond remainder.
+      esp_timer_start_once(
+          h_timer,
+          (uint64_t) next_change_ms * 1000 - (now_us - last_advance_us));
+    }
+    // A request that arrived after the store above either finds the
+    // timer armed and re-arms it, or is seen here.
+  } while (requests_pending.load());
+}
+
+bool LedPatternEngine::show(uint8_t pin, const LedPattern& pattern) {
+  for (size_t i = 0; i < pin_count; ++i) {
+    if (pins[i] == pin) {
+      sequencer.request(i, &pattern);
+      wake();
+      return true;
+    }
+  }
+  return false;
+}
+
+void LedPatternEngine::all_off(void) {
+  for (size_t i = 0; i < pin_count; ++i) {
+    sequencer.request(i, &LED_PATTERN_OFF);
+  }
+  wake();
+}
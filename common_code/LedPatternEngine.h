@@ -0,0 +1,85 @@
+/*
+ * LedPatternEngine.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Drives LED patterns on a set of GPIO pins from a single one-shot
+ * esp_timer, replacing one blink task per LED. The timer fires only
+ * when some LED changes level, and not at all while every LED holds
+ * steady. See LedSequencer.h for the pattern format.
+ *
+ * show() never blocks or takes a lock, so any task, including the Wi-Fi
+ * task that runs ESP-NOW callbacks, can switch patterns. The new pattern
+ * starts at once. Patterns started together stay in step.
+ *
+ * The engine owns its pins. Do not write to them directly once begin()
+ * has been invoked.
+ */
+
+#ifndef LEDPATTERNENGINE_H_
+#define LEDPATTERNENGINE_H_
+
+#include "Arduino.h"
+
+#include <atomic>
+
+#include "esp_timer.h"
+
+#include "LedSequencer.h"
+
+class LedPatternEngine {
+  const uint8_t *pins;
+  const size_t pin_count;
+  LedSequencer sequencer;
+  esp_timer_handle_t h_timer;
+  int64_t last_advance_us;  // Whole milliseconds passed to the sequencer
+  std::atomic<bool> requests_pending;
+
+  static void on_timer(void *engine);
+
+  /**
+   * Advances the patterns, drives the pins that changed, and arms the
+   * timer for the next change. Runs in the esp_timer task.
+   */
+  void advance(void);
+
+  /**
+   * Runs advance() as soon as possible.
+   */
+  void wake(void);
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * pins                The GPIO pins to drive, at most
+   *                     LED_SEQUENCER_CHANNELS. Must outlive the engine.
+   * pin_count           The number of pins in the array.
+   */
+  LedPatternEngine(const uint8_t *pins, size_t pin_count);
+  virtual ~LedPatternEngine();
+
+  /**
+   * Configures the pins as outputs, turns them off, and starts any
+   * patterns shown so far. Returns true on success.
+   */
+  bool begin(void);
+
+  /**
+   * Plays a pattern on a pin. Returns false if the engine does not own
+   * the pin.
+   */
+  bool show(uint8_t pin, const LedPattern& pattern);
+
+  /**
+   * Turns off every pin.
+   */
+  void all_off(void);
+};
+
+#endif /* LEDPATTERNENGINE_H_ */
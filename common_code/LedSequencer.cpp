@@ -0,0 +1,106 @@
+/*
+ * LedSequencer.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LedSequencer.h"
+
+static_assert(
+    LED_SEQUENCER_CHANNELS <= 32,
+    "The change mask holds at most 32 channels.");
+
+static const LedStep OFF_STEPS[] = {
+  { LED_LEVEL_LOW, 0 },
+};
+
+static const LedStep ON_STEPS[] = {
+  { LED_LEVEL_HIGH, 0 },
+};
+
+const LedPattern LED_PATTERN_OFF = { OFF_STEPS, 1, LED_PATTERN_ONCE };
+const LedPattern LED_PATTERN_ON = { ON_STEPS, 1, LED_PATTERN_ONCE };
+
+LedSequencer::LedSequencer() {
+  for (size_t i = 0; i < LED_SEQUENCER_CHANNELS; ++i) {
+    channels[i].pattern = &LED_PATTERN_OFF;
+    channels[i].step = 0;
+    channels[i].level = LED_LEVEL_LOW;
+    channels[i].remaining_ms = LED_SEQUENCER_IDLE;
+    requests[i].store(NULL, std::memory_order_relaxed);
+  }
+}
+
+void LedSequencer::start(Channel& channel, const LedPattern *pattern) {
+  channel.pattern = pattern;
+  channel.step = 0;
+  if (pattern->step_count) {
+    channel.level = pattern->steps[0].level;
+    channel.remaining_ms = pattern->steps[0].duration_ms;
+    consume(channel, 0);
+  } else {
+    channel.level = LED_LEVEL_LOW;
+    channel.remaining_ms = LED_SEQUENCER_IDLE;
+  }
+}
+
+void LedSequencer::consume(Channel& channel, uint32_t elapsed_ms) {
+  const LedPattern *pattern = channel.pattern;
+  // Counts consecutive empty steps so that a repeating section with no
+  // duration holds instead of spinning.
+  size_t empty_steps = 0;
+  while (channel.remaining_ms != LED_SEQUENCER_IDLE
+      && channel.remaining_ms <= elapsed_ms) {
+    elapsed_ms -= channel.remaining_ms;
+    size_t next_step = channel.step + 1;
+    if (next_step == pattern->step_count) {
+      if (pattern->repeat_from >= pattern->step_count) {
+        channel.remaining_ms = LED_SEQUENCER_IDLE;
+        return;
+      }
+      next_step = pattern->repeat_from;
+    }
+    if (pattern->steps[next_step].duration_ms) {
+      empty_steps = 0;
+    } else if (pattern->step_count < ++empty_steps) {
+      channel.remaining_ms = LED_SEQUENCER_IDLE;
+      return;
+    }
+    channel.step = next_step;
+    channel.level = pattern->steps[next_step].level;
+    channel.remaining_ms = pattern->steps[next_step].duration_ms;
+  }
+  if (channel.remaining_ms != LED_SEQUENCER_IDLE) {
+    channel.remaining_ms -= elapsed_ms;
+  }
+}
+
+void LedSequencer::request(size_t channel, const LedPattern *pattern) {
+  if (channel < LED_SEQUENCER_CHANNELS && pattern) {
+    requests[channel].store(pattern, std::memory_order_release);
+  }
+}
+
+uint32_t LedSequencer::advance(uint32_t elapsed_ms, uint32_t *changed_channels) {
+  uint32_t changed = 0;
+  uint32_t next_change_ms = LED_SEQUENCER_IDLE;
+  for (size_t i = 0; i < LED_SEQUENCER_CHANNELS; ++i) {
+    Channel& channel = channels[i];
+    uint8_t previous_level = channel.level;
+    consume(channel, elapsed_ms);
+    const LedPattern *request =
+        requests[i].exchange(NULL, std::memory_order_acquire);
+    if (request) {
+      start(channel, request);
+    }
+    if (channel.level != previous_level) {
+      changed |= (uint32_t) 1 << i;
+    }
+    if (channel.remaining_ms < next_change_ms) {
+      next_change_ms = channel.remaining_ms;
+    }
+  }
+  *changed_channels = changed;
+  return next_change_ms;
+}
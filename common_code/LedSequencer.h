@@ -0,0 +1,119 @@
+/*
+ * LedSequencer.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Plays declarative on/off patterns on a set of output channels. A
+ * pattern is a list of levels and durations, an optional lead-in that
+ * plays once followed by a section that repeats. A pattern that does
+ * not repeat holds its last level when it ends. Ripples are one pattern
+ * per channel that differ only in the length of their lead-in, and
+ * group flashes are a repeating section that ends with a long pause.
+ *
+ * The sequencer keeps no time of its own. Its owner calls advance()
+ * with the time that has passed, and advance() reports the channels
+ * whose levels changed and the time until the next change, so one timer
+ * drives every channel. Any task can request a new pattern for a channel
+ * at any time without locking; the request takes effect on the next
+ * advance().
+ *
+ * Patterns and their steps must outlive the sequencer, so declare them
+ * const at namespace scope, where they stay in flash.
+ *
+ * The sequencer has no Arduino or FreeRTOS dependencies, so it builds on
+ * a host. Only one task may call advance().
+ */
+
+#ifndef LEDSEQUENCER_H_
+#define LEDSEQUENCER_H_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#define LED_SEQUENCER_CHANNELS 8  // Must not exceed 32, the change mask
+#define LED_SEQUENCER_IDLE UINT32_MAX  // advance(): no change is pending
+#define LED_PATTERN_ONCE 0xFF  // LedPattern::repeat_from: do not repeat
+#define LED_LEVEL_LOW 0  // Same as the Arduino LOW
+#define LED_LEVEL_HIGH 1  // Same as the Arduino HIGH
+
+/**
+ * A pattern step: a level (HIGH or LOW) and how long to hold it. Steps
+ * may last 0 ms, e.g. a ripple lead-in for the first channel.
+ */
+struct LedStep {
+  uint8_t level;
+  uint32_t duration_ms;
+};
+
+struct LedPattern {
+  const LedStep *steps;
+  uint8_t step_count;
+  uint8_t repeat_from;  // First step to repeat, or LED_PATTERN_ONCE
+};
+
+extern const LedPattern LED_PATTERN_OFF;  // Hold the channel low.
+extern const LedPattern LED_PATTERN_ON;  // Hold the channel high.
+
+class LedSequencer {
+  struct Channel {
+    const LedPattern *pattern;
+    uint8_t step;
+    uint8_t level;
+    uint32_t remaining_ms;  // LED_SEQUENCER_IDLE when holding
+  };
+
+  Channel channels[LED_SEQUENCER_CHANNELS];
+  std::atomic<const LedPattern *> requests[LED_SEQUENCER_CHANNELS];
+
+  /**
+   * Starts a pattern on a channel.
+   */
+  static void start(Channel& channel, const LedPattern *pattern);
+
+  /**
+   * Moves a channel forward in its pattern.
+   */
+  static void consume(Channel& channel, uint32_t elapsed_ms);
+
+public:
+  LedSequencer();
+
+  /**
+   * Requests a pattern for a channel, replacing any earlier request that
+   * has not yet taken effect. Safe to invoke from any task.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * channel             The channel, [0, LED_SEQUENCER_CHANNELS)
+   * pattern             The pattern. Must not be NULL.
+   */
+  void request(size_t channel, const LedPattern *pattern);
+
+  /**
+   * Advances every channel by the elapsed time, then starts the
+   * requested patterns. Returns the time until the next level change
+   * or LED_SEQUENCER_IDLE if every channel holds its level.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * elapsed_ms          Time since the previous advance()
+   * changed_channels    Receives a bit mask of the channels whose levels
+   *                     changed, bit 0 for channel 0.
+   */
+  uint32_t advance(uint32_t elapsed_ms, uint32_t *changed_channels);
+
+  /**
+   * Returns a channel's current level.
+   */
+  uint8_t get_level(size_t channel) const {
+    return channels[channel].level;
+  }
+};
+
+#endif /* LEDSEQUENCER_H_ */
@@ -0,0 +1,107 @@
+/*
+ * LinkQuality.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "LinkQuality.h"
+
+#include <stdlib.h>
+
+// Sequence numbers this far behind the highest seen mean that a sender
+// without a boot identifier restarted, as in DuplicateFilter.
+#define LINK_QUALITY_RESTART_WINDOW 32
+
+// Loss rate updates per sequence gap. After 128 losses in a row, the
+// rate is within 0.03% of 100%, so longer gaps change nothing visible.
+#define LINK_QUALITY_MAX_GAP_STEPS 128
+
+#define LINK_QUALITY_RATE_ONE 65536
+
+LinkQuality::LinkQuality() :
+    has_rssi(false),
+    rssi_x16(0),
+    rssi_min(0),
+    rssi_max(0),
+    started(false),
+    boot_id(0),
+    highest_sequence(0),
+    frames_received(0),
+    frames_lost(0),
+    recent_loss(0),
+    last_transit_ms(0),
+    jitter_x16(0),
+    jitter_histogram(),
+    last_arrival_ms(0) {
+}
+
+void LinkQuality::smooth_loss(bool lost) {
+  if (lost) {
+    recent_loss += (LINK_QUALITY_RATE_ONE - recent_loss) >> 4;
+  } else {
+    recent_loss -= recent_loss >> 4;
+  }
+}
+
+void LinkQuality::on_rssi(int8_t rssi_dbm) {
+  if (!has_rssi) {
+    rssi_x16 = rssi_dbm * 16;
+    rssi_min = rssi_dbm;
+    rssi_max = rssi_dbm;
+    has_rssi = true;
+    return;
+  }
+  rssi_x16 += (rssi_dbm * 16 - rssi_x16) / 16;
+  if (rssi_dbm < rssi_min) {
+    rssi_min = rssi_dbm;
+  }
+  if (rssi_max < rssi_dbm) {
+    rssi_max = rssi_dbm;
+  }
+}
+
+void LinkQuality::on_frame(
+    uint16_t sequence,
+    uint16_t boot_id,
+    uint32_t sent_ms,
+    uint32_t arrival_ms) {
+  ++frames_received;
+  last_arrival_ms = arrival_ms;
+  int32_t transit_ms = (int32_t) (arrival_ms - sent_ms);
+  int16_t ahead = (int16_t) (uint16_t) (sequence - highest_sequence);
+
+  if (!started
+      || boot_id != this->boot_id
+      || ahead <= -LINK_QUALITY_RESTART_WINDOW) {
+    // First frame, or the sender restarted: start a new baseline.
+    started = true;
+    this->boot_id = boot_id;
+    highest_sequence = sequence;
+    last_transit_ms = transit_ms;
+    smooth_loss(false);
+    return;
+  }
+
+  if (ahead <= 0) {
+    // Late, so it was counted as lost when its successor arrived.
+    if (frames_lost) {
+      --frames_lost;
+    }
+    smooth_loss(false);
+    return;
+  }
+
+  uint32_t gap = ahead - 1;
+  frames_lost += gap;
+  for (uint32_t i = 0; i < gap && i < LINK_QUALITY_MAX_GAP_STEPS; ++i) {
+    smooth_loss(true);
+  }
+  smooth_loss(false);
+
+  uint32_t d_ms = (uint32_t) abs(transit_ms - last_transit_ms);
+  jitter_x16 += d_ms - ((jitter_x16 + 8) >> 4);
+  jitter_histogram.record(d_ms);
+  highest_sequence = sequence;
+  last_transit_ms = transit_ms;
+}
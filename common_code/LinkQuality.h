@@ -0,0 +1,147 @@
+/*
+ * LinkQuality.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Link quality statistics for one sender, measured at the receiver:
+ *
+ * Statistic  Source
+ * ---------- -------------------------------------------------------------
+ * RSSI       Radio metadata of each received frame. Smoothed, with the
+ *            minimum and maximum.
+ * Loss       Gaps in the frame sequence numbers. A frame that arrives
+ *            after its successors, e.g. a retransmission, is taken off
+ *            the loss count. Kept as a total and as a recent rate.
+ * Jitter     Variation in transit time between consecutive frames, as in
+ *            RFC 3550: D = (arrival - sent) - (previous arrival - previous
+ *            sent). The sender's clock offset cancels out. Kept as the
+ *            smoothed mean |D| and a histogram of |D|.
+ *
+ * Every update takes constant time, so the statistics can be kept in the
+ * radio's receive callback. Smoothed values are exponentially weighted
+ * with a weight of 1/16 per sample.
+ *
+ * A new boot identifier, or for senders without one, a sequence number
+ * far behind the highest seen, means that the sender restarted, and
+ * starts a new baseline.
+ *
+ * Pass only frames that are not duplicates to on_frame(). Updates must
+ * come from one task; other tasks may read values that are slightly
+ * stale.
+ *
+ * The statistics have no Arduino or FreeRTOS dependencies.
+ */
+
+#ifndef LINKQUALITY_H_
+#define LINKQUALITY_H_
+
+#include <stdint.h>
+
+#include "LatencyHistogram.h"
+
+class LinkQuality {
+  bool has_rssi;
+  int16_t rssi_x16;  // Smoothed RSSI, 1/16 dBm
+  int8_t rssi_min;
+  int8_t rssi_max;
+
+  bool started;  // A sequenced frame has arrived
+  uint16_t boot_id;
+  uint16_t highest_sequence;
+  uint32_t frames_received;
+  uint32_t frames_lost;
+  uint32_t recent_loss;  // Smoothed loss rate, 1/65536
+
+  int32_t last_transit_ms;  // Arrival - sent for highest_sequence
+  uint32_t jitter_x16;  // Smoothed |D|, 1/16 ms
+  LatencyHistogram jitter_histogram;  // |D|
+  uint32_t last_arrival_ms;
+
+  /**
+   * Folds one received (lost = false) or lost (lost = true) frame into
+   * the recent loss rate.
+   */
+  void smooth_loss(bool lost);
+
+public:
+  LinkQuality();
+
+  /**
+   * Records the signal strength of a frame, in dBm.
+   */
+  void on_rssi(int8_t rssi_dbm);
+
+  /**
+   * Records the arrival of a frame that is not a duplicate.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * sequence            The frame's sequence number
+   * boot_id             The frame's boot identifier, 0 if it has none
+   * sent_ms             The sender's timestamp
+   * arrival_ms          The receiver's clock at arrival
+   */
+  void on_frame(
+      uint16_t sequence,
+      uint16_t boot_id,
+      uint32_t sent_ms,
+      uint32_t arrival_ms);
+
+  bool get_has_rssi(void) const {
+    return has_rssi;
+  }
+
+  /**
+   * Returns the smoothed RSSI, rounded to the nearest dBm.
+   */
+  int get_rssi_dbm(void) const {
+    return (rssi_x16 + (rssi_x16 < 0 ? -8 : 8)) / 16;
+  }
+
+  int get_rssi_min_dbm(void) const {
+    return rssi_min;
+  }
+
+  int get_rssi_max_dbm(void) const {
+    return rssi_max;
+  }
+
+  uint32_t get_frames_received(void) const {
+    return frames_received;
+  }
+
+  uint32_t get_frames_lost(void) const {
+    return frames_lost;
+  }
+
+  /**
+   * Returns the recent loss rate in frames per thousand.
+   */
+  uint32_t get_recent_loss_permille(void) const {
+    return (recent_loss * 1000 + 32768) >> 16;
+  }
+
+  /**
+   * Returns the smoothed jitter, rounded to the nearest millisecond.
+   */
+  uint32_t get_jitter_ms(void) const {
+    return (jitter_x16 + 8) >> 4;
+  }
+
+  const LatencyHistogram &get_jitter_histogram(void) const {
+    return jitter_histogram;
+  }
+
+  /**
+   * Returns the receiver's clock when the last frame arrived. Valid
+   * once get_frames_received() is non-zero.
+   */
+  uint32_t get_last_arrival_ms(void) const {
+    return last_arrival_ms;
+  }
+};
+
+#endif /* LINKQUALITY_H_ */
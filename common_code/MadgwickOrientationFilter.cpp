@@ -0,0 +1,161 @@
+/*
+ * MadgwickOrientationFilter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "MadgwickOrientationFilter.h"
+
+#include <math.h>
+
+#define DEGREES_TO_RADIANS_D (3.14159265358979323846 / 180.0)
+#define ONE_Q30 (1LL << 30)
+
+/**
+ * Multiplies two Q30 values.
+ */
+static inline int64_t multiply(int64_t a, int64_t b) {
+  return (a * b) >> 30;
+}
+
+MadgwickOrientationFilter::MadgwickOrientationFilter(
+    uint16_t sample_rate_hz,
+    float beta) :
+      OrientationFilter(sample_rate_hz),
+      beta(beta),
+      half_radians_per_lsb_q40(0),
+      beta_per_sample_q30(0),
+      q0(ONE_Q30),
+      q1(0),
+      q2(0),
+      q3(0) {
+  on_calibrated();
+}
+
+const char *MadgwickOrientationFilter::get_name(void) const {
+  return "Q30 Madgwick";
+}
+
+void MadgwickOrientationFilter::on_calibrated(void) {
+  half_radians_per_lsb_q40 = llround(
+      0.5 * DEGREES_TO_RADIANS_D * 1099511627776.0
+          / (gyro_lsb_per_degree_per_second * get_sample_rate_hz()));
+  beta_per_sample_q30 = llround(
+      (double) beta * ONE_Q30 / get_sample_rate_hz());
+}
+
+void MadgwickOrientationFilter::update_gravity(void) {
+  // Gravity in the sensor frame, scaled so that 1 g is 2^14, the raw
+  // accelerometer scale at +/- 2 g. Only its direction matters.
+  int64_t w = q0;
+  int64_t x = q1;
+  int64_t y = q2;
+  int64_t z = q3;
+  gravity_x = (int32_t) ((x * z - w * y) >> 45);
+  gravity_y = (int32_t) ((w * x + y * z) >> 45);
+  gravity_z = (int32_t) ((w * w - x * x - y * y + z * z) >> 46);
+}
+
+void MadgwickOrientationFilter::initialize(const Sample& sample) {
+  int64_t ax = sample.accel_x;
+  int64_t ay = sample.accel_y;
+  int64_t az = sample.accel_z;
+  uint32_t norm = square_root(ax * ax + ay * ay + az * az);
+  if (!norm) {
+    return;
+  }
+
+  // Shortest rotation that carries +Z onto the measured gravity.
+  int64_t w = ONE_Q30 + az * ONE_Q30 / norm;
+  int64_t x = ay * ONE_Q30 / norm;
+  int64_t y = -ax * ONE_Q30 / norm;
+  uint64_t squared = w * w + x * x + y * y;
+  uint32_t length = square_root(squared);
+  if (length < (1U << 20)) {
+    // Upside down. Turn half way around X.
+    q0 = 0;
+    q1 = ONE_Q30;
+    q2 = 0;
+    q3 = 0;
+  } else {
+    q0 = (int32_t) (w * ONE_Q30 / length);
+    q1 = (int32_t) (x * ONE_Q30 / length);
+    q2 = (int32_t) (y * ONE_Q30 / length);
+    q3 = 0;
+  }
+  update_gravity();
+}
+
+void MadgwickOrientationFilter::filter(const Sample& sample) {
+  int64_t w = q0;
+  int64_t x = q1;
+  int64_t y = q2;
+  int64_t z = q3;
+
+  // Half the rotation during this sample, Q30 radians.
+  int64_t hx = (sample.gyro_x * half_radians_per_lsb_q40) >> 10;
+  int64_t hy = (sample.gyro_y * half_radians_per_lsb_q40) >> 10;
+  int64_t hz = (sample.gyro_z * half_radians_per_lsb_q40) >> 10;
+
+  // Quaternion change due to rotation, q * (0, h).
+  int64_t dw = (-x * hx - y * hy - z * hz) >> 30;
+  int64_t dx = (w * hx + y * hz - z * hy) >> 30;
+  int64_t dy = (w * hy - x * hz + z * hx) >> 30;
+  int64_t dz = (w * hz + x * hy - y * hx) >> 30;
+
+  int64_t raw_ax = sample.accel_x;
+  int64_t raw_ay = sample.accel_y;
+  int64_t raw_az = sample.accel_z;
+  uint32_t accel_norm =
+      square_root(raw_ax * raw_ax + raw_ay * raw_ay + raw_az * raw_az);
+  if (accel_norm) {
+    int64_t ax = raw_ax * ONE_Q30 / accel_norm;
+    int64_t ay = raw_ay * ONE_Q30 / accel_norm;
+    int64_t az = raw_az * ONE_Q30 / accel_norm;
+
+    int64_t ww = multiply(w, w);
+    int64_t xx = multiply(x, x);
+    int64_t yy = multiply(y, y);
+    int64_t zz = multiply(z, z);
+
+    // Gradient of the accelerometer objective function, Q30.
+    int64_t s0 = 4 * multiply(w, yy) + 2 * multiply(y, ax)
+        + 4 * multiply(w, xx) - 2 * multiply(x, ay);
+    int64_t s1 = 4 * multiply(x, zz) - 2 * multiply(z, ax)
+        + 4 * multiply(ww, x) - 2 * multiply(w, ay) - 4 * x
+        + 8 * multiply(x, xx) + 8 * multiply(x, yy) + 4 * multiply(x, az);
+    int64_t s2 = 4 * multiply(ww, y) + 2 * multiply(w, ax)
+        + 4 * multiply(y, zz) - 2 * multiply(z, ay) - 4 * y
+        + 8 * multiply(y, xx) + 8 * multiply(y, yy) + 4 * multiply(y, az);
+    int64_t s3 = 4 * multiply(xx, z) - 2 * multiply(x, ax)
+        + 4 * multiply(yy, z) - 2 * multiply(y, ay);
+
+    // Drop to Q22 so the squares fit in 64 bits.
+    s0 >>= 8;
+    s1 >>= 8;
+    s2 >>= 8;
+    s3 >>= 8;
+    uint32_t step_norm = square_root(
+        (uint64_t) (s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3));
+    if (step_norm) {
+      dw -= multiply(beta_per_sample_q30, s0 * ONE_Q30 / step_norm);
+      dx -= multiply(beta_per_sample_q30, s1 * ONE_Q30 / step_norm);
+      dy -= multiply(beta_per_sample_q30, s2 * ONE_Q30 / step_norm);
+      dz -= multiply(beta_per_sample_q30, s3 * ONE_Q30 / step_norm);
+    }
+  }
+
+  w += dw;
+  x += dx;
+  y += dy;
+  z += dz;
+  uint32_t length = square_root((uint64_t) (w * w + x * x + y * y + z * z));
+  if (length) {
+    q0 = (int32_t) (w * ONE_Q30 / length);
+    q1 = (int32_t) (x * ONE_Q30 / length);
+    q2 = (int32_t) (y * ONE_Q30 / length);
+    q3 = (int32_t) (z * ONE_Q30 / length);
+  }
+  update_gravity();
+}
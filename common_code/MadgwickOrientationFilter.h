@@ -0,0 +1,62 @@
+/*
+ * MadgwickOrientationFilter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Integer implementation of Madgwick's gradient descent IMU filter. The
+ * orientation quaternion is held in Q2.30, i.e. a 32 bit container with
+ * two integer bits so that unit components fit, and all products run in
+ * 64 bits. Normalization uses an integer square root and 64 bit division,
+ * so the update never touches the FPU.
+ *
+ * See S. Madgwick, "An efficient orientation filter for inertial and
+ * inertial/magnetic sensor arrays", 2010.
+ */
+
+#ifndef MADGWICKORIENTATIONFILTER_H_
+#define MADGWICKORIENTATIONFILTER_H_
+
+#include <stdint.h>
+
+#include "OrientationFilter.h"
+
+class MadgwickOrientationFilter : public OrientationFilter {
+  const float beta;
+  int64_t half_radians_per_lsb_q40;  // Half rotation per gyro LSB per sample
+  int64_t beta_per_sample_q30;       // beta * sample period
+  int32_t q0;                        // Orientation quaternion, Q2.30
+  int32_t q1;
+  int32_t q2;
+  int32_t q3;
+
+  void update_gravity(void);
+
+protected:
+  virtual void on_calibrated(void);
+
+  virtual void initialize(const Sample& sample);
+
+  virtual void filter(const Sample& sample);
+
+public:
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                   Contents
+   * ---------------------- -------------------------------------------------
+   * sample_rate_hz         The rate at which samples arrive.
+   * beta                   Gradient descent gain in radians per second.
+   *                        Madgwick suggests 0.1. Converted to fixed
+   *                        point at calibration.
+   */
+  MadgwickOrientationFilter(
+      uint16_t sample_rate_hz,
+      float beta);
+
+  virtual const char *get_name(void) const;
+};
+
+#endif /* MADGWICKORIENTATIONFILTER_H_ */
@@ -0,0 +1,130 @@
+/*
+ * Mpu6050AngleIntegrator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "Mpu6050AngleIntegrator.h"
+
+#include <math.h>
+
+#define RADIANS_TO_DEGREES_F (180.0f / 3.14159265f)
+
+/**
+ * Wraps an angle into [-limit, +limit]. Matches MPU6050_light.
+ */
+static float wrap(float angle, float limit) {
+  while (angle > limit) {
+    angle -= 2 * limit;
+  }
+  while (angle < -limit) {
+    angle += 2 * limit;
+  }
+  return angle;
+}
+
+/**
+ * Moves a scaled, filtered value toward a sample.
+ */
+static inline int32_t low_pass(int32_t scaled_filtered, int32_t sample) {
+  return scaled_filtered
+      + sample
+      - (scaled_filtered >> Mpu6050AngleIntegrator::GRAVITY_FILTER_SHIFT);
+}
+
+Mpu6050AngleIntegrator::Mpu6050AngleIntegrator(
+    uint16_t sample_rate_hz,
+    float gyro_coefficient) :
+      OrientationFilter(sample_rate_hz),
+      scaled_gravity_x(0),
+      scaled_gravity_y(0),
+      scaled_gravity_z(0),
+      sample_period_seconds(1.0f / sample_rate_hz),
+      gyro_coefficient(gyro_coefficient),
+      angle_x(0),
+      angle_y(0),
+      latest_angles(Angles()) {
+}
+
+const char *Mpu6050AngleIntegrator::get_name(void) const {
+  return "float complementary";
+}
+
+int32_t Mpu6050AngleIntegrator::get_roll_centidegrees(void) const {
+  return lroundf(get_angle_x() * 100);
+}
+
+int32_t Mpu6050AngleIntegrator::get_pitch_centidegrees(void) const {
+  return lroundf(get_angle_y() * 100);
+}
+
+void Mpu6050AngleIntegrator::publish_angles(void) {
+  Angles angles = {angle_x, angle_y};
+  latest_angles.publish(angles);
+}
+
+void Mpu6050AngleIntegrator::accel_angles(
+    const Sample& sample,
+    float *accel_angle_x,
+    float *accel_angle_y,
+    float *sign_z) const {
+  float accel_x = sample.accel_x / accel_lsb_per_g;
+  float accel_y = sample.accel_y / accel_lsb_per_g;
+  float accel_z = sample.accel_z / accel_lsb_per_g;
+
+  *sign_z = accel_z < 0 ? -1 : 1;
+  *accel_angle_x = atan2f(
+      accel_y,
+      *sign_z * sqrtf(accel_z * accel_z + accel_x * accel_x))
+          * RADIANS_TO_DEGREES_F;
+  *accel_angle_y = -atan2f(
+      accel_x,
+      sqrtf(accel_z * accel_z + accel_y * accel_y))
+          * RADIANS_TO_DEGREES_F;
+}
+
+void Mpu6050AngleIntegrator::initialize(const Sample& sample) {
+  // Start from the accelerometer's view rather than waiting for the
+  // filters to converge from level.
+  float sign_z;
+  accel_angles(sample, &angle_x, &angle_y, &sign_z);
+  // Multiply rather than shift: shifting a negative value left is
+  // undefined.
+  scaled_gravity_x = sample.accel_x * (1 << GRAVITY_FILTER_SHIFT);
+  scaled_gravity_y = sample.accel_y * (1 << GRAVITY_FILTER_SHIFT);
+  scaled_gravity_z = sample.accel_z * (1 << GRAVITY_FILTER_SHIFT);
+  gravity_x = sample.accel_x;
+  gravity_y = sample.accel_y;
+  gravity_z = sample.accel_z;
+  publish_angles();
+}
+
+void Mpu6050AngleIntegrator::filter(const Sample& sample) {
+  float accel_angle_x;
+  float accel_angle_y;
+  float sign_z;
+  accel_angles(sample, &accel_angle_x, &accel_angle_y, &sign_z);
+  float gyro_x = sample.gyro_x / gyro_lsb_per_degree_per_second;
+  float gyro_y = sample.gyro_y / gyro_lsb_per_degree_per_second;
+
+  scaled_gravity_x = low_pass(scaled_gravity_x, sample.accel_x);
+  scaled_gravity_y = low_pass(scaled_gravity_y, sample.accel_y);
+  scaled_gravity_z = low_pass(scaled_gravity_z, sample.accel_z);
+  gravity_x = scaled_gravity_x >> GRAVITY_FILTER_SHIFT;
+  gravity_y = scaled_gravity_y >> GRAVITY_FILTER_SHIFT;
+  gravity_z = scaled_gravity_z >> GRAVITY_FILTER_SHIFT;
+
+  angle_x = wrap(
+      gyro_coefficient * (accel_angle_x + wrap(
+          angle_x + gyro_x * sample_period_seconds - accel_angle_x, 180))
+      + (1.0f - gyro_coefficient) * accel_angle_x,
+      180);
+  angle_y = wrap(
+      gyro_coefficient * (accel_angle_y + wrap(
+          angle_y + sign_z * gyro_y * sample_period_seconds - accel_angle_y,
+          90))
+      + (1.0f - gyro_coefficient) * accel_angle_y,
+      90);
+  publish_angles();
+}
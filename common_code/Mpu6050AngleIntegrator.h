@@ -0,0 +1,110 @@
+/*
+ * Mpu6050AngleIntegrator.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Floating point reference orientation filter that integrates raw MPU6050
+ * samples into roll (X) and pitch (Y) angles using the same complementary
+ * filter as MPU6050_light. Unlike the library, which measures the time
+ * between best-effort update() calls, the integrator assumes that samples
+ * arrive at the fixed rate that the MPU6050 writes them to its FIFO.
+ *
+ * The integrator also keeps a low pass filtered gravity vector in integer
+ * raw units for consumers, such as TiltDetector, that must avoid floating
+ * point.
+ *
+ * Like the gravity vector, the angles are published after each update,
+ * so readers in other tasks get the roll and pitch of one estimate.
+ *
+ * The integrator has no Arduino or FreeRTOS dependencies, so it builds on
+ * a host and can be driven by recorded register dumps.
+ */
+
+#ifndef MPU6050ANGLEINTEGRATOR_H_
+#define MPU6050ANGLEINTEGRATOR_H_
+
+#include <stdint.h>
+
+#include "OrientationFilter.h"
+
+class Mpu6050AngleIntegrator : public OrientationFilter {
+  /**
+   * Roll (X) and pitch (Y) in degrees.
+   */
+  struct Angles {
+    float x;
+    float y;
+  };
+
+  int32_t scaled_gravity_x;  // Filtered gravity << GRAVITY_FILTER_SHIFT
+  int32_t scaled_gravity_y;
+  int32_t scaled_gravity_z;
+  const float sample_period_seconds;
+  const float gyro_coefficient;
+  float angle_x;
+  float angle_y;
+  LatestValue<Angles> latest_angles;  // Published after each update
+
+  /**
+   * Publishes the current angles.
+   */
+  void publish_angles(void);
+
+  void accel_angles(
+      const Sample& sample,
+      float *accel_angle_x,
+      float *accel_angle_y,
+      float *sign_z) const;
+
+protected:
+  virtual void initialize(const Sample& sample);
+
+  virtual void filter(const Sample& sample);
+
+public:
+  /**
+   * Gravity low pass filter strength. Each sample moves the filtered
+   * gravity vector 1 / 2^GRAVITY_FILTER_SHIFT of the way toward the
+   * sample, which is a time constant of 8 samples.
+   */
+  static const unsigned GRAVITY_FILTER_SHIFT = 3;
+
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                   Contents
+   * ---------------------- -------------------------------------------------
+   * sample_rate_hz         The rate at which the MPU6050 fills its FIFO
+   * gyro_coefficient       Complementary filter weight given to the
+   *                        integrated gyroscope reading. The accelerometer
+   *                        gets the remainder. MPU6050_light uses 0.98.
+   */
+  Mpu6050AngleIntegrator(
+      uint16_t sample_rate_hz,
+      float gyro_coefficient);
+
+  virtual const char *get_name(void) const;
+
+  virtual int32_t get_roll_centidegrees(void) const;
+
+  virtual int32_t get_pitch_centidegrees(void) const;
+
+  /**
+   * Returns the roll in degrees, [-180, +180].
+   */
+  float get_angle_x(void) const {
+    return latest_angles.read().x;
+  }
+
+  /**
+   * Returns the pitch in degrees, [-90, +90].
+   */
+  float get_angle_y(void) const {
+    return latest_angles.read().y;
+  }
+};
+
+#endif /* MPU6050ANGLEINTEGRATOR_H_ */
@@ -0,0 +1,48 @@
+/*
+ * Mpu6050Fifo.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "Mpu6050Fifo.h"
+
+static inline int16_t big_endian_int16(const uint8_t *bytes) {
+  return (int16_t) (((uint16_t) bytes[0] << 8) | bytes[1]);
+}
+
+uint16_t Mpu6050Fifo::fifo_count(const uint8_t *count_bytes) {
+  return ((uint16_t) count_bytes[0] << 8) | count_bytes[1];
+}
+
+size_t Mpu6050Fifo::parse(
+    const uint8_t *fifo_bytes,
+    size_t byte_count,
+    Mpu6050RawSample *samples,
+    size_t max_samples) {
+  size_t sample_count = 0;
+  while (
+      MPU6050_FIFO_FRAME_SIZE <= byte_count
+      && sample_count < max_samples) {
+    Mpu6050RawSample *sample = samples + sample_count++;
+    sample->accel_x = big_endian_int16(fifo_bytes);
+    sample->accel_y = big_endian_int16(fifo_bytes + 2);
+    sample->accel_z = big_endian_int16(fifo_bytes + 4);
+    sample->gyro_x = big_endian_int16(fifo_bytes + 6);
+    sample->gyro_y = big_endian_int16(fifo_bytes + 8);
+    sample->gyro_z = big_endian_int16(fifo_bytes + 10);
+    fifo_bytes += MPU6050_FIFO_FRAME_SIZE;
+    byte_count -= MPU6050_FIFO_FRAME_SIZE;
+  }
+  return sample_count;
+}
+
+uint8_t Mpu6050Fifo::sample_rate_divider(uint16_t output_data_rate_hz) {
+  if (output_data_rate_hz < 4) {
+    output_data_rate_hz = 4;  // The slowest rate the divider can reach.
+  } else if (MPU6050_FILTERED_GYRO_OUTPUT_RATE_HZ < output_data_rate_hz) {
+    output_data_rate_hz = MPU6050_FILTERED_GYRO_OUTPUT_RATE_HZ;
+  }
+  return (uint8_t) (
+      MPU6050_FILTERED_GYRO_OUTPUT_RATE_HZ / output_data_rate_hz - 1);
+}
@@ -0,0 +1,103 @@
+/*
+ * Mpu6050Fifo.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * MPU6050 FIFO register map and frame parser. The MPU6050 writes one frame
+ * to its on-chip FIFO at every sample, so a reader can sleep until the
+ * data ready interrupt fires and then drain everything the FIFO holds in a
+ * single I2C burst.
+ *
+ * The parser has no Arduino or FreeRTOS dependencies, so it builds on a
+ * host and can be run against recorded register dumps.
+ */
+
+#ifndef MPU6050FIFO_H_
+#define MPU6050FIFO_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MPU6050_SAMPLE_RATE_DIVIDER_REGISTER 0x19
+#define MPU6050_CONFIG_REGISTER 0x1A
+#define MPU6050_FIFO_ENABLE_REGISTER 0x23
+#define MPU6050_INTERRUPT_CONFIG_REGISTER 0x37
+#define MPU6050_INTERRUPT_ENABLE_REGISTER 0x38
+#define MPU6050_INTERRUPT_STATUS_REGISTER 0x3A
+#define MPU6050_USER_CONTROL_REGISTER 0x6A
+#define MPU6050_FIFO_COUNT_REGISTER 0x72  // High byte, low byte follows
+#define MPU6050_FIFO_DATA_REGISTER 0x74
+
+// Digital low pass filter setting 3: 44 Hz accelerometer and 42 Hz gyroscope
+// bandwidth. Enabling the filter drops the gyroscope output rate to 1 kHz.
+#define MPU6050_DLPF_44_HZ 0x03
+#define MPU6050_FILTERED_GYRO_OUTPUT_RATE_HZ 1000
+
+#define MPU6050_FIFO_ACCEL_AND_GYRO 0x78  // XG, YG, ZG, and ACCEL
+#define MPU6050_USER_CONTROL_FIFO_ENABLE 0x40
+#define MPU6050_USER_CONTROL_FIFO_RESET 0x04
+#define MPU6050_INTERRUPT_DATA_READY 0x01
+#define MPU6050_INTERRUPT_FIFO_OVERFLOW 0x10
+
+#define MPU6050_FIFO_CAPACITY 1024
+
+// A frame holds accelerometer X, Y, Z followed by gyroscope X, Y, Z, each a
+// big-endian 16 bit value. The MPU6050 writes enabled sensors to the FIFO in
+// register order, so the accelerometer always comes first.
+#define MPU6050_FIFO_FRAME_SIZE 12
+
+/**
+ * A raw, unscaled sample, as the MPU6050 reports it.
+ */
+struct Mpu6050RawSample {
+  int16_t accel_x;
+  int16_t accel_y;
+  int16_t accel_z;
+  int16_t gyro_x;
+  int16_t gyro_y;
+  int16_t gyro_z;
+};
+
+class Mpu6050Fifo {
+public:
+  /**
+   * Decodes the FIFO count, which the MPU6050 reports as two big-endian
+   * bytes starting at MPU6050_FIFO_COUNT_REGISTER.
+   */
+  static uint16_t fifo_count(const uint8_t *count_bytes);
+
+  /**
+   * Returns the number of complete frames in the specified FIFO count.
+   */
+  static size_t whole_frames(uint16_t fifo_count) {
+    return fifo_count / MPU6050_FIFO_FRAME_SIZE;
+  }
+
+  /**
+   * Parses FIFO frames into raw samples. Returns the number of samples
+   * parsed. Trailing bytes that do not form a complete frame are ignored.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * fifo_bytes          Bytes read from MPU6050_FIFO_DATA_REGISTER
+   * byte_count          The number of bytes in fifo_bytes
+   * samples             Receives the parsed samples
+   * max_samples         The capacity of samples
+   */
+  static size_t parse(
+      const uint8_t *fifo_bytes,
+      size_t byte_count,
+      Mpu6050RawSample *samples,
+      size_t max_samples);
+
+  /**
+   * Returns the sample rate divider that produces the specified output
+   * data rate when the digital low pass filter is enabled.
+   */
+  static uint8_t sample_rate_divider(uint16_t output_data_rate_hz);
+};
+
+#endif /* MPU6050FIFO_H_ */
@@ -0,0 +1,149 @@
+/*
+ * NotificationBatch.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "NotificationBatch.h"
+
+#include <string.h>
+
+NotificationBatchEncoder::NotificationBatchEncoder() :
+    first_timestamp_ms(0),
+    sequence(0),
+    holds_change(false) {
+  frame[WIRE_FORMAT_MAGIC_OFFSET] = WIRE_FORMAT_MAGIC;
+  frame[WIRE_FORMAT_VERSION_OFFSET] = WIRE_FORMAT_VERSION;
+  frame[WIRE_FORMAT_COMPATIBLE_VERSION_OFFSET] =
+      WIRE_FORMAT_COMPATIBLE_VERSION;
+  frame[WIRE_FORMAT_HEADER_SIZE_OFFSET] = WIRE_FORMAT_HEADER_SIZE;
+  frame[WIRE_FORMAT_ENTRY_SIZE_OFFSET] = WIRE_FORMAT_ENTRY_SIZE;
+  set_boot_id(0);
+  clear();
+}
+
+bool NotificationBatchEncoder::add(
+    const MotionNotificationMessage& message,
+    uint32_t timestamp_ms,
+    bool is_change) {
+  if (is_full()) {
+    return false;
+  }
+  if (is_empty()) {
+    first_timestamp_ms = timestamp_ms;
+  }
+  uint8_t *entry = frame
+      + WIRE_FORMAT_HEADER_SIZE
+      + get_entry_count() * WIRE_FORMAT_ENTRY_SIZE;
+  WireFormat::put_uint32(
+      entry + WIRE_FORMAT_ENTRY_TIMESTAMP_OFFSET,
+      timestamp_ms);
+  entry[WIRE_FORMAT_ENTRY_STATUS_OFFSET] = (uint8_t) message.status;
+  WireFormat::put_float(
+      entry + WIRE_FORMAT_ENTRY_TEMPERATURE_OFFSET,
+      message.temperature_celsius);
+  if (is_change) {
+    frame[WIRE_FORMAT_FLAGS_OFFSET] |= WIRE_FORMAT_FLAG_ACK_REQUESTED;
+    holds_change = true;
+  }
+  ++frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET];
+  return true;
+}
+
+uint16_t NotificationBatchEncoder::seal(uint32_t now_ms) {
+  uint16_t frame_sequence = sequence++;
+  WireFormat::put_uint16(
+      frame + WIRE_FORMAT_SEQUENCE_OFFSET,
+      frame_sequence);
+  WireFormat::put_uint32(frame + WIRE_FORMAT_TIMESTAMP_OFFSET, now_ms);
+  size_t crc_offset = get_frame_size() - WIRE_FORMAT_CRC_SIZE;
+  WireFormat::put_uint16(
+      frame + crc_offset,
+      WireFormat::crc16(frame, crc_offset));
+  return frame_sequence;
+}
+
+void NotificationBatchEncoder::clear(void) {
+  frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET] = 0;
+  frame[WIRE_FORMAT_FLAGS_OFFSET] = 0;
+  holds_change = false;
+}
+
+uint32_t NotificationBatchEncoder::ms_until_due(
+    uint32_t now_ms,
+    uint32_t deadline_ms) const {
+  if (is_empty()) {
+    return UINT32_MAX;
+  }
+  uint32_t waited_ms = now_ms - first_timestamp_ms;
+  return deadline_ms <= waited_ms ? 0 : deadline_ms - waited_ms;
+}
+
+/**
+ * Stores an entry if its status is known. Returns the number stored.
+ */
+static inline size_t store(
+    TimestampedNotification *notification,
+    uint32_t timestamp_ms,
+    uint8_t status,
+    float temperature_celsius) {
+  if (LAST_NOTIFICATION_STATUS <= status) {
+    return 0;
+  }
+  notification->timestamp_ms = timestamp_ms;
+  notification->message.status = (MotionStatus) status;
+  notification->message.temperature_celsius = temperature_celsius;
+  return 1;
+}
+
+size_t NotificationBatchDecoder::decode(
+    const uint8_t *frame,
+    size_t frame_size,
+    TimestampedNotification *notifications,
+    size_t max_notifications,
+    ReceivedFrameInfo *info) {
+  size_t count = 0;
+  if (info) {
+    info->has_sequence = false;
+    info->sequence = 0;
+    info->sent_ms = 0;
+    info->ack_requested = false;
+    info->boot_id = 0;
+  }
+  if (!frame_size || !max_notifications) {
+    return count;
+  }
+
+  if (frame[0] == WIRE_FORMAT_MAGIC) {
+    WireFrameView view(frame, frame_size);
+    if (view.is_valid()) {
+      if (info) {
+        info->has_sequence = true;
+        info->sequence = view.get_sequence();
+        info->sent_ms = view.get_timestamp_ms();
+        info->ack_requested =
+            view.get_flags() & WIRE_FORMAT_FLAG_ACK_REQUESTED;
+        info->boot_id = view.get_boot_id();
+      }
+      for (size_t i = 0;
+          i < view.get_entry_count() && count < max_notifications;
+          ++i) {
+        count += store(
+            notifications + count,
+            view.get_entry_timestamp_ms(i),
+            view.get_entry_status(i),
+            view.get_entry_temperature_celsius(i));
+      }
+    }
+  } else if (frame_size == sizeof(MotionNotificationMessage)) {
+    MotionNotificationMessage message;
+    memcpy(&message, frame, sizeof(message));
+    count = store(
+        notifications,
+        0,
+        (uint8_t) message.status,
+        message.temperature_celsius);
+  }
+  return count;
+}
@@ -0,0 +1,195 @@
+/*
+ * NotificationBatch.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Packs several timestamped motion notifications into a single ESP-NOW
+ * frame in the wire format that WireFormat.h describes, and unpacks
+ * received frames.
+ *
+ * The decoder also accepts the bare MotionNotificationMessage that older
+ * senders transmit. Its first byte is a MotionStatus, which never equals
+ * WIRE_FORMAT_MAGIC, and it is 8 bytes long.
+ *
+ * The codec has no Arduino or FreeRTOS dependencies, so it builds on a
+ * host.
+ */
+
+#ifndef NOTIFICATIONBATCH_H_
+#define NOTIFICATIONBATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "MotionNotificationMessage.h"
+#include "WireFormat.h"
+
+#define NOTIFICATION_BATCH_MAX_ENTRIES WIRE_FORMAT_MAX_ENTRIES
+
+static_assert(
+    sizeof(MotionNotificationMessage) == 8,
+    "Legacy frames are 8 byte MotionNotificationMessage structures.");
+static_assert(
+    LAST_NOTIFICATION_STATUS < WIRE_FORMAT_MAGIC,
+    "The magic number must not collide with legacy status bytes.");
+
+/**
+ * A notification and the sender time that it was queued. Legacy frames
+ * carry no time, so their timestamp is 0.
+ */
+struct TimestampedNotification {
+  uint32_t timestamp_ms;
+  MotionNotificationMessage message;
+};
+
+/**
+ * Frame level information that the decoder reports alongside the
+ * notifications.
+ */
+struct ReceivedFrameInfo {
+  bool has_sequence;   // True for version 2 and later frames
+  uint16_t sequence;
+  uint32_t sent_ms;    // Sender timestamp, version 2 and later
+  bool ack_requested;  // The sender awaits an acknowledgment
+  uint16_t boot_id;    // Sender boot identifier, version 4, else 0
+};
+
+/**
+ * Accumulates notifications into a frame.
+ */
+class NotificationBatchEncoder {
+  uint8_t frame[WIRE_FORMAT_MAX_FRAME_SIZE];
+  uint32_t first_timestamp_ms;  // Time of the oldest entry
+  uint16_t sequence;            // Sequence number of the next frame
+  bool holds_change;            // An entry was added as a change
+
+public:
+  NotificationBatchEncoder();
+
+  /**
+   * Sets the boot identifier that every frame carries. Draw it at random
+   * and nonzero once per start, so that receivers can tell that the
+   * sequence numbers have started over.
+   */
+  void set_boot_id(uint16_t boot_id) {
+    WireFormat::put_uint16(frame + WIRE_FORMAT_BOOT_ID_OFFSET, boot_id);
+  }
+
+  /**
+   * Appends a notification. Returns false, leaving the batch unchanged,
+   * if the batch is full.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * message             The notification
+   * timestamp_ms        The time that it was queued
+   * is_change           True if it reports a state change, which the
+   *                     receivers must acknowledge. Heartbeats that
+   *                     repeat the last status are not changes.
+   */
+  bool add(
+      const MotionNotificationMessage& message,
+      uint32_t timestamp_ms,
+      bool is_change);
+
+  /**
+   * Asks the receivers to acknowledge the batch even if it holds only
+   * PINGs, e.g. to probe a link that carries no state changes.
+   */
+  void request_ack(void) {
+    frame[WIRE_FORMAT_FLAGS_OFFSET] |= WIRE_FORMAT_FLAG_ACK_REQUESTED;
+  }
+
+  /**
+   * Stamps the batch with the next sequence number and the send time,
+   * and appends the CRC. The frame is then ready to send. Returns the
+   * sequence number.
+   */
+  uint16_t seal(uint32_t now_ms);
+
+  /**
+   * Empties the batch.
+   */
+  void clear(void);
+
+  size_t get_entry_count(void) const {
+    return frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET];
+  }
+
+  bool is_empty(void) const {
+    return !get_entry_count();
+  }
+
+  bool is_full(void) const {
+    return get_entry_count() == NOTIFICATION_BATCH_MAX_ENTRIES;
+  }
+
+  /**
+   * Returns true if the receiver must acknowledge the batch, because it
+   * holds a state change or because request_ack() was called.
+   */
+  bool requests_ack(void) const {
+    return frame[WIRE_FORMAT_FLAGS_OFFSET] & WIRE_FORMAT_FLAG_ACK_REQUESTED;
+  }
+
+  /**
+   * Returns true if any entry was added as a state change.
+   */
+  bool has_change(void) const {
+    return holds_change;
+  }
+
+  /**
+   * Returns the time remaining before the oldest entry has waited the
+   * specified deadline, 0 if it has, or UINT32_MAX if the batch is empty.
+   */
+  uint32_t ms_until_due(uint32_t now_ms, uint32_t deadline_ms) const;
+
+  const uint8_t *get_frame(void) const {
+    return frame;
+  }
+
+  /**
+   * Returns the frame size, including the CRC.
+   */
+  size_t get_frame_size(void) const {
+    return WIRE_FORMAT_HEADER_SIZE
+        + get_entry_count() * WIRE_FORMAT_ENTRY_SIZE
+        + WIRE_FORMAT_CRC_SIZE;
+  }
+};
+
+/**
+ * Unpacks received frames.
+ */
+class NotificationBatchDecoder {
+public:
+  /**
+   * Decodes a received frame. Returns the number of notifications
+   * stored, which is 0 if the frame is malformed or corrupt. Entries
+   * with unknown statuses are skipped.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * frame               Received bytes
+   * frame_size          Number of received bytes
+   * notifications       Receives the decoded notifications
+   * max_notifications   Capacity of notifications. Excess entries are
+   *                     dropped.
+   * info                If not NULL, receives the sequence number and
+   *                     flags of a valid frame.
+   */
+  static size_t decode(
+      const uint8_t *frame,
+      size_t frame_size,
+      TimestampedNotification *notifications,
+      size_t max_notifications,
+      ReceivedFrameInfo *info = NULL);
+};
+
+#endif /* NOTIFICATIONBATCH_H_ */
@@ -0,0 +1,123 @@
+/*
+ * OrientationFilter.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "OrientationFilter.h"
+
+#include <math.h>
+
+OrientationFilter::OrientationFilter(uint16_t sample_rate_hz) :
+    sample_rate_hz(sample_rate_hz),
+    accel_offset_x(0),
+    accel_offset_y(0),
+    accel_offset_z(0),
+    gyro_offset_x(0),
+    gyro_offset_y(0),
+    gyro_offset_z(0),
+    sample_count(0),
+    latest_gravity(Gravity()),
+    accel_lsb_per_g(16384.0f),  // +/- 2 g, MPU6050 default
+    gyro_lsb_per_degree_per_second(65.5f),  // +/- 500 deg/s
+    gravity_x(0),
+    gravity_y(0),
+    gravity_z(0) {
+}
+
+OrientationFilter::~OrientationFilter() {
+}
+
+void OrientationFilter::on_calibrated(void) {
+}
+
+void OrientationFilter::calibrate(const Calibration& calibration) {
+  accel_lsb_per_g = calibration.accel_lsb_per_g;
+  gyro_lsb_per_degree_per_second = calibration.gyro_lsb_per_degree_per_second;
+  accel_offset_x = lroundf(calibration.accel_offset_x * accel_lsb_per_g);
+  accel_offset_y = lroundf(calibration.accel_offset_y * accel_lsb_per_g);
+  accel_offset_z = lroundf(calibration.accel_offset_z * accel_lsb_per_g);
+  gyro_offset_x =
+      lroundf(calibration.gyro_offset_x * gyro_lsb_per_degree_per_second);
+  gyro_offset_y =
+      lroundf(calibration.gyro_offset_y * gyro_lsb_per_degree_per_second);
+  gyro_offset_z =
+      lroundf(calibration.gyro_offset_z * gyro_lsb_per_degree_per_second);
+  on_calibrated();
+}
+
+void OrientationFilter::update(const Mpu6050RawSample& raw_sample) {
+  Sample sample;
+  sample.accel_x = raw_sample.accel_x - accel_offset_x;
+  sample.accel_y = raw_sample.accel_y - accel_offset_y;
+  sample.accel_z = raw_sample.accel_z - accel_offset_z;
+  sample.gyro_x = raw_sample.gyro_x - gyro_offset_x;
+  sample.gyro_y = raw_sample.gyro_y - gyro_offset_y;
+  sample.gyro_z = raw_sample.gyro_z - gyro_offset_z;
+  if (sample_count++) {
+    filter(sample);
+  } else {
+    initialize(sample);
+  }
+  Gravity gravity = {gravity_x, gravity_y, gravity_z};
+  latest_gravity.publish(gravity);
+}
+
+int32_t OrientationFilter::get_roll_centidegrees(void) const {
+  Gravity gravity = get_gravity();
+  int64_t x = gravity.x;
+  int64_t z = gravity.z;
+  int64_t horizontal = square_root(x * x + z * z);
+  return atan2_centidegrees(gravity.y, z < 0 ? -horizontal : horizontal);
+}
+
+int32_t OrientationFilter::get_pitch_centidegrees(void) const {
+  Gravity gravity = get_gravity();
+  int64_t y = gravity.y;
+  int64_t z = gravity.z;
+  return -atan2_centidegrees(gravity.x, square_root(y * y + z * z));
+}
+
+int32_t OrientationFilter::atan2_centidegrees(int64_t y, int64_t x) {
+  if (!x && !y) {
+    return 0;
+  }
+  uint64_t magnitude_x = x < 0 ? -x : x;
+  uint64_t magnitude_y = y < 0 ? -y : y;
+  bool steep = magnitude_x < magnitude_y;
+  uint64_t numerator = steep ? magnitude_x : magnitude_y;
+  uint64_t denominator = steep ? magnitude_y : magnitude_x;
+
+  // atan(z) ~= z * (pi/4 + 0.273 * (1 - z)) for z in [0, 1], here in
+  // hundredths of a degree with z in Q15.
+  int64_t z = (int64_t) ((numerator << 15) / denominator);
+  int32_t angle = (int32_t) (
+      (z * (4500LL * 32768 + 1564LL * (32768 - z))) >> 30);
+
+  if (steep) {
+    angle = 9000 - angle;
+  }
+  if (x < 0) {
+    angle = 18000 - angle;
+  }
+  return y < 0 ? -angle : angle;
+}
+
+uint32_t OrientationFilter::square_root(uint64_t value) {
+  uint64_t root = 0;
+  uint64_t bit = 1ULL << 62;
+  while (value < bit) {
+    bit >>= 2;
+  }
+  while (bit) {
+    if (root + bit <= value) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint32_t) root;
+}
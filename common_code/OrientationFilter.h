@@ -0,0 +1,181 @@
+/*
+ * OrientationFilter.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Base orientation filter, a pluggable stage that fuses raw MPU6050
+ * accelerometer and gyroscope samples into an estimate of the gravity
+ * vector and the roll and pitch angles. Samples arrive at a fixed,
+ * configurable rate, e.g. from the MPU6050 FIFO.
+ *
+ * Implementations provide initialize(), which seeds the estimate from the
+ * first sample, and filter(), which folds in each subsequent sample. Both
+ * receive offset corrected samples in raw units. Implementations keep
+ * the gravity vector in raw accelerometer units, so it can be passed
+ * directly to TiltDetector.
+ *
+ * One task updates the filter while others read it. After each update,
+ * the filter publishes the gravity vector through a LatestValue, so
+ * readers always get the three components of one estimate.
+ *
+ * The base class and the fixed point implementations have no Arduino or
+ * FreeRTOS dependencies, so they build on a host and can be replayed
+ * against captured traces.
+ */
+
+#ifndef ORIENTATIONFILTER_H_
+#define ORIENTATIONFILTER_H_
+
+#include <stdint.h>
+
+#include "LatestValue.h"
+#include "Mpu6050Fifo.h"
+
+class OrientationFilter {
+public:
+  /**
+   * Scale and offsets that convert raw readings to g and degrees per
+   * second. The offsets are in converted units, as MPU6050::calcOffsets()
+   * computes them.
+   */
+  struct Calibration {
+    float accel_lsb_per_g;
+    float gyro_lsb_per_degree_per_second;
+    float accel_offset_x;
+    float accel_offset_y;
+    float accel_offset_z;
+    float gyro_offset_x;
+    float gyro_offset_y;
+    float gyro_offset_z;
+  };
+
+  /**
+   * An offset corrected sample in raw units.
+   */
+  struct Sample {
+    int32_t accel_x;
+    int32_t accel_y;
+    int32_t accel_z;
+    int32_t gyro_x;
+    int32_t gyro_y;
+    int32_t gyro_z;
+  };
+
+  /**
+   * A gravity vector in raw accelerometer units.
+   */
+  struct Gravity {
+    int32_t x;
+    int32_t y;
+    int32_t z;
+  };
+
+private:
+  const uint16_t sample_rate_hz;
+  int32_t accel_offset_x;  // Offsets in raw units
+  int32_t accel_offset_y;
+  int32_t accel_offset_z;
+  int32_t gyro_offset_x;
+  int32_t gyro_offset_y;
+  int32_t gyro_offset_z;
+  uint32_t sample_count;
+  LatestValue<Gravity> latest_gravity;  // Published after each update
+
+protected:
+  float accel_lsb_per_g;
+  float gyro_lsb_per_degree_per_second;
+  int32_t gravity_x;  // Estimated gravity in raw accelerometer units
+  int32_t gravity_y;
+  int32_t gravity_z;
+
+  /**
+   * Invoked when the scale changes. Implementations that precompute
+   * fixed point constants from the scale and sample rate override this.
+   * Runs once at startup, so it may use floating point.
+   */
+  virtual void on_calibrated(void);
+
+  /**
+   * Seeds the estimate from the first sample.
+   */
+  virtual void initialize(const Sample& sample) = 0;
+
+  /**
+   * Folds a sample into the estimate.
+   */
+  virtual void filter(const Sample& sample) = 0;
+
+public:
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * sample_rate_hz      The rate at which samples arrive.
+   */
+  OrientationFilter(uint16_t sample_rate_hz);
+
+  virtual ~OrientationFilter();
+
+  /**
+   * Sets scale and offsets. Invoke this before updating.
+   */
+  void calibrate(const Calibration& calibration);
+
+  /**
+   * Corrects a raw sample and folds it into the estimate, then publishes
+   * the new gravity vector. Only one task may update the filter.
+   */
+  void update(const Mpu6050RawSample& raw_sample);
+
+  /**
+   * Returns the filter name, for reports.
+   */
+  virtual const char *get_name(void) const = 0;
+
+  /**
+   * Returns the roll in hundredths of a degree, [-18000, +18000], using
+   * the MPU6050_light convention. The default derives it from the
+   * gravity vector.
+   */
+  virtual int32_t get_roll_centidegrees(void) const;
+
+  /**
+   * Returns the pitch in hundredths of a degree, [-9000, +9000], using
+   * the MPU6050_light convention. The default derives it from the
+   * gravity vector.
+   */
+  virtual int32_t get_pitch_centidegrees(void) const;
+
+  /**
+   * Returns the most recently published gravity vector. Any task may
+   * call this.
+   */
+  Gravity get_gravity(void) const {
+    return latest_gravity.read();
+  }
+
+  uint16_t get_sample_rate_hz(void) const {
+    return sample_rate_hz;
+  }
+
+  uint32_t get_sample_count(void) const {
+    return sample_count;
+  }
+
+  /**
+   * Integer atan2 in hundredths of a degree, accurate to about 0.25
+   * degrees.
+   */
+  static int32_t atan2_centidegrees(int64_t y, int64_t x);
+
+  /**
+   * Integer square root, rounded down.
+   */
+  static uint32_t square_root(uint64_t value);
+};
+
+#endif /* ORIENTATIONFILTER_H_ */
@@ -0,0 +1,56 @@
+/*
+ * PeerTable.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "PeerTable.h"
+
+#include <string.h>
+
+// 32 bit FNV-1a parameters
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+PeerTable::PeerTable() :
+    peer_count(0),
+    rejected(0) {
+  memset(macs, 0, sizeof(macs));
+  memset(buckets, 0, sizeof(buckets));
+}
+
+size_t PeerTable::probe(const uint8_t *mac) const {
+  uint32_t hash = FNV_OFFSET_BASIS;
+  for (size_t i = 0; i < PEER_TABLE_MAC_SIZE; ++i) {
+    hash = (hash ^ mac[i]) * FNV_PRIME;
+  }
+  // The table is never full, so the probe always ends.
+  size_t bucket = (hash ^ (hash >> 16)) & (PEER_TABLE_BUCKETS - 1);
+  while (buckets[bucket]
+      && memcmp(macs[buckets[bucket] - 1], mac, PEER_TABLE_MAC_SIZE)) {
+    bucket = (bucket + 1) & (PEER_TABLE_BUCKETS - 1);
+  }
+  return bucket;
+}
+
+int PeerTable::find(const uint8_t *mac) const {
+  uint8_t entry = buckets[probe(mac)];
+  return entry ? entry - 1 : PEER_TABLE_NOT_FOUND;
+}
+
+int PeerTable::add(const uint8_t *mac) {
+  size_t bucket = probe(mac);
+  if (buckets[bucket]) {
+    return buckets[bucket] - 1;
+  }
+  if (peer_count == PEER_TABLE_CAPACITY) {
+    ++rejected;
+    return PEER_TABLE_NOT_FOUND;
+  }
+  size_t slot = peer_count;
+  memcpy(macs[slot], mac, PEER_TABLE_MAC_SIZE);
+  buckets[bucket] = slot + 1;
+  peer_count = slot + 1;
+  return slot;
+}
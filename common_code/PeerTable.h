@@ -0,0 +1,89 @@
+/*
+ * PeerTable.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Maps ESP-NOW peer MAC addresses to small, dense slot numbers so that
+ * per-peer state can live in plain arrays indexed by slot. Peers take
+ * the next free slot on first contact and keep it until restart; slots
+ * are never reused, so a slot number passed between tasks stays valid.
+ *
+ * Lookup is an open addressed hash over a bucket array much larger than
+ * the slot count, so it takes one or two probes regardless of the
+ * number of peers. Boards from one vendor share the first three bytes
+ * of their MACs, so the hash mixes all six.
+ *
+ * Only one task may add() peers. Other tasks may read the slots that
+ * they have been told about. The table has no Arduino or FreeRTOS
+ * dependencies.
+ */
+
+#ifndef PEERTABLE_H_
+#define PEERTABLE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PEER_TABLE_CAPACITY 20  // Maximum number of peers, as in ESP-NOW
+#define PEER_TABLE_BUCKETS 64  // Hash buckets, a power of two
+#define PEER_TABLE_MAC_SIZE 6
+#define PEER_TABLE_NOT_FOUND -1
+
+class PeerTable {
+  static_assert(
+      (PEER_TABLE_BUCKETS & (PEER_TABLE_BUCKETS - 1)) == 0,
+      "The bucket count must be a power of two.");
+  static_assert(
+      2 * PEER_TABLE_CAPACITY <= PEER_TABLE_BUCKETS,
+      "Keep the table at most half full so that probes stay short.");
+
+  uint8_t macs[PEER_TABLE_CAPACITY][PEER_TABLE_MAC_SIZE];  // By slot
+  uint8_t buckets[PEER_TABLE_BUCKETS];  // Slot plus one, 0 if empty
+  size_t peer_count;
+  uint32_t rejected;  // Peers turned away because the table was full
+
+  /**
+   * Returns the bucket that holds a MAC or, if the MAC is not present,
+   * the empty bucket where it belongs.
+   */
+  size_t probe(const uint8_t *mac) const;
+
+public:
+  PeerTable();
+
+  /**
+   * Returns the slot of the specified peer, or PEER_TABLE_NOT_FOUND if
+   * the peer has not been added.
+   */
+  int find(const uint8_t *mac) const;
+
+  /**
+   * Returns the slot of the specified peer, adding the peer if it is
+   * new. Returns PEER_TABLE_NOT_FOUND if the peer is new and the table
+   * is full.
+   */
+  int add(const uint8_t *mac);
+
+  /**
+   * Returns the MAC address of the peer in the specified slot, which
+   * must be less than get_peer_count().
+   */
+  const uint8_t *get_mac(size_t slot) const {
+    return macs[slot];
+  }
+
+  /**
+   * Returns the number of peers, which occupy slots 0 through
+   * get_peer_count() - 1.
+   */
+  size_t get_peer_count(void) const {
+    return peer_count;
+  }
+
+  uint32_t get_rejected(void) const {
+    return rejected;
+  }
+};
+
+#endif /* PEERTABLE_H_ */
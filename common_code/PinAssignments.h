@@ -20,5 +20,7 @@
 #define IO_INTERRUPT_PIN 17  // TODO: change in sender, too.
 #define TEMPERATURE_AND_HUMIDITY_PIN 25
 #define ALARM_PIN 33  // HIGH sounds the alarm
+#define I2C_SDA_PIN 21  // I2C data, the ESP32 default
+#define I2C_SCL_PIN 22  // I2C clock, the ESP32 default
 
 #endif /* PINASSIGNMENTS_H_ */
@@ -0,0 +1,138 @@
+/*
+ * RetransmitQueue.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "RetransmitQueue.h"
+
+#include <string.h>
+
+RetransmitQueue::RetransmitQueue(
+    uint32_t initial_timeout_ms,
+    uint8_t max_attempts) :
+      initial_timeout_ms(initial_timeout_ms),
+      max_attempts(max_attempts),
+      round_trip(),
+      frames_acknowledged(0),
+      retransmissions(0),
+      frames_abandoned(0),
+      frames_evicted(0) {
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    pending[i].attempts = 0;
+  }
+}
+
+void RetransmitQueue::track(
+    const uint8_t *frame,
+    size_t frame_size,
+    uint16_t sequence,
+    uint32_t now_ms,
+    PeerSet awaiting) {
+  if (WIRE_FORMAT_MAX_FRAME_SIZE < frame_size || !awaiting) {
+    return;
+  }
+  PendingFrame *slot = NULL;
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY && !slot; ++i) {
+    if (!pending[i].attempts) {
+      slot = pending + i;
+    }
+  }
+  if (!slot) {
+    slot = pending;
+    for (size_t i = 1; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+      if ((int32_t) (pending[i].first_send_ms - slot->first_send_ms) < 0) {
+        slot = pending + i;
+      }
+    }
+    ++frames_evicted;
+  }
+  memcpy(slot->frame, frame, frame_size);
+  slot->frame_size = frame_size;
+  slot->sequence = sequence;
+  slot->awaiting = awaiting;
+  slot->attempts = 1;
+  slot->first_send_ms = now_ms;
+  slot->next_send_ms = now_ms + timeout_ms(1);
+}
+
+void RetransmitQueue::on_ack(
+    uint16_t sequence,
+    uint32_t now_ms,
+    size_t peer,
+    FrameSink& sink) {
+  PeerSet peer_bit = peer_set_of(peer);
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    PendingFrame& frame = pending[i];
+    if (frame.attempts
+        && frame.sequence == sequence
+        && (frame.awaiting & peer_bit)) {
+      round_trip.record(now_ms - frame.first_send_ms);
+      frame.awaiting &= ~peer_bit;
+      sink.on_frame_acknowledged(frame.frame, frame.frame_size, peer);
+      if (!frame.awaiting) {
+        ++frames_acknowledged;
+        frame.attempts = 0;
+      }
+      return;
+    }
+  }
+}
+
+PeerSet RetransmitQueue::service(uint32_t now_ms, FrameSink& sink) {
+  PeerSet unresponsive = 0;
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    PendingFrame& frame = pending[i];
+    if (!frame.attempts || (int32_t) (now_ms - frame.next_send_ms) < 0) {
+      continue;
+    }
+    if (max_attempts <= frame.attempts) {
+      ++frames_abandoned;
+      unresponsive |= frame.awaiting;
+      frame.attempts = 0;
+      sink.on_frame_abandoned(frame.frame, frame.frame_size, frame.awaiting);
+      continue;
+    }
+    sink.send_frame(frame.frame, frame.frame_size, frame.awaiting);
+    ++retransmissions;
+    ++frame.attempts;
+    frame.next_send_ms = now_ms + timeout_ms(frame.attempts);
+  }
+  return unresponsive;
+}
+
+uint32_t RetransmitQueue::ms_until_next_send(uint32_t now_ms) const {
+  uint32_t result = UINT32_MAX;
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    const PendingFrame& frame = pending[i];
+    if (frame.attempts) {
+      int32_t remaining_ms = (int32_t) (frame.next_send_ms - now_ms);
+      uint32_t wait_ms = remaining_ms < 0 ? 0 : (uint32_t) remaining_ms;
+      if (wait_ms < result) {
+        result = wait_ms;
+      }
+    }
+  }
+  return result;
+}
+
+size_t RetransmitQueue::get_pending_count(void) const {
+  size_t count = 0;
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    if (pending[i].attempts) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+PeerSet RetransmitQueue::get_awaiting(void) const {
+  PeerSet awaiting = 0;
+  for (size_t i = 0; i < RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    if (pending[i].attempts) {
+      awaiting |= pending[i].awaiting;
+    }
+  }
+  return awaiting;
+}
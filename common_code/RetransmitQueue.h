@@ -0,0 +1,157 @@
+/*
+ * RetransmitQueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Sender half of the acknowledged delivery protocol. Holds copies of
+ * frames that receivers must acknowledge and resends each one, with
+ * exponential backoff, until every receiver that it awaits has
+ * acknowledged it or it runs out of attempts. Retransmissions go only to
+ * the receivers that have not yet acknowledged. The FrameSink learns of
+ * each acknowledgment and takes back frames that run out of attempts.
+ * Records the time from first send to each acknowledgment.
+ *
+ * The queue has no Arduino or FreeRTOS dependencies. Frames leave through
+ * a FrameSink and time comes from the caller, so it can run on a host
+ * against a simulated lossy link.
+ */
+
+#ifndef RETRANSMITQUEUE_H_
+#define RETRANSMITQUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FrameSink.h"
+#include "LatencyHistogram.h"
+#include "WireFormat.h"
+
+#define RETRANSMIT_QUEUE_CAPACITY 4
+
+class RetransmitQueue {
+  struct PendingFrame {
+    uint8_t frame[WIRE_FORMAT_MAX_FRAME_SIZE];
+    size_t frame_size;
+    uint16_t sequence;
+    PeerSet awaiting;  // Receivers that have not acknowledged
+    uint8_t attempts;  // Sends so far, 0 if the slot is free
+    uint32_t first_send_ms;
+    uint32_t next_send_ms;
+  };
+
+  PendingFrame pending[RETRANSMIT_QUEUE_CAPACITY];
+  const uint32_t initial_timeout_ms;
+  const uint8_t max_attempts;
+  LatencyHistogram round_trip;
+  uint32_t frames_acknowledged;
+  uint32_t retransmissions;
+  uint32_t frames_abandoned;
+  uint32_t frames_evicted;
+
+  /**
+   * Returns the backoff after the specified number of attempts.
+   */
+  uint32_t timeout_ms(uint8_t attempts) const {
+    return initial_timeout_ms << (attempts - 1);
+  }
+
+public:
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * initial_timeout_ms  Wait for an acknowledgment after the first send.
+   *                     Each retransmission doubles the wait.
+   * max_attempts        Sends, including the first, before giving up
+   */
+  RetransmitQueue(uint32_t initial_timeout_ms, uint8_t max_attempts);
+
+  /**
+   * Takes a copy of a frame that has just been sent for the first time.
+   * When the queue is full, drops the oldest frame to make room. Its
+   * receivers may well have it, so it does not go back to the sink. Does
+   * nothing if awaiting is empty.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * frame               The frame
+   * frame_size          Its size in bytes
+   * sequence            Its sequence number
+   * now_ms              The time that it was sent
+   * awaiting            The receivers that must acknowledge it
+   */
+  void track(
+      const uint8_t *frame,
+      size_t frame_size,
+      uint16_t sequence,
+      uint32_t now_ms,
+      PeerSet awaiting);
+
+  /**
+   * Records a receiver's acknowledgment of the frame with the specified
+   * sequence number, and its round trip time, and passes the frame to the
+   * sink's on_frame_acknowledged(). Retires the frame once all of its
+   * receivers have acknowledged it. Ignores unknown and duplicate
+   * acknowledgments.
+   */
+  void on_ack(
+      uint16_t sequence,
+      uint32_t now_ms,
+      size_t peer,
+      FrameSink& sink);
+
+  /**
+   * Resends frames whose acknowledgment is overdue to the receivers that
+   * have not acknowledged them, and abandons frames that have used all of
+   * their attempts, handing them back to the sink. Returns the receivers
+   * that failed to acknowledge an abandoned frame.
+   */
+  PeerSet service(uint32_t now_ms, FrameSink& sink);
+
+  /**
+   * Returns the time until the next retransmission, or UINT32_MAX if no
+   * frame is waiting for acknowledgment.
+   */
+  uint32_t ms_until_next_send(uint32_t now_ms) const;
+
+  /**
+   * Returns the number of frames awaiting acknowledgment.
+   */
+  size_t get_pending_count(void) const;
+
+  /**
+   * Returns the receivers that have yet to acknowledge a pending frame.
+   */
+  PeerSet get_awaiting(void) const;
+
+  const LatencyHistogram& get_round_trip_histogram(void) const {
+    return round_trip;
+  }
+
+  uint32_t get_frames_acknowledged(void) const {
+    return frames_acknowledged;
+  }
+
+  uint32_t get_retransmissions(void) const {
+    return retransmissions;
+  }
+
+  uint32_t get_frames_abandoned(void) const {
+    return frames_abandoned;
+  }
+
+  /**
+   * Returns the number of frames dropped to make room for newer ones.
+   */
+  uint32_t get_frames_evicted(void) const {
+    return frames_evicted;
+  }
+};
+
+#endif /* RETRANSMITQUEUE_H_ */
@@ -0,0 +1,232 @@
+/*
+ * StateMachine.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Table driven finite state machine. A transition table is a constexpr
+ * [state][event] array of uint8_t cells, each holding either
+ * fsm_to(next state) or FSM_IGNORE, which leaves the machine where it
+ * is. Tables declared constexpr at namespace scope live in flash.
+ *
+ * Cells hold the next state plus one, so a cell that the table leaves
+ * out is 0 and fsm_table_is_complete() rejects it at compile time, as
+ * fsm_all_states_reachable() rejects states that nothing can enter.
+ * Verify each table with static_assert where it is defined.
+ *
+ * On a transition, the machine calls the owner's non-virtual
+ * on_enter(State) method, which performs the entry actions, usually in a
+ * switch. Self transitions count, so a Moore machine sees every event.
+ * The machine holds only the current state, one byte; callers pass the
+ * table to dispatch() so that it need not be stored.
+ *
+ * StateMachineArray runs many machines, e.g. one per peer, from one
+ * table, with their states in one contiguous array. Its owner's
+ * on_enter(size_t, State) receives the index of the machine as well.
+ *
+ * The machine has no Arduino or FreeRTOS dependencies, so it builds on a
+ * host. It is not thread safe.
+ */
+
+#ifndef STATEMACHINE_H_
+#define STATEMACHINE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FSM_IGNORE 0xFF  // Transition table cell: ignore the event
+#define FSM_MAX_STATES 64  // Limited by the reachability check bit mask
+
+/**
+ * Returns the transition table cell for the specified next state.
+ */
+template <typename State> constexpr uint8_t fsm_to(State state) {
+  return static_cast<uint8_t>(state + 1);
+}
+
+/**
+ * Returns the reachability bit mask for a state.
+ */
+template <typename State> constexpr uint64_t fsm_state_bit(State state) {
+  return 1ULL << state;
+}
+
+/**
+ * Returns true if every cell of a table holds FSM_IGNORE or a valid
+ * next state.
+ */
+template <size_t STATE_COUNT, size_t EVENT_COUNT>
+constexpr bool fsm_table_is_complete(
+    const uint8_t (&table)[STATE_COUNT][EVENT_COUNT],
+    size_t cell = 0) {
+  return cell == STATE_COUNT * EVENT_COUNT
+      || ((table[cell / EVENT_COUNT][cell % EVENT_COUNT] == FSM_IGNORE
+          || (0 < table[cell / EVENT_COUNT][cell % EVENT_COUNT]
+              && table[cell / EVENT_COUNT][cell % EVENT_COUNT]
+                  <= STATE_COUNT))
+          && fsm_table_is_complete(table, cell + 1));
+}
+
+/**
+ * Returns the specified states together with the states that any of
+ * them enters in one transition. The table must be complete.
+ */
+template <size_t STATE_COUNT, size_t EVENT_COUNT>
+constexpr uint64_t fsm_successors(
+    const uint8_t (&table)[STATE_COUNT][EVENT_COUNT],
+    uint64_t states,
+    size_t cell = 0) {
+  return cell == STATE_COUNT * EVENT_COUNT
+      ? states
+      : fsm_successors(table, states, cell + 1)
+          | (((states >> (cell / EVENT_COUNT)) & 1)
+              && table[cell / EVENT_COUNT][cell % EVENT_COUNT] != FSM_IGNORE
+                  ? 1ULL << (table[cell / EVENT_COUNT][cell % EVENT_COUNT] - 1)
+                  : 0);
+}
+
+/**
+ * Returns every state reachable from the specified states.
+ */
+template <size_t STATE_COUNT, size_t EVENT_COUNT>
+constexpr uint64_t fsm_reachable_states(
+    const uint8_t (&table)[STATE_COUNT][EVENT_COUNT],
+    uint64_t states) {
+  return fsm_successors(table, states) == states
+      ? states
+      : fsm_reachable_states(table, fsm_successors(table, states));
+}
+
+/**
+ * Returns true if every state can be reached from the roots: the initial
+ * state plus any states that the owner enters without the table. The
+ * table must be complete.
+ */
+template <size_t STATE_COUNT, size_t EVENT_COUNT>
+constexpr bool fsm_all_states_reachable(
+    const uint8_t (&table)[STATE_COUNT][EVENT_COUNT],
+    uint64_t roots) {
+  static_assert(
+      STATE_COUNT <= FSM_MAX_STATES,
+      "Too many states for the reachability check.");
+  return fsm_reachable_states(table, roots)
+      == (STATE_COUNT == 64 ? ~0ULL : (1ULL << STATE_COUNT) - 1);
+}
+
+template <typename State, size_t STATE_COUNT, size_t EVENT_COUNT>
+class StateMachine {
+  static_assert(
+      STATE_COUNT < FSM_IGNORE,
+      "Too many states to encode in a table cell.");
+
+  uint8_t state;
+
+public:
+  typedef uint8_t Table[STATE_COUNT][EVENT_COUNT];
+
+  explicit StateMachine(State initial_state) :
+      state(initial_state) {
+  }
+
+  State get_state(void) const {
+    return static_cast<State>(state);
+  }
+
+  /**
+   * Moves to a state without consulting the table or running entry
+   * actions, e.g. from within an entry action or on an error.
+   */
+  void set_state(State new_state) {
+    state = new_state;
+  }
+
+  /**
+   * Applies an event. If the table does not ignore it, enters the next
+   * state and invokes owner.on_enter() with it. Returns true if the
+   * machine made a transition. Events outside the table are ignored.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * table               The transition table
+   * event               The event, an index into the table's rows
+   * owner               Object whose on_enter(State) performs the entry
+   *                     actions
+   */
+  template <typename Owner>
+  bool dispatch(const Table& table, unsigned event, Owner& owner) {
+    uint8_t cell = event < EVENT_COUNT ? table[state][event] : FSM_IGNORE;
+    if (cell == FSM_IGNORE) {
+      return false;
+    }
+    state = cell - 1;
+    owner.on_enter(static_cast<State>(state));
+    return true;
+  }
+};
+
+template <
+    typename State,
+    size_t STATE_COUNT,
+    size_t EVENT_COUNT,
+    size_t MACHINE_COUNT>
+class StateMachineArray {
+  static_assert(
+      STATE_COUNT < FSM_IGNORE,
+      "Too many states to encode in a table cell.");
+
+  uint8_t states[MACHINE_COUNT];
+
+public:
+  typedef uint8_t Table[STATE_COUNT][EVENT_COUNT];
+
+  explicit StateMachineArray(State initial_state) {
+    for (size_t i = 0; i < MACHINE_COUNT; ++i) {
+      states[i] = initial_state;
+    }
+  }
+
+  State get_state(size_t index) const {
+    return static_cast<State>(states[index]);
+  }
+
+  /**
+   * Moves a machine to a state without consulting the table or running
+   * entry actions.
+   */
+  void set_state(size_t index, State new_state) {
+    states[index] = new_state;
+  }
+
+  /**
+   * Applies an event to one machine. If the table does not ignore it,
+   * the machine enters the next state and dispatch() invokes
+   * owner.on_enter(index, next state). Returns true if the machine made
+   * a transition. Events outside the table are ignored.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * table               The transition table
+   * index               The machine, less than MACHINE_COUNT
+   * event               The event, an index into the table's rows
+   * owner               Object whose on_enter(size_t, State) performs the
+   *                     entry actions
+   */
+  template <typename Owner>
+  bool dispatch(
+      const Table& table, size_t index, unsigned event, Owner& owner) {
+    uint8_t cell =
+        event < EVENT_COUNT ? table[states[index]][event] : FSM_IGNORE;
+    if (cell == FSM_IGNORE) {
+      return false;
+    }
+    states[index] = cell - 1;
+    owner.on_enter(index, static_cast<State>(states[index]));
+    return true;
+  }
+};
+
+#endif /* STATEMACHINE_H_ */
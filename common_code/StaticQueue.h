@@ -0,0 +1,60 @@
+/*
+ * StaticQueue.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * FreeRTOS queue that carries its own storage, so creating it allocates
+ * nothing from the heap. Declare queues globally or as members of
+ * global objects, where the storage shows up in the linker map.
+ *
+ * Usage:
+ *
+ *   StaticQueue<DisplayMessage, 3> display_command_queue;
+ *   ...
+ *   QueueHandle_t h_display_command_queue = display_command_queue.create();
+ */
+
+#ifndef STATICQUEUE_H_
+#define STATICQUEUE_H_
+
+#include "Arduino.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+template <typename T, UBaseType_t LENGTH> class StaticQueue {
+  static_assert(0 < LENGTH, "Queues must hold at least one item.");
+
+  uint8_t storage[LENGTH * sizeof(T)];
+  StaticQueue_t queue_buffer;
+  QueueHandle_t h_queue;
+
+public:
+  StaticQueue() :
+      h_queue(NULL) {
+  }
+
+  /**
+   * Creates the queue on first use and returns its handle.
+   */
+  QueueHandle_t create(void) {
+    if (!h_queue) {
+      h_queue = xQueueCreateStatic(
+          LENGTH,
+          sizeof(T),
+          storage,
+          &queue_buffer);
+    }
+    return h_queue;
+  }
+
+  /**
+   * Returns the queue handle, or NULL if the queue has not been created.
+   */
+  QueueHandle_t get_handle(void) const {
+    return h_queue;
+  }
+};
+
+#endif /* STATICQUEUE_H_ */
@@ -0,0 +1,46 @@
+/*
+ * StaticTask.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Task that carries its own stack and task control block, so creating
+ * it allocates nothing from the heap. The storage is part of the task
+ * object, so declare tasks globally, where the storage shows up in the
+ * linker map, and never on the stack.
+ *
+ * The stack depth is in StackType_t units. On the ESP32, StackType_t is
+ * a byte, so the depth has the same meaning as the xTaskCreate() depths
+ * that the tasks used before.
+ */
+
+#ifndef STATICTASK_H_
+#define STATICTASK_H_
+
+#include "Arduino.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "Task.h"
+
+template <uint32_t STACK_DEPTH> class StaticTask : public Task {
+  static_assert(
+      configMINIMAL_STACK_SIZE <= STACK_DEPTH,
+      "Stack depth is below the FreeRTOS minimum.");
+
+  StackType_t stack[STACK_DEPTH];
+  StaticTask_t task_buffer;
+
+protected:
+  StaticTask(const char *task_name, TaskRole role) :
+      Task(task_name, STACK_DEPTH, role, stack, &task_buffer) {
+  }
+
+public:
+  static uint32_t get_stack_depth(void) {
+    return STACK_DEPTH;
+  }
+};
+
+#endif /* STATICTASK_H_ */
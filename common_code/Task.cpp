@@ -7,16 +7,37 @@
 
 #include "Task.h"
 
+#include "TaskMonitor.h"
+
 Task::Task(
     const char * task_name,
     uint32_t stack_depth,
-    UBaseType_t priority) :
+    TaskRole role) :
       task_name(task_name),
       stack_depth(stack_depth),
-      priority(priority),
+      priority(task_policy(role).priority),
+      affinity(task_policy(role).affinity),
       creation_status(0),
-      h_task(NULL) {
+      h_task(NULL),
+      stack_buffer(NULL),
+      task_buffer(NULL) {
+
+}
 
+Task::Task(
+    const char * task_name,
+    uint32_t stack_depth,
+    TaskRole role,
+    StackType_t *stack_buffer,
+    StaticTask_t *task_buffer) :
+      task_name(task_name),
+      stack_depth(stack_depth),
+      priority(task_policy(role).priority),
+      affinity(task_policy(role).affinity),
+      creation_status(0),
+      h_task(NULL),
+      stack_buffer(stack_buffer),
+      task_buffer(task_buffer) {
 }
 
 Task::~Task() {
@@ -24,16 +45,33 @@ Task::~Task() {
 
 TaskHandle_t Task::create_and_start_task() {
   TaskHandle_t task_handle = NULL;
+  BaseType_t core_id = task_core_id(affinity);
 
-  creation_status = xTaskCreate(
-      run_the_task_loop,
-      task_name,
-      stack_depth,
-      this,
-      priority,
-      &task_handle);
+  if (stack_buffer && task_buffer) {
+    task_handle = xTaskCreateStaticPinnedToCore(
+        run_the_task_loop,
+        task_name,
+        stack_depth,
+        this,
+        priority,
+        stack_buffer,
+        task_buffer,
+        core_id);
+    creation_status = task_handle ? pdPASS : pdFAIL;
+  } else {
+    creation_status = xTaskCreatePinnedToCore(
+        run_the_task_loop,
+        task_name,
+        stack_depth,
+        this,
+        priority,
+        &task_handle,
+        core_id);
+  }
 
-  if (creation_status != pdPASS) {
+  if (creation_status == pdPASS) {
+    TaskMonitor::watch(task_handle, task_name, stack_depth);
+  } else {
     task_handle = NULL;
   }
 
@@ -4,13 +4,16 @@
  *  Created on: Feb 19, 2023
  *      Author: Eric Mintz
  *
- * Base FreeRTOS Task class, a template for implementing tasks that allocate
- * their own stacks (as opposed to tasks whose stack storage is provided
- * at startup). The task is **not** pinned to a core.
+ * Base FreeRTOS Task class. A task either allocates its stack and control
+ * block from the heap when it starts, or runs in storage that it is given
+ * at construction and allocates nothing. StaticTask, in StaticTask.h,
+ * provides that storage and is the preferred base class. Each task names
+ * its role, and the policy table in TaskPolicy.h sets its priority and
+ * the core that it runs on.
  *
  * Users must provide the following:
  *
- * 1. run_task_loop() implementation.
+ * 1. task_loop() implementation.
  *
  * 2. A startup method that invokes create_and_start_task(). Pro tip: pass
  *    all required handles via the startup method.
@@ -24,12 +27,17 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include "TaskPolicy.h"
+
 class Task {
   const char * task_name;
   const uint32_t stack_depth;
   UBaseType_t priority;
+  TaskAffinity affinity;
   BaseType_t creation_status;
   TaskHandle_t h_task;
+  StackType_t *stack_buffer;  // NULL to allocate the stack from the heap
+  StaticTask_t *task_buffer;
 
   /**
    * The task function, the function that runs when the task starts.
@@ -47,12 +55,36 @@ protected:
   Task(
       const char * task_name,
       uint32_t stack_depth,
-      UBaseType_t priority);
+      TaskRole role);
+
+  /**
+   * Constructor for tasks that provide their own storage.
+   *
+   * Parameters:
+   *
+   * Name         Contents
+   * ------------ ---------------------------------------------------------
+   * task_name    Task name, for debugging
+   * stack_depth  Stack size in StackType_t units, which are bytes on the
+   *              ESP32
+   * role         Task role, which selects the priority and core
+   * stack_buffer Stack storage, at least stack_depth units. It must
+   *              outlive the task.
+   * task_buffer  Task control block storage. It must outlive the task.
+   */
+  Task(
+      const char * task_name,
+      uint32_t stack_depth,
+      TaskRole role,
+      StackType_t *stack_buffer,
+      StaticTask_t *task_buffer);
 
   /**
-   * Creates a FreeRTOS task that runs this instance's task loop. Returns the
-   * resulting task handle or NULL if the task could not be run. Users can
-   * invoke get_creation_status() to retrieve the creation status.
+   * Creates a FreeRTOS task that runs this instance's task loop on the
+   * core that its policy selects, in the provided storage if there is
+   * any, and registers it with the TaskMonitor. Returns the resulting task
+   * handle or NULL if the task could not be run. Users can invoke get_creation_status() to retrieve
+   * the creation status.
    */
   TaskHandle_t create_and_start_task();
 
@@ -66,6 +98,14 @@ public:
     return creation_status;
   }
 
+  UBaseType_t get_priority(void) const {
+    return priority;
+  }
+
+  TaskAffinity get_affinity(void) const {
+    return affinity;
+  }
+
   /***
    * Notify this Task from application code. If this Task is suspended,
    * it will resume running.
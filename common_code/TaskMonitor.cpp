@@ -0,0 +1,166 @@
+/*
+ * TaskMonitor.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TaskMonitor.h"
+
+#include "Topic.h"
+
+TaskMonitor::WatchedTask TaskMonitor::watched_tasks[TASK_MONITOR_CAPACITY];
+volatile size_t TaskMonitor::watched_task_count = 0;
+portMUX_TYPE TaskMonitor::registration_lock = portMUX_INITIALIZER_UNLOCKED;
+
+TaskMonitor::TaskMonitor() :
+    StaticTask("Task monitor", TASK_ROLE_MONITOR),
+#if TASK_MONITOR_HAS_RUN_TIME_STATS
+    has_total_run_time(false),
+    last_total_run_time(0),
+#endif
+    report_interval_windows(0),
+    windows_since_report(0) {
+}
+
+TaskMonitor::~TaskMonitor() {
+}
+
+bool TaskMonitor::watch(
+    TaskHandle_t h_task,
+    const char *name,
+    uint32_t stack_depth) {
+  bool watched = false;
+  if (h_task) {
+    portENTER_CRITICAL(&registration_lock);
+    size_t index = watched_task_count;
+    if (index < TASK_MONITOR_CAPACITY) {
+      WatchedTask& task = watched_tasks[index];
+      task.h_task = h_task;
+      task.name = name;
+      task.stack_depth = stack_depth;
+      task.min_free_stack = stack_depth;
+      task.has_run_time = false;
+      task.last_run_time = 0;
+      task.cpu_share.clear();
+      // Publish the record only once it is complete.
+      watched_task_count = index + 1;
+      watched = true;
+    }
+    portEXIT_CRITICAL(&registration_lock);
+  }
+  return watched;
+}
+
+TaskHandle_t TaskMonitor::start(uint32_t report_interval_ms) {
+  report_interval_windows =
+      (report_interval_ms + TASK_MONITOR_WINDOW_MS - 1)
+          / TASK_MONITOR_WINDOW_MS;
+  return create_and_start_task();
+}
+
+void TaskMonitor::sample(void) {
+  size_t count = watched_task_count;
+  for (size_t i = 0; i < count; ++i) {
+    watched_tasks[i].min_free_stack =
+        uxTaskGetStackHighWaterMark(watched_tasks[i].h_task);
+  }
+#if TASK_MONITOR_HAS_RUN_TIME_STATS
+  sample_run_time();
+#endif
+}
+
+void TaskMonitor::sample_run_time(void) {
+#if TASK_MONITOR_HAS_RUN_TIME_STATS
+  uint32_t total_run_time = 0;
+  UBaseType_t system_task_count = uxTaskGetSystemState(
+      system_state,
+      TASK_MONITOR_SYSTEM_TASKS,
+      &total_run_time);
+  if (!system_task_count) {
+    // The snapshot is too small. Leave the statistics as they are.
+    return;
+  }
+  uint32_t window_time = total_run_time - last_total_run_time;
+  size_t count = watched_task_count;
+  for (size_t i = 0; i < count; ++i) {
+    WatchedTask& task = watched_tasks[i];
+    for (UBaseType_t j = 0; j < system_task_count; ++j) {
+      if (system_state[j].xHandle == task.h_task) {
+        uint32_t run_time = system_state[j].ulRunTimeCounter;
+        if (has_total_run_time && task.has_run_time) {
+          task.cpu_share.record(run_time - task.last_run_time, window_time);
+        }
+        task.last_run_time = run_time;
+        task.has_run_time = true;
+        break;
+      }
+    }
+  }
+  last_total_run_time = total_run_time;
+  has_total_run_time = true;
+#endif
+}
+
+/**
+ * Prints a share, in tenths of a percent, as a percentage.
+ */
+static void print_share(uint16_t share) {
+  Serial.printf("%3u.%u", share / 10, share % 10);
+}
+
+void TaskMonitor::report(void) {
+  size_t count = watched_task_count;
+  Serial.printf(
+      "Task monitor: %u tasks, %u byte free heap\n",
+      (unsigned) count,
+      (unsigned) ESP.getFreeHeap());
+  Serial.println("Task             Stack  Peak  Free  CPU% min  mean   max");
+  for (size_t i = 0; i < count; ++i) {
+    const WatchedTask& task = watched_tasks[i];
+    Serial.printf("%-16.16s ", task.name);
+    if (task.stack_depth) {
+      Serial.printf(
+          "%5u %5u ",
+          (unsigned) task.stack_depth,
+          (unsigned) (task.stack_depth - task.min_free_stack));
+    } else {
+      Serial.print("    ?     ? ");
+    }
+    Serial.printf("%5u ", (unsigned) task.min_free_stack);
+    if (task.cpu_share.get_windows()) {
+      Serial.print("   ");
+      print_share(task.cpu_share.get_min_share());
+      Serial.print(" ");
+      print_share(task.cpu_share.get_mean_share());
+      Serial.print(" ");
+      print_share(task.cpu_share.get_max_share());
+    } else {
+      Serial.print("       -     -     -");
+    }
+    Serial.println();
+  }
+  TopicBase::print_report();
+}
+
+void TaskMonitor::task_loop(void) {
+  for (;;) {
+    bool report_requested =
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TASK_MONITOR_WINDOW_MS));
+    sample();
+    if (Serial.available()) {
+      while (0 <= Serial.read()) {
+      }
+      report_requested = true;
+    }
+    ++windows_since_report;
+    if (report_interval_windows
+        && report_interval_windows <= windows_since_report) {
+      report_requested = true;
+    }
+    if (report_requested) {
+      report();
+      windows_since_report = 0;
+    }
+  }
+}
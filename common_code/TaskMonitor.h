@@ -0,0 +1,133 @@
+/*
+ * TaskMonitor.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Task that watches the stack and CPU use of the other tasks and prints a
+ * compact report over serial. Every Task registers itself when it starts.
+ * Register tasks created by other means, such as the Arduino loop task
+ * or the FreeRTOS timer service task, with watch().
+ *
+ * Once per window, the monitor samples each watched task's stack high
+ * water mark and, when FreeRTOS keeps run time statistics
+ * (configGENERATE_RUN_TIME_STATS and configUSE_TRACE_FACILITY), the CPU
+ * time that it used. See CpuShareStatistics.h. The monitor prints a
+ * report at the configured interval, when request_report() is invoked,
+ * and when a character arrives on the serial port. The report ends with
+ * the event bus statistics, if any topics exist. See Topic.h.
+ *
+ * Watched tasks must never be deleted.
+ */
+
+#ifndef TASKMONITOR_H_
+#define TASKMONITOR_H_
+
+#include "Arduino.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "CpuShareStatistics.h"
+#include "StaticTask.h"
+
+#define TASK_MONITOR_CAPACITY 24  // Maximum number of watched tasks
+#define TASK_MONITOR_WINDOW_MS 1000  // CPU share sampling window
+
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+#define TASK_MONITOR_HAS_RUN_TIME_STATS 1
+// Capacity of the system state snapshot, which includes system tasks.
+#define TASK_MONITOR_SYSTEM_TASKS (TASK_MONITOR_CAPACITY + 16)
+#else
+#define TASK_MONITOR_HAS_RUN_TIME_STATS 0
+#endif
+
+class TaskMonitor : public StaticTask<3072> {
+  struct WatchedTask {
+    TaskHandle_t h_task;
+    const char *name;
+    uint32_t stack_depth;  // 0 if unknown
+    UBaseType_t min_free_stack;
+    bool has_run_time;  // last_run_time is valid
+    uint32_t last_run_time;
+    CpuShareStatistics cpu_share;
+  };
+
+  static WatchedTask watched_tasks[TASK_MONITOR_CAPACITY];
+  static volatile size_t watched_task_count;
+  static portMUX_TYPE registration_lock;
+
+#if TASK_MONITOR_HAS_RUN_TIME_STATS
+  TaskStatus_t system_state[TASK_MONITOR_SYSTEM_TASKS];
+  bool has_total_run_time;
+  uint32_t last_total_run_time;
+#endif
+  uint32_t report_interval_windows;  // 0 to report only on request
+  uint32_t windows_since_report;
+
+  /**
+   * Samples the stack high water marks and the CPU time of every
+   * watched task.
+   */
+  void sample(void);
+
+  /**
+   * Samples the watched tasks' CPU time. Requires run time statistics.
+   */
+  void sample_run_time(void);
+
+  /**
+   * Prints one line per watched task over serial.
+   */
+  void report(void);
+
+  virtual void task_loop(void);
+
+public:
+  TaskMonitor();
+  virtual ~TaskMonitor();
+
+  /**
+   * Adds a task to the watch list. Returns false if the list is full.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * h_task              The task to watch
+   * name                Task name for the report. Must outlive the monitor.
+   * stack_depth         Stack size in StackType_t units, or 0 if unknown
+   */
+  static bool watch(
+      TaskHandle_t h_task,
+      const char *name,
+      uint32_t stack_depth);
+
+  /**
+   * Returns the number of watched tasks.
+   */
+  static size_t get_watched_task_count(void) {
+    return watched_task_count;
+  }
+
+  /**
+   * Starts the monitor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * report_interval_ms  Time between reports, or 0 to report only on
+   *                     request
+   */
+  TaskHandle_t start(uint32_t report_interval_ms);
+
+  /**
+   * Has the monitor print a report. Do NOT invoke from an ISR.
+   */
+  void request_report(void) {
+    notify();
+  }
+};
+
+#endif /* TASKMONITOR_H_ */
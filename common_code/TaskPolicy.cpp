@@ -0,0 +1,48 @@
+/*
+ * TaskPolicy.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TaskPolicy.h"
+
+static const TaskPolicy TASK_POLICIES[] = {
+  // Gyroscope reader
+  { 1, TASK_ANY_CORE },  // TASK_ROLE_TEMPERATURE_SAMPLER
+  { 2, TASK_CORE_0 },  // TASK_ROLE_GYROSCOPE_UPDATE
+  { 10, TASK_CORE_0 },  // TASK_ROLE_MOTION_DETECTION
+  { 15, TASK_CORE_0 },  // TASK_ROLE_EVENT_RELAY
+  { 15, TASK_CORE_0 },  // TASK_ROLE_ESP_NOW_SEND
+
+  // Receiver
+  { 4, TASK_CORE_0 },  // TASK_ROLE_ESP_NOW_RECEIVE
+  { 2, TASK_CORE_0 },  // TASK_ROLE_CONNECTION_WATCHDOG
+  { 15, TASK_CORE_0 },  // TASK_ROLE_CONNECTION_STATUS
+  { 9, TASK_CORE_1 },  // TASK_ROLE_MILK_ARRIVAL
+  { 10, TASK_CORE_1 },  // TASK_ROLE_TIME_KEEPER
+  { 5, TASK_CORE_1 },  // TASK_ROLE_ALARM
+  { 3, TASK_CORE_1 },  // TASK_ROLE_LCD_DISPLAY
+  { 11, TASK_CORE_1 },  // TASK_ROLE_I2C_BUS, above all of its clients
+
+  // Both
+  { 1, TASK_ANY_CORE },  // TASK_ROLE_MONITOR
+  { 16, TASK_ANY_CORE },  // TASK_ROLE_TIMER_SERVICE, above all of its clients
+};
+
+static_assert(
+    sizeof(TASK_POLICIES) / sizeof(TASK_POLICIES[0]) == TASK_ROLE_COUNT,
+    "Every task role must have a policy.");
+
+const TaskPolicy& task_policy(TaskRole role) {
+  return TASK_POLICIES[role];
+}
+
+BaseType_t task_core_id(TaskAffinity affinity) {
+#if portNUM_PROCESSORS > 1
+  return affinity == TASK_ANY_CORE ? tskNO_AFFINITY : (BaseType_t) affinity;
+#else
+  (void) affinity;
+  return tskNO_AFFINITY;
+#endif
+}
@@ -0,0 +1,74 @@
+/*
+ * TaskPolicy.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Scheduling policy for every task in the system: its priority and the
+ * core it runs on. Tasks name their role, and the policy table in
+ * TaskPolicy.cpp supplies the rest, so priorities and core assignments
+ * can be reviewed and changed in one place.
+ *
+ * On the dual core ESP32, the Wi-Fi driver and its ESP-NOW callbacks run
+ * on core 0 and the Arduino loop on core 1. Radio and motion work shares
+ * core 0 and the user interface gets core 1. On single core targets,
+ * every task runs on the one core.
+ */
+
+#ifndef TASKPOLICY_H_
+#define TASKPOLICY_H_
+
+#include "Arduino.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+enum TaskAffinity {
+  TASK_CORE_0,  // Protocol CPU, where the radio runs
+  TASK_CORE_1,  // Application CPU
+  TASK_ANY_CORE,  // Let the scheduler choose
+};
+
+enum TaskRole {
+  // Gyroscope reader
+  TASK_ROLE_TEMPERATURE_SAMPLER,
+  TASK_ROLE_GYROSCOPE_UPDATE,
+  TASK_ROLE_MOTION_DETECTION,
+  TASK_ROLE_EVENT_RELAY,
+  TASK_ROLE_ESP_NOW_SEND,
+
+  // Receiver
+  TASK_ROLE_ESP_NOW_RECEIVE,
+  TASK_ROLE_CONNECTION_WATCHDOG,
+  TASK_ROLE_CONNECTION_STATUS,
+  TASK_ROLE_MILK_ARRIVAL,
+  TASK_ROLE_TIME_KEEPER,
+  TASK_ROLE_ALARM,
+  TASK_ROLE_LCD_DISPLAY,
+  TASK_ROLE_I2C_BUS,
+
+  // Both
+  TASK_ROLE_MONITOR,
+  TASK_ROLE_TIMER_SERVICE,
+
+  TASK_ROLE_COUNT,  // MUST be last
+};
+
+struct TaskPolicy {
+  UBaseType_t priority;
+  TaskAffinity affinity;
+};
+
+/**
+ * Returns the policy for a role.
+ */
+const TaskPolicy& task_policy(TaskRole role);
+
+/**
+ * Returns the core ID to pass to xTaskCreatePinnedToCore() for an
+ * affinity, or tskNO_AFFINITY if the task may run on any core or the
+ * target has only one.
+ */
+BaseType_t task_core_id(TaskAffinity affinity);
+
+#endif /* TASKPOLICY_H_ */
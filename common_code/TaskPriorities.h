@@ -1,18 +0,0 @@
-/*
- * TaskPriorities.h
- *
- *  Created on: Dec 25, 2022
- *      Author: Eric Mintz
- *
- * Task priorities for the system
- */
-
-#ifndef TASKPRIORITIES_H_
-#define TASKPRIORITIES_H_
-
-#define GYROSCOPE_UPDATE_PIORITY 2
-#define BLINK_TASK_PRIORITY 8
-#define MOTION_DETECTION_PRIORITY 10
-#define ESP_NOW_SEND_PRIORITY 15
-
-#endif /* TASKPRIORITIES_H_ */
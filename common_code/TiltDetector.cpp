@@ -0,0 +1,32 @@
+/*
+ * TiltDetector.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TiltDetector.h"
+
+static inline uint64_t shifted_square(int32_t value) {
+  if (value < INT16_MIN) {
+    value = INT16_MIN;
+  } else if (INT16_MAX < value) {
+    value = INT16_MAX;
+  }
+  int32_t shifted = value / (1 << TiltDetector::INPUT_SHIFT);
+  return (uint64_t) (shifted * shifted);
+}
+
+bool TiltDetector::is_tilted(int32_t x, int32_t y, int32_t z) const {
+  uint64_t x_squared = shifted_square(x);
+  uint64_t y_squared = shifted_square(y);
+  uint64_t z_squared = shifted_square(z);
+  uint64_t x_and_z = x_squared + z_squared;
+  uint64_t y_and_z = y_squared + z_squared;
+
+  // Each term is below 2^46, so the Q16 product stays below 2^64.
+  uint64_t scaled =
+      (y_squared * y_and_z + x_squared * x_and_z + x_and_z * y_and_z)
+          * cosine_squared_q16;
+  return (x_and_z * y_and_z) << 16 < scaled;
+}
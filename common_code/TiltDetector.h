@@ -0,0 +1,105 @@
+/*
+ * TiltDetector.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Integer tilt detection. Decides whether a gravity vector is inclined
+ * beyond a threshold without floating point or transcendental functions,
+ * which the ESP32-S2 would otherwise evaluate in software.
+ *
+ * The sender used to compute
+ *
+ *   inclination = atan(sqrt(tan(roll)^2 + tan(pitch)^2))
+ *
+ * from MPU6050_light style angles, where, for gravity (x, y, z),
+ *
+ *   tan(roll)  = y / sqrt(x^2 + z^2)
+ *   tan(pitch) = x / sqrt(y^2 + z^2)
+ *
+ * and signalled tilt when the inclination exceeded the threshold T. Let
+ * X = x^2, Y = y^2, Z = z^2, and c = cos(T). Since atan() is monotonic,
+ * the test is equivalent to
+ *
+ *   c^2 * (Y(Y + Z) + X(X + Z) + (X + Z)(Y + Z)) > (X + Z)(Y + Z)
+ *
+ * For a single axis (X = 0) this reduces to the cosine test
+ * Z < c^2 * |g|^2. The extra terms make combined roll and pitch produce
+ * the same decisions as the float formula did.
+ *
+ * c^2 is computed at compile time from the threshold angle. The class has
+ * no Arduino or FreeRTOS dependencies, so it builds on a host.
+ */
+
+#ifndef TILTDETECTOR_H_
+#define TILTDETECTOR_H_
+
+#include <stdint.h>
+
+class TiltDetector {
+  const uint32_t cosine_squared_q16;
+
+  /**
+   * Taylor series for the cosine, evaluated by the compiler. Accurate to
+   * well beyond Q16 for angles in [-pi/2, +pi/2].
+   */
+  static constexpr double cosine_series(
+      double x_squared, double term, unsigned n) {
+    return 12 < n
+        ? 0.0
+        : term + cosine_series(
+            x_squared,
+            -term * x_squared / ((2 * n + 1) * (2 * n + 2)),
+            n + 1);
+  }
+
+public:
+  /**
+   * Bits discarded from each gravity component before squaring. Keeps the
+   * arithmetic within 64 bits for any 16 bit input.
+   */
+  static const unsigned INPUT_SHIFT = 4;
+
+  /**
+   * Returns cos(radians)^2 in unsigned Q16 fixed point. Intended for
+   * compile time evaluation.
+   */
+  static constexpr uint32_t cosine_squared_in_q16(double radians) {
+    return (uint32_t) (
+        cosine_series(radians * radians, 1.0, 0)
+            * cosine_series(radians * radians, 1.0, 0)
+            * 65536.0
+        + 0.5);
+  }
+
+  /**
+   * Constructor
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * threshold_radians   Tilt angle above which is_tilted() returns true,
+   *                     in [0, pi/2]. Declare the detector constexpr so
+   *                     that the threshold is computed at compile time.
+   */
+  constexpr explicit TiltDetector(double threshold_radians) :
+      cosine_squared_q16(cosine_squared_in_q16(threshold_radians)) {
+  }
+
+  /**
+   * Returns true if the gravity vector is inclined beyond the threshold.
+   * Components may be in any units, provided that all three use the same
+   * units and lie within the int16_t range, e.g. raw MPU6050 readings.
+   */
+  bool is_tilted(int32_t x, int32_t y, int32_t z) const;
+
+  /**
+   * Returns the threshold cosine squared in Q16.
+   */
+  uint32_t get_cosine_squared_q16(void) const {
+    return cosine_squared_q16;
+  }
+};
+
+#endif /* TILTDETECTOR_H_ */
@@ -0,0 +1,103 @@
+/*
+ * TimerService.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TimerService.h"
+
+#include "esp_timer.h"
+
+#define TIMER_SERVICE_TICK_US (TIMER_SERVICE_TICK_MS * 1000)
+
+TimerService::TimerService() :
+    StaticTask("Timer Service", TASK_ROLE_TIMER_SERVICE),
+    wheel(),
+    posted(0),
+    dropped(0) {
+  portMUX_INITIALIZE(&lock);
+}
+
+TimerService::~TimerService() {
+}
+
+uint32_t TimerService::current_tick(void) {
+  return (uint32_t) (esp_timer_get_time() / TIMER_SERVICE_TICK_US);
+}
+
+void TimerService::init_timer(
+    WheelTimer *timer,
+    QueueHandle_t h_queue,
+    const void *message) {
+  TimingWheel::init(timer, h_queue, message);
+}
+
+void TimerService::start_timer(WheelTimer *timer, uint32_t delay_ms) {
+  uint32_t ticks =
+      (delay_ms + TIMER_SERVICE_TICK_MS - 1) / TIMER_SERVICE_TICK_MS;
+  uint32_t now = current_tick();
+  portENTER_CRITICAL(&lock);
+  bool was_idle = !wheel.get_pending();
+  if (was_idle) {
+    // The service stops ticking when idle, so catch the wheel up.
+    wheel.advance(now);
+  }
+  // The current tick is partly over, so wait one more.
+  wheel.start(timer, now + ticks + 1);
+  portEXIT_CRITICAL(&lock);
+  if (was_idle) {
+    notify();
+  }
+}
+
+void TimerService::stop_timer(WheelTimer *timer) {
+  portENTER_CRITICAL(&lock);
+  wheel.stop(timer);
+  portEXIT_CRITICAL(&lock);
+}
+
+bool TimerService::is_timer_running(const WheelTimer *timer) {
+  portENTER_CRITICAL(&lock);
+  bool running = TimingWheel::is_active(timer);
+  portEXIT_CRITICAL(&lock);
+  return running;
+}
+
+void TimerService::expire(void) {
+  uint32_t now = current_tick();
+  portENTER_CRITICAL(&lock);
+  wheel.advance(now);
+  for (;;) {
+    WheelTimer *timer = wheel.take_expired();
+    if (!timer) {
+      break;
+    }
+    QueueHandle_t h_queue = (QueueHandle_t) timer->target;
+    const void *message = timer->message;
+    portEXIT_CRITICAL(&lock);
+    if (xQueueSendToBack(h_queue, message, 0) == pdTRUE) {
+      ++posted;
+    } else {
+      ++dropped;
+    }
+    portENTER_CRITICAL(&lock);
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+void TimerService::task_loop(void) {
+  for (;;) {
+    portENTER_CRITICAL(&lock);
+    bool is_idle = !wheel.get_pending();
+    portEXIT_CRITICAL(&lock);
+    ulTaskNotifyTake(
+        pdTRUE,
+        is_idle ? portMAX_DELAY : pdMS_TO_TICKS(TIMER_SERVICE_TICK_MS));
+    expire();
+  }
+}
+
+TaskHandle_t TimerService::start(void) {
+  return create_and_start_task();
+}
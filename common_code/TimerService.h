@@ -0,0 +1,115 @@
+/*
+ * TimerService.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Timer service built on a TimingWheel. One task, ticked from
+ * esp_timer every TIMER_SERVICE_TICK_MS while any timer runs, drives
+ * every timer in the system. Starting, restarting, and stopping a timer
+ * take constant time under a short spinlock, and go through no command
+ * queue, so timers are cheap enough to have one per sender or alarm.
+ *
+ * A timer's expiry is a message copied into a FreeRTOS queue; nothing
+ * runs in the service task, and nothing is sent while the lock is held.
+ * The message must outlive the timer, and the queue's item size must
+ * match it.
+ *
+ * An expiry can be in flight while its owner restarts the timer. Owners
+ * that restart timers from a task other than the one receiving the
+ * expiry, or while an expiry waits in the queue, should ignore expiries
+ * that arrive while is_timer_running() reports the timer running.
+ *
+ * Usage:
+ *
+ *   WheelTimer timeout;
+ *   TimerService::init_timer(&timeout, h_event_queue, &TIMEOUT_EVENT);
+ *   ...
+ *   timer_service.start_timer(&timeout, 500);  // Posts in 500 ms
+ */
+
+#ifndef TIMERSERVICE_H_
+#define TIMERSERVICE_H_
+
+#include "Arduino.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#include "StaticTask.h"
+#include "TimingWheel.h"
+
+#define TIMER_SERVICE_TICK_MS 10  // Timer resolution
+
+class TimerService : public StaticTask<2048> {
+  TimingWheel wheel;
+  portMUX_TYPE lock;
+  uint32_t posted;   // Expiries sent
+  uint32_t dropped;  // Expiries lost to a full queue
+
+  /**
+   * Returns the current wheel tick. Derived from the 64 bit esp_timer
+   * clock, so it wraps cleanly.
+   */
+  static uint32_t current_tick(void);
+
+  /**
+   * Expires the timers that are due and sends their messages.
+   */
+  void expire(void);
+
+  virtual void task_loop(void);
+
+public:
+  TimerService();
+  virtual ~TimerService();
+
+  /**
+   * Prepares a timer for use.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * timer               The timer, which must not be running
+   * h_queue             The queue that receives the expiry
+   * message             The expiry message, an item of h_queue
+   */
+  static void init_timer(
+      WheelTimer *timer,
+      QueueHandle_t h_queue,
+      const void *message);
+
+  /**
+   * Starts a timer, or restarts it if it is running. The timer expires
+   * after at least delay_ms, rounded up to a whole tick.
+   */
+  void start_timer(WheelTimer *timer, uint32_t delay_ms);
+
+  /**
+   * Stops a timer. An expiry that has already been sent stays in the
+   * queue.
+   */
+  void stop_timer(WheelTimer *timer);
+
+  /**
+   * Returns true if a timer is running.
+   */
+  bool is_timer_running(const WheelTimer *timer);
+
+  /**
+   * Starts the service task.
+   */
+  TaskHandle_t start(void);
+
+  uint32_t get_posted(void) const {
+    return posted;
+  }
+
+  uint32_t get_dropped(void) const {
+    return dropped;
+  }
+};
+
+#endif /* TIMERSERVICE_H_ */
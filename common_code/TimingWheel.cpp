@@ -0,0 +1,143 @@
+/*
+ * TimingWheel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TimingWheel.h"
+
+#include <string.h>
+
+#define SLOT_MASK (TIMING_WHEEL_SLOTS - 1)
+
+TimingWheel::TimingWheel() :
+    expired(NULL),
+    next_tick(0),
+    pending(0) {
+  memset(slots, 0, sizeof(slots));
+}
+
+void TimingWheel::init(
+    WheelTimer *timer,
+    void *target,
+    const void *message) {
+  timer->next = NULL;
+  timer->link = NULL;
+  timer->expires = 0;
+  timer->has_expired = false;
+  timer->target = target;
+  timer->message = message;
+}
+
+void TimingWheel::push(WheelTimer **head, WheelTimer *timer) {
+  timer->next = *head;
+  if (timer->next) {
+    timer->next->link = &timer->next;
+  }
+  timer->link = head;
+  *head = timer;
+}
+
+void TimingWheel::unlink(WheelTimer *timer) {
+  *timer->link = timer->next;
+  if (timer->next) {
+    timer->next->link = timer->link;
+  }
+  timer->next = NULL;
+  timer->link = NULL;
+}
+
+void TimingWheel::file(WheelTimer *timer) {
+  int32_t delta = (int32_t) (timer->expires - next_tick);
+  if (delta < 0) {
+    // Already due: expire on the next tick processed.
+    push(&slots[0][next_tick & SLOT_MASK], timer);
+    return;
+  }
+  // Out of range timers wait in the farthest slot of the top level.
+  uint32_t expires = (uint32_t) delta < TIMING_WHEEL_RANGE
+      ? timer->expires
+      : next_tick + TIMING_WHEEL_RANGE - 1;
+  size_t level = 0;
+  uint32_t span = (uint32_t) delta >> TIMING_WHEEL_SLOT_BITS;
+  while (span && level < TIMING_WHEEL_LEVELS - 1) {
+    ++level;
+    span >>= TIMING_WHEEL_SLOT_BITS;
+  }
+  size_t slot = (expires >> (level * TIMING_WHEEL_SLOT_BITS)) & SLOT_MASK;
+  push(&slots[level][slot], timer);
+}
+
+void TimingWheel::cascade(size_t level, size_t slot) {
+  WheelTimer *timer = slots[level][slot];
+  slots[level][slot] = NULL;
+  while (timer) {
+    WheelTimer *next = timer->next;
+    file(timer);
+    timer = next;
+  }
+}
+
+void TimingWheel::start(WheelTimer *timer, uint32_t expires) {
+  if (is_active(timer)) {
+    stop(timer);
+  }
+  timer->expires = expires;
+  file(timer);
+  ++pending;
+}
+
+void TimingWheel::stop(WheelTimer *timer) {
+  if (!is_active(timer)) {
+    return;
+  }
+  if (timer->has_expired) {
+    timer->has_expired = false;
+  } else {
+    --pending;
+  }
+  unlink(timer);
+}
+
+void TimingWheel::advance(uint32_t tick) {
+  if (!pending) {
+    next_tick = tick + 1;
+    return;
+  }
+  while ((int32_t) (tick - next_tick) >= 0) {
+    size_t slot = next_tick & SLOT_MASK;
+    // At the start of each turn of a level, bring the next slot of the
+    // level above it down.
+    size_t index = slot;
+    for (size_t level = 1;
+        !index && level < TIMING_WHEEL_LEVELS;
+        ++level) {
+      index = (next_tick >> (level * TIMING_WHEEL_SLOT_BITS)) & SLOT_MASK;
+      cascade(level, index);
+    }
+    WheelTimer *timer = slots[0][slot];
+    slots[0][slot] = NULL;
+    while (timer) {
+      WheelTimer *next = timer->next;
+      push(&expired, timer);
+      timer->has_expired = true;
+      --pending;
+      timer = next;
+    }
+    ++next_tick;
+    if (!pending) {
+      next_tick = tick + 1;
+      break;
+    }
+  }
+}
+
+WheelTimer *TimingWheel::take_expired(void) {
+  WheelTimer *timer = expired;
+  if (timer) {
+    unlink(timer);
+    timer->has_expired = false;
+  }
+  return timer;
+}
@@ -0,0 +1,150 @@
+/*
+ * TimingWheel.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Hierarchical timing wheel: any number of timers, started, stopped, and
+ * restarted in constant time. Timers are intrusive, so the wheel
+ * allocates nothing, and a timer costs only its own small struct.
+ *
+ * The wheel has TIMING_WHEEL_LEVELS levels of TIMING_WHEEL_SLOTS slots.
+ * A level 0 slot spans one tick, a level 1 slot spans a whole turn of
+ * level 0, and so on, so three levels of 64 slots cover 2^18 ticks.
+ * Timers due within a turn of level 0 go straight into the slot for
+ * their tick; later ones wait in a coarser slot and cascade down a level
+ * when the finer level's turn reaches them. A timer is touched at most
+ * once per level before it expires. Timers due beyond the range of the
+ * wheel wait in the top level and cascade until they are in range.
+ *
+ * advance() moves the timers that are due onto an expired list, and the
+ * owner takes them off with take_expired() to act on them, e.g. after
+ * releasing a lock. Stopping a timer that is on the expired list removes
+ * it from the list, so an expiry can still be cancelled until it is
+ * taken.
+ *
+ * The wheel is not thread safe; see TimerService.h. It has no Arduino or
+ * FreeRTOS dependencies, and ticks are whatever unit the owner chooses.
+ */
+
+#ifndef TIMINGWHEEL_H_
+#define TIMINGWHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMING_WHEEL_LEVELS 3
+#define TIMING_WHEEL_SLOT_BITS 6
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_SLOT_BITS)
+#define TIMING_WHEEL_RANGE \
+  ((uint32_t) 1 << (TIMING_WHEEL_LEVELS * TIMING_WHEEL_SLOT_BITS))
+
+/**
+ * A timer. The wheel owns the links and the expiry tick; target and
+ * message belong to the wheel's owner, which uses them to act on the
+ * expiry. Zero the links, e.g. with TimingWheel::init(), before first
+ * use.
+ */
+struct WheelTimer {
+  WheelTimer *next;
+  WheelTimer **link;  // The pointer that points here, NULL when idle
+  uint32_t expires;   // Tick
+  bool has_expired;   // On the expired list
+  void *target;
+  const void *message;
+};
+
+class TimingWheel {
+  WheelTimer *slots[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS];
+  WheelTimer *expired;
+  uint32_t next_tick;  // The next tick that advance() will process
+  size_t pending;  // Timers in the slots, excluding expired ones
+
+  /**
+   * Files a timer in the slot for its expiry tick.
+   */
+  void file(WheelTimer *timer);
+
+  /**
+   * Pushes a timer onto a list.
+   */
+  static void push(WheelTimer **head, WheelTimer *timer);
+
+  /**
+   * Removes a timer from whatever list holds it.
+   */
+  static void unlink(WheelTimer *timer);
+
+  /**
+   * Refiles every timer in a slot, moving it down at least one level.
+   */
+  void cascade(size_t level, size_t slot);
+
+public:
+  TimingWheel();
+
+  /**
+   * Prepares a timer for use.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * timer               The timer, which must not be running
+   * target              Where the owner sends the expiry, e.g. a queue
+   * message             What the owner sends
+   */
+  static void init(WheelTimer *timer, void *target, const void *message);
+
+  /**
+   * Starts a timer, or restarts it if it is already running or has
+   * expired but not been taken. A tick already processed expires at the
+   * next advance().
+   */
+  void start(WheelTimer *timer, uint32_t expires);
+
+  /**
+   * Stops a timer. Stopping an idle timer does nothing.
+   */
+  void stop(WheelTimer *timer);
+
+  /**
+   * Returns true if a timer is running or has expired but not been
+   * taken.
+   */
+  static bool is_active(const WheelTimer *timer) {
+    return timer->link != NULL;
+  }
+
+  /**
+   * Processes every tick up to and including the specified one, moving
+   * the timers that are due onto the expired list. Jumps straight to the
+   * tick when no timers are pending.
+   */
+  void advance(uint32_t tick);
+
+  /**
+   * Takes a timer off the expired list, leaving it idle. Returns NULL
+   * when the list is empty. Timers that expired together come off in no
+   * particular order.
+   */
+  WheelTimer *take_expired(void);
+
+  /**
+   * Returns the next tick that advance() will process. Timers that
+   * expire before it have expired.
+   */
+  uint32_t get_next_tick(void) const {
+    return next_tick;
+  }
+
+  /**
+   * Returns the number of timers that are running, excluding those that
+   * have expired.
+   */
+  size_t get_pending(void) const {
+    return pending;
+  }
+};
+
+#endif /* TIMINGWHEEL_H_ */
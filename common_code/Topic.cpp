@@ -0,0 +1,100 @@
+/*
+ * Topic.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "Topic.h"
+
+// Zero initialized before any constructor runs, so topics may register
+// in any order.
+TopicBase *TopicBase::first_topic = NULL;
+
+TopicBase::TopicBase(
+    const char *name,
+    QueueHandle_t *subscribers,
+    size_t max_subscribers) :
+        next_topic(first_topic),
+        name(name),
+        published(0),
+        delivered(0),
+        dropped(0),
+        received(0),
+        max_latency_us(0),
+        total_latency_us(0),
+        subscribers(subscribers),
+        max_subscribers(max_subscribers),
+        subscriber_count(0) {
+  portMUX_INITIALIZE(&lock);
+  first_topic = this;
+}
+
+TopicBase::~TopicBase() {
+}
+
+bool TopicBase::subscribe(QueueHandle_t h_queue) {
+  bool subscribed = false;
+  if (h_queue) {
+    portENTER_CRITICAL(&lock);
+    size_t index = subscriber_count;
+    if (index < max_subscribers) {
+      subscribers[index] = h_queue;
+      // Publish the subscriber only once its handle is in place.
+      subscriber_count = index + 1;
+      subscribed = true;
+    }
+    portEXIT_CRITICAL(&lock);
+  }
+  return subscribed;
+}
+
+bool TopicBase::fan_out(const void *envelope, TickType_t wait) {
+  size_t count = subscriber_count;
+  uint32_t failures = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (xQueueSendToBack(subscribers[i], envelope, wait) != pdTRUE) {
+      ++failures;
+    }
+  }
+  portENTER_CRITICAL(&lock);
+  ++published;
+  delivered += count - failures;
+  dropped += failures;
+  portEXIT_CRITICAL(&lock);
+  return !failures;
+}
+
+void TopicBase::record_latency(uint32_t published_us) {
+  uint32_t latency_us = (uint32_t) esp_timer_get_time() - published_us;
+  portENTER_CRITICAL(&lock);
+  ++received;
+  total_latency_us += latency_us;
+  if (max_latency_us < latency_us) {
+    max_latency_us = latency_us;
+  }
+  portEXIT_CRITICAL(&lock);
+}
+
+uint32_t TopicBase::get_mean_latency_us(void) const {
+  return received ? (uint32_t) (total_latency_us / received) : 0;
+}
+
+void TopicBase::print_report(void) {
+  if (!first_topic) {
+    return;
+  }
+  Serial.println(
+      "Topic            Subs Published Delivered Dropped Mean us  Max us");
+  for (TopicBase *topic = first_topic; topic; topic = topic->next_topic) {
+    Serial.printf(
+        "%-16.16s %4u %9u %9u %7u %7u %7u\n",
+        topic->name,
+        (unsigned) topic->subscriber_count,
+        (unsigned) topic->published,
+        (unsigned) topic->delivered,
+        (unsigned) topic->dropped,
+        (unsigned) topic->get_mean_latency_us(),
+        (unsigned) topic->max_latency_us);
+  }
+}
@@ -0,0 +1,224 @@
+/*
+ * Topic.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Typed publish/subscribe event bus. A Topic carries one message type
+ * from any number of publishers to a fixed number of subscribers. Each
+ * subscriber owns a Subscription, a statically allocated queue, and
+ * publish() copies the message straight into every subscriber's queue,
+ * so producers need not know who consumes their messages.
+ *
+ * Messages must be small, trivially copyable structs. Topics are
+ * global objects that register themselves during static initialization;
+ * the subscriber capacity is fixed at compile time.
+ *
+ * Every topic counts the messages published to it, the copies
+ * delivered, and the copies dropped because a subscriber's queue was
+ * full, and measures the time from publication to receipt. The
+ * TaskMonitor report includes these counts. See print_report().
+ *
+ * Usage:
+ *
+ *   Topic<DisplayMessage, 1> display_topic("Display");
+ *   ...
+ *   Subscription<DisplayMessage, 3> display_commands;
+ *   display_commands.subscribe(display_topic);
+ *   ...
+ *   display_topic.publish(message);  // In the producer
+ *   ...
+ *   display_commands.receive(message, portMAX_DELAY);  // In the consumer
+ *
+ * Do NOT publish from an ISR.
+ */
+
+#ifndef TOPIC_H_
+#define TOPIC_H_
+
+#include "Arduino.h"
+
+#include <type_traits>
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#include "StaticQueue.h"
+
+#define TOPIC_MAX_MESSAGE_SIZE 32  // Largest message, in bytes
+
+/**
+ * Message as it travels through a subscriber's queue.
+ */
+template <typename Message> struct TopicEnvelope {
+  Message message;
+  uint32_t published_us;  // Publication time, low 32 bits
+};
+
+/**
+ * Type-independent topic state: registration and statistics.
+ */
+class TopicBase {
+  static TopicBase *first_topic;  // Registered topics, newest first
+
+  TopicBase *next_topic;
+  const char *name;
+  portMUX_TYPE lock;
+  uint32_t published;  // Messages published
+  uint32_t delivered;  // Copies delivered to subscribers
+  uint32_t dropped;  // Copies dropped because a queue was full
+  uint32_t received;  // Copies received, i.e. latency samples
+  uint32_t max_latency_us;
+  uint64_t total_latency_us;
+
+protected:
+  QueueHandle_t *subscribers;
+  const size_t max_subscribers;
+  volatile size_t subscriber_count;
+
+  TopicBase(
+      const char *name,
+      QueueHandle_t *subscribers,
+      size_t max_subscribers);
+
+  /**
+   * Copies an envelope into every subscriber queue. Returns false if
+   * any subscriber dropped it.
+   */
+  bool fan_out(const void *envelope, TickType_t wait);
+
+public:
+  virtual ~TopicBase();
+
+  /**
+   * Adds a subscriber queue. Returns false if the topic is full.
+   * Subscription::subscribe() invokes this.
+   */
+  bool subscribe(QueueHandle_t h_queue);
+
+  /**
+   * Records the delay between publication and receipt. Subscription
+   * invokes this for every received message.
+   */
+  void record_latency(uint32_t published_us);
+
+  const char *get_name(void) const {
+    return name;
+  }
+
+  uint32_t get_published(void) const {
+    return published;
+  }
+
+  uint32_t get_delivered(void) const {
+    return delivered;
+  }
+
+  uint32_t get_dropped(void) const {
+    return dropped;
+  }
+
+  uint32_t get_max_latency_us(void) const {
+    return max_latency_us;
+  }
+
+  /**
+   * Returns the mean latency in microseconds, or 0 if no message has
+   * been received.
+   */
+  uint32_t get_mean_latency_us(void) const;
+
+  /**
+   * Prints one line per registered topic over serial. Prints nothing
+   * if no topics are registered.
+   */
+  static void print_report(void);
+};
+
+template <typename Message, size_t MAX_SUBSCRIBERS> class Topic :
+    public TopicBase {
+  static_assert(
+      std::is_trivially_copyable<Message>::value,
+      "Topic messages must be trivially copyable.");
+  static_assert(
+      sizeof(Message) <= TOPIC_MAX_MESSAGE_SIZE,
+      "Topic messages must be small; send a pointer instead.");
+  static_assert(0 < MAX_SUBSCRIBERS, "Topics need at least one subscriber.");
+
+  QueueHandle_t subscriber_queues[MAX_SUBSCRIBERS];
+
+public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * name                Topic name for the report. Must outlive the topic.
+   */
+  Topic(const char *name) :
+      TopicBase(name, subscriber_queues, MAX_SUBSCRIBERS) {
+  }
+
+  /**
+   * Sends a message to every subscriber. Returns true if every
+   * subscriber received it, false if any subscriber's queue stayed
+   * full for the wait time.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * message             The message to send
+   * wait                Maximum time to wait for room in each subscriber's
+   *                     queue
+   */
+  bool publish(const Message &message, TickType_t wait = 0) {
+    TopicEnvelope<Message> envelope;
+    envelope.message = message;
+    envelope.published_us = (uint32_t) esp_timer_get_time();
+    return fan_out(&envelope, wait);
+  }
+};
+
+/**
+ * A subscriber's statically allocated message buffer.
+ */
+template <typename Message, UBaseType_t DEPTH> class Subscription {
+  StaticQueue<TopicEnvelope<Message>, DEPTH> queue;
+  TopicBase *topic;
+
+public:
+  Subscription() :
+    topic(NULL) {
+  }
+
+  /**
+   * Subscribes to a topic. Returns false if the topic has no room for
+   * another subscriber. Subscribe before any task receives.
+   */
+  template <size_t MAX_SUBSCRIBERS> bool subscribe(
+      Topic<Message, MAX_SUBSCRIBERS> &topic) {
+    this->topic = &topic;
+    return topic.subscribe(queue.create());
+  }
+
+  /**
+   * Receives the next message. Returns true if a message arrived
+   * within the wait time.
+   */
+  bool receive(Message &message, TickType_t wait) {
+    TopicEnvelope<Message> envelope;
+    bool has_message =
+        xQueueReceive(queue.get_handle(), &envelope, wait) == pdTRUE;
+    if (has_message) {
+      message = envelope.message;
+      topic->record_latency(envelope.published_us);
+    }
+    return has_message;
+  }
+};
+
+#endif /* TOPIC_H_ */
@@ -0,0 +1,65 @@
+/*
+ * WireFormat.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "WireFormat.h"
+
+// CRC-16/CCITT-FALSE remainders for each 4 bit value.
+static const uint16_t CRC_NIBBLE_TABLE[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+};
+
+uint16_t WireFormat::crc16(const uint8_t *data, size_t size) {
+  uint16_t crc = 0xFFFF;
+  while (size--) {
+    uint8_t byte = *data++;
+    crc = (uint16_t) ((crc << 4) ^ CRC_NIBBLE_TABLE[(crc >> 12) ^ (byte >> 4)]);
+    crc = (uint16_t) ((crc << 4) ^ CRC_NIBBLE_TABLE[(crc >> 12) ^ (byte & 0x0F)]);
+  }
+  return crc;
+}
+
+bool WireFrameView::is_valid(void) const {
+  if (frame_size < WIRE_FORMAT_V2_HEADER_SIZE + WIRE_FORMAT_CRC_SIZE
+      || frame[WIRE_FORMAT_MAGIC_OFFSET] != WIRE_FORMAT_MAGIC
+      || WIRE_FORMAT_VERSION < frame[WIRE_FORMAT_COMPATIBLE_VERSION_OFFSET]
+      || frame[WIRE_FORMAT_HEADER_SIZE_OFFSET] < WIRE_FORMAT_V2_HEADER_SIZE
+      || frame[WIRE_FORMAT_ENTRY_SIZE_OFFSET] < WIRE_FORMAT_ENTRY_SIZE) {
+    return false;
+  }
+  size_t expected_size =
+      frame[WIRE_FORMAT_HEADER_SIZE_OFFSET]
+      + (size_t) frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET]
+          * frame[WIRE_FORMAT_ENTRY_SIZE_OFFSET]
+      + WIRE_FORMAT_CRC_SIZE;
+  size_t crc_offset = frame_size - WIRE_FORMAT_CRC_SIZE;
+  return expected_size == frame_size
+      && WireFormat::crc16(frame, crc_offset)
+          == WireFormat::get_uint16(frame + crc_offset);
+}
+
+void WireFormat::encode_ack(uint8_t *ack, uint16_t sequence) {
+  ack[0] = WIRE_FORMAT_ACK_MAGIC;
+  ack[WIRE_FORMAT_ACK_VERSION_OFFSET] = WIRE_FORMAT_VERSION;
+  put_uint16(ack + WIRE_FORMAT_ACK_SEQUENCE_OFFSET, sequence);
+  size_t crc_offset = WIRE_FORMAT_ACK_SIZE - WIRE_FORMAT_CRC_SIZE;
+  put_uint16(ack + crc_offset, crc16(ack, crc_offset));
+}
+
+bool WireFormat::decode_ack(
+    const uint8_t *ack,
+    size_t ack_size,
+    uint16_t *sequence) {
+  size_t crc_offset = WIRE_FORMAT_ACK_SIZE - WIRE_FORMAT_CRC_SIZE;
+  if (ack_size != WIRE_FORMAT_ACK_SIZE
+      || ack[0] != WIRE_FORMAT_ACK_MAGIC
+      || crc16(ack, crc_offset) != get_uint16(ack + crc_offset)) {
+    return false;
+  }
+  *sequence = get_uint16(ack + WIRE_FORMAT_ACK_SEQUENCE_OFFSET);
+  return true;
+}
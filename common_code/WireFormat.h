@@ -0,0 +1,269 @@
+/*
+ * WireFormat.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Sender to receiver wire format, version 4. All multi-byte fields are
+ * little-endian and unaligned, and are read and written a byte at a time,
+ * so the layout does not depend on the compiler. A frame is
+ *
+ * Offset  Size  Contents
+ * ------  ----  -----------------------------------------------------------
+ * 0       1     WIRE_FORMAT_MAGIC
+ * 1       1     Format version of the sender
+ * 2       1     Oldest version that can decode the frame
+ * 3       1     Header size, WIRE_FORMAT_HEADER_SIZE or more
+ * 4       2     Sequence number, incremented per frame
+ * 6       4     Sender timestamp, milliseconds
+ * 10      1     Entry count, 1 .. WIRE_FORMAT_MAX_ENTRIES
+ * 11      1     Entry size, WIRE_FORMAT_ENTRY_SIZE or more
+ * 12      1     Flags, version 3 and later, see WIRE_FORMAT_FLAG_*
+ * 13      2     Boot identifier, version 4 and later: random and nonzero,
+ *               drawn afresh each time the sender starts
+ * 15      ...   Entries
+ * end - 2 2     CRC-16/CCITT-FALSE of everything before it
+ *
+ * and each entry is
+ *
+ * Offset  Size  Contents
+ * ------  ----  -----------------------------------------------------------
+ * 0       4     Sender timestamp, milliseconds
+ * 4       1     MotionStatus
+ * 5       4     Temperature, IEEE 754 single
+ *
+ * Version negotiation: a receiver accepts any frame whose oldest
+ * decodable version is at or below its own version. Later versions may
+ * lengthen the header or the entries, and older receivers skip the fields
+ * that they do not know, so either node can be upgraded first. Version 3
+ * added the flags byte, and version 4 the boot identifier, which tells
+ * the receiver that sequence numbers have started over. Older receivers
+ * ignore both.
+ *
+ * When a frame's WIRE_FORMAT_FLAG_ACK_REQUESTED flag is set, the receiver
+ * answers with an acknowledgment frame
+ *
+ * Offset  Size  Contents
+ * ------  ----  -----------------------------------------------------------
+ * 0       1     WIRE_FORMAT_ACK_MAGIC
+ * 1       1     Format version of the receiver
+ * 2       2     Sequence number of the acknowledged frame
+ * 4       2     CRC-16/CCITT-FALSE of everything before it
+ *
+ * WireFrameView validates and reads a received frame in place, without
+ * copying it.
+ */
+
+#ifndef WIREFORMAT_H_
+#define WIREFORMAT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "MotionNotificationMessage.h"
+
+#define WIRE_FORMAT_MAGIC 0x4D
+#define WIRE_FORMAT_ACK_MAGIC 0x4B
+#define WIRE_FORMAT_VERSION 4
+#define WIRE_FORMAT_COMPATIBLE_VERSION 2
+
+#define WIRE_FORMAT_MAGIC_OFFSET 0
+#define WIRE_FORMAT_VERSION_OFFSET 1
+#define WIRE_FORMAT_COMPATIBLE_VERSION_OFFSET 2
+#define WIRE_FORMAT_HEADER_SIZE_OFFSET 3
+#define WIRE_FORMAT_SEQUENCE_OFFSET 4
+#define WIRE_FORMAT_TIMESTAMP_OFFSET 6
+#define WIRE_FORMAT_ENTRY_COUNT_OFFSET 10
+#define WIRE_FORMAT_ENTRY_SIZE_OFFSET 11
+#define WIRE_FORMAT_FLAGS_OFFSET 12
+#define WIRE_FORMAT_BOOT_ID_OFFSET 13
+#define WIRE_FORMAT_HEADER_SIZE 15
+#define WIRE_FORMAT_V2_HEADER_SIZE 12
+
+#define WIRE_FORMAT_FLAG_ACK_REQUESTED 0x01
+
+#define WIRE_FORMAT_ENTRY_TIMESTAMP_OFFSET 0
+#define WIRE_FORMAT_ENTRY_STATUS_OFFSET 4
+#define WIRE_FORMAT_ENTRY_TEMPERATURE_OFFSET 5
+#define WIRE_FORMAT_ENTRY_SIZE 9
+
+#define WIRE_FORMAT_CRC_SIZE 2
+
+#define WIRE_FORMAT_ACK_VERSION_OFFSET 1
+#define WIRE_FORMAT_ACK_SEQUENCE_OFFSET 2
+#define WIRE_FORMAT_ACK_SIZE 6
+#define WIRE_FORMAT_MAX_ENTRIES 8
+#define WIRE_FORMAT_MAX_FRAME_SIZE \
+  (WIRE_FORMAT_HEADER_SIZE \
+      + WIRE_FORMAT_MAX_ENTRIES * WIRE_FORMAT_ENTRY_SIZE \
+      + WIRE_FORMAT_CRC_SIZE)
+
+// ESP-NOW payload limit, ESP_NOW_MAX_DATA_LEN
+#define WIRE_FORMAT_MAX_PAYLOAD_SIZE 250
+
+static_assert(
+    WIRE_FORMAT_SEQUENCE_OFFSET + 2 == WIRE_FORMAT_TIMESTAMP_OFFSET
+        && WIRE_FORMAT_TIMESTAMP_OFFSET + 4 == WIRE_FORMAT_ENTRY_COUNT_OFFSET
+        && WIRE_FORMAT_ENTRY_SIZE_OFFSET + 1 == WIRE_FORMAT_FLAGS_OFFSET
+        && WIRE_FORMAT_FLAGS_OFFSET + 1 == WIRE_FORMAT_BOOT_ID_OFFSET
+        && WIRE_FORMAT_BOOT_ID_OFFSET + 2 == WIRE_FORMAT_HEADER_SIZE,
+    "Wire format header fields must be contiguous.");
+static_assert(
+    WIRE_FORMAT_ENTRY_TEMPERATURE_OFFSET + 4 == WIRE_FORMAT_ENTRY_SIZE,
+    "Wire format entry fields must be contiguous.");
+static_assert(
+    WIRE_FORMAT_MAX_FRAME_SIZE <= WIRE_FORMAT_MAX_PAYLOAD_SIZE,
+    "A full frame must fit one ESP-NOW payload.");
+static_assert(
+    WIRE_FORMAT_ACK_SEQUENCE_OFFSET + 2 + WIRE_FORMAT_CRC_SIZE
+        == WIRE_FORMAT_ACK_SIZE,
+    "Acknowledgment fields must be contiguous.");
+static_assert(
+    sizeof(float) == 4,
+    "Temperatures travel as IEEE 754 singles.");
+static_assert(
+    LAST_NOTIFICATION_STATUS <= 0xFF,
+    "Statuses travel as single bytes.");
+
+class WireFormat {
+public:
+  /**
+   * CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF.
+   */
+  static uint16_t crc16(const uint8_t *data, size_t size);
+
+  static uint16_t get_uint16(const uint8_t *source) {
+    return (uint16_t) (source[0] | (source[1] << 8));
+  }
+
+  static uint32_t get_uint32(const uint8_t *source) {
+    return (uint32_t) source[0]
+        | ((uint32_t) source[1] << 8)
+        | ((uint32_t) source[2] << 16)
+        | ((uint32_t) source[3] << 24);
+  }
+
+  static float get_float(const uint8_t *source) {
+    uint32_t bits = get_uint32(source);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  static void put_uint16(uint8_t *destination, uint16_t value) {
+    destination[0] = (uint8_t) value;
+    destination[1] = (uint8_t) (value >> 8);
+  }
+
+  static void put_uint32(uint8_t *destination, uint32_t value) {
+    destination[0] = (uint8_t) value;
+    destination[1] = (uint8_t) (value >> 8);
+    destination[2] = (uint8_t) (value >> 16);
+    destination[3] = (uint8_t) (value >> 24);
+  }
+
+  static void put_float(uint8_t *destination, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_uint32(destination, bits);
+  }
+
+  /**
+   * Writes an acknowledgment of the specified frame sequence number into
+   * a buffer of WIRE_FORMAT_ACK_SIZE bytes.
+   */
+  static void encode_ack(uint8_t *ack, uint16_t sequence);
+
+  /**
+   * Validates a received acknowledgment in place. Returns true and sets
+   * the acknowledged sequence number if it is valid.
+   */
+  static bool decode_ack(
+      const uint8_t *ack,
+      size_t ack_size,
+      uint16_t *sequence);
+};
+
+/**
+ * Read-only view of a received version 2 or later frame. The view never
+ * copies the frame, which must outlive it.
+ */
+class WireFrameView {
+  const uint8_t *frame;
+  const size_t frame_size;
+
+  const uint8_t *entry(size_t index) const {
+    return frame
+        + frame[WIRE_FORMAT_HEADER_SIZE_OFFSET]
+        + index * frame[WIRE_FORMAT_ENTRY_SIZE_OFFSET];
+  }
+
+public:
+  WireFrameView(const uint8_t *frame, size_t frame_size) :
+      frame(frame),
+      frame_size(frame_size) {
+  }
+
+  /**
+   * Returns true if the frame is a well formed frame that this version
+   * can decode and its CRC matches. Invoke this before any accessor.
+   */
+  bool is_valid(void) const;
+
+  uint8_t get_version(void) const {
+    return frame[WIRE_FORMAT_VERSION_OFFSET];
+  }
+
+  uint16_t get_sequence(void) const {
+    return WireFormat::get_uint16(frame + WIRE_FORMAT_SEQUENCE_OFFSET);
+  }
+
+  uint32_t get_timestamp_ms(void) const {
+    return WireFormat::get_uint32(frame + WIRE_FORMAT_TIMESTAMP_OFFSET);
+  }
+
+  size_t get_entry_count(void) const {
+    return frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET];
+  }
+
+  /**
+   * Returns the flags. Version 2 frames have none.
+   */
+  uint8_t get_flags(void) const {
+    return frame[WIRE_FORMAT_HEADER_SIZE_OFFSET] > WIRE_FORMAT_FLAGS_OFFSET
+        ? frame[WIRE_FORMAT_FLAGS_OFFSET]
+        : 0;
+  }
+
+  /**
+   * Returns the sender's boot identifier. Frames older than version 4
+   * have none, and return 0.
+   */
+  uint16_t get_boot_id(void) const {
+    return frame[WIRE_FORMAT_HEADER_SIZE_OFFSET]
+            >= WIRE_FORMAT_BOOT_ID_OFFSET + 2
+        ? WireFormat::get_uint16(frame + WIRE_FORMAT_BOOT_ID_OFFSET)
+        : 0;
+  }
+
+  uint32_t get_entry_timestamp_ms(size_t index) const {
+    return WireFormat::get_uint32(
+        entry(index) + WIRE_FORMAT_ENTRY_TIMESTAMP_OFFSET);
+  }
+
+  /**
+   * Returns the entry's status, which may be LAST_NOTIFICATION_STATUS or
+   * above if the sender is newer. Callers should skip such entries.
+   */
+  uint8_t get_entry_status(size_t index) const {
+    return entry(index)[WIRE_FORMAT_ENTRY_STATUS_OFFSET];
+  }
+
+  float get_entry_temperature_celsius(size_t index) const {
+    return WireFormat::get_float(
+        entry(index) + WIRE_FORMAT_ENTRY_TEMPERATURE_OFFSET);
+  }
+};
+
+#endif /* WIREFORMAT_H_ */
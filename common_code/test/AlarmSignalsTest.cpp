@@ -0,0 +1,241 @@
+/*
+ * AlarmSignalsTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Plays every alarm signal through an LedSequencer, driven the way
+ * LedPatternEngine drives it, and checks its level at every millisecond
+ * against the level and duration tables that AlarmTask stepped through
+ * with vTaskDelay() before the signals moved to the sequencer. Also
+ * checks that a request replaces a signal mid-step, ripples, and
+ * patterns with empty steps.
+ */
+
+#include <string.h>
+
+#include "AlarmSignals.h"
+#include "HostTest.h"
+#include "LedSequencer.h"
+
+#define WAVEFORM_MS 25000  // Two and a half turns of the longest signal
+
+struct LevelAndDuration {
+  uint8_t level;
+  uint32_t duration_ms;
+};
+
+// The tables as AlarmTask played them, each repeated until replaced.
+static const LevelAndDuration OLD_SILENCE[] = {
+  { LED_LEVEL_LOW, 60000 },
+};
+static const LevelAndDuration OLD_DELIVERED[] = {
+  { LED_LEVEL_HIGH, 50 },
+  { LED_LEVEL_LOW, 9950 },
+};
+static const LevelAndDuration OLD_DISCONNECTED[] = {
+  { LED_LEVEL_HIGH, 500 },
+  { LED_LEVEL_LOW, 500 },
+  { LED_LEVEL_HIGH, 500 },
+  { LED_LEVEL_LOW, 500 },
+  { LED_LEVEL_HIGH, 500 },
+  { LED_LEVEL_LOW, 500 },
+  { LED_LEVEL_LOW, 7000 },
+};
+static const LevelAndDuration OLD_LID_OPEN[] = {
+  { LED_LEVEL_HIGH, 50 },
+  { LED_LEVEL_LOW, 50 },
+  { LED_LEVEL_HIGH, 50 },
+  { LED_LEVEL_LOW, 50 },
+  { LED_LEVEL_HIGH, 50 },
+  { LED_LEVEL_LOW, 1250 },
+};
+static const LevelAndDuration OLD_PANIC[] = {
+  { LED_LEVEL_HIGH, 950 },
+  { LED_LEVEL_LOW, 50 },
+};
+
+static uint8_t expected[WAVEFORM_MS];
+static uint8_t actual[WAVEFORM_MS];
+
+/**
+ * Expands an old table into its level at every millisecond.
+ */
+static void expand(const LevelAndDuration *steps, size_t step_count) {
+  size_t t = 0;
+  for (size_t i = 0; t < WAVEFORM_MS; i = (i + 1) % step_count) {
+    for (uint32_t ms = 0; ms < steps[i].duration_ms && t < WAVEFORM_MS;
+        ++ms) {
+      expected[t++] = steps[i].level;
+    }
+  }
+}
+
+/**
+ * Plays a pattern on one channel of a fresh sequencer, advancing by the
+ * time that advance() returns, as LedPatternEngine does. Records the
+ * level at every millisecond and checks the change mask on the way.
+ */
+static void play(const LedPattern *pattern, size_t channel) {
+  LedSequencer sequencer;
+  sequencer.request(channel, pattern);
+  uint32_t changed;
+  uint32_t next_change_ms = sequencer.advance(0, &changed);
+  HOST_CHECK(
+      (changed == 0) == (sequencer.get_level(channel) == LED_LEVEL_LOW));
+  size_t t = 0;
+  while (t < WAVEFORM_MS) {
+    uint8_t level = sequencer.get_level(channel);
+    uint32_t hold_ms = next_change_ms;
+    for (; hold_ms && t < WAVEFORM_MS; --hold_ms) {
+      actual[t++] = level;
+    }
+    if (next_change_ms == LED_SEQUENCER_IDLE) {
+      break;
+    }
+    HOST_CHECK(next_change_ms);
+    next_change_ms = sequencer.advance(next_change_ms, &changed);
+    HOST_CHECK(!(changed & ~((uint32_t) 1 << channel)));
+    HOST_CHECK(!!changed == (sequencer.get_level(channel) != level));
+  }
+}
+
+/**
+ * Plays a pattern one millisecond at a time, as a polling owner would.
+ */
+static void play_by_millisecond(const LedPattern *pattern) {
+  LedSequencer sequencer;
+  sequencer.request(0, pattern);
+  uint32_t changed;
+  sequencer.advance(0, &changed);
+  for (size_t t = 0; t < WAVEFORM_MS; ++t) {
+    actual[t] = sequencer.get_level(0);
+    sequencer.advance(1, &changed);
+  }
+}
+
+static void check_signal(
+    const char *name,
+    const LedPattern *pattern,
+    const LevelAndDuration *old_steps,
+    size_t old_step_count) {
+  expand(old_steps, old_step_count);
+  play(pattern, 0);
+  bool matches = !memcmp(expected, actual, WAVEFORM_MS);
+  play(pattern, LED_SEQUENCER_CHANNELS - 1);
+  matches &= !memcmp(expected, actual, WAVEFORM_MS);
+  play_by_millisecond(pattern);
+  matches &= !memcmp(expected, actual, WAVEFORM_MS);
+  if (!matches) {
+    fprintf(stderr, "%s differs from the old table.\n", name);
+  }
+  HOST_CHECK(matches);
+}
+
+#define CHECK_SIGNAL(pattern, old_steps) \
+  check_signal( \
+      #pattern, \
+      &pattern, \
+      old_steps, \
+      sizeof(old_steps) / sizeof(old_steps[0]))
+
+static void test_replacement(void) {
+  // Deep in the seven second tail of the disconnected alarm.
+  LedSequencer sequencer;
+  uint32_t changed;
+  sequencer.request(0, &disconnected_alarm);
+  sequencer.advance(0, &changed);
+  uint32_t next_change_ms = 0;
+  for (uint32_t t = 0; t < 4000; t += next_change_ms) {
+    next_change_ms = sequencer.advance(next_change_ms, &changed);
+  }
+  HOST_CHECK(sequencer.get_level(0) == LED_LEVEL_LOW);
+  HOST_CHECK(1000 < next_change_ms);
+
+  // The lid opens: the chirps start now, not when the tail ends.
+  sequencer.advance(10, &changed);
+  sequencer.request(0, &lid_open_signal);
+  next_change_ms = sequencer.advance(0, &changed);
+  HOST_CHECK(changed == 1);
+  HOST_CHECK(sequencer.get_level(0) == LED_LEVEL_HIGH);
+  HOST_CHECK(next_change_ms == 50);
+
+  // The last request before an advance wins.
+  sequencer.request(0, &panic_alarm_signal);
+  sequencer.request(0, &silent_alarm);
+  next_change_ms = sequencer.advance(20, &changed);
+  HOST_CHECK(changed == 1);
+  HOST_CHECK(sequencer.get_level(0) == LED_LEVEL_LOW);
+  HOST_CHECK(next_change_ms == LED_SEQUENCER_IDLE);
+}
+
+static void test_ripple(void) {
+  // Four channels blink in turn, 100 ms apart.
+  static const LedStep RIPPLE_STEPS[4][3] = {
+    { { LED_LEVEL_LOW, 0 }, { LED_LEVEL_HIGH, 100 }, { LED_LEVEL_LOW, 300 } },
+    { { LED_LEVEL_LOW, 100 }, { LED_LEVEL_HIGH, 100 }, { LED_LEVEL_LOW, 300 } },
+    { { LED_LEVEL_LOW, 200 }, { LED_LEVEL_HIGH, 100 }, { LED_LEVEL_LOW, 300 } },
+    { { LED_LEVEL_LOW, 300 }, { LED_LEVEL_HIGH, 100 }, { LED_LEVEL_LOW, 300 } },
+  };
+  static const LedPattern RIPPLE[4] = {
+    { RIPPLE_STEPS[0], 3, 1 },
+    { RIPPLE_STEPS[1], 3, 1 },
+    { RIPPLE_STEPS[2], 3, 1 },
+    { RIPPLE_STEPS[3], 3, 1 },
+  };
+  LedSequencer sequencer;
+  for (size_t i = 0; i < 4; ++i) {
+    sequencer.request(i, RIPPLE + i);
+  }
+  uint32_t changed;
+  uint32_t next_change_ms = sequencer.advance(0, &changed);
+  HOST_CHECK(changed == 1);
+  bool in_turn = true;
+  for (uint32_t t = 0; t < 4000; t += next_change_ms) {
+    // Exactly one channel is lit, in turn, every 100 ms.
+    size_t lit = (t / 100) % 4;
+    for (size_t i = 0; i < 4; ++i) {
+      in_turn &= sequencer.get_level(i) == (i == lit);
+    }
+    HOST_CHECK(next_change_ms == 100);
+    next_change_ms = sequencer.advance(next_change_ms, &changed);
+  }
+  HOST_CHECK(in_turn);
+}
+
+static void test_empty_steps(void) {
+  // A repeating section with no duration holds instead of spinning.
+  static const LedStep EMPTY_STEPS[] = {
+    { LED_LEVEL_HIGH, 0 },
+    { LED_LEVEL_LOW, 0 },
+  };
+  static const LedPattern EMPTY = { EMPTY_STEPS, 2, 0 };
+  static const LedPattern NO_STEPS = { EMPTY_STEPS, 0, 0 };
+  LedSequencer sequencer;
+  uint32_t changed;
+  sequencer.request(0, &EMPTY);
+  sequencer.request(1, &LED_PATTERN_ON);
+  HOST_CHECK(sequencer.advance(0, &changed) == LED_SEQUENCER_IDLE);
+  HOST_CHECK(changed & 2);
+  sequencer.request(1, &NO_STEPS);
+  HOST_CHECK(sequencer.advance(1000, &changed) == LED_SEQUENCER_IDLE);
+  HOST_CHECK(sequencer.get_level(1) == LED_LEVEL_LOW);
+
+  // Requests for channels that do not exist are dropped.
+  sequencer.request(LED_SEQUENCER_CHANNELS, &LED_PATTERN_ON);
+  sequencer.request(2, NULL);
+  HOST_CHECK(sequencer.advance(0, &changed) == LED_SEQUENCER_IDLE);
+  HOST_CHECK(!changed);
+}
+
+int main() {
+  CHECK_SIGNAL(silent_alarm, OLD_SILENCE);
+  CHECK_SIGNAL(delivered_alarm, OLD_DELIVERED);
+  CHECK_SIGNAL(disconnected_alarm, OLD_DISCONNECTED);
+  CHECK_SIGNAL(lid_open_signal, OLD_LID_OPEN);
+  CHECK_SIGNAL(panic_alarm_signal, OLD_PANIC);
+  test_replacement();
+  test_ripple();
+  test_empty_steps();
+  return host_test_result("AlarmSignalsTest");
+}
@@ -0,0 +1,399 @@
+/*
+ * Hd44780EncoderTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Feeds the Hd44780Encoder byte stream into a model of a PCF8574
+ * backpack and HD44780 controller, and checks that the controller ends
+ * up in the right mode with the right characters in its display RAM:
+ * after the initialization sequence, after direct writes, and after
+ * LcdFramebuffer flushes of seeded random screens.
+ *
+ * Then counts the bytes and I2C transactions per full-screen update for
+ * the LiquidCrystal_I2C library, which sends every byte as a
+ * transaction of its own, for BufferedI2cLcd, and for BufferedI2cLcd
+ * behind an LcdFramebuffer.
+ */
+
+#include <string.h>
+
+#include "HostTest.h"
+#include "Hd44780Encoder.h"
+#include "LcdFramebuffer.h"
+#include "LcdWriter.h"
+
+#define DDRAM_SIZE 0x80
+#define ROW_1_ADDRESS 0x40
+#define TRANSACTION_BYTES (20 * HD44780_BYTES_PER_TRANSFER)  // As in BufferedI2cLcd
+#define RANDOM_SCREENS 20000
+
+/**
+ * A PCF8574 backpack and HD44780 controller, as seen from the I2C bus.
+ * Latches D4-D7 and RS on each falling edge of EN.
+ */
+class Hd44780Model {
+public:
+  char ddram[DDRAM_SIZE];
+  uint8_t address;
+  bool four_bit;
+  bool two_lines;
+  bool display_on;
+  bool increment;
+  bool has_high_nibble;  // 4-bit mode: waiting for the low nibble
+  uint8_t high_nibble;
+  uint8_t outputs;
+  bool backlight_seen_off;
+  uint32_t read_strobes;  // Strobes with R/W high, which must not occur
+
+  Hd44780Model() :
+      address(0),
+      four_bit(false),
+      two_lines(false),
+      display_on(false),
+      increment(false),
+      has_high_nibble(false),
+      high_nibble(0),
+      outputs(0),
+      backlight_seen_off(false),
+      read_strobes(0) {
+    memset(ddram, ' ', sizeof(ddram));
+  }
+
+  void on_byte(uint8_t value) {
+    if (!(value & HD44780_PCF8574_BACKLIGHT)) {
+      backlight_seen_off = true;
+    }
+    bool falling_edge = (outputs & HD44780_PCF8574_EN)
+        && !(value & HD44780_PCF8574_EN);
+    outputs = value;
+    if (!falling_edge) {
+      return;
+    }
+    if (value & 0x02) {
+      ++read_strobes;
+      return;
+    }
+    bool rs = value & HD44780_PCF8574_RS;
+    uint8_t nibble = value & 0xF0;
+    if (!four_bit) {
+      // 8-bit mode: D0-D3 are not wired and read as 0.
+      execute(rs, nibble);
+    } else if (!has_high_nibble) {
+      high_nibble = nibble;
+      has_high_nibble = true;
+    } else {
+      has_high_nibble = false;
+      execute(rs, high_nibble | (nibble >> 4));
+    }
+  }
+
+  void on_transaction(const uint8_t *bytes, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+      on_byte(bytes[i]);
+    }
+  }
+
+  void execute(bool rs, uint8_t value) {
+    if (rs) {
+      ddram[address] = (char) value;
+      address = (address + (increment ? 1 : -1)) & (DDRAM_SIZE - 1);
+    } else if (value & HD44780_SET_DDRAM_ADDRESS) {
+      address = value & (DDRAM_SIZE - 1);
+    } else if (value & HD44780_FUNCTION_SET) {
+      four_bit = !(value & 0x10);
+      two_lines = value & HD44780_TWO_LINES;
+    } else if (value & HD44780_DISPLAY_CONTROL) {
+      display_on = value & HD44780_DISPLAY_ON;
+    } else if (value & HD44780_ENTRY_MODE_SET) {
+      increment = value & HD44780_ENTRY_INCREMENT;
+    } else if (value & HD44780_RETURN_HOME) {
+      address = 0;
+    } else if (value & HD44780_CLEAR_DISPLAY) {
+      memset(ddram, ' ', sizeof(ddram));
+      address = 0;
+      increment = true;
+    }
+  }
+
+  /**
+   * Returns true if a row of the display shows the specified text.
+   */
+  bool row_shows(uint8_t row, const char *text) const {
+    return !memcmp(
+        ddram + (row ? ROW_1_ADDRESS : 0),
+        text,
+        LCD_FRAMEBUFFER_COLUMNS);
+  }
+};
+
+/**
+ * The host counterpart of BufferedI2cLcd: batches the encoder's output
+ * the same way and delivers each transaction to the model.
+ */
+class SimulatedI2cLcd : public LcdWriter {
+  uint8_t transaction[TRANSACTION_BYTES];
+  Hd44780Encoder encoder;
+
+public:
+  Hd44780Model model;
+  uint32_t transactions;
+  uint32_t bytes_sent;
+
+  SimulatedI2cLcd() :
+      encoder(transaction, sizeof(transaction)),
+      transactions(0),
+      bytes_sent(0) {
+  }
+
+  void send(void) {
+    size_t length = encoder.get_length();
+    if (length) {
+      model.on_transaction(encoder.get_bytes(), length);
+      ++transactions;
+      bytes_sent += length;
+      encoder.clear();
+    }
+  }
+
+  void init(void) {
+    encoder.clear();
+    encoder.set_backlight(true);
+    encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+    send();
+    encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+    send();
+    encoder.nibble(HD44780_FUNCTION_SET | 0x10);
+    encoder.nibble(HD44780_FUNCTION_SET);
+    encoder.command(HD44780_FUNCTION_SET | HD44780_TWO_LINES);
+    encoder.command(HD44780_DISPLAY_CONTROL | HD44780_DISPLAY_ON);
+    encoder.command(HD44780_ENTRY_MODE_SET | HD44780_ENTRY_INCREMENT);
+    send();
+    encoder.command(HD44780_CLEAR_DISPLAY);
+    send();
+  }
+
+  virtual void set_cursor(uint8_t column, uint8_t row) {
+    if (!encoder.get_room()) {
+      send();
+    }
+    encoder.set_cursor(column, row);
+  }
+
+  virtual void write(const char *text, size_t length) {
+    for (;;) {
+      size_t count = encoder.text(text, length);
+      text += count;
+      length -= count;
+      if (!length) {
+        break;
+      }
+      send();
+    }
+    send();
+  }
+
+  void reset_counts(void) {
+    transactions = 0;
+    bytes_sent = 0;
+  }
+};
+
+static void test_encoding(void) {
+  uint8_t bytes[2 * HD44780_BYTES_PER_TRANSFER];
+  Hd44780Encoder encoder(bytes, sizeof(bytes));
+  HOST_CHECK(encoder.get_room() == 2);
+  HOST_CHECK(encoder.data('A'));
+  // 'A' is 0x41: high nibble 4, then low nibble 1, each strobed.
+  static const uint8_t A[] = {
+    0x49, 0x4D, 0x49, 0x19, 0x1D, 0x19,
+  };
+  HOST_CHECK(encoder.get_length() == sizeof(A));
+  HOST_CHECK(!memcmp(bytes, A, sizeof(A)));
+
+  encoder.set_backlight(false);
+  HOST_CHECK(encoder.set_cursor(3, 1));
+  // Set DDRAM address 0x43, RS low, backlight off.
+  static const uint8_t CURSOR[] = {
+    0xC0, 0xC4, 0xC0, 0x30, 0x34, 0x30,
+  };
+  HOST_CHECK(!memcmp(bytes + sizeof(A), CURSOR, sizeof(CURSOR)));
+  HOST_CHECK(!encoder.get_room());
+  HOST_CHECK(!encoder.command(HD44780_RETURN_HOME));
+  HOST_CHECK(!encoder.data('B'));
+  HOST_CHECK(!encoder.text("CD", 2));
+  HOST_CHECK(encoder.get_length() == sizeof(bytes));
+
+  encoder.clear();
+  HOST_CHECK(encoder.text("abc", 3) == 2);
+}
+
+static void test_initialization(void) {
+  SimulatedI2cLcd lcd;
+  memset(lcd.model.ddram, '#', sizeof(lcd.model.ddram));
+  lcd.init();
+  HOST_CHECK(lcd.model.four_bit);
+  HOST_CHECK(lcd.model.two_lines);
+  HOST_CHECK(lcd.model.display_on);
+  HOST_CHECK(lcd.model.increment);
+  HOST_CHECK(!lcd.model.has_high_nibble);
+  HOST_CHECK(lcd.model.row_shows(0, "                "));
+  HOST_CHECK(lcd.model.row_shows(1, "                "));
+
+  // A controller left in 4-bit mode halfway through a byte, e.g. by a
+  // reset of the ESP32 alone, comes back the same way.
+  SimulatedI2cLcd stuck;
+  stuck.model.four_bit = true;
+  stuck.model.has_high_nibble = true;
+  stuck.init();
+  HOST_CHECK(stuck.model.four_bit);
+  HOST_CHECK(stuck.model.two_lines);
+  HOST_CHECK(stuck.model.display_on);
+  HOST_CHECK(!stuck.model.has_high_nibble);
+
+  lcd.set_cursor(0, 0);
+  lcd.write("Lid closed      ", LCD_FRAMEBUFFER_COLUMNS);
+  lcd.set_cursor(11, 1);
+  lcd.write("12:34", 5);
+  HOST_CHECK(lcd.model.row_shows(0, "Lid closed      "));
+  HOST_CHECK(lcd.model.row_shows(1, "           12:34"));
+  HOST_CHECK(!lcd.model.backlight_seen_off);
+  HOST_CHECK(!lcd.model.read_strobes);
+}
+
+/**
+ * Seeded randomness, identical on every host.
+ */
+static uint32_t random_state = 12345;
+
+static uint32_t next_random(void) {
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 16) & 0x7FFF;
+}
+
+static void test_framebuffer(void) {
+  SimulatedI2cLcd lcd;
+  lcd.init();
+  LcdFramebuffer framebuffer;
+  framebuffer.reset();
+  char expected[LCD_FRAMEBUFFER_ROWS][LCD_FRAMEBUFFER_COLUMNS];
+  memset(expected, ' ', sizeof(expected));
+  bool matches = true;
+  for (uint32_t screen = 0; screen < RANDOM_SCREENS; ++screen) {
+    // A few short prints, some of them clipped at the end of the row.
+    for (uint32_t prints = next_random() % 4; prints; --prints) {
+      uint8_t column = next_random() % (LCD_FRAMEBUFFER_COLUMNS + 2);
+      uint8_t row = next_random() % LCD_FRAMEBUFFER_ROWS;
+      char text[8];
+      size_t length = next_random() % sizeof(text);
+      for (size_t i = 0; i < length; ++i) {
+        text[i] = (char) ('0' + next_random() % 4);
+      }
+      text[length] = '\0';
+      framebuffer.set_cursor(column, row);
+      framebuffer.print(text);
+      for (size_t i = 0; i < length && column + i < LCD_FRAMEBUFFER_COLUMNS;
+          ++i) {
+        expected[row][column + i] = text[i];
+      }
+    }
+    framebuffer.flush(lcd);
+    HOST_CHECK(!framebuffer.is_dirty());
+    for (uint8_t row = 0; row < LCD_FRAMEBUFFER_ROWS; ++row) {
+      matches &= lcd.model.row_shows(row, expected[row]);
+    }
+  }
+  HOST_CHECK(matches);
+  HOST_CHECK(!lcd.model.read_strobes);
+  HOST_CHECK(framebuffer.get_sent_transfers()
+      < framebuffer.get_requested_transfers());
+}
+
+static const char *const SCREEN_A[LCD_FRAMEBUFFER_ROWS] = {
+  "Lid closed      ",
+  "Box 1 up   12:34",
+};
+static const char *const SCREEN_B[LCD_FRAMEBUFFER_ROWS] = {
+  "MILK DELIVERED! ",
+  "Temp 3.5C  12:35",
+};
+
+static void draw(LcdFramebuffer &framebuffer, const char *const *screen) {
+  for (uint8_t row = 0; row < LCD_FRAMEBUFFER_ROWS; ++row) {
+    framebuffer.set_cursor(0, row);
+    framebuffer.print(screen[row]);
+  }
+}
+
+static void report_update_costs(void) {
+  // Two cursor moves and 32 characters, each two strobed nibbles. The
+  // LiquidCrystal_I2C library writes each byte as its own transaction.
+  uint32_t unbuffered_bytes =
+      (LCD_FRAMEBUFFER_ROWS * (1 + LCD_FRAMEBUFFER_COLUMNS))
+          * HD44780_BYTES_PER_TRANSFER;
+
+  SimulatedI2cLcd direct;
+  direct.init();
+  direct.reset_counts();
+  for (uint8_t row = 0; row < LCD_FRAMEBUFFER_ROWS; ++row) {
+    direct.set_cursor(0, row);
+    direct.write(SCREEN_B[row], LCD_FRAMEBUFFER_COLUMNS);
+  }
+  HOST_CHECK(direct.model.row_shows(0, SCREEN_B[0]));
+  HOST_CHECK(direct.model.row_shows(1, SCREEN_B[1]));
+  HOST_CHECK(direct.bytes_sent == unbuffered_bytes);
+  HOST_CHECK(direct.transactions == LCD_FRAMEBUFFER_ROWS);
+
+  SimulatedI2cLcd lcd;
+  lcd.init();
+  LcdFramebuffer framebuffer;
+  framebuffer.reset();
+  draw(framebuffer, SCREEN_A);
+  framebuffer.flush(lcd);
+
+  // Every cell that differs between the two screens.
+  lcd.reset_counts();
+  draw(framebuffer, SCREEN_B);
+  framebuffer.flush(lcd);
+  HOST_CHECK(lcd.model.row_shows(0, SCREEN_B[0]));
+  HOST_CHECK(lcd.model.row_shows(1, SCREEN_B[1]));
+  uint32_t changed_bytes = lcd.bytes_sent;
+  uint32_t changed_transactions = lcd.transactions;
+
+  // The same screen again: nothing to send.
+  lcd.reset_counts();
+  draw(framebuffer, SCREEN_B);
+  framebuffer.flush(lcd);
+  HOST_CHECK(!lcd.bytes_sent);
+
+  // The clock ticks over.
+  draw(framebuffer, SCREEN_A);
+  framebuffer.flush(lcd);
+  lcd.reset_counts();
+  framebuffer.set_cursor(0, 1);
+  framebuffer.print("Box 1 up   12:35");
+  framebuffer.flush(lcd);
+  HOST_CHECK(lcd.bytes_sent == 2 * HD44780_BYTES_PER_TRANSFER);
+  HOST_CHECK(lcd.transactions == 1);
+
+  printf(
+      "Full-screen update: LiquidCrystal_I2C %u bytes in %u transactions,"
+      " BufferedI2cLcd %u bytes in %u, with LcdFramebuffer %u bytes in %u."
+      " Clock tick: %u bytes in %u.\n",
+      (unsigned) unbuffered_bytes,
+      (unsigned) unbuffered_bytes,
+      (unsigned) direct.bytes_sent,
+      (unsigned) direct.transactions,
+      (unsigned) changed_bytes,
+      (unsigned) changed_transactions,
+      (unsigned) lcd.bytes_sent,
+      (unsigned) lcd.transactions);
+}
+
+int main() {
+  test_encoding();
+  test_initialization();
+  test_framebuffer();
+  report_update_costs();
+  return host_test_result("Hd44780EncoderTest");
+}
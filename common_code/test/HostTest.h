@@ -0,0 +1,63 @@
+/*
+ * HostTest.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Minimal support for the host test programs: checks that count failures
+ * instead of aborting, a result line for CTest, and a monotonic clock for
+ * benchmarks. Each test program is a single translation unit.
+ */
+
+#ifndef HOSTTEST_H_
+#define HOSTTEST_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+static int host_test_failures = 0;
+
+/**
+ * Records a failure, with its location, if the condition is false.
+ */
+#define HOST_CHECK(condition) \
+  host_check((condition), #condition, __FILE__, __LINE__)
+
+static inline void host_check(
+    bool passed,
+    const char *condition,
+    const char *file,
+    int line) {
+  if (!passed) {
+    ++host_test_failures;
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+  }
+}
+
+/**
+ * Prints the result and returns the process exit status.
+ */
+static inline int host_test_result(const char *name) {
+  printf(
+      "%s: %s\n",
+      name,
+      host_test_failures ? "FAILED" : "passed");
+  return host_test_failures ? 1 : 0;
+}
+
+/**
+ * Returns a monotonic time in nanoseconds.
+ */
+static inline uint64_t host_nanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+ * Keeps the compiler from optimizing away a benchmark result.
+ */
+static volatile uint32_t host_benchmark_sink;
+
+#endif /* HOSTTEST_H_ */
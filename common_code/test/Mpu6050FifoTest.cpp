@@ -0,0 +1,114 @@
+/*
+ * Mpu6050FifoTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Parses MPU6050 register dumps, laid out as the FIFO count and FIFO
+ * data burst reads return them, and integrates the samples into angles.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "HostTest.h"
+#include "Mpu6050AngleIntegrator.h"
+#include "Mpu6050Fifo.h"
+
+#define SAMPLE_RATE_HZ 100
+
+// FIFO_COUNTH, FIFO_COUNTL: 41 bytes, three frames and five stray bytes.
+static const uint8_t FIFO_COUNT_DUMP[] = {0x00, 0x29};
+
+// FIFO_R_W burst, box at rest: accelerometer X, Y, Z, then gyroscope
+// X, Y, Z, big-endian, with a little noise. The last frame is cut off.
+static const uint8_t LEVEL_FIFO_DUMP[] = {
+  0x00, 0x12, 0xFF, 0xEE, 0x40, 0x10, 0x00, 0x03, 0xFF, 0xFD, 0x00, 0x01,
+  0x00, 0x0C, 0xFF, 0xF4, 0x3F, 0xF0, 0xFF, 0xFE, 0x00, 0x02, 0x00, 0x00,
+  0xFF, 0xFA, 0x00, 0x08, 0x40, 0x04, 0x00, 0x01, 0x00, 0x00, 0xFF, 0xFF,
+  0x00, 0x10, 0xFF, 0xF0, 0x40,
+};
+
+// FIFO_R_W burst, lid raised 45 degrees about X and held still.
+static const uint8_t TILTED_FIFO_DUMP[] = {
+  0x00, 0x00, 0x2D, 0x41, 0x2D, 0x41, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x00, 0x04, 0x2D, 0x3D, 0x2D, 0x45, 0x00, 0x01, 0xFF, 0xFF, 0x00, 0x00,
+};
+
+static void test_count_and_rate(void) {
+  uint16_t count = Mpu6050Fifo::fifo_count(FIFO_COUNT_DUMP);
+  HOST_CHECK(count == 41);
+  HOST_CHECK(Mpu6050Fifo::whole_frames(count) == 3);
+  HOST_CHECK(Mpu6050Fifo::sample_rate_divider(1000) == 0);
+  HOST_CHECK(Mpu6050Fifo::sample_rate_divider(100) == 9);
+  HOST_CHECK(Mpu6050Fifo::sample_rate_divider(1) == 249);
+  HOST_CHECK(Mpu6050Fifo::sample_rate_divider(8000) == 0);
+}
+
+static void test_parse(void) {
+  Mpu6050RawSample samples[8];
+  size_t count = Mpu6050Fifo::parse(
+      LEVEL_FIFO_DUMP, sizeof(LEVEL_FIFO_DUMP), samples, 8);
+  HOST_CHECK(count == 3);
+  HOST_CHECK(samples[0].accel_x == 18);
+  HOST_CHECK(samples[0].accel_y == -18);
+  HOST_CHECK(samples[0].accel_z == 16400);
+  HOST_CHECK(samples[0].gyro_x == 3);
+  HOST_CHECK(samples[0].gyro_y == -3);
+  HOST_CHECK(samples[0].gyro_z == 1);
+  HOST_CHECK(samples[1].accel_z == 16368);
+  HOST_CHECK(samples[2].accel_x == -6);
+  HOST_CHECK(samples[2].gyro_z == -1);
+
+  // A short sample buffer stops the parse.
+  HOST_CHECK(Mpu6050Fifo::parse(
+      LEVEL_FIFO_DUMP, sizeof(LEVEL_FIFO_DUMP), samples, 2) == 2);
+  HOST_CHECK(Mpu6050Fifo::parse(LEVEL_FIFO_DUMP, 11, samples, 8) == 0);
+}
+
+/**
+ * Feeds a dump to the integrator repeatedly.
+ */
+static void replay(
+    Mpu6050AngleIntegrator& integrator,
+    const uint8_t *dump,
+    size_t dump_size,
+    size_t repeats) {
+  Mpu6050RawSample samples[8];
+  size_t count = Mpu6050Fifo::parse(dump, dump_size, samples, 8);
+  for (size_t i = 0; i < repeats; ++i) {
+    for (size_t j = 0; j < count; ++j) {
+      integrator.update(samples[j]);
+    }
+  }
+}
+
+static void test_integration(void) {
+  OrientationFilter::Calibration calibration = {
+    16384.0f, 65.5f, 0, 0, 0, 0, 0, 0,
+  };
+  Mpu6050AngleIntegrator integrator(SAMPLE_RATE_HZ, 0.98f);
+  integrator.calibrate(calibration);
+
+  replay(integrator, LEVEL_FIFO_DUMP, sizeof(LEVEL_FIFO_DUMP), 100);
+  HOST_CHECK(integrator.get_sample_count() == 300);
+  HOST_CHECK(fabsf(integrator.get_angle_x()) < 0.5f);
+  HOST_CHECK(fabsf(integrator.get_angle_y()) < 0.5f);
+  HOST_CHECK(16300 < integrator.get_gravity().z);
+
+  // The complementary filter converges with a time constant of about 50
+  // samples, so 500 samples settle it.
+  replay(integrator, TILTED_FIFO_DUMP, sizeof(TILTED_FIFO_DUMP), 250);
+  HOST_CHECK(fabsf(integrator.get_angle_x() - 45.0f) < 0.5f);
+  HOST_CHECK(fabsf(integrator.get_angle_y()) < 0.5f);
+  HOST_CHECK(abs(integrator.get_roll_centidegrees() - 4500) < 50);
+  OrientationFilter::Gravity gravity = integrator.get_gravity();
+  HOST_CHECK(abs(gravity.y - gravity.z) < 16);
+}
+
+int main() {
+  test_count_and_rate();
+  test_parse();
+  test_integration();
+  return host_test_result("Mpu6050FifoTest");
+}
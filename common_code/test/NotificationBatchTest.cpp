@@ -0,0 +1,171 @@
+/*
+ * NotificationBatchTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Checks batching and unbatching of notifications, then compares the
+ * encode and decode throughput of full batches with that of one
+ * notification per frame.
+ */
+
+#include <string.h>
+
+#include "HostTest.h"
+#include "NotificationBatch.h"
+
+#define BENCHMARK_NOTIFICATIONS 4000000
+
+static void test_batching(void) {
+  NotificationBatchEncoder encoder;
+  HOST_CHECK(encoder.is_empty());
+  HOST_CHECK(encoder.ms_until_due(0, 100) == UINT32_MAX);
+
+  MotionNotificationMessage message = {LID_HAS_NOT_MOVED, 20.0f};
+  for (size_t i = 0; i < NOTIFICATION_BATCH_MAX_ENTRIES; ++i) {
+    message.temperature_celsius = 20.0f + i;
+    HOST_CHECK(encoder.add(message, 1000 + i, false));
+  }
+  HOST_CHECK(encoder.is_full());
+  HOST_CHECK(!encoder.add(message, 2000, false));
+  HOST_CHECK(!encoder.requests_ack());
+
+  // The deadline runs from the oldest entry.
+  HOST_CHECK(encoder.ms_until_due(1040, 100) == 60);
+  HOST_CHECK(encoder.ms_until_due(1100, 100) == 0);
+  HOST_CHECK(encoder.ms_until_due(1500, 100) == 0);
+
+  uint16_t first = encoder.seal(1100);
+  HOST_CHECK(encoder.get_frame_size()
+      == WIRE_FORMAT_HEADER_SIZE
+          + NOTIFICATION_BATCH_MAX_ENTRIES * WIRE_FORMAT_ENTRY_SIZE
+          + WIRE_FORMAT_CRC_SIZE);
+
+  TimestampedNotification decoded[NOTIFICATION_BATCH_MAX_ENTRIES + 1];
+  ReceivedFrameInfo info;
+  size_t count = NotificationBatchDecoder::decode(
+      encoder.get_frame(),
+      encoder.get_frame_size(),
+      decoded,
+      NOTIFICATION_BATCH_MAX_ENTRIES + 1,
+      &info);
+  HOST_CHECK(count == NOTIFICATION_BATCH_MAX_ENTRIES);
+  HOST_CHECK(info.has_sequence);
+  HOST_CHECK(info.sequence == first);
+  HOST_CHECK(info.sent_ms == 1100);
+  HOST_CHECK(!info.ack_requested);
+  for (size_t i = 0; i < count; ++i) {
+    HOST_CHECK(decoded[i].timestamp_ms == 1000 + i);
+    HOST_CHECK(decoded[i].message.status == LID_HAS_NOT_MOVED);
+    HOST_CHECK(decoded[i].message.temperature_celsius == 20.0f + i);
+  }
+
+  // A short buffer takes the oldest entries.
+  HOST_CHECK(NotificationBatchDecoder::decode(
+      encoder.get_frame(), encoder.get_frame_size(), decoded, 3) == 3);
+  HOST_CHECK(decoded[2].timestamp_ms == 1002);
+
+  // Only changes ask for acknowledgment, and clearing forgets the flag.
+  encoder.clear();
+  message.status = LID_RAISED;
+  encoder.add(message, 3000, true);
+  HOST_CHECK(encoder.requests_ack());
+  HOST_CHECK(encoder.seal(3000) == (uint16_t) (first + 1));
+  encoder.clear();
+  HOST_CHECK(encoder.is_empty());
+  HOST_CHECK(!encoder.requests_ack());
+  encoder.add(message, 3100, false);
+  encoder.request_ack();
+  HOST_CHECK(encoder.requests_ack());
+}
+
+static void test_legacy_frames(void) {
+  MotionNotificationMessage message = {LID_RAISED, 18.5f};
+  TimestampedNotification decoded[1];
+  HOST_CHECK(NotificationBatchDecoder::decode(
+      (const uint8_t *) &message, sizeof(message), decoded, 1) == 1);
+  HOST_CHECK(decoded[0].timestamp_ms == 0);
+  HOST_CHECK(decoded[0].message.status == LID_RAISED);
+  HOST_CHECK(decoded[0].message.temperature_celsius == 18.5f);
+  HOST_CHECK(!NotificationBatchDecoder::decode(
+      (const uint8_t *) &message, sizeof(message) - 1, decoded, 1));
+
+  // Unknown statuses are skipped.
+  message.status = LAST_NOTIFICATION_STATUS;
+  HOST_CHECK(!NotificationBatchDecoder::decode(
+      (const uint8_t *) &message, sizeof(message), decoded, 1));
+}
+
+/**
+ * Encodes and decodes BENCHMARK_NOTIFICATIONS notifications, entries per
+ * frame at a time, and reports the rates.
+ */
+static void benchmark(size_t entries) {
+  NotificationBatchEncoder encoder;
+  TimestampedNotification decoded[NOTIFICATION_BATCH_MAX_ENTRIES];
+  MotionNotificationMessage message = {LID_HAS_NOT_MOVED, 21.0f};
+  uint32_t frames = 0;
+  uint64_t bytes = 0;
+  uint32_t received = 0;
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_NOTIFICATIONS; i += entries) {
+    encoder.clear();
+    for (size_t j = 0; j < entries; ++j) {
+      encoder.add(message, i + j, false);
+    }
+    encoder.seal(i);
+    ++frames;
+    bytes += encoder.get_frame_size();
+    received += NotificationBatchDecoder::decode(
+        encoder.get_frame(),
+        encoder.get_frame_size(),
+        decoded,
+        NOTIFICATION_BATCH_MAX_ENTRIES);
+  }
+  double seconds = (host_nanoseconds() - start) / 1e9;
+  host_benchmark_sink = received;
+  HOST_CHECK(received == BENCHMARK_NOTIFICATIONS);
+  printf(
+      "%u per frame: %.0f frames/s, %.1f MB/s, %.1f bytes per"
+      " notification, %.0f notifications/s.\n",
+      (unsigned) entries,
+      frames / seconds,
+      bytes / seconds / 1e6,
+      (double) bytes / BENCHMARK_NOTIFICATIONS,
+      BENCHMARK_NOTIFICATIONS / seconds);
+}
+
+/**
+ * Decodes BENCHMARK_NOTIFICATIONS bare MotionNotificationMessage frames,
+ * the format that preceded batching.
+ */
+static void benchmark_legacy(void) {
+  TimestampedNotification decoded[1];
+  MotionNotificationMessage message = {LID_HAS_NOT_MOVED, 21.0f};
+  uint8_t frame[sizeof(message)];
+  uint32_t received = 0;
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_NOTIFICATIONS; ++i) {
+    message.temperature_celsius = (float) (i & 31);
+    memcpy(frame, &message, sizeof(frame));
+    received += NotificationBatchDecoder::decode(
+        frame, sizeof(frame), decoded, 1);
+  }
+  double seconds = (host_nanoseconds() - start) / 1e9;
+  host_benchmark_sink = received;
+  HOST_CHECK(received == BENCHMARK_NOTIFICATIONS);
+  printf(
+      "Legacy: %.0f frames/s, %.1f MB/s, %u bytes per notification.\n",
+      BENCHMARK_NOTIFICATIONS / seconds,
+      BENCHMARK_NOTIFICATIONS * sizeof(frame) / seconds / 1e6,
+      (unsigned) sizeof(frame));
+}
+
+int main() {
+  test_batching();
+  test_legacy_frames();
+  benchmark_legacy();
+  benchmark(1);
+  benchmark(NOTIFICATION_BATCH_MAX_ENTRIES);
+  return host_test_result("NotificationBatchTest");
+}
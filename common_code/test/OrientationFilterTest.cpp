@@ -0,0 +1,220 @@
+/*
+ * OrientationFilterTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Replays a lid trace through every orientation filter and checks the
+ * angles and the tilt decisions that TiltDetector makes from each one's
+ * gravity vector, then measures the host time of an update.
+ *
+ * The trace is synthesized from a script, with seeded noise, so every run
+ * replays the same samples: the box rests, takes a knock, has its lid
+ * raised 60 degrees about X, holds it, and lowers it again. It stands in
+ * for a captured MPU6050 FIFO trace, which the repository does not have
+ * yet, so it models neither sensor bias drift nor the real knock shape.
+ *
+ * Update times are host nanoseconds, not ESP32 cycles. They rank the
+ * filters against each other but do not predict their cost on the
+ * sender.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "ComplementaryOrientationFilter.h"
+#include "HostTest.h"
+#include "MadgwickOrientationFilter.h"
+#include "Mpu6050AngleIntegrator.h"
+#include "TiltDetector.h"
+
+#define SAMPLE_RATE_HZ 100
+#define ONE_G 16384                // Raw accelerometer units, +/- 2 g
+#define LSB_PER_DEGREE_PER_S 65.5  // Raw gyroscope units, +/- 500 deg/s
+#define ACCEL_NOISE 80             // Raw units, about 5 mg
+#define GYRO_NOISE 5
+#define TRACE_SECONDS 24
+#define SETTLE_SAMPLES 50  // Allowed after motion stops
+#define BENCHMARK_UPDATES 1000000
+
+static constexpr TiltDetector tilt_detector(M_PI / 6);
+
+static const double DEGREES = M_PI / 180;
+
+/**
+ * Phases of the trace, in seconds.
+ */
+enum Phase {
+  RESTING,
+  KNOCKED,  // A sharp sideways jolt, not a tilt
+  RAISING,
+  RAISED,
+  LOWERING,
+};
+
+static Phase phase_at(double t) {
+  if (t < 4) {
+    return RESTING;
+  }
+  if (t < 4.03) {
+    return KNOCKED;
+  }
+  if (t < 8) {
+    return RESTING;
+  }
+  if (t < 9) {
+    return RAISING;
+  }
+  if (t < 16) {
+    return RAISED;
+  }
+  if (t < 17) {
+    return LOWERING;
+  }
+  return RESTING;
+}
+
+/**
+ * Seeded noise, roughly Gaussian, identical on every host.
+ */
+static uint32_t noise_state = 12345;
+
+static int32_t noise(int32_t amplitude) {
+  int32_t sum = 0;
+  for (int i = 0; i < 4; ++i) {
+    noise_state = noise_state * 1103515245 + 12345;
+    sum += (int32_t) ((noise_state >> 16) & 0x7FFF) - 0x4000;
+  }
+  return sum * amplitude / 0x8000;
+}
+
+struct TraceSample {
+  Mpu6050RawSample raw;
+  Phase phase;
+  double roll_degrees;  // Truth
+};
+
+static TraceSample trace[TRACE_SECONDS * SAMPLE_RATE_HZ];
+
+static void build_trace(void) {
+  double roll = 0;
+  for (size_t i = 0; i < TRACE_SECONDS * SAMPLE_RATE_HZ; ++i) {
+    double t = (double) i / SAMPLE_RATE_HZ;
+    Phase phase = phase_at(t);
+    double roll_rate = phase == RAISING
+        ? 60
+        : phase == LOWERING ? -60 : 0;
+    roll += roll_rate / SAMPLE_RATE_HZ;
+    Mpu6050RawSample& raw = trace[i].raw;
+    raw.accel_x = (int16_t) (
+        noise(ACCEL_NOISE) + (phase == KNOCKED ? ONE_G / 2 : 0));
+    raw.accel_y = (int16_t) (lround(sin(roll * DEGREES) * ONE_G)
+        + noise(ACCEL_NOISE));
+    raw.accel_z = (int16_t) (lround(cos(roll * DEGREES) * ONE_G)
+        + noise(ACCEL_NOISE));
+    raw.gyro_x = (int16_t) (lround(roll_rate * LSB_PER_DEGREE_PER_S)
+        + noise(GYRO_NOISE));
+    raw.gyro_y = (int16_t) noise(GYRO_NOISE);
+    raw.gyro_z = (int16_t) noise(GYRO_NOISE);
+    trace[i].phase = phase;
+    trace[i].roll_degrees = roll;
+  }
+}
+
+static void replay(OrientationFilter& filter) {
+  OrientationFilter::Calibration calibration = {
+    (float) ONE_G, (float) LSB_PER_DEGREE_PER_S, 0, 0, 0, 0, 0, 0,
+  };
+  filter.calibrate(calibration);
+  uint32_t false_raises = 0;
+  uint32_t missed_raises = 0;
+  double worst_error = 0;
+  size_t since_motion = SETTLE_SAMPLES;
+  for (size_t i = 0; i < TRACE_SECONDS * SAMPLE_RATE_HZ; ++i) {
+    const TraceSample& sample = trace[i];
+    filter.update(sample.raw);
+    OrientationFilter::Gravity gravity = filter.get_gravity();
+    bool tilted = tilt_detector.is_tilted(gravity.x, gravity.y, gravity.z);
+    if (sample.phase == RAISING || sample.phase == LOWERING) {
+      since_motion = 0;
+      continue;
+    }
+    if (++since_motion < SETTLE_SAMPLES) {
+      continue;
+    }
+    if (sample.phase == RAISED) {
+      missed_raises += !tilted;
+    } else {
+      false_raises += tilted;
+    }
+    double error = fabs(
+        filter.get_roll_centidegrees() / 100.0 - sample.roll_degrees);
+    if (worst_error < error) {
+      worst_error = error;
+    }
+  }
+  printf(
+      "%-20s settled roll error %.2f degrees, false raises %u,"
+      " missed raises %u.\n",
+      filter.get_name(),
+      worst_error,
+      (unsigned) false_raises,
+      (unsigned) missed_raises);
+  HOST_CHECK(!false_raises);
+  HOST_CHECK(!missed_raises);
+  HOST_CHECK(worst_error < 2.0);
+}
+
+static void benchmark(OrientationFilter& filter) {
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_UPDATES; ++i) {
+    filter.update(trace[i % (TRACE_SECONDS * SAMPLE_RATE_HZ)].raw);
+  }
+  uint64_t elapsed_ns = host_nanoseconds() - start;
+  host_benchmark_sink = filter.get_gravity().z;
+  printf(
+      "%-20s %.1f host ns per update.\n",
+      filter.get_name(),
+      (double) elapsed_ns / BENCHMARK_UPDATES);
+}
+
+static void test_atan2(void) {
+  HOST_CHECK(OrientationFilter::atan2_centidegrees(1, 1) == 4500);
+  HOST_CHECK(OrientationFilter::atan2_centidegrees(1, -1) == 13500);
+  HOST_CHECK(OrientationFilter::atan2_centidegrees(-1, -1) == -13500);
+  HOST_CHECK(OrientationFilter::atan2_centidegrees(1, 0) == 9000);
+  HOST_CHECK(OrientationFilter::atan2_centidegrees(0, 0) == 0);
+  int32_t worst = 0;
+  for (int32_t angle = -18000; angle <= 18000; angle += 7) {
+    double radians = angle / 100.0 * DEGREES;
+    int32_t error = abs(OrientationFilter::atan2_centidegrees(
+        lround(sin(radians) * 1000000),
+        lround(cos(radians) * 1000000)) - angle);
+    if (18000 < error) {
+      error = 36000 - error;
+    }
+    if (worst < error) {
+      worst = error;
+    }
+  }
+  HOST_CHECK(worst <= 25);
+  HOST_CHECK(OrientationFilter::square_root(1000000) == 1000);
+  HOST_CHECK(OrientationFilter::square_root(999999) == 999);
+}
+
+int main() {
+  build_trace();
+  test_atan2();
+
+  ComplementaryOrientationFilter complementary(SAMPLE_RATE_HZ, 0.98f);
+  MadgwickOrientationFilter madgwick(SAMPLE_RATE_HZ, 0.1f);
+  Mpu6050AngleIntegrator integrator(SAMPLE_RATE_HZ, 0.98f);
+  OrientationFilter *filters[] = {&complementary, &madgwick, &integrator};
+  for (size_t i = 0; i < 3; ++i) {
+    replay(*filters[i]);
+  }
+  for (size_t i = 0; i < 3; ++i) {
+    benchmark(*filters[i]);
+  }
+  return host_test_result("OrientationFilterTest");
+}
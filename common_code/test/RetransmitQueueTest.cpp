@@ -0,0 +1,719 @@
+/*
+ * RetransmitQueueTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Runs the acknowledged send path over simulated lossy links: a sender
+ * with a NotificationBatchEncoder, a RetransmitQueue, and an EventStore,
+ * and receivers with a DuplicateFilter and LinkQuality, joined by links
+ * that drop frames and acknowledgments. Like EspNowTransmitter, the
+ * sender stores the changes in abandoned frames for the receivers that
+ * did not acknowledge them, skips changes that a receiver has since
+ * passed, and replays the rest to each receiver, in order, once it has
+ * no frames awaiting acknowledgment.
+ *
+ * For each loss rate, reports the events superseded and repeated, the
+ * duplicates rejected, the changes that arrived after a newer one, and
+ * the median, p99, and maximum event latency, and checks that the
+ * receiver ends with the last status. Retransmitted copies of a frame
+ * are filtered out, but a replayed event that had already arrived
+ * arrives again. Also checks abandonment, eviction, a change that only
+ * one of two receivers acknowledges, a change acknowledged after a
+ * newer one, and sender restarts.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "DuplicateFilter.h"
+#include "EventStore.h"
+#include "HostTest.h"
+#include "LinkQuality.h"
+#include "NotificationBatch.h"
+#include "RetransmitQueue.h"
+
+#define ACK_TIMEOUT_MS 50  // As in EspNowTransmitter
+#define MAX_SEND_ATTEMPTS 6
+
+#define SIMULATED_MS 600000  // Ten minutes per loss rate
+#define EVENT_INTERVAL_MS 100
+#define DRAIN_MS 10000  // No new events at the end of the run
+#define MAX_EVENTS (SIMULATED_MS / EVENT_INTERVAL_MS)
+#define MIN_DELAY_MS 2  // One way
+#define MAX_EXTRA_DELAY_MS 4
+#define IN_FLIGHT_CAPACITY 64
+#define STORED_CAPACITY 32  // As in EspNowTransmitter
+#define MAX_RECEIVERS 2
+#define MAX_CHANGES_RECEIVED 16
+
+/**
+ * Seeded randomness, identical on every host.
+ */
+static uint32_t random_state = 12345;
+
+static uint32_t next_random(void) {
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 16) & 0x7FFF;
+}
+
+struct InFlightFrame {
+  uint32_t arrival_ms;
+  size_t frame_size;
+  uint8_t frame[WIRE_FORMAT_MAX_FRAME_SIZE];
+};
+
+/**
+ * One direction of a link. Drops each frame with the specified
+ * probability, and every frame that carries dropped_status, and delays
+ * the rest by a few milliseconds.
+ */
+class SimulatedLink : public FrameSink {
+  InFlightFrame in_flight[IN_FLIGHT_CAPACITY];
+  size_t count;
+
+  bool carries_dropped_status(const uint8_t *frame, size_t frame_size) {
+    TimestampedNotification entries[NOTIFICATION_BATCH_MAX_ENTRIES];
+    size_t entry_count = NotificationBatchDecoder::decode(
+        frame,
+        frame_size,
+        entries,
+        NOTIFICATION_BATCH_MAX_ENTRIES);
+    for (size_t i = 0; i < entry_count; ++i) {
+      if (entries[i].message.status == dropped_status) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  uint32_t loss_permille;
+  MotionStatus dropped_status;  // LAST_NOTIFICATION_STATUS drops none
+  uint32_t now_ms;
+  uint32_t frames_sent;
+
+  SimulatedLink(uint32_t loss_permille) :
+      count(0),
+      loss_permille(loss_permille),
+      dropped_status(LAST_NOTIFICATION_STATUS),
+      now_ms(0),
+      frames_sent(0) {
+  }
+
+  virtual bool send_frame(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers) {
+    (void) peers;
+    ++frames_sent;
+    if (next_random() % 1000 < loss_permille
+        || IN_FLIGHT_CAPACITY <= count
+        || carries_dropped_status(frame, frame_size)) {
+      return true;
+    }
+    InFlightFrame& sent = in_flight[count++];
+    sent.arrival_ms =
+        now_ms + MIN_DELAY_MS + next_random() % (MAX_EXTRA_DELAY_MS + 1);
+    sent.frame_size = frame_size;
+    memcpy(sent.frame, frame, frame_size);
+    return true;
+  }
+
+  /**
+   * Takes a frame that has arrived by now_ms into the specified buffer.
+   * Returns false if none has.
+   */
+  bool receive(InFlightFrame *received) {
+    for (size_t i = 0; i < count; ++i) {
+      if ((int32_t) (now_ms - in_flight[i].arrival_ms) >= 0) {
+        *received = in_flight[i];
+        in_flight[i] = in_flight[--count];
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+/**
+ * The sender, which follows EspNowTransmitter's delivery rules. Every
+ * receiver counts as reachable, and each change goes in a frame of its
+ * own.
+ */
+class Sender : public FrameSink {
+  size_t receiver_count;
+  uint32_t delivered_change_ms[MAX_RECEIVERS];
+  PeerSet delivered_change_peers;
+
+  PeerSet all_peers(void) const {
+    return (PeerSet) ((1 << receiver_count) - 1);
+  }
+
+  /**
+   * Stores the changes in a frame for the specified receivers, skipping
+   * those that a receiver has since passed.
+   */
+  void hold_changes(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers) {
+    TimestampedNotification entries[NOTIFICATION_BATCH_MAX_ENTRIES];
+    size_t entry_count = NotificationBatchDecoder::decode(
+        frame,
+        frame_size,
+        entries,
+        NOTIFICATION_BATCH_MAX_ENTRIES);
+    for (size_t i = 0; i < entry_count; ++i) {
+      PeerSet owed = peers;
+      for (size_t peer = 0; peer < receiver_count; ++peer) {
+        if ((delivered_change_peers & peer_set_of(peer))
+            && 0 <= (int32_t) (delivered_change_ms[peer]
+                - entries[i].timestamp_ms)) {
+          owed &= ~peer_set_of(peer);
+        }
+      }
+      stored_events.push(entries[i], owed);
+    }
+  }
+
+public:
+  SimulatedLink *links[MAX_RECEIVERS];
+  NotificationBatchEncoder encoder;
+  RetransmitQueue retransmit_queue;
+  EventStore<STORED_CAPACITY> stored_events;
+  uint32_t abandon_calls;
+
+  Sender(SimulatedLink **links, size_t receiver_count) :
+      receiver_count(receiver_count),
+      delivered_change_peers(0),
+      retransmit_queue(ACK_TIMEOUT_MS, MAX_SEND_ATTEMPTS),
+      abandon_calls(0) {
+    memset(delivered_change_ms, 0, sizeof(delivered_change_ms));
+    for (size_t peer = 0; peer < receiver_count; ++peer) {
+      this->links[peer] = links[peer];
+    }
+    encoder.set_boot_id(0x5A5A);
+    // As after power on, when RTC memory holds garbage.
+    memset((void *) &stored_events, 0xA5, sizeof(stored_events));
+    stored_events.restore();
+  }
+
+  virtual bool send_frame(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers) {
+    for (size_t peer = 0; peer < receiver_count; ++peer) {
+      if (peers & peer_set_of(peer)) {
+        links[peer]->send_frame(frame, frame_size, peer_set_of(peer));
+      }
+    }
+    return true;
+  }
+
+  virtual void on_frame_acknowledged(
+      const uint8_t *frame,
+      size_t frame_size,
+      size_t peer) {
+    TimestampedNotification entries[NOTIFICATION_BATCH_MAX_ENTRIES];
+    size_t entry_count = NotificationBatchDecoder::decode(
+        frame,
+        frame_size,
+        entries,
+        NOTIFICATION_BATCH_MAX_ENTRIES);
+    for (size_t i = 0; i < entry_count; ++i) {
+      if (!(delivered_change_peers & peer_set_of(peer))
+          || 0 < (int32_t) (entries[i].timestamp_ms
+              - delivered_change_ms[peer])) {
+        delivered_change_ms[peer] = entries[i].timestamp_ms;
+        delivered_change_peers |= peer_set_of(peer);
+      }
+    }
+  }
+
+  virtual void on_frame_abandoned(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet unacknowledged) {
+    ++abandon_calls;
+    hold_changes(frame, frame_size, unacknowledged);
+  }
+
+  /**
+   * Sends a status change to every receiver that is owed nothing, and
+   * stores it for the rest.
+   */
+  void send_change(MotionStatus status, uint32_t now_ms) {
+    MotionNotificationMessage message = {status, 20.0f};
+    encoder.clear();
+    encoder.add(message, now_ms, true);
+    uint16_t sequence = encoder.seal(now_ms);
+    PeerSet held = stored_events.get_owed_peers();
+    hold_changes(encoder.get_frame(), encoder.get_frame_size(), held);
+    PeerSet peers = all_peers() & ~held;
+    send_frame(encoder.get_frame(), encoder.get_frame_size(), peers);
+    retransmit_queue.track(
+        encoder.get_frame(),
+        encoder.get_frame_size(),
+        sequence,
+        now_ms,
+        peers);
+  }
+
+  /**
+   * Replays stored changes to each receiver that has no frames awaiting
+   * acknowledgment.
+   */
+  void replay(uint32_t now_ms) {
+    PeerSet ready =
+        stored_events.get_owed_peers() & ~retransmit_queue.get_awaiting();
+    for (size_t peer = 0;
+        peer < receiver_count
+            && retransmit_queue.get_pending_count()
+                < RETRANSMIT_QUEUE_CAPACITY;
+        ++peer) {
+      PeerSet peer_bit = peer_set_of(peer);
+      if (!(ready & peer_bit)) {
+        continue;
+      }
+      TimestampedNotification entries[NOTIFICATION_BATCH_MAX_ENTRIES];
+      size_t entry_count = stored_events.take(
+          peer,
+          delivered_change_peers & peer_bit,
+          delivered_change_ms[peer],
+          entries,
+          NOTIFICATION_BATCH_MAX_ENTRIES);
+      if (!entry_count) {
+        continue;
+      }
+      encoder.clear();
+      for (size_t i = 0; i < entry_count; ++i) {
+        encoder.add(entries[i].message, entries[i].timestamp_ms, true);
+      }
+      uint16_t sequence = encoder.seal(now_ms);
+      send_frame(encoder.get_frame(), encoder.get_frame_size(), peer_bit);
+      retransmit_queue.track(
+          encoder.get_frame(),
+          encoder.get_frame_size(),
+          sequence,
+          now_ms,
+          peer_bit);
+    }
+  }
+
+  void on_ack(uint16_t sequence, uint32_t now_ms, size_t peer) {
+    retransmit_queue.on_ack(sequence, now_ms, peer, *this);
+  }
+
+  void service(uint32_t now_ms) {
+    retransmit_queue.service(now_ms, *this);
+  }
+};
+
+/**
+ * A receiver and its links to and from the sender. Records the first
+ * changes that it receives.
+ */
+class Receiver {
+public:
+  SimulatedLink forward;
+  SimulatedLink backward;
+  DuplicateFilter duplicate_filter;
+  LinkQuality link_quality;
+  TimestampedNotification changes[MAX_CHANGES_RECEIVED];
+  size_t change_count;
+  uint32_t changes_stale;  // Older than one received before
+  uint32_t newest_ms;
+  MotionStatus status;
+
+  Receiver(uint32_t loss_permille) :
+      forward(loss_permille),
+      backward(loss_permille),
+      change_count(0),
+      changes_stale(0),
+      newest_ms(0),
+      status(LAST_NOTIFICATION_STATUS) {
+  }
+
+  void set_time(uint32_t now_ms) {
+    forward.now_ms = now_ms;
+    backward.now_ms = now_ms;
+  }
+
+  /**
+   * Takes the frames that have arrived, acknowledges them if asked, and
+   * applies their changes. Returns the number of changes applied and
+   * places them in the specified buffer, which must hold a full frame's
+   * worth per arrival.
+   */
+  size_t receive(
+      uint32_t now_ms,
+      TimestampedNotification *applied,
+      size_t max_count) {
+    size_t applied_count = 0;
+    InFlightFrame received;
+    while (forward.receive(&received)) {
+      TimestampedNotification entries[NOTIFICATION_BATCH_MAX_ENTRIES];
+      ReceivedFrameInfo info;
+      size_t entry_count = NotificationBatchDecoder::decode(
+          received.frame,
+          received.frame_size,
+          entries,
+          NOTIFICATION_BATCH_MAX_ENTRIES,
+          &info);
+      HOST_CHECK(info.has_sequence);
+      if (info.ack_requested) {
+        uint8_t ack[WIRE_FORMAT_ACK_SIZE];
+        WireFormat::encode_ack(ack, info.sequence);
+        backward.send_frame(ack, sizeof(ack), 1);
+      }
+      if (!duplicate_filter.is_new(info.sequence, info.boot_id)) {
+        continue;
+      }
+      link_quality.on_frame(
+          info.sequence,
+          info.boot_id,
+          info.sent_ms,
+          now_ms);
+      for (size_t i = 0; i < entry_count; ++i) {
+        if (change_count
+            && (int32_t) (entries[i].timestamp_ms - newest_ms) < 0) {
+          ++changes_stale;
+        } else {
+          newest_ms = entries[i].timestamp_ms;
+        }
+        status = entries[i].message.status;
+        if (change_count < MAX_CHANGES_RECEIVED) {
+          changes[change_count] = entries[i];
+        }
+        ++change_count;
+        if (applied_count < max_count) {
+          applied[applied_count++] = entries[i];
+        }
+      }
+    }
+    return applied_count;
+  }
+
+  /**
+   * Passes the acknowledgments that have arrived to the sender.
+   */
+  void deliver_acks(uint32_t now_ms, Sender& sender, size_t peer) {
+    InFlightFrame received;
+    while (backward.receive(&received)) {
+      uint16_t sequence;
+      if (WireFormat::decode_ack(
+          received.frame,
+          received.frame_size,
+          &sequence)) {
+        sender.on_ack(sequence, now_ms, peer);
+      }
+    }
+  }
+};
+
+/**
+ * Advances a sender and its receivers by one millisecond. Acknowledgments
+ * reach the sender before its retransmissions and replays are due.
+ */
+static void step(
+    uint32_t now_ms,
+    Sender& sender,
+    Receiver **receivers,
+    size_t receiver_count) {
+  TimestampedNotification applied[IN_FLIGHT_CAPACITY];
+  for (size_t peer = 0; peer < receiver_count; ++peer) {
+    receivers[peer]->set_time(now_ms);
+    receivers[peer]->receive(now_ms, applied, IN_FLIGHT_CAPACITY);
+    receivers[peer]->deliver_acks(now_ms, sender, peer);
+  }
+  sender.service(now_ms);
+  sender.replay(now_ms);
+}
+
+static uint32_t event_latencies_ms[MAX_EVENTS];
+
+static int compare_uint32(const void *a, const void *b) {
+  uint32_t left = *(const uint32_t *) a;
+  uint32_t right = *(const uint32_t *) b;
+  return left < right ? -1 : right < left ? 1 : 0;
+}
+
+/**
+ * Simulates SIMULATED_MS of traffic to one receiver at the specified
+ * loss rate, which applies to both directions.
+ */
+static void simulate(uint32_t loss_permille) {
+  Receiver receiver(loss_permille);
+  SimulatedLink *links[] = {&receiver.forward};
+  Sender sender(links, 1);
+
+  // Events are numbered by their timestamps, EVENT_INTERVAL_MS apart.
+  static uint8_t deliveries[MAX_EVENTS];
+  memset(deliveries, 0, sizeof(deliveries));
+  size_t event_count = 0;
+  uint32_t events_repeated = 0;
+  MotionStatus last_status = LAST_NOTIFICATION_STATUS;
+
+  for (uint32_t now_ms = 1; now_ms <= SIMULATED_MS; ++now_ms) {
+    receiver.set_time(now_ms);
+    if (!(now_ms % EVENT_INTERVAL_MS)
+        && now_ms <= SIMULATED_MS - DRAIN_MS) {
+      last_status = event_count & 1 ? LID_HAS_NOT_MOVED : LID_RAISED;
+      sender.send_change(last_status, now_ms);
+      ++event_count;
+    }
+
+    TimestampedNotification applied[IN_FLIGHT_CAPACITY];
+    size_t applied_count =
+        receiver.receive(now_ms, applied, IN_FLIGHT_CAPACITY);
+    for (size_t i = 0; i < applied_count; ++i) {
+      size_t event = applied[i].timestamp_ms / EVENT_INTERVAL_MS - 1;
+      if (deliveries[event]++) {
+        // Replayed after the receiver had it, but the ACK was lost.
+        ++events_repeated;
+      } else {
+        event_latencies_ms[event] = now_ms - applied[i].timestamp_ms;
+      }
+    }
+    receiver.deliver_acks(now_ms, sender, 0);
+    sender.service(now_ms);
+    sender.replay(now_ms);
+  }
+
+  size_t superseded = 0;
+  size_t delivered = 0;
+  for (size_t i = 0; i < event_count; ++i) {
+    if (deliveries[i]) {
+      event_latencies_ms[delivered++] = event_latencies_ms[i];
+    } else {
+      ++superseded;
+    }
+  }
+  HOST_CHECK(deliveries[event_count - 1]);
+  qsort(
+      event_latencies_ms,
+      delivered,
+      sizeof(event_latencies_ms[0]),
+      compare_uint32);
+
+  printf(
+      "%2u%% loss: %u events, %u superseded, %u repeated, %u stale,"
+      " %u duplicate frames; latency p50 %u ms, p99 %u ms, max %u ms;"
+      " %u frames sent, %u retransmitted, %u abandoned;"
+      " receiver saw %u permille loss\n",
+      (unsigned) (loss_permille / 10),
+      (unsigned) event_count,
+      (unsigned) superseded,
+      (unsigned) events_repeated,
+      (unsigned) receiver.changes_stale,
+      (unsigned) receiver.duplicate_filter.get_duplicates(),
+      (unsigned) event_latencies_ms[delivered / 2],
+      (unsigned) event_latencies_ms[delivered * 99 / 100],
+      (unsigned) event_latencies_ms[delivered - 1],
+      (unsigned) receiver.forward.frames_sent,
+      (unsigned) sender.retransmit_queue.get_retransmissions(),
+      (unsigned) sender.retransmit_queue.get_frames_abandoned(),
+      (unsigned) receiver.link_quality.get_recent_loss_permille());
+
+  // Events that never arrived were passed by a newer one that did, so
+  // the receiver ends up with the last status.
+  HOST_CHECK(receiver.status == last_status);
+  HOST_CHECK(
+      sender.abandon_calls
+          == sender.retransmit_queue.get_frames_abandoned());
+  HOST_CHECK(!sender.stored_events.get_dropped());
+  if (!loss_permille) {
+    HOST_CHECK(!superseded);
+    HOST_CHECK(!events_repeated);
+    HOST_CHECK(!receiver.changes_stale);
+    HOST_CHECK(!receiver.duplicate_filter.get_duplicates());
+    HOST_CHECK(!sender.retransmit_queue.get_retransmissions());
+    HOST_CHECK(event_latencies_ms[delivered - 1]
+        <= MIN_DELAY_MS + MAX_EXTRA_DELAY_MS);
+  } else {
+    HOST_CHECK(receiver.duplicate_filter.get_duplicates());
+  }
+}
+
+static void test_abandonment(void) {
+  // Nothing gets through, so every frame runs out of attempts.
+  Receiver receiver(1000);
+  SimulatedLink *links[] = {&receiver.forward, &receiver.forward,
+      &receiver.forward};
+  Sender sender(links, 3);
+  RetransmitQueue& retransmit_queue = sender.retransmit_queue;
+  NotificationBatchEncoder encoder;
+  MotionNotificationMessage message = {LID_RAISED, 20.0f};
+  encoder.add(message, 100, true);
+  uint16_t sequence = encoder.seal(100);
+  retransmit_queue.track(
+      encoder.get_frame(),
+      encoder.get_frame_size(),
+      sequence,
+      100,
+      peer_set_of(0) | peer_set_of(2));
+  sender.on_ack(sequence, 110, 2);
+
+  PeerSet unresponsive = 0;
+  uint32_t now_ms;
+  for (now_ms = 100; !unresponsive && now_ms < 100000; ++now_ms) {
+    unresponsive = retransmit_queue.service(now_ms, sender);
+  }
+  HOST_CHECK(unresponsive == peer_set_of(0));
+  // 50 + 100 + 200 + 400 + 800 + 1600 ms of backoff.
+  HOST_CHECK(now_ms - 1 == 100 + 3150);
+  HOST_CHECK(receiver.forward.frames_sent == MAX_SEND_ATTEMPTS - 1);
+  HOST_CHECK(sender.abandon_calls == 1);
+  // Held only for the receiver that did not acknowledge it.
+  HOST_CHECK(sender.stored_events.get_count() == 1);
+  HOST_CHECK(sender.stored_events.get_owed_peers() == peer_set_of(0));
+  TimestampedNotification taken[NOTIFICATION_BATCH_MAX_ENTRIES];
+  HOST_CHECK(sender.stored_events.take(
+      0,
+      false,
+      0,
+      taken,
+      NOTIFICATION_BATCH_MAX_ENTRIES) == 1);
+  HOST_CHECK(taken[0].timestamp_ms == 100);
+  HOST_CHECK(taken[0].message.status == LID_RAISED);
+  HOST_CHECK(sender.stored_events.is_empty());
+  HOST_CHECK(!retransmit_queue.get_pending_count());
+
+  // A full queue drops its oldest frame to make room. Its receivers may
+  // well have it, so nothing is stored.
+  for (uint32_t i = 0; i <= RETRANSMIT_QUEUE_CAPACITY; ++i) {
+    encoder.clear();
+    encoder.add(message, 200 + i, true);
+    sequence = encoder.seal(200 + i);
+    retransmit_queue.track(
+        encoder.get_frame(),
+        encoder.get_frame_size(),
+        sequence,
+        200 + i,
+        peer_set_of(0));
+  }
+  HOST_CHECK(sender.abandon_calls == 1);
+  HOST_CHECK(retransmit_queue.get_frames_evicted() == 1);
+  HOST_CHECK(sender.stored_events.is_empty());
+  HOST_CHECK(retransmit_queue.get_pending_count()
+      == RETRANSMIT_QUEUE_CAPACITY);
+}
+
+static void test_partial_ack(void) {
+  // Receiver 0 gets everything. Receiver 1 is out of range until 8 s.
+  Receiver receiver_0(0);
+  Receiver receiver_1(1000);
+  Receiver *receivers[] = {&receiver_0, &receiver_1};
+  SimulatedLink *links[] = {&receiver_0.forward, &receiver_1.forward};
+  Sender sender(links, 2);
+
+  for (uint32_t now_ms = 1; now_ms <= 20000; ++now_ms) {
+    if (now_ms == 100) {
+      sender.send_change(LID_RAISED, now_ms);
+    } else if (now_ms == 1000) {
+      sender.send_change(LID_HAS_NOT_MOVED, now_ms);
+    } else if (now_ms == 4000) {
+      // The raise ran out of attempts, but the close is still pending
+      // for receiver 1, so the raise waits in the store.
+      HOST_CHECK(sender.stored_events.get_count() == 1);
+      HOST_CHECK(sender.stored_events.get_owed_peers() == peer_set_of(1));
+      HOST_CHECK(sender.retransmit_queue.get_awaiting() == peer_set_of(1));
+    } else if (now_ms == 8000) {
+      receiver_1.forward.loss_permille = 0;
+      receiver_1.backward.loss_permille = 0;
+    }
+    step(now_ms, sender, receivers, 2);
+  }
+
+  // Receiver 0 acknowledged both, so nothing was replayed to it.
+  HOST_CHECK(receiver_0.change_count == 2);
+  HOST_CHECK(receiver_0.changes[0].message.status == LID_RAISED);
+  HOST_CHECK(receiver_0.changes[1].message.status == LID_HAS_NOT_MOVED);
+  HOST_CHECK(receiver_0.forward.frames_sent == 2);
+
+  // Receiver 1 missed both and gets them once each, in order.
+  HOST_CHECK(receiver_1.change_count == 2);
+  HOST_CHECK(receiver_1.changes[0].timestamp_ms == 100);
+  HOST_CHECK(receiver_1.changes[0].message.status == LID_RAISED);
+  HOST_CHECK(receiver_1.changes[1].timestamp_ms == 1000);
+  HOST_CHECK(receiver_1.changes[1].message.status == LID_HAS_NOT_MOVED);
+  HOST_CHECK(!receiver_1.changes_stale);
+  HOST_CHECK(receiver_1.status == LID_HAS_NOT_MOVED);
+  HOST_CHECK(sender.stored_events.is_empty());
+  HOST_CHECK(!sender.retransmit_queue.get_pending_count());
+}
+
+static void test_acknowledged_out_of_order(void) {
+  // Every copy of the raise is lost, but the close that follows it gets
+  // through. Replaying the raise after the close would be a false alarm.
+  Receiver receiver(0);
+  receiver.forward.dropped_status = LID_RAISED;
+  Receiver *receivers[] = {&receiver};
+  SimulatedLink *links[] = {&receiver.forward};
+  Sender sender(links, 1);
+
+  for (uint32_t now_ms = 1; now_ms <= 10000; ++now_ms) {
+    if (now_ms == 100) {
+      sender.send_change(LID_RAISED, now_ms);
+    } else if (now_ms == 1000) {
+      sender.send_change(LID_HAS_NOT_MOVED, now_ms);
+    }
+    step(now_ms, sender, receivers, 1);
+  }
+
+  HOST_CHECK(sender.retransmit_queue.get_frames_abandoned() == 1);
+  HOST_CHECK(sender.stored_events.is_empty());
+  HOST_CHECK(receiver.change_count == 1);
+  HOST_CHECK(receiver.changes[0].message.status == LID_HAS_NOT_MOVED);
+  HOST_CHECK(receiver.status == LID_HAS_NOT_MOVED);
+
+  // A stored change that a newer delivery passes is skipped on replay.
+  EventStore<STORED_CAPACITY>& stored_events = sender.stored_events;
+  TimestampedNotification raised = {200, {LID_RAISED, 20.0f}};
+  TimestampedNotification closed = {300, {LID_HAS_NOT_MOVED, 20.0f}};
+  stored_events.push(closed, peer_set_of(0));
+  stored_events.push(raised, peer_set_of(0));
+  TimestampedNotification taken[NOTIFICATION_BATCH_MAX_ENTRIES];
+  HOST_CHECK(stored_events.take(
+      0,
+      true,
+      250,
+      taken,
+      NOTIFICATION_BATCH_MAX_ENTRIES) == 1);
+  HOST_CHECK(taken[0].timestamp_ms == 300);
+  HOST_CHECK(stored_events.is_empty());
+}
+
+static void test_restart(void) {
+  DuplicateFilter duplicate_filter;
+  LinkQuality link_quality;
+  for (uint16_t sequence = 0; sequence < 40; ++sequence) {
+    HOST_CHECK(duplicate_filter.is_new(sequence, 0x1111));
+    link_quality.on_frame(sequence, 0x1111, sequence, sequence + 3);
+  }
+  HOST_CHECK(!duplicate_filter.is_new(39, 0x1111));
+
+  // The sender restarts and counts from 0 again under a new boot id.
+  for (uint16_t sequence = 0; sequence < 8; ++sequence) {
+    HOST_CHECK(duplicate_filter.is_new(sequence, 0x2222));
+    link_quality.on_frame(sequence, 0x2222, sequence, sequence + 3);
+  }
+  HOST_CHECK(!duplicate_filter.is_new(7, 0x2222));
+  HOST_CHECK(duplicate_filter.get_duplicates() == 2);
+  HOST_CHECK(!link_quality.get_frames_lost());
+  HOST_CHECK(link_quality.get_frames_received() == 48);
+}
+
+int main() {
+  test_abandonment();
+  test_partial_ack();
+  test_acknowledged_out_of_order();
+  test_restart();
+  static const uint32_t LOSS_PERMILLE[] = {0, 100, 300, 500};
+  for (size_t i = 0; i < sizeof(LOSS_PERMILLE) / sizeof(LOSS_PERMILLE[0]);
+      ++i) {
+    simulate(LOSS_PERMILLE[i]);
+  }
+  return host_test_result("RetransmitQueueTest");
+}
@@ -0,0 +1,298 @@
+/*
+ * StateMachineTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Checks the StateMachine table checks and dispatch on a copy of the
+ * connection status machine, then measures transitions per second
+ * against the enum table and switch that the tasks used before.
+ */
+
+#include "HostTest.h"
+#include "StateMachine.h"
+
+#define BENCHMARK_EVENTS 100000000
+#define MACHINE_COUNT 8
+
+enum NetState {
+  NET_INITIALIZED,
+  NET_GOING_DOWN,
+  NET_DISCONNECTED,
+  NET_GOING_UP,
+  NET_CONNECTED,
+  NET_SENDER_PANIC,
+  NET_STATE_COUNT,
+};
+
+enum NetEvent {
+  NET_DOWN,
+  NET_UP,
+  NET_SENDER_FAILED,
+  NET_EVENT_COUNT,
+};
+
+static constexpr uint8_t TRANSITION_TABLE
+    [NET_STATE_COUNT][NET_EVENT_COUNT] = {
+  { // NET_INITIALIZED
+    fsm_to(NET_GOING_DOWN),  // NET_DOWN
+    fsm_to(NET_GOING_UP),  // NET_UP
+    fsm_to(NET_SENDER_PANIC),  // NET_SENDER_FAILED
+  },
+  { // NET_GOING_DOWN
+    fsm_to(NET_DISCONNECTED),  // NET_DOWN
+    fsm_to(NET_GOING_UP),  // NET_UP
+    fsm_to(NET_SENDER_PANIC),  // NET_SENDER_FAILED
+  },
+  { // NET_DISCONNECTED
+    fsm_to(NET_DISCONNECTED),  // NET_DOWN
+    fsm_to(NET_GOING_UP),  // NET_UP
+    fsm_to(NET_SENDER_PANIC),  // NET_SENDER_FAILED
+  },
+  { // NET_GOING_UP
+    fsm_to(NET_GOING_DOWN),  // NET_DOWN
+    fsm_to(NET_CONNECTED),  // NET_UP
+    fsm_to(NET_SENDER_PANIC),  // NET_SENDER_FAILED
+  },
+  { // NET_CONNECTED
+    fsm_to(NET_GOING_DOWN),  // NET_DOWN
+    fsm_to(NET_CONNECTED),  // NET_UP
+    fsm_to(NET_SENDER_PANIC),  // NET_SENDER_FAILED
+  },
+  { // NET_SENDER_PANIC
+    FSM_IGNORE,
+    FSM_IGNORE,
+    FSM_IGNORE,
+  },
+};
+
+static_assert(
+    fsm_table_is_complete(TRANSITION_TABLE),
+    "Every state must handle every event.");
+static_assert(
+    fsm_all_states_reachable(TRANSITION_TABLE, fsm_state_bit(NET_INITIALIZED)),
+    "Every state must be reachable.");
+
+// A row left out of the table is caught.
+static constexpr uint8_t SHORT_TABLE[NET_STATE_COUNT][NET_EVENT_COUNT] = {
+  {fsm_to(NET_GOING_DOWN), FSM_IGNORE, FSM_IGNORE},
+};
+static_assert(
+    !fsm_table_is_complete(SHORT_TABLE),
+    "Missing cells must be rejected.");
+
+// So is a state that nothing enters.
+static constexpr uint8_t ORPHAN_TABLE[NET_STATE_COUNT][NET_EVENT_COUNT] = {
+  {fsm_to(NET_GOING_DOWN), FSM_IGNORE, FSM_IGNORE},
+  {fsm_to(NET_DISCONNECTED), FSM_IGNORE, FSM_IGNORE},
+  {fsm_to(NET_GOING_UP), FSM_IGNORE, FSM_IGNORE},
+  {fsm_to(NET_CONNECTED), FSM_IGNORE, FSM_IGNORE},
+  {fsm_to(NET_INITIALIZED), FSM_IGNORE, FSM_IGNORE},
+  {FSM_IGNORE, FSM_IGNORE, FSM_IGNORE},
+};
+static_assert(
+    fsm_table_is_complete(ORPHAN_TABLE),
+    "The orphan table is complete.");
+static_assert(
+    !fsm_all_states_reachable(ORPHAN_TABLE, fsm_state_bit(NET_INITIALIZED)),
+    "Unreachable states must be rejected.");
+static_assert(
+    fsm_all_states_reachable(
+        ORPHAN_TABLE,
+        fsm_state_bit(NET_INITIALIZED) | fsm_state_bit(NET_SENDER_PANIC)),
+    "States entered outside the table count as roots.");
+
+/**
+ * Counts entries into each state, as entry actions would.
+ */
+struct CountingOwner {
+  uint32_t entries[NET_STATE_COUNT];
+  uint32_t total;
+  size_t last_index;
+
+  CountingOwner() :
+      total(0),
+      last_index(0) {
+    for (size_t i = 0; i < NET_STATE_COUNT; ++i) {
+      entries[i] = 0;
+    }
+  }
+
+  void on_enter(NetState state) {
+    ++entries[state];
+    ++total;
+  }
+
+  void on_enter(size_t index, NetState state) {
+    last_index = index;
+    on_enter(state);
+  }
+};
+
+typedef StateMachine<NetState, NET_STATE_COUNT, NET_EVENT_COUNT>
+    NetStateMachine;
+typedef StateMachineArray<
+    NetState, NET_STATE_COUNT, NET_EVENT_COUNT, MACHINE_COUNT>
+    NetStateMachineArray;
+
+static void test_dispatch(void) {
+  NetStateMachine machine(NET_INITIALIZED);
+  CountingOwner owner;
+  HOST_CHECK(sizeof(machine) == 1);
+
+  HOST_CHECK(machine.dispatch(TRANSITION_TABLE, NET_UP, owner));
+  HOST_CHECK(machine.get_state() == NET_GOING_UP);
+  HOST_CHECK(machine.dispatch(TRANSITION_TABLE, NET_UP, owner));
+  HOST_CHECK(machine.get_state() == NET_CONNECTED);
+
+  // Self transitions run the entry actions again.
+  HOST_CHECK(machine.dispatch(TRANSITION_TABLE, NET_UP, owner));
+  HOST_CHECK(owner.entries[NET_CONNECTED] == 2);
+
+  // Events outside the table change nothing.
+  HOST_CHECK(!machine.dispatch(TRANSITION_TABLE, NET_EVENT_COUNT, owner));
+  HOST_CHECK(!machine.dispatch(TRANSITION_TABLE, 200, owner));
+  HOST_CHECK(machine.get_state() == NET_CONNECTED);
+  HOST_CHECK(owner.total == 3);
+
+  // The panic state is terminal.
+  HOST_CHECK(machine.dispatch(TRANSITION_TABLE, NET_SENDER_FAILED, owner));
+  for (unsigned event = 0; event < NET_EVENT_COUNT; ++event) {
+    HOST_CHECK(!machine.dispatch(TRANSITION_TABLE, event, owner));
+  }
+  HOST_CHECK(machine.get_state() == NET_SENDER_PANIC);
+  HOST_CHECK(owner.total == 4);
+
+  // set_state() skips the entry actions.
+  machine.set_state(NET_DISCONNECTED);
+  HOST_CHECK(machine.get_state() == NET_DISCONNECTED);
+  HOST_CHECK(owner.total == 4);
+}
+
+static void test_array(void) {
+  NetStateMachineArray machines(NET_INITIALIZED);
+  CountingOwner owner;
+  HOST_CHECK(sizeof(machines) == MACHINE_COUNT);
+
+  HOST_CHECK(machines.dispatch(TRANSITION_TABLE, 3, NET_DOWN, owner));
+  HOST_CHECK(owner.last_index == 3);
+  HOST_CHECK(machines.dispatch(TRANSITION_TABLE, 5, NET_UP, owner));
+  HOST_CHECK(owner.last_index == 5);
+  HOST_CHECK(machines.get_state(3) == NET_GOING_DOWN);
+  HOST_CHECK(machines.get_state(5) == NET_GOING_UP);
+  for (size_t i = 0; i < MACHINE_COUNT; ++i) {
+    if (i != 3 && i != 5) {
+      HOST_CHECK(machines.get_state(i) == NET_INITIALIZED);
+    }
+  }
+  HOST_CHECK(!machines.dispatch(TRANSITION_TABLE, 0, NET_EVENT_COUNT, owner));
+  HOST_CHECK(owner.total == 2);
+}
+
+/**
+ * The previous style: a table of enums with NET_STATE_COUNT marking
+ * ignored events, and the entry actions in a switch.
+ */
+static const NetState LEGACY_TABLE[NET_STATE_COUNT][NET_EVENT_COUNT] = {
+  {NET_GOING_DOWN, NET_GOING_UP, NET_SENDER_PANIC},
+  {NET_DISCONNECTED, NET_GOING_UP, NET_SENDER_PANIC},
+  {NET_DISCONNECTED, NET_GOING_UP, NET_SENDER_PANIC},
+  {NET_GOING_DOWN, NET_CONNECTED, NET_SENDER_PANIC},
+  {NET_GOING_DOWN, NET_CONNECTED, NET_SENDER_PANIC},
+  {NET_STATE_COUNT, NET_STATE_COUNT, NET_STATE_COUNT},
+};
+
+struct LegacyMachine {
+  NetState state;
+  CountingOwner owner;
+
+  void step(NetEvent event) {
+    NetState next = LEGACY_TABLE[state][event];
+    if (next == NET_STATE_COUNT) {
+      return;
+    }
+    switch (state = next) {
+      case NET_INITIALIZED:
+      case NET_GOING_DOWN:
+      case NET_DISCONNECTED:
+      case NET_GOING_UP:
+      case NET_CONNECTED:
+      case NET_SENDER_PANIC:
+        owner.on_enter(state);
+        break;
+      default:
+        break;
+    }
+  }
+};
+
+/**
+ * Seeded events, identical on every host. Never NET_SENDER_FAILED, so
+ * the machines keep moving.
+ */
+static uint32_t random_state;
+
+static unsigned next_event(void) {
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 16) & 1;
+}
+
+static void benchmark(void) {
+  NetStateMachine machine(NET_INITIALIZED);
+  CountingOwner owner;
+  random_state = 12345;
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_EVENTS; ++i) {
+    machine.dispatch(TRANSITION_TABLE, next_event(), owner);
+  }
+  double machine_seconds = (host_nanoseconds() - start) / 1e9;
+
+  NetStateMachineArray machines(NET_INITIALIZED);
+  CountingOwner array_owner;
+  random_state = 12345;
+  start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_EVENTS; ++i) {
+    machines.dispatch(
+        TRANSITION_TABLE,
+        i % MACHINE_COUNT,
+        next_event(),
+        array_owner);
+  }
+  double array_seconds = (host_nanoseconds() - start) / 1e9;
+
+  LegacyMachine legacy;
+  legacy.state = NET_INITIALIZED;
+  random_state = 12345;
+  start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_EVENTS; ++i) {
+    legacy.step((NetEvent) next_event());
+  }
+  double legacy_seconds = (host_nanoseconds() - start) / 1e9;
+
+  // Same events, same transitions.
+  HOST_CHECK(owner.total == BENCHMARK_EVENTS);
+  HOST_CHECK(legacy.owner.total == BENCHMARK_EVENTS);
+  HOST_CHECK(array_owner.total == BENCHMARK_EVENTS);
+  for (size_t i = 0; i < NET_STATE_COUNT; ++i) {
+    HOST_CHECK(owner.entries[i] == legacy.owner.entries[i]);
+  }
+  host_benchmark_sink = owner.entries[NET_CONNECTED]
+      + array_owner.entries[NET_CONNECTED]
+      + legacy.owner.entries[NET_CONNECTED];
+
+  printf(
+      "Transitions/s: StateMachine %.0f M, StateMachineArray %.0f M,"
+      " enum table and switch %.0f M. Table bytes: %u vs %u.\n",
+      BENCHMARK_EVENTS / machine_seconds / 1e6,
+      BENCHMARK_EVENTS / array_seconds / 1e6,
+      BENCHMARK_EVENTS / legacy_seconds / 1e6,
+      (unsigned) sizeof(TRANSITION_TABLE),
+      (unsigned) sizeof(LEGACY_TABLE));
+}
+
+int main() {
+  test_dispatch();
+  test_array();
+  benchmark();
+  return host_test_result("StateMachineTest");
+}
@@ -0,0 +1,136 @@
+/*
+ * TiltDetectorTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Checks that TiltDetector makes the same decisions as the float
+ * inclination formula that it replaced, over every gravity direction,
+ * and compares their costs.
+ */
+
+#include <math.h>
+
+#include "HostTest.h"
+#include "TiltDetector.h"
+
+#define THRESHOLD_RADIANS (M_PI / 6)  // As GyroscopeTask uses
+#define ONE_G 16384                   // Raw units at +/- 2 g
+#define STEP_DEGREES 0.25
+#define BOUNDARY_DEGREES 0.25  // Quantization allowance at the threshold
+#define BENCHMARK_ITERATIONS 2000000
+
+static constexpr TiltDetector tilt_detector(THRESHOLD_RADIANS);
+
+static const double DEGREES = M_PI / 180;
+
+/**
+ * The formula that the sender used, on MPU6050_light style angles.
+ */
+static float float_inclination(float roll_radians, float pitch_radians) {
+  float tan_roll = tanf(roll_radians);
+  float tan_pitch = tanf(pitch_radians);
+  return atanf(sqrtf(tan_roll * tan_roll + tan_pitch * tan_pitch));
+}
+
+/**
+ * Derives roll and pitch from gravity as MPU6050_light does.
+ */
+static void angles(
+    double x, double y, double z, float *roll, float *pitch) {
+  *roll = atan2(y, (z < 0 ? -1 : 1) * sqrt(x * x + z * z));
+  *pitch = -atan2(x, sqrt(y * y + z * z));
+}
+
+static void test_equivalence(void) {
+  uint32_t decisions = 0;
+  uint32_t mismatches = 0;
+  uint32_t near_threshold = 0;
+  // Every direction on the sphere: polar angle from +Z and azimuth.
+  for (double polar = 0; polar <= 180; polar += STEP_DEGREES) {
+    for (double azimuth = 0; azimuth < 360; azimuth += STEP_DEGREES) {
+      double x = sin(polar * DEGREES) * cos(azimuth * DEGREES);
+      double y = sin(polar * DEGREES) * sin(azimuth * DEGREES);
+      double z = cos(polar * DEGREES);
+      float roll;
+      float pitch;
+      angles(x, y, z, &roll, &pitch);
+      float inclination = float_inclination(roll, pitch);
+      bool expected = THRESHOLD_RADIANS < inclination;
+      bool actual = tilt_detector.is_tilted(
+          lround(x * ONE_G), lround(y * ONE_G), lround(z * ONE_G));
+      ++decisions;
+      if (expected != actual) {
+        if (fabs(inclination - THRESHOLD_RADIANS)
+            < BOUNDARY_DEGREES * DEGREES) {
+          ++near_threshold;
+        } else {
+          ++mismatches;
+        }
+      }
+    }
+  }
+  printf(
+      "Equivalence: %u decisions, %u differ within %.2f degrees of the"
+      " threshold, %u elsewhere.\n",
+      (unsigned) decisions,
+      (unsigned) near_threshold,
+      BOUNDARY_DEGREES,
+      (unsigned) mismatches);
+  HOST_CHECK(!mismatches);
+}
+
+static void test_edges(void) {
+  HOST_CHECK(!tilt_detector.is_tilted(0, 0, ONE_G));
+  HOST_CHECK(!tilt_detector.is_tilted(0, 0, -ONE_G));
+  HOST_CHECK(tilt_detector.is_tilted(0, ONE_G, 0));
+  HOST_CHECK(tilt_detector.is_tilted(ONE_G, 0, 0));
+  // Out of range components are clamped, not wrapped.
+  HOST_CHECK(!tilt_detector.is_tilted(0, 0, 100000));
+  HOST_CHECK(tilt_detector.get_cosine_squared_q16() == 49152);  // 3/4
+}
+
+static void benchmark(void) {
+  int32_t gravity[64][3];
+  float rolls[64];
+  float pitches[64];
+  for (size_t i = 0; i < 64; ++i) {
+    double polar = i * 90.0 / 64;
+    double azimuth = i * 37.0;
+    double x = sin(polar * DEGREES) * cos(azimuth * DEGREES);
+    double y = sin(polar * DEGREES) * sin(azimuth * DEGREES);
+    double z = cos(polar * DEGREES);
+    gravity[i][0] = lround(x * ONE_G);
+    gravity[i][1] = lround(y * ONE_G);
+    gravity[i][2] = lround(z * ONE_G);
+    angles(x, y, z, rolls + i, pitches + i);
+  }
+
+  uint32_t tilted = 0;
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i) {
+    const int32_t *g = gravity[i & 63];
+    tilted += tilt_detector.is_tilted(g[0], g[1], g[2]);
+  }
+  uint64_t integer_ns = host_nanoseconds() - start;
+
+  start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; ++i) {
+    tilted += THRESHOLD_RADIANS
+        < float_inclination(rolls[i & 63], pitches[i & 63]);
+  }
+  uint64_t float_ns = host_nanoseconds() - start;
+  host_benchmark_sink = tilted;
+
+  printf(
+      "Per decision: integer %.1f ns, float formula %.1f ns.\n",
+      (double) integer_ns / BENCHMARK_ITERATIONS,
+      (double) float_ns / BENCHMARK_ITERATIONS);
+}
+
+int main() {
+  test_edges();
+  test_equivalence();
+  benchmark();
+  return host_test_result("TiltDetectorTest");
+}
@@ -0,0 +1,264 @@
+/*
+ * TimingWheelTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Checks the TimingWheel against a plain array of expiry ticks over
+ * seeded random starts, stops, and advances, across the 32 bit tick
+ * wrap and beyond the range of the wheel. Then measures start and stop
+ * throughput against a sorted timer list like the one that FreeRTOS
+ * software timers keep.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "HostTest.h"
+#include "TimingWheel.h"
+
+#define RANDOM_TIMERS 500
+#define RANDOM_STEPS 2000000
+#define BENCHMARK_TIMERS 1000
+#define BENCHMARK_ROUNDS 2000
+
+/**
+ * Seeded randomness, identical on every host.
+ */
+static uint32_t random_state = 12345;
+
+static uint32_t next_random(void) {
+  random_state = random_state * 1103515245 + 12345;
+  return (random_state >> 16) & 0x7FFF;
+}
+
+static void test_basics(void) {
+  TimingWheel wheel;
+  WheelTimer a;
+  WheelTimer b;
+  static const int A_MESSAGE = 1;
+  TimingWheel::init(&a, &wheel, &A_MESSAGE);
+  TimingWheel::init(&b, NULL, NULL);
+  HOST_CHECK(!TimingWheel::is_active(&a));
+
+  // With nothing pending, advance() jumps.
+  wheel.advance(1000000);
+  HOST_CHECK(wheel.get_next_tick() == 1000001);
+
+  wheel.start(&a, 1000010);
+  wheel.start(&b, 1000010);
+  HOST_CHECK(wheel.get_pending() == 2);
+  wheel.advance(1000009);
+  HOST_CHECK(!wheel.take_expired());
+  wheel.advance(1000010);
+  HOST_CHECK(!wheel.get_pending());
+  HOST_CHECK(TimingWheel::is_active(&a));
+
+  // An expiry can be cancelled until it is taken.
+  wheel.stop(&b);
+  HOST_CHECK(!TimingWheel::is_active(&b));
+  WheelTimer *expired = wheel.take_expired();
+  HOST_CHECK(expired == &a);
+  HOST_CHECK(expired->target == &wheel && expired->message == &A_MESSAGE);
+  HOST_CHECK(!wheel.take_expired());
+  HOST_CHECK(!TimingWheel::is_active(&a));
+
+  // A tick already processed expires on the next advance().
+  wheel.start(&a, 1000000);
+  wheel.advance(1000011);
+  HOST_CHECK(wheel.take_expired() == &a);
+
+  // Restarting moves the timer; stopping an idle timer does nothing.
+  wheel.start(&a, 1000100);
+  wheel.start(&a, 1000200);
+  HOST_CHECK(wheel.get_pending() == 1);
+  wheel.advance(1000150);
+  HOST_CHECK(!wheel.take_expired());
+  wheel.stop(&a);
+  wheel.stop(&a);
+  HOST_CHECK(!wheel.get_pending());
+
+  // Restarting an expired timer that has not been taken rearms it.
+  wheel.start(&a, 1000300);
+  wheel.advance(1000300);
+  wheel.start(&a, 1000400);
+  HOST_CHECK(wheel.get_pending() == 1);
+  HOST_CHECK(!wheel.take_expired());
+  wheel.advance(1000400);
+  HOST_CHECK(wheel.take_expired() == &a);
+
+  // Beyond the range of the wheel.
+  wheel.start(&a, 1000400 + 3 * TIMING_WHEEL_RANGE);
+  wheel.advance(1000400 + 3 * TIMING_WHEEL_RANGE - 1);
+  HOST_CHECK(!wheel.take_expired());
+  wheel.advance(1000400 + 3 * TIMING_WHEEL_RANGE);
+  HOST_CHECK(wheel.take_expired() == &a);
+}
+
+static void test_random(void) {
+  static WheelTimer timers[RANDOM_TIMERS];
+  uint32_t due[RANDOM_TIMERS];
+  bool armed[RANDOM_TIMERS];
+  static size_t indexes[RANDOM_TIMERS];
+  TimingWheel wheel;
+  for (size_t i = 0; i < RANDOM_TIMERS; ++i) {
+    indexes[i] = i;
+    TimingWheel::init(timers + i, NULL, indexes + i);
+    armed[i] = false;
+  }
+
+  // Start just short of the wrap.
+  uint32_t now = 0xFFFF0000;
+  wheel.advance(now);
+  uint32_t fired = 0;
+  uint32_t early = 0;
+  uint32_t late = 0;
+  uint32_t spurious = 0;
+  for (uint32_t step = 0; step < RANDOM_STEPS; ++step) {
+    size_t i = next_random() % RANDOM_TIMERS;
+    uint32_t operation = next_random() % 10;
+    if (operation < 3) {
+      // Mostly short delays, some past the range of the wheel.
+      uint32_t delay = next_random() % 8
+          ? 1 + next_random() % 5000
+          : 1 + (next_random() << 5) % (2 * TIMING_WHEEL_RANGE);
+      due[i] = now + delay;
+      armed[i] = true;
+      wheel.start(timers + i, due[i]);
+    } else if (operation < 4) {
+      armed[i] = false;
+      wheel.stop(timers + i);
+    } else {
+      now += next_random() % 50;
+      wheel.advance(now);
+      for (WheelTimer *timer = wheel.take_expired();
+          timer;
+          timer = wheel.take_expired()) {
+        size_t k = *(const size_t *) timer->message;
+        if (!armed[k]) {
+          ++spurious;
+        } else if ((int32_t) (now - due[k]) < 0) {
+          ++early;
+        }
+        armed[k] = false;
+        ++fired;
+      }
+      for (size_t k = 0; k < RANDOM_TIMERS; ++k) {
+        if (armed[k] && (int32_t) (due[k] - now) <= 0) {
+          ++late;
+          armed[k] = false;
+          wheel.stop(timers + k);
+        }
+      }
+    }
+  }
+  size_t armed_count = 0;
+  for (size_t k = 0; k < RANDOM_TIMERS; ++k) {
+    armed_count += armed[k];
+  }
+  HOST_CHECK(!spurious);
+  HOST_CHECK(!early);
+  HOST_CHECK(!late);
+  HOST_CHECK(wheel.get_pending() == armed_count);
+  HOST_CHECK(100000 < fired);
+  HOST_CHECK((int32_t) (now - 0xFFFF0000) > 0x10000);
+}
+
+/**
+ * A list kept sorted by expiry, as FreeRTOS keeps its timer list.
+ * Starting walks the list to the insertion point.
+ */
+struct ListTimer {
+  ListTimer *next;
+  ListTimer **link;
+  uint32_t expires;
+};
+
+class SortedTimerList {
+  ListTimer *head;
+
+public:
+  SortedTimerList() :
+      head(NULL) {
+  }
+
+  void start(ListTimer *timer, uint32_t expires) {
+    if (timer->link) {
+      stop(timer);
+    }
+    timer->expires = expires;
+    ListTimer **link = &head;
+    while (*link && (*link)->expires <= expires) {
+      link = &(*link)->next;
+    }
+    timer->next = *link;
+    if (timer->next) {
+      timer->next->link = &timer->next;
+    }
+    timer->link = link;
+    *link = timer;
+  }
+
+  void stop(ListTimer *timer) {
+    *timer->link = timer->next;
+    if (timer->next) {
+      timer->next->link = timer->link;
+    }
+    timer->next = NULL;
+    timer->link = NULL;
+  }
+};
+
+static void benchmark(void) {
+  static WheelTimer wheel_timers[BENCHMARK_TIMERS];
+  static ListTimer list_timers[BENCHMARK_TIMERS];
+  static uint32_t delays[BENCHMARK_TIMERS];
+  TimingWheel wheel;
+  SortedTimerList list;
+  for (size_t i = 0; i < BENCHMARK_TIMERS; ++i) {
+    TimingWheel::init(wheel_timers + i, NULL, NULL);
+    memset(list_timers + i, 0, sizeof(list_timers[i]));
+    delays[i] = 1 + next_random() % 5000;
+  }
+
+  // Arm every timer, then cancel every timer, in each round.
+  uint64_t start = host_nanoseconds();
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIMERS; ++i) {
+      wheel.start(wheel_timers + i, round + delays[i]);
+    }
+    for (size_t i = 0; i < BENCHMARK_TIMERS; ++i) {
+      wheel.stop(wheel_timers + i);
+    }
+  }
+  double wheel_seconds = (host_nanoseconds() - start) / 1e9;
+  host_benchmark_sink = wheel.get_pending();
+
+  start = host_nanoseconds();
+  for (uint32_t round = 0; round < BENCHMARK_ROUNDS / 10; ++round) {
+    for (size_t i = 0; i < BENCHMARK_TIMERS; ++i) {
+      list.start(list_timers + i, round + delays[i]);
+    }
+    for (size_t i = 0; i < BENCHMARK_TIMERS; ++i) {
+      list.stop(list_timers + i);
+    }
+  }
+  double list_seconds = (host_nanoseconds() - start) / 1e9;
+
+  double operations = 2.0 * BENCHMARK_ROUNDS * BENCHMARK_TIMERS;
+  printf(
+      "%u timers armed and cancelled: wheel %.1f M operations/s"
+      " (%.1f ns each), sorted list %.1f M operations/s (%.1f ns each).\n",
+      (unsigned) BENCHMARK_TIMERS,
+      operations / wheel_seconds / 1e6,
+      wheel_seconds * 1e9 / operations,
+      operations / 10 / list_seconds / 1e6,
+      list_seconds * 1e9 * 10 / operations);
+}
+
+int main() {
+  test_basics();
+  test_random();
+  benchmark();
+  return host_test_result("TimingWheelTest");
+}
@@ -0,0 +1,208 @@
+/*
+ * WireFormatTest.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Checks the wire format codec: the CRC, in place validation, version
+ * negotiation, and acknowledgments. Then measures validation and decode
+ * throughput.
+ */
+
+#include <string.h>
+
+#include "HostTest.h"
+#include "NotificationBatch.h"
+#include "WireFormat.h"
+
+#define BENCHMARK_FRAMES 2000000
+
+/**
+ * Builds a frame by hand with the specified version fields, header size,
+ * and entry size. Returns its size.
+ */
+static size_t build_frame(
+    uint8_t *frame,
+    uint8_t version,
+    uint8_t compatible_version,
+    uint8_t header_size,
+    uint8_t entry_size) {
+  memset(frame, 0, WIRE_FORMAT_MAX_PAYLOAD_SIZE);
+  frame[WIRE_FORMAT_MAGIC_OFFSET] = WIRE_FORMAT_MAGIC;
+  frame[WIRE_FORMAT_VERSION_OFFSET] = version;
+  frame[WIRE_FORMAT_COMPATIBLE_VERSION_OFFSET] = compatible_version;
+  frame[WIRE_FORMAT_HEADER_SIZE_OFFSET] = header_size;
+  WireFormat::put_uint16(frame + WIRE_FORMAT_SEQUENCE_OFFSET, 0x1234);
+  WireFormat::put_uint32(frame + WIRE_FORMAT_TIMESTAMP_OFFSET, 0xA0B0C0D0);
+  frame[WIRE_FORMAT_ENTRY_COUNT_OFFSET] = 2;
+  frame[WIRE_FORMAT_ENTRY_SIZE_OFFSET] = entry_size;
+  for (size_t i = 0; i < 2; ++i) {
+    uint8_t *entry = frame + header_size + i * entry_size;
+    WireFormat::put_uint32(entry + WIRE_FORMAT_ENTRY_TIMESTAMP_OFFSET, 7 + i);
+    entry[WIRE_FORMAT_ENTRY_STATUS_OFFSET] = LID_RAISED;
+    WireFormat::put_float(
+        entry + WIRE_FORMAT_ENTRY_TEMPERATURE_OFFSET,
+        -4.25f);
+  }
+  size_t crc_offset = header_size + 2 * entry_size;
+  WireFormat::put_uint16(
+      frame + crc_offset,
+      WireFormat::crc16(frame, crc_offset));
+  return crc_offset + WIRE_FORMAT_CRC_SIZE;
+}
+
+static void test_primitives(void) {
+  // The CRC-16/CCITT-FALSE check value.
+  HOST_CHECK(WireFormat::crc16((const uint8_t *) "123456789", 9) == 0x29B1);
+
+  uint8_t bytes[4];
+  WireFormat::put_uint32(bytes, 0x01020304);
+  HOST_CHECK(bytes[0] == 0x04 && bytes[3] == 0x01);
+  HOST_CHECK(WireFormat::get_uint32(bytes) == 0x01020304);
+  WireFormat::put_uint16(bytes, 0xBEEF);
+  HOST_CHECK(bytes[0] == 0xEF && bytes[1] == 0xBE);
+  WireFormat::put_float(bytes, 1.0f);
+  HOST_CHECK(WireFormat::get_uint32(bytes) == 0x3F800000);
+}
+
+static void test_validation(void) {
+  uint8_t frame[WIRE_FORMAT_MAX_PAYLOAD_SIZE];
+  size_t size = build_frame(
+      frame,
+      WIRE_FORMAT_VERSION,
+      WIRE_FORMAT_COMPATIBLE_VERSION,
+      WIRE_FORMAT_HEADER_SIZE,
+      WIRE_FORMAT_ENTRY_SIZE);
+  WireFrameView view(frame, size);
+  HOST_CHECK(view.is_valid());
+  HOST_CHECK(view.get_sequence() == 0x1234);
+  HOST_CHECK(view.get_timestamp_ms() == 0xA0B0C0D0);
+  HOST_CHECK(view.get_entry_count() == 2);
+  HOST_CHECK(view.get_entry_timestamp_ms(1) == 8);
+  HOST_CHECK(view.get_entry_status(1) == LID_RAISED);
+  HOST_CHECK(view.get_entry_temperature_celsius(1) == -4.25f);
+
+  // Every single bit error is caught.
+  bool all_caught = true;
+  for (size_t bit = 0; bit < size * 8; ++bit) {
+    frame[bit / 8] ^= 1 << (bit % 8);
+    all_caught &= !WireFrameView(frame, size).is_valid();
+    frame[bit / 8] ^= 1 << (bit % 8);
+  }
+  HOST_CHECK(all_caught);
+
+  // Truncated and padded frames are rejected.
+  HOST_CHECK(!WireFrameView(frame, size - 1).is_valid());
+  HOST_CHECK(!WireFrameView(frame, size + 1).is_valid());
+  HOST_CHECK(!WireFrameView(frame, 3).is_valid());
+}
+
+static void test_version_negotiation(void) {
+  uint8_t frame[WIRE_FORMAT_MAX_PAYLOAD_SIZE];
+  TimestampedNotification decoded[4];
+  ReceivedFrameInfo info;
+
+  // A version 2 sender: no flags, no boot identifier.
+  size_t size = build_frame(frame, 2, 2, WIRE_FORMAT_V2_HEADER_SIZE, 9);
+  HOST_CHECK(NotificationBatchDecoder::decode(
+      frame, size, decoded, 4, &info) == 2);
+  HOST_CHECK(!info.ack_requested);
+  HOST_CHECK(!info.boot_id);
+
+  // A version 3 sender asking for an acknowledgment.
+  size = build_frame(frame, 3, 2, WIRE_FORMAT_FLAGS_OFFSET + 1, 9);
+  frame[WIRE_FORMAT_FLAGS_OFFSET] = WIRE_FORMAT_FLAG_ACK_REQUESTED;
+  WireFormat::put_uint16(
+      frame + size - WIRE_FORMAT_CRC_SIZE,
+      WireFormat::crc16(frame, size - WIRE_FORMAT_CRC_SIZE));
+  HOST_CHECK(NotificationBatchDecoder::decode(
+      frame, size, decoded, 4, &info) == 2);
+  HOST_CHECK(info.ack_requested);
+  HOST_CHECK(!info.boot_id);
+
+  // A later sender with a longer header and longer entries that this
+  // version can still decode.
+  size = build_frame(
+      frame,
+      WIRE_FORMAT_VERSION + 1,
+      WIRE_FORMAT_VERSION,
+      WIRE_FORMAT_HEADER_SIZE + 4,
+      WIRE_FORMAT_ENTRY_SIZE + 3);
+  HOST_CHECK(NotificationBatchDecoder::decode(
+      frame, size, decoded, 4, &info) == 2);
+  HOST_CHECK(decoded[1].timestamp_ms == 8);
+  HOST_CHECK(decoded[1].message.temperature_celsius == -4.25f);
+
+  // A sender that this version cannot decode.
+  size = build_frame(
+      frame,
+      WIRE_FORMAT_VERSION + 1,
+      WIRE_FORMAT_VERSION + 1,
+      WIRE_FORMAT_HEADER_SIZE,
+      WIRE_FORMAT_ENTRY_SIZE);
+  HOST_CHECK(!NotificationBatchDecoder::decode(
+      frame, size, decoded, 4, &info));
+  HOST_CHECK(!info.has_sequence);
+
+  // Headers and entries shorter than version 2 are malformed.
+  size = build_frame(frame, 2, 2, WIRE_FORMAT_V2_HEADER_SIZE - 1, 9);
+  HOST_CHECK(!WireFrameView(frame, size).is_valid());
+  size = build_frame(frame, 2, 2, WIRE_FORMAT_V2_HEADER_SIZE, 8);
+  HOST_CHECK(!WireFrameView(frame, size).is_valid());
+}
+
+static void test_acknowledgments(void) {
+  uint8_t ack[WIRE_FORMAT_ACK_SIZE];
+  uint16_t sequence = 0;
+  WireFormat::encode_ack(ack, 0xFEDC);
+  HOST_CHECK(WireFormat::decode_ack(ack, sizeof(ack), &sequence));
+  HOST_CHECK(sequence == 0xFEDC);
+  HOST_CHECK(!WireFormat::decode_ack(ack, sizeof(ack) - 1, &sequence));
+  ack[WIRE_FORMAT_ACK_SEQUENCE_OFFSET] ^= 0x01;
+  HOST_CHECK(!WireFormat::decode_ack(ack, sizeof(ack), &sequence));
+}
+
+static void benchmark(void) {
+  NotificationBatchEncoder encoder;
+  MotionNotificationMessage message = {LID_HAS_NOT_MOVED, 21.0f};
+  for (size_t i = 0; i < NOTIFICATION_BATCH_MAX_ENTRIES; ++i) {
+    encoder.add(message, i, false);
+  }
+  encoder.seal(0);
+  const uint8_t *frame = encoder.get_frame();
+  size_t size = encoder.get_frame_size();
+
+  uint32_t valid = 0;
+  uint64_t start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_FRAMES; ++i) {
+    valid += WireFrameView(frame, size).is_valid();
+  }
+  double validate_seconds = (host_nanoseconds() - start) / 1e9;
+
+  TimestampedNotification decoded[NOTIFICATION_BATCH_MAX_ENTRIES];
+  start = host_nanoseconds();
+  for (uint32_t i = 0; i < BENCHMARK_FRAMES; ++i) {
+    valid += NotificationBatchDecoder::decode(
+        frame, size, decoded, NOTIFICATION_BATCH_MAX_ENTRIES);
+  }
+  double decode_seconds = (host_nanoseconds() - start) / 1e9;
+  host_benchmark_sink = valid;
+
+  printf(
+      "%u byte frames: validate %.1f MB/s, %.0f frames/s;"
+      " decode %.1f MB/s, %.0f frames/s.\n",
+      (unsigned) size,
+      BENCHMARK_FRAMES * size / validate_seconds / 1e6,
+      BENCHMARK_FRAMES / validate_seconds,
+      BENCHMARK_FRAMES * size / decode_seconds / 1e6,
+      BENCHMARK_FRAMES / decode_seconds);
+}
+
+int main() {
+  test_primitives();
+  test_validation();
+  test_version_negotiation();
+  test_acknowledgments();
+  benchmark();
+  return host_test_result("WireFormatTest");
+}
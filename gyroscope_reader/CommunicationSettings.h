@@ -12,8 +12,17 @@
 
 #include "Arduino.h"
 
-// Receiver MAC address: CC:DB:A7:01:E6:10
+// Receiver MAC addresses. Every receiver is alerted.
+//
+//   Kitchen: CC:DB:A7:01:E6:10
+//   Bedroom: 78:21:84:7F:7E:40
 
-static const uint8_t receiver_address[] = {0xCC, 0xDB, 0xA7, 0x01, 0xE6, 0x10};
+static const uint8_t receiver_addresses[][6] = {
+  {0xCC, 0xDB, 0xA7, 0x01, 0xE6, 0x10},
+  {0x78, 0x21, 0x84, 0x7F, 0x7E, 0x40},
+};
+
+#define RECEIVER_COUNT \
+  (sizeof(receiver_addresses) / sizeof(receiver_addresses[0]))
 
 #endif /* COMMUNICATIONSETTINGS_H_ */
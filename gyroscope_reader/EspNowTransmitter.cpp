@@ -7,131 +7,674 @@
 
 #include "EspNowTransmitter.h"
 
-#include "TaskPriorities.h"
+#include "EventStore.h"
 
 #include "PinAssignments.h"
 
-enum EspSendState {
-	SUCCESSFUL,  // Send succeeded
-	FAILED,  // Send failed.
-	ESP_SEND_STATUS_LAST,  // MUST be last
-};
+/**
+ * Heartbeat interval bounds. The maximum must stay below the receiver's
+ * shortest gyroscope connection watchdog timeout, 1100 ms.
+ */
+#define MIN_HEARTBEAT_INTERVAL_MS 250
+#define MAX_HEARTBEAT_INTERVAL_MS 1000
+
+/**
+ * Longest heartbeat interval while heartbeats are broadcast. The radio
+ * cannot confirm a broadcast, so a receiver that misses one must hear
+ * the next before its shortest watchdog timeout, 1100 ms, expires.
+ */
+#define MAX_BROADCAST_HEARTBEAT_INTERVAL_MS 500
+
+/**
+ * The gyroscope is presumed lost after this long without a notification.
+ */
+#define GYROSCOPE_SILENCE_MS 1000
+
+/**
+ * Longest time that a notification waits in a batch. This bounds the
+ * added lid raise latency.
+ */
+#define BATCH_FLUSH_DEADLINE_MS 100
+
+/**
+ * Acknowledgment wait after the first send. Each retransmission doubles
+ * it: 50, 100, 200, 400, and 800 ms, about 1.5 s in all.
+ */
+#define ACK_TIMEOUT_MS 50
+#define MAX_SEND_ATTEMPTS 6
+
+/**
+ * Status changes owed to receivers. Each takes sizeof(StoredEvent), 16
+ * bytes, of RTC memory, which holds 8 KB in all. A change owed to
+ * several receivers is stored once.
+ */
+#define STORED_EVENT_CAPACITY 32
+
+/**
+ * Time between transmission statistics reports.
+ */
+#define STATISTICS_REPORT_INTERVAL_MS 60000
+
+/**
+ * Longest time that broadcast receivers go without being asked for an
+ * acknowledgment. This bounds the time to notice that one has dropped.
+ */
+#define PROBE_INTERVAL_MS 2000
+
+static const uint8_t BROADCAST_ADDRESS[ESP_NOW_ETH_ALEN] =
+    {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
-BlinkTask* EspNowTransmitter::global_blink_task = NULL;
+EspNowTransmitter* EspNowTransmitter::instance = NULL;
+LedPatternEngine* EspNowTransmitter::status_leds = NULL;
+volatile uint32_t
+    EspNowTransmitter::deliveries_succeeded[ESP_NOW_MAX_RECEIVERS] = {0};
+volatile uint32_t
+    EspNowTransmitter::deliveries_failed[ESP_NOW_MAX_RECEIVERS] = {0};
+volatile bool
+    EspNowTransmitter::last_delivery_succeeded[ESP_NOW_MAX_RECEIVERS] =
+        {false};
+volatile uint32_t EspNowTransmitter::broadcasts_sent = 0;
+
+// Status changes owed to receivers. RTC memory survives a software
+// reset, a brownout, and deep sleep, so a sender restart during an
+// outage does not lose them.
+RTC_NOINIT_ATTR static EventStore<STORED_EVENT_CAPACITY> stored_events;
+
+// Red LED pattern while any receiver is unreachable: three 150 ms
+// flashes, then a pause.
+static const LedStep CONNECTION_LOST_BLINK_STEPS[] = {
+  { HIGH, 150 },
+  { LOW, 150 },
+  { HIGH, 150 },
+  { LOW, 150 },
+  { HIGH, 150 },
+  { LOW, 500 },
+};
+static const LedPattern CONNECTION_LOST_BLINK = {
+  CONNECTION_LOST_BLINK_STEPS,
+  6,
+  0,
+};
 
 void EspNowTransmitter::send_callback(
   const uint8_t *mac_address,
   esp_now_send_status_t send_status) {
-  if (global_blink_task) {
-    switch (send_status) {
-    case ESP_NOW_SEND_SUCCESS:
-      digitalWrite(GREEN_LED_PIN, HIGH);
-      global_blink_task->suspend();
-      break;
-    case ESP_NOW_SEND_FAIL:
-      digitalWrite(GREEN_LED_PIN, LOW);
-      global_blink_task->resume();
-      break;
-    }
-  } else {
-    Serial.println("Blink task is unavailable.");
+  int peer = instance ? instance->find_peer(mac_address) : -1;
+  if (peer < 0) {
+    // A broadcast, which the radio never acknowledges, so it always
+    // reports success.
+    ++broadcasts_sent;
+    return;
+  }
+  switch (send_status) {
+  case ESP_NOW_SEND_SUCCESS:
+    ++deliveries_succeeded[peer];
+    last_delivery_succeeded[peer] = true;
+    break;
+  case ESP_NOW_SEND_FAIL:
+    ++deliveries_failed[peer];
+    last_delivery_succeeded[peer] = false;
+    break;
   }
 }
 
-const EspNowTransmitter::ConnectionState STATE_TRANSITION_TABLE
+static constexpr uint8_t STATE_TRANSITION_TABLE
     [EspNowTransmitter::LAST_CONNECTION_STATE]
-    [EspSendState::ESP_SEND_STATUS_LAST] = {
+    [EspNowTransmitter::ESP_SEND_STATUS_LAST] = {
   {   // STARTING
-    EspNowTransmitter::RECONNECTED,  // Successful
-    EspNowTransmitter::STARTING,   // Failed
+    fsm_to(EspNowTransmitter::RECONNECTED),  // Successful
+    fsm_to(EspNowTransmitter::STARTING),   // Failed
   },
   {	// RECONNECTED
-    EspNowTransmitter::CONNECTED,  // Successful
-    EspNowTransmitter::CONNECTION_LOST,  // Failed.
+    fsm_to(EspNowTransmitter::CONNECTED),  // Successful
+    fsm_to(EspNowTransmitter::CONNECTION_LOST),  // Failed.
   },
   {	// CONNECTED
-    EspNowTransmitter::CONNECTED,  // Successful
-    EspNowTransmitter::CONNECTION_LOST,  // Failed.
+    fsm_to(EspNowTransmitter::CONNECTED),  // Successful
+    fsm_to(EspNowTransmitter::CONNECTION_LOST),  // Failed.
   },
   {	// CONNECTION_LOST
-    EspNowTransmitter::RECONNECTED,  // Successful
-    EspNowTransmitter::DISCONNECTED,  // Failed
+    fsm_to(EspNowTransmitter::RECONNECTED),  // Successful
+    fsm_to(EspNowTransmitter::DISCONNECTED),  // Failed
   },
   {	// DISCONNECTED
-    EspNowTransmitter::RECONNECTED,
-    EspNowTransmitter::DISCONNECTED,
+    fsm_to(EspNowTransmitter::RECONNECTED),  // Successful
+    fsm_to(EspNowTransmitter::DISCONNECTED),  // Failed
   }
 };
 
+static_assert(
+    fsm_table_is_complete(STATE_TRANSITION_TABLE),
+    "Every connection state must handle every send result.");
+static_assert(
+    fsm_all_states_reachable(
+        STATE_TRANSITION_TABLE,
+        fsm_state_bit(EspNowTransmitter::STARTING)),
+    "Every connection state must be reachable.");
+
 EspNowTransmitter::EspNowTransmitter(
-    const uint8_t *peer_address,
-      BlinkTask *blink_task) :
-          Task(
-              "ESP-Now transmitter",
-              2048,
-              ESP_NOW_SEND_PRIORITY),
-      connection_state(STARTING),
-      peer_address(peer_address),
+    const uint8_t (*peer_addresses)[ESP_NOW_ETH_ALEN],
+      size_t peer_count,
+      LedPatternEngine *status_leds,
+      TransmitMode transmit_mode) :
+          StaticTask("ESP-Now transmitter", TASK_ROLE_ESP_NOW_SEND),
+      connection_states(STARTING),
+      peer_addresses(peer_addresses),
+      peer_count(
+          peer_count < ESP_NOW_MAX_RECEIVERS
+              ? peer_count
+              : ESP_NOW_MAX_RECEIVERS),
+      acknowledged_seen(0),
+      delivered_change_peers(0),
+      last_probe_ms(0),
+      all_reachable_shown(false),
       h_notification_send_queue(0),
-      wait_for_incoming_in_ticks(pdMS_TO_TICKS(1)),
+      heartbeat_policy(
+          MIN_HEARTBEAT_INTERVAL_MS,
+          MAX_HEARTBEAT_INTERVAL_MS),
+      transmit_mode(transmit_mode),
+      batch(),
+      retransmit_queue(ACK_TIMEOUT_MS, MAX_SEND_ATTEMPTS),
+      ack_queue(),
+      h_ack_queue(NULL),
+      frames_sent(0),
+      bytes_sent(0),
       builtin_led_state(LOW) {
+  memset(succeeded_seen, 0, sizeof(succeeded_seen));
+  memset(failed_seen, 0, sizeof(failed_seen));
+  memset(acks_received, 0, sizeof(acks_received));
+  memset(unicasts_sent, 0, sizeof(unicasts_sent));
+  memset(delivered_change_ms, 0, sizeof(delivered_change_ms));
   notification_message.status = PING;
   notification_message.temperature_celsius = ABSOLUTE_ZERO;
-  start_time = millis();
+  instance = this;
+  EspNowTransmitter::status_leds = status_leds;
 }
 
 EspNowTransmitter::~EspNowTransmitter() {
 }
 
+int EspNowTransmitter::find_peer(const uint8_t *mac_address) const {
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    if (!memcmp(peer_addresses[peer], mac_address, ESP_NOW_ETH_ALEN)) {
+      return peer;
+    }
+  }
+  return -1;
+}
+
+void EspNowTransmitter::receive_callback(
+    const uint8_t *mac_address,
+    const uint8_t *data,
+    int data_length) {
+  AckArrival ack;
+  int peer = instance ? instance->find_peer(mac_address) : -1;
+  if (0 <= peer
+      && instance->h_ack_queue
+      && WireFormat::decode_ack(
+          data,
+          data_length < 0 ? 0 : data_length,
+          &ack.sequence)) {
+    ack.peer = peer;
+    ack.arrival_ms = millis();
+    xQueueSendToBack(instance->h_ack_queue, &ack, 0);
+  }
+}
+
+void EspNowTransmitter::service_acknowledgments(void) {
+  AckArrival ack;
+  while (xQueueReceive(h_ack_queue, &ack, 0) == pdTRUE) {
+    ++acks_received[ack.peer];
+    retransmit_queue.on_ack(ack.sequence, ack.arrival_ms, ack.peer, *this);
+    advance_connection_state(ack.peer, true);
+  }
+  // Receivers that let a frame run out of attempts are gone.
+  advance_connection_states(
+      retransmit_queue.service(millis(), *this),
+      false);
+}
+
+void EspNowTransmitter::advance_connection_state(
+    size_t peer,
+    bool send_succeeded) {
+  connection_states.dispatch(
+      STATE_TRANSITION_TABLE,
+      peer,
+      send_succeeded ? SUCCESSFUL : FAILED,
+      *this);
+}
+
+void EspNowTransmitter::advance_connection_states(
+    PeerSet peers,
+    bool send_succeeded) {
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    if (peers & peer_set_of(peer)) {
+      advance_connection_state(peer, send_succeeded);
+    }
+  }
+}
+
+void EspNowTransmitter::on_enter(size_t peer, ConnectionState new_state) {
+  switch (new_state) {
+    case STARTING:
+      break;
+    case RECONNECTED:
+      Serial.printf("Receiver %u is reachable.\n", (unsigned) peer);
+      break;
+    case CONNECTED:
+      break;
+    case CONNECTION_LOST:
+      Serial.printf("Receiver %u is unreachable.\n", (unsigned) peer);
+      break;
+    case DISCONNECTED:
+      break;
+    case LAST_CONNECTION_STATE:
+      // Should never happen.
+      break;
+  }
+  show_link_status();
+}
+
+void EspNowTransmitter::show_link_status(void) {
+  bool all_reachable = reachable_peers() == all_peers();
+  // Restarting the blink would break its rhythm, so change the LEDs only
+  // when the status changes.
+  if (all_reachable == all_reachable_shown) {
+    return;
+  }
+  all_reachable_shown = all_reachable;
+  if (all_reachable) {
+    status_leds->show(GREEN_LED_PIN, LED_PATTERN_ON);
+    status_leds->show(RED_LED_PIN, LED_PATTERN_OFF);
+  } else {
+    status_leds->show(GREEN_LED_PIN, LED_PATTERN_OFF);
+    status_leds->show(RED_LED_PIN, CONNECTION_LOST_BLINK);
+  }
+}
+
+void EspNowTransmitter::on_delivery_results(void) {
+  uint32_t delivered = 0;
+  uint32_t failed = 0;
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    uint32_t succeeded_now = deliveries_succeeded[peer];
+    uint32_t failed_now = deliveries_failed[peer];
+    uint32_t peer_delivered = succeeded_now - succeeded_seen[peer];
+    uint32_t peer_failed = failed_now - failed_seen[peer];
+    succeeded_seen[peer] = succeeded_now;
+    failed_seen[peer] = failed_now;
+    delivered += peer_delivered;
+    failed += peer_failed;
+
+    // Only the most recent outcome is known to be last, so apply the
+    // other one first.
+    bool last_succeeded = last_delivery_succeeded[peer];
+    if (last_succeeded ? peer_failed : peer_delivered) {
+      advance_connection_state(peer, !last_succeeded);
+    }
+    if (last_succeeded ? peer_delivered : peer_failed) {
+      advance_connection_state(peer, last_succeeded);
+    }
+  }
+  // Broadcasts always report success, which proves nothing, so only
+  // acknowledgments confirm delivery to broadcast receivers. Keep
+  // broadcast heartbeats close enough together that losing one does not
+  // starve a receiver's watchdog; the probes catch receivers that miss
+  // more.
+  uint32_t acknowledged_now = retransmit_queue.get_frames_acknowledged();
+  delivered += acknowledged_now - acknowledged_seen;
+  acknowledged_seen = acknowledged_now;
+  heartbeat_policy.set_max_interval_ms(
+      should_broadcast(reachable_peers())
+          ? MAX_BROADCAST_HEARTBEAT_INTERVAL_MS
+          : MAX_HEARTBEAT_INTERVAL_MS);
+  heartbeat_policy.on_delivery_results(delivered, failed);
+}
+
+PeerSet EspNowTransmitter::reachable_peers(void) const {
+  PeerSet reachable = 0;
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    ConnectionState state = connection_states.get_state(peer);
+    if (state == RECONNECTED || state == CONNECTED) {
+      reachable |= peer_set_of(peer);
+    }
+  }
+  return reachable;
+}
+
+bool EspNowTransmitter::should_broadcast(PeerSet reachable) {
+  // One broadcast replaces two or more unicasts.
+  return reachable & (reachable - 1);
+}
+
+bool EspNowTransmitter::transmit(
+    const uint8_t *mac_address,
+    const uint8_t *frame,
+    size_t frame_size) {
+  esp_err_t send_status = esp_now_send(mac_address, frame, frame_size);
+  ++frames_sent;
+  bytes_sent += frame_size;
+  builtin_led_state = builtin_led_state ? LOW : HIGH;
+  digitalWrite(BUILTIN_LED_PIN, builtin_led_state);
+  return send_status == ESP_OK;
+}
+
+bool EspNowTransmitter::send_first_copy(
+    const uint8_t *frame,
+    size_t frame_size,
+    PeerSet peers) {
+  bool sent = true;
+  PeerSet broadcast_peers = reachable_peers();
+  if (peers == all_peers() && should_broadcast(broadcast_peers)) {
+    if (!transmit(BROADCAST_ADDRESS, frame, frame_size)) {
+      advance_connection_states(broadcast_peers, false);
+      sent = false;
+    }
+    peers &= ~broadcast_peers;
+  }
+  return send_frame(frame, frame_size, peers) && sent;
+}
+
+bool EspNowTransmitter::send_frame(
+    const uint8_t *frame,
+    size_t frame_size,
+    PeerSet peers) {
+  // ESP_OK only means that a frame was queued. The send callback
+  // reports whether a unicast receiver got it, which advances its
+  // connection state from the task loop.
+  bool sent = true;
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    if (peers & peer_set_of(peer)) {
+      ++unicasts_sent[peer];
+      if (!transmit(peer_addresses[peer], frame, frame_size)) {
+        advance_connection_state(peer, false);
+        sent = false;
+      }
+    }
+  }
+  return sent;
+}
+
+void EspNowTransmitter::on_frame_acknowledged(
+    const uint8_t *frame,
+    size_t frame_size,
+    size_t peer) {
+  TimestampedNotification notifications[NOTIFICATION_BATCH_MAX_ENTRIES];
+  size_t count = NotificationBatchDecoder::decode(
+      frame,
+      frame_size,
+      notifications,
+      NOTIFICATION_BATCH_MAX_ENTRIES);
+  PeerSet peer_bit = peer_set_of(peer);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t timestamp_ms = notifications[i].timestamp_ms;
+    if (notifications[i].message.status != PING
+        && (!(delivered_change_peers & peer_bit)
+            || 0 < (int32_t) (timestamp_ms - delivered_change_ms[peer]))) {
+      delivered_change_ms[peer] = timestamp_ms;
+      delivered_change_peers |= peer_bit;
+    }
+  }
+}
+
+void EspNowTransmitter::on_frame_abandoned(
+    const uint8_t *frame,
+    size_t frame_size,
+    PeerSet unacknowledged) {
+  // The receivers that did acknowledge it already have the changes.
+  hold_changes(frame, frame_size, unacknowledged);
+}
+
+PeerSet EspNowTransmitter::held_peers(void) const {
+  if (transmit_mode == SEND_LEGACY_MESSAGES) {
+    return 0;
+  }
+  return (all_peers() & ~reachable_peers()) | stored_events.get_owed_peers();
+}
+
+void EspNowTransmitter::hold_changes(
+    const uint8_t *frame,
+    size_t frame_size,
+    PeerSet peers) {
+  TimestampedNotification notifications[NOTIFICATION_BATCH_MAX_ENTRIES];
+  size_t count = NotificationBatchDecoder::decode(
+      frame,
+      frame_size,
+      notifications,
+      NOTIFICATION_BATCH_MAX_ENTRIES);
+  for (size_t i = 0; i < count; ++i) {
+    if (notifications[i].message.status == PING) {
+      continue;
+    }
+    // Receivers that acknowledged a newer change are past this one.
+    PeerSet owed = peers;
+    for (size_t peer = 0; peer < peer_count; ++peer) {
+      if ((delivered_change_peers & peer_set_of(peer))
+          && 0 <= (int32_t) (delivered_change_ms[peer]
+              - notifications[i].timestamp_ms)) {
+        owed &= ~peer_set_of(peer);
+      }
+    }
+    stored_events.push(notifications[i], owed);
+  }
+}
+
+void EspNowTransmitter::replay_stored_events(void) {
+  PeerSet ready = stored_events.get_owed_peers()
+      & reachable_peers()
+      & ~retransmit_queue.get_awaiting();
+  for (size_t peer = 0;
+      ready
+          && peer < peer_count
+          && retransmit_queue.get_pending_count() < RETRANSMIT_QUEUE_CAPACITY;
+      ++peer) {
+    PeerSet peer_bit = peer_set_of(peer);
+    if (!(ready & peer_bit)) {
+      continue;
+    }
+    flush_batch();
+    TimestampedNotification notifications[NOTIFICATION_BATCH_MAX_ENTRIES];
+    size_t count = stored_events.take(
+        peer,
+        delivered_change_peers & peer_bit,
+        delivered_change_ms[peer],
+        notifications,
+        NOTIFICATION_BATCH_MAX_ENTRIES);
+    if (!count) {
+      continue;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      batch.add(notifications[i].message, notifications[i].timestamp_ms, true);
+    }
+    uint32_t now_ms = millis();
+    uint16_t sequence = batch.seal(now_ms);
+    send_frame(batch.get_frame(), batch.get_frame_size(), peer_bit);
+    retransmit_queue.track(
+        batch.get_frame(),
+        batch.get_frame_size(),
+        sequence,
+        now_ms,
+        peer_bit);
+    batch.clear();
+  }
+}
+
+size_t EspNowTransmitter::get_stored_event_count(void) const {
+  return stored_events.get_count();
+}
+
+void EspNowTransmitter::send_notification(
+    uint32_t now_ms,
+    bool is_change) {
+  switch (transmit_mode) {
+    case SEND_LEGACY_MESSAGES:
+      send_first_copy(
+          (const uint8_t *)(&notification_message),
+          sizeof(notification_message),
+          all_peers());
+      break;
+    case SEND_FRAMES:
+      batch.add(notification_message, now_ms, is_change);
+      flush_batch();
+      break;
+    case SEND_BATCHED_FRAMES:
+      if (!batch.add(notification_message, now_ms, is_change)) {
+        flush_batch();
+        batch.add(notification_message, now_ms, is_change);
+      }
+      break;
+  }
+}
+
+void EspNowTransmitter::flush_batch(void) {
+  if (!batch.is_empty()) {
+    uint32_t now_ms = millis();
+    // Only acknowledgments show whether broadcast receivers are there.
+    PeerSet reachable = reachable_peers();
+    if (should_broadcast(reachable)
+        && PROBE_INTERVAL_MS <= now_ms - last_probe_ms) {
+      batch.request_ack();
+    }
+    uint16_t sequence = batch.seal(now_ms);
+    PeerSet peers = all_peers();
+    if (batch.has_change()) {
+      // Held receivers get the changes in order, from the store.
+      PeerSet held = held_peers();
+      hold_changes(batch.get_frame(), batch.get_frame_size(), held);
+      peers &= ~held;
+    }
+    if (peers) {
+      send_first_copy(batch.get_frame(), batch.get_frame_size(), peers);
+    }
+    if (batch.requests_ack()) {
+      last_probe_ms = now_ms;
+      // Unreachable receivers get heartbeats, but retrying them would
+      // only spend airtime.
+      retransmit_queue.track(
+          batch.get_frame(),
+          batch.get_frame_size(),
+          sequence,
+          now_ms,
+          reachable & peers);
+    }
+    batch.clear();
+  }
+}
+
+void EspNowTransmitter::report_statistics(void) {
+  Serial.print("ESP-NOW notifications sent: ");
+  Serial.print(heartbeat_policy.get_notifications_sent());
+  Serial.print(", suppressed: ");
+  Serial.print(heartbeat_policy.get_notifications_suppressed());
+  Serial.print(", delivery failures: ");
+  Serial.print(heartbeat_policy.get_deliveries_failed());
+  Serial.print(", frames: ");
+  Serial.print(frames_sent);
+  Serial.print(", bytes: ");
+  Serial.print(bytes_sent);
+  Serial.print(", broadcasts: ");
+  Serial.print(broadcasts_sent);
+  Serial.print(", heartbeat interval: ");
+  Serial.print(heartbeat_policy.get_interval_ms());
+  Serial.println(" ms.");
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    Serial.printf(
+        "Receiver %u: state %u, unicasts: %u, delivered: %u,"
+        " failed: %u, acknowledged: %u.\n",
+        (unsigned) peer,
+        (unsigned) connection_states.get_state(peer),
+        (unsigned) unicasts_sent[peer],
+        (unsigned) deliveries_succeeded[peer],
+        (unsigned) deliveries_failed[peer],
+        (unsigned) acks_received[peer]);
+  }
+  Serial.print("Stored status changes: ");
+  Serial.print(stored_events.get_count());
+  Serial.print(", overwritten: ");
+  Serial.print(stored_events.get_dropped());
+  Serial.println(".");
+
+  const LatencyHistogram& round_trip =
+      retransmit_queue.get_round_trip_histogram();
+  Serial.print("Acknowledged: ");
+  Serial.print(retransmit_queue.get_frames_acknowledged());
+  Serial.print(", retransmissions: ");
+  Serial.print(retransmit_queue.get_retransmissions());
+  Serial.print(", abandoned: ");
+  Serial.print(retransmit_queue.get_frames_abandoned());
+  Serial.print(", evicted: ");
+  Serial.print(retransmit_queue.get_frames_evicted());
+  Serial.print(", round trip p50: ");
+  Serial.print(round_trip.percentile_ms(50));
+  Serial.print(" ms, p99: ");
+  Serial.print(round_trip.percentile_ms(99));
+  Serial.print(" ms, max: ");
+  Serial.print(round_trip.get_max_ms());
+  Serial.println(" ms.");
+  Serial.print("Round trip histogram (< ms: count):");
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; ++i) {
+    if (round_trip.get_bucket(i)) {
+      Serial.print(" ");
+      Serial.print(LatencyHistogram::bucket_limit_ms(i));
+      Serial.print(": ");
+      Serial.print(round_trip.get_bucket(i));
+    }
+  }
+  Serial.println();
+}
+
 void EspNowTransmitter::task_loop() {
-  bool send_message = false;
+  MotionNotificationMessage incoming_message;
+  uint32_t last_receive_ms = millis();
+  uint32_t last_report_ms = last_receive_ms;
   for (;;) {
+    uint32_t wait_ms = heartbeat_policy.ms_until_heartbeat(millis());
+    uint32_t flush_wait_ms =
+        batch.ms_until_due(millis(), BATCH_FLUSH_DEADLINE_MS);
+    if (flush_wait_ms < wait_ms) {
+      wait_ms = flush_wait_ms;
+    }
+    uint32_t retransmit_wait_ms =
+        retransmit_queue.ms_until_next_send(millis());
+    if (retransmit_wait_ms < wait_ms) {
+      wait_ms = retransmit_wait_ms;
+    }
     BaseType_t receive_status = xQueueReceive(
         h_notification_send_queue,
-        &notification_message,
-        wait_for_incoming_in_ticks);
-    if (receive_status != pdTRUE) {
+        &incoming_message,
+        pdMS_TO_TICKS(wait_ms));
+    uint32_t now_ms = millis();
+    if (receive_status == pdTRUE) {
+      last_receive_ms = now_ms;
+      notification_message = incoming_message;
+    } else if (GYROSCOPE_SILENCE_MS <= now_ms - last_receive_ms) {
       notification_message.status = GYROSCOPE_SIGNAL_LOST;
       notification_message.temperature_celsius = ABSOLUTE_ZERO;
+    } else {
+      // Heartbeat. The most recent status has already been sent.
+      notification_message.status = PING;
+    }
+
+    on_delivery_results();
+
+    if (heartbeat_policy.should_send(notification_message.status, now_ms)) {
+      // A heartbeat that repeats the last status, e.g. while the
+      // gyroscope stays lost, is not a change, so it is neither stored
+      // nor acknowledged.
+      send_notification(
+          now_ms,
+          heartbeat_policy.is_change(notification_message.status));
+      heartbeat_policy.on_sent(notification_message.status, now_ms);
     }
-    esp_err_t send_status = esp_now_send(
-      peer_address,
-      (const uint8_t *)(&notification_message),
-      sizeof(notification_message));
-    EspSendState send_state =
-      (send_status == ESP_OK) ? SUCCESSFUL : FAILED;
-    builtin_led_state = builtin_led_state ? LOW : HIGH;
-    digitalWrite(BUILTIN_LED_PIN, builtin_led_state);
-
-    connection_state = STATE_TRANSITION_TABLE[connection_state][send_state];
-    switch (connection_state) {
-      case STARTING:
-        send_message = true;
-        break;
-      case RECONNECTED:
-        send_message = true;
-        start_time = millis();
-        global_blink_task->suspend();
-        wait_for_incoming_in_ticks = pdMS_TO_TICKS(1000);
-        break;
-      case CONNECTED:
-        if ((send_message = ((millis() - start_time) > 500))) {
-          start_time = millis();
-        }
-        break;
-      case CONNECTION_LOST:
-        send_message = true;
-        wait_for_incoming_in_ticks = pdMS_TO_TICKS(50);
-        break;
-      case DISCONNECTED:
-        digitalWrite(GREEN_LED_PIN, LOW);
-        if ((send_message = ((millis() - start_time) > 500))) {
-          start_time = millis();
-        }
-        break;
-      case LAST_CONNECTION_STATE:
-        // Should never happen.
-        break;
+    replay_stored_events();
+    if (batch.is_full()
+        || !batch.ms_until_due(now_ms, BATCH_FLUSH_DEADLINE_MS)) {
+      flush_batch();
+    }
+    service_acknowledgments();
+
+    if (STATISTICS_REPORT_INTERVAL_MS <= now_ms - last_report_ms) {
+      last_report_ms = now_ms;
+      report_statistics();
     }
   }
 }
@@ -139,33 +682,61 @@ void EspNowTransmitter::task_loop() {
 bool EspNowTransmitter::begin(QueueHandle_t h_notification_send_queue) {
   this->h_notification_send_queue = h_notification_send_queue;
 
+  Serial.print("Restoring stored status changes ... ");
+  if (stored_events.restore()) {
+    Serial.print(stored_events.get_count());
+    Serial.println(" retained.");
+  } else {
+    Serial.println("none retained.");
+  }
+
+  // Receivers see a new boot identifier and forget the sequence numbers
+  // of the previous run.
+  uint16_t boot_id;
+  do {
+    boot_id = (uint16_t) esp_random();
+  } while (!boot_id);
+  batch.set_boot_id(boot_id);
+
   Serial.print("Initializing ESP-NOW ... ");
   esp_err_t esp_now_status = esp_now_init();
   Serial.println((esp_now_status == ESP_OK) ? "succeeded." : "failed.");
 
-  Serial.print("Adding peer ... ");
-  esp_now_peer_info peer_info;
-  memset(&peer_info, 0, sizeof(peer_info));
-  memcpy(peer_info.peer_addr, peer_address, ESP_NOW_ETH_ALEN);
-  memset(peer_info.lmk, 0, ESP_NOW_KEY_LEN);
-  peer_info.ifidx = WIFI_IF_STA;
-  peer_info.encrypt = false;
-  esp_err_t peer_add_status = esp_now_add_peer(&peer_info);
-  if (peer_add_status == ESP_OK) {
-    Serial.println("succeeded.");
-  } else {
-    Serial.print("failed with status: 0X");
-    Serial.println(peer_add_status - ESP_ERR_ESPNOW_BASE);
+  // The broadcast address goes last.
+  for (size_t peer = 0; peer <= peer_count; ++peer) {
+    Serial.print("Adding peer ... ");
+    esp_now_peer_info peer_info;
+    memset(&peer_info, 0, sizeof(peer_info));
+    memcpy(
+        peer_info.peer_addr,
+        peer < peer_count ? peer_addresses[peer] : BROADCAST_ADDRESS,
+        ESP_NOW_ETH_ALEN);
+    memset(peer_info.lmk, 0, ESP_NOW_KEY_LEN);
+    peer_info.ifidx = WIFI_IF_STA;
+    peer_info.encrypt = false;
+    esp_err_t peer_add_status = esp_now_add_peer(&peer_info);
+    if (peer_add_status == ESP_OK) {
+      Serial.println("succeeded.");
+    } else {
+      Serial.print("failed with status: 0X");
+      Serial.println(peer_add_status - ESP_ERR_ESPNOW_BASE);
+    }
   }
   bool callback_registration_status =
     esp_now_register_send_cb(send_callback) == ESP_OK;
   Serial.print("Registering send callback ... ");
   Serial.println(callback_registration_status ? "succeeded." : "failed.");
 
+  h_ack_queue = ack_queue.create();
+  callback_registration_status =
+    esp_now_register_recv_cb(receive_callback) == ESP_OK;
+  Serial.print("Registering acknowledgment callback ... ");
+  Serial.println(callback_registration_status ? "succeeded." : "failed.");
+
   return true;
 }
 
 TaskHandle_t EspNowTransmitter::start() {
-    global_blink_task->resume();
+  status_leds->show(RED_LED_PIN, CONNECTION_LOST_BLINK);
   return create_and_start_task();
 }
@@ -4,7 +4,22 @@
  *  Created on: Dec 25, 2022
  *      Author: Eric Mintz
  *
- * Task that sends messages to an ESP-NOW receiver.
+ * Task that sends messages to one or more ESP-NOW receivers.
+ *
+ * Each receiver has its own connection state machine. A frame bound for
+ * two or more reachable receivers goes out once, as an ESP-NOW broadcast,
+ * so that adding a receiver costs no extra airtime. Broadcasts are not
+ * acknowledged by the radio, so the receivers' own acknowledgments track
+ * them: when only heartbeats are flowing, a heartbeat requests them every
+ * PROBE_INTERVAL_MS. A receiver that misses an acknowledgment, a lone
+ * reachable receiver, and every unreachable receiver are sent to by
+ * unicast, which the radio acknowledges and retries.
+ *
+ * Status changes reach each receiver in the order that they happened.
+ * A receiver that is unreachable, or that never acknowledged a change,
+ * is owed its changes through the event store, and gets later changes
+ * through the store too until it has caught up. Heartbeats still reach
+ * it directly, which is how it becomes reachable again.
  */
 
 #ifndef ESPNOWTRANSMITTER_H_
@@ -18,12 +33,22 @@
 #include "freertos/queue.h"
 #include "freertos/task.h"
 
-#include "BlinkTask.h"
+#include "FrameSink.h"
+#include "HeartbeatPolicy.h"
+#include "LedPatternEngine.h"
 #include "MotionNotificationMessage.h"
-#include "Task.h"
+#include "NotificationBatch.h"
+#include "RetransmitQueue.h"
+#include "StateMachine.h"
+#include "StaticQueue.h"
+#include "StaticTask.h"
+
+// Most receivers that one transmitter serves
+#define ESP_NOW_MAX_RECEIVERS 4
 
 class EspNowTransmitter :
-    public Task {
+    public StaticTask<2048>,
+    public FrameSink {
 public:
   enum ConnectionState {
     STARTING,  // Establishing connection at startup.
@@ -34,15 +59,84 @@ public:
     LAST_CONNECTION_STATE,  // MUST be last
   };
 
+  /**
+   * Frame formats. Receivers decode all of them, so send legacy messages
+   * only to receivers that predate the wire format.
+   */
+  enum TransmitMode {
+    SEND_LEGACY_MESSAGES,  // Bare MotionNotificationMessage per frame
+    SEND_FRAMES,  // Wire format frame per notification
+    SEND_BATCHED_FRAMES,  // Wire format frames holding several notifications
+  };
+
+  /**
+   * Connection state machine events.
+   */
+  enum EspSendState {
+    SUCCESSFUL,  // Delivery succeeded
+    FAILED,  // Send or delivery failed.
+    ESP_SEND_STATUS_LAST,  // MUST be last
+  };
+
 private:
+  friend class StateMachineArray<
+      ConnectionState,
+      LAST_CONNECTION_STATE,
+      ESP_SEND_STATUS_LAST,
+      ESP_NOW_MAX_RECEIVERS>;
+
+  static_assert(
+      ESP_NOW_MAX_RECEIVERS <= FRAME_SINK_MAX_PEERS,
+      "Every receiver needs a bit in a PeerSet.");
+
+  /**
+   * An acknowledgment, the receiver that sent it, and the time it
+   * arrived.
+   */
+  struct AckArrival {
+    uint16_t sequence;
+    uint8_t peer;
+    uint32_t arrival_ms;
+  };
+
   static EspNowTransmitter *instance;
-  static BlinkTask *global_blink_task;
-  ConnectionState connection_state;
-  const uint8_t *peer_address;
-  uint32_t start_time;
+  static LedPatternEngine *status_leds;
+  // Unicast delivery results by receiver, set by send_callback
+  static volatile uint32_t deliveries_succeeded[ESP_NOW_MAX_RECEIVERS];
+  static volatile uint32_t deliveries_failed[ESP_NOW_MAX_RECEIVERS];
+  static volatile bool last_delivery_succeeded[ESP_NOW_MAX_RECEIVERS];
+  static volatile uint32_t broadcasts_sent;  // Set by send_callback
+
+  // Per receiver state, indexed by position in peer_addresses
+  StateMachineArray<
+      ConnectionState,
+      LAST_CONNECTION_STATE,
+      ESP_SEND_STATUS_LAST,
+      ESP_NOW_MAX_RECEIVERS> connection_states;
+  uint32_t succeeded_seen[ESP_NOW_MAX_RECEIVERS];  // Results applied so far
+  uint32_t failed_seen[ESP_NOW_MAX_RECEIVERS];
+  uint32_t acks_received[ESP_NOW_MAX_RECEIVERS];
+  uint32_t unicasts_sent[ESP_NOW_MAX_RECEIVERS];
+
+  const uint8_t (*peer_addresses)[ESP_NOW_ETH_ALEN];
+  const size_t peer_count;
+  uint32_t acknowledged_seen;  // Acknowledged frames applied so far
+  // Timestamp of the newest status change each receiver acknowledged
+  uint32_t delivered_change_ms[ESP_NOW_MAX_RECEIVERS];
+  PeerSet delivered_change_peers;  // Receivers that acknowledged a change
+  uint32_t last_probe_ms;  // Last frame that requested acknowledgments
+  bool all_reachable_shown;  // What the status LEDs show
   QueueHandle_t h_notification_send_queue;
   MotionNotificationMessage notification_message;
-  TickType_t wait_for_incoming_in_ticks;
+  HeartbeatPolicy heartbeat_policy;
+  const TransmitMode transmit_mode;
+  NotificationBatchEncoder batch;
+  RetransmitQueue retransmit_queue;
+  // Acknowledgments from the receive callback
+  StaticQueue<AckArrival, 2 * RETRANSMIT_QUEUE_CAPACITY> ack_queue;
+  QueueHandle_t h_ack_queue;
+  uint32_t frames_sent;  // Transmissions: a broadcast counts once
+  uint32_t bytes_sent;
   uint8_t builtin_led_state;
 
   static void send_callback(
@@ -50,15 +144,147 @@ private:
     esp_now_send_status_t send_status);
 
   /**
-   * The task loop.
+   * Receives acknowledgments from the receivers. Runs in the Wi-Fi task,
+   * so it only timestamps the acknowledgment and queues it for the
+   * transmitter task.
    */
-  virtual void task_loop(void);
-public:
+  static void receive_callback(
+    const uint8_t *mac_address,
+    const uint8_t *data,
+    int data_length);
+
+  /**
+   * Returns the index of the receiver with the specified address, or -1
+   * if there is none.
+   */
+  int find_peer(const uint8_t *mac_address) const;
+
+  /**
+   * Moves a receiver's connection state machine to its next state.
+   */
+  void advance_connection_state(size_t peer, bool send_succeeded);
+
+  /**
+   * Moves the connection state machines of a set of receivers.
+   */
+  void advance_connection_states(PeerSet peers, bool send_succeeded);
+
+  /**
+   * Connection state entry actions: drive the status LEDs.
+   */
+  void on_enter(size_t peer, ConnectionState new_state);
 
-  static void set_blink_task(BlinkTask *blink_task) {
-    global_blink_task = blink_task;
+  /**
+   * Applies the delivery results reported since the last call to the
+   * heartbeat policy and the connection states.
+   */
+  void on_delivery_results(void);
+
+  /**
+   * Returns every receiver.
+   */
+  PeerSet all_peers(void) const {
+    return (PeerSet) ((1 << peer_count) - 1);
   }
 
+  /**
+   * Returns the receivers whose connection is up.
+   */
+  PeerSet reachable_peers(void) const;
+
+  /**
+   * Returns true if a frame for the specified reachable receivers should
+   * go out as a single broadcast.
+   */
+  static bool should_broadcast(PeerSet reachable);
+
+  /**
+   * Sends the first copy of a frame to a set of receivers, and advances
+   * the connection states of any that it could not be sent to. A frame
+   * for every receiver goes to the reachable ones as a broadcast if
+   * should_broadcast() allows; a broadcast would also reach receivers
+   * outside a smaller set.
+   */
+  bool send_first_copy(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers);
+
+  /**
+   * Sends a frame to one address. Returns true if ESP-NOW queued it.
+   */
+  bool transmit(
+      const uint8_t *mac_address,
+      const uint8_t *frame,
+      size_t frame_size);
+
+  /**
+   * Lights the green LED while every receiver is reachable and flashes
+   * the red LED while any is not.
+   */
+  void show_link_status(void);
+
+  /**
+   * Returns the receivers that must get state changes through the event
+   * store rather than directly: those that are unreachable and those that
+   * are owed stored changes, which must reach them first.
+   */
+  PeerSet held_peers(void) const;
+
+  /**
+   * Stores the status changes in a frame, but not its PINGs, for those
+   * of the specified receivers that have not acknowledged a newer one.
+   */
+  void hold_changes(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers);
+
+  /**
+   * Sends each reachable receiver that is owed stored events its oldest
+   * ones in a batch of their own, by unicast. A receiver gets no more
+   * until it has acknowledged or abandoned what it was sent, so its
+   * events arrive in order.
+   */
+  void replay_stored_events(void);
+
+  /**
+   * Retires acknowledged frames and resends overdue ones.
+   */
+  void service_acknowledgments(void);
+
+  /**
+   * Sends the current notification in its own frame or, when batching,
+   * adds it to the batch, flushing the batch first if it is full. Only
+   * state changes ask for acknowledgment.
+   */
+  void send_notification(uint32_t now_ms, bool is_change);
+
+  /**
+   * Seals and sends the batch, if it holds anything, and empties it. The
+   * batch requests acknowledgments if it holds a state change or if a
+   * probe of broadcast receivers is due. A batch that holds a state change
+   * skips the held receivers, whose copies go to the event store.
+   */
+  void flush_batch(void);
+
+  /**
+   * Prints the transmission counters and the round trip time histogram.
+   */
+  void report_statistics(void);
+
+  /**
+   * The task loop. Sends status changes at once and otherwise sends only
+   * heartbeats, as the heartbeat policy directs. Frames that carry a
+   * status change are resent until the receivers acknowledge them.
+   * Status changes for held receivers are stored, and replayed to each
+   * one once it is reachable again. Waits for incoming
+   * notifications until the next heartbeat, batch flush, or
+   * retransmission is due.
+   */
+  virtual void task_loop(void);
+public:
+
   /**
    * Constructor.
    *
@@ -66,23 +292,32 @@ public:
    *
    * Name                      Contents
    * ------------------------- ---------------------------------------------------
-   * peer_address              The receiver's MAC address consisting of 6 unsigned
-   *                           bytes. See CommunicationSettings.h
-   * blink_task                Pointer to the blink task used to turn off the
-   *                           status LED when the receiver reconnects.
-   *
-   * Note: to avoid spurious error indication, BE SURE to suspend the blink task
-   * before binding it to an EspNowTransmitter.
+   * peer_addresses            The receivers' MAC addresses, each consisting of
+   *                           6 unsigned bytes. See CommunicationSettings.h
+   * peer_count                The number of receivers, at most
+   *                           ESP_NOW_MAX_RECEIVERS
+   * status_leds               Drives the red and green status LEDs. The red
+   *                           LED flashes while any receiver is unreachable,
+   *                           and the green LED lights while all of them
+   *                           are reachable.
+   * transmit_mode             Frame format. SEND_BATCHED_FRAMES packs
+   *                           notifications into frames that are sent when
+   *                           full or when the oldest notification has
+   *                           waited BATCH_FLUSH_DEADLINE_MS. See
+   *                           WireFormat.h.
    */
 
   EspNowTransmitter(
-    const uint8_t *peer_address,
-    BlinkTask *blink_task);
+    const uint8_t (*peer_addresses)[ESP_NOW_ETH_ALEN],
+    size_t peer_count,
+    LedPatternEngine *status_leds,
+    TransmitMode transmit_mode = SEND_FRAMES);
   virtual ~EspNowTransmitter();
 
   /**
    * Initialize the transmitter. Disable the error indication blink
-   * and connect to the receiver. This might take some time.
+   * and connect to the receivers. This might take some time. Status
+   * changes retained from before a restart are kept for replay.
    *
    * Arguments
    *
@@ -100,6 +335,91 @@ public:
    */
   bool begin(QueueHandle_t h_notification_send_queue);
 
+  /**
+   * Returns the number of notifications sent, alone or in batches.
+   */
+  uint32_t get_notifications_sent(void) const {
+    return heartbeat_policy.get_notifications_sent();
+  }
+
+  /**
+   * Returns the number of notifications that were not sent because they
+   * carried no news and no heartbeat was due.
+   */
+  uint32_t get_notifications_suppressed(void) const {
+    return heartbeat_policy.get_notifications_suppressed();
+  }
+
+  /**
+   * Returns the number of status changes awaiting replay.
+   */
+  size_t get_stored_event_count(void) const;
+
+  /**
+   * Returns the number of frames delivered to a receiver: unicasts that
+   * the radio acknowledged plus acknowledgments that the receiver sent.
+   */
+  uint32_t get_deliveries_succeeded(size_t peer) const {
+    return deliveries_succeeded[peer] + acks_received[peer];
+  }
+
+  /**
+   * Returns the number of unicasts to a receiver that the radio gave up
+   * on.
+   */
+  uint32_t get_deliveries_failed(size_t peer) const {
+    return deliveries_failed[peer];
+  }
+
+  ConnectionState get_connection_state(size_t peer) const {
+    return connection_states.get_state(peer);
+  }
+
+  /**
+   * Returns the number of ESP-NOW transmissions. A broadcast counts once.
+   */
+  uint32_t get_frames_sent(void) const {
+    return frames_sent;
+  }
+
+  /**
+   * Returns the number of ESP-NOW payload bytes sent.
+   */
+  uint32_t get_bytes_sent(void) const {
+    return bytes_sent;
+  }
+
+  /**
+   * Sends a frame to each of a set of receivers in turn, and advances
+   * the connection states of any that it could not be sent to. The
+   * retransmit queue resends through here, so every retry goes only to
+   * the receivers that missed it, and the radio reports whether each
+   * one got it.
+   */
+  virtual bool send_frame(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet peers);
+
+  /**
+   * Records the newest status change in a frame that a receiver
+   * acknowledged, so that older ones are not replayed to it.
+   */
+  virtual void on_frame_acknowledged(
+      const uint8_t *frame,
+      size_t frame_size,
+      size_t peer);
+
+  /**
+   * Returns the state changes in a frame that ran out of attempts to the
+   * event store, for replay to the receivers that did not acknowledge
+   * it.
+   */
+  virtual void on_frame_abandoned(
+      const uint8_t *frame,
+      size_t frame_size,
+      PeerSet unacknowledged);
+
   /**
    * Start the task. Note that you must invoke begin() before starting the
    * task.
@@ -12,61 +12,74 @@
 
 #include "Arduino.h"
 
-#include "TaskPriorities.h"
+#include "esp_timer.h"
 
-const EventRelayTask::State EventRelayTask::TRANSITION_TABLE
-    [GYRO_NUMBER_OF_STATES][LAST_NOTIFICATION_STATUS] =
+
+static constexpr uint8_t TRANSITION_TABLE
+    [EventRelayTask::GYRO_NUMBER_OF_STATES][LAST_NOTIFICATION_STATUS] =
 {
   {  // GYRO_CREATED
-      GYRO_NEW_CLOSURE_RECEIVED, // LID_HAS_NOT_MOVED
-      GYRO_NEW_OPEN_RECEIVED, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_NUMBER_OF_STATES, // PING
+      fsm_to(EventRelayTask::GYRO_NEW_CLOSURE_RECEIVED), // LID_HAS_NOT_MOVED
+      fsm_to(EventRelayTask::GYRO_NEW_OPEN_RECEIVED), // LID_RAISED
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      FSM_IGNORE, // PING
   },
   {  // GYRO_NEW_CLOSURE_RECEIVED
-      GYRO_VERIFYING_CLOSURE, // LID_HAS_NOT_MOVED
-      GYRO_VERIFYING_OPEN, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_VERIFYING_CLOSURE, // PING
+      fsm_to(EventRelayTask::GYRO_VERIFYING_CLOSURE), // LID_HAS_NOT_MOVED
+      // LID_RAISED, a new raise with its own confirmation clock
+      fsm_to(EventRelayTask::GYRO_NEW_OPEN_RECEIVED),
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      fsm_to(EventRelayTask::GYRO_VERIFYING_CLOSURE), // PING
   },
   {  // GYRO_VERIFYING_CLOSURE
-      GYRO_VERIFYING_CLOSURE, // LID_HAS_NOT_MOVED
-      GYRO_NEW_OPEN_RECEIVED, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_VERIFYING_CLOSURE, // PING
+      fsm_to(EventRelayTask::GYRO_VERIFYING_CLOSURE), // LID_HAS_NOT_MOVED
+      fsm_to(EventRelayTask::GYRO_NEW_OPEN_RECEIVED), // LID_RAISED
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      fsm_to(EventRelayTask::GYRO_VERIFYING_CLOSURE), // PING
   },
   {  // GYRO_CONFIRMED_CLOSURE
-      GYRO_NUMBER_OF_STATES, // LID_HAS_NOT_MOVED -- ignored
-      GYRO_NEW_OPEN_RECEIVED, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_NUMBER_OF_STATES, // PING
+      FSM_IGNORE, // LID_HAS_NOT_MOVED -- ignored
+      fsm_to(EventRelayTask::GYRO_NEW_OPEN_RECEIVED), // LID_RAISED
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      FSM_IGNORE, // PING
   },
   {  // GYRO_NEW_OPEN_RECEIVED
-      GYRO_NEW_CLOSURE_RECEIVED, // LID_HAS_NOT_MOVED
-      GYRO_VERIFYING_OPEN, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_VERIFYING_OPEN, // PING
+      fsm_to(EventRelayTask::GYRO_NEW_CLOSURE_RECEIVED), // LID_HAS_NOT_MOVED
+      fsm_to(EventRelayTask::GYRO_VERIFYING_OPEN), // LID_RAISED
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      fsm_to(EventRelayTask::GYRO_VERIFYING_OPEN), // PING
   },
   {  // GYRO_VERIFYING_OPEN
-      GYRO_NEW_CLOSURE_RECEIVED, // LID_HAS_NOT_MOVED
-      GYRO_VERIFYING_OPEN, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_VERIFYING_OPEN, // PING
+      fsm_to(EventRelayTask::GYRO_NEW_CLOSURE_RECEIVED), // LID_HAS_NOT_MOVED
+      fsm_to(EventRelayTask::GYRO_VERIFYING_OPEN), // LID_RAISED
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      fsm_to(EventRelayTask::GYRO_VERIFYING_OPEN), // PING
   },
   {  // GYRO_CONFIRMED_OPEN
-      GYRO_NEW_CLOSURE_RECEIVED, // LID_HAS_NOT_MOVED
-      GYRO_VERIFYING_OPEN, // LID_RAISED
-      GYRO_SIGNAL_LOST, // GYROSCOPE_SIGNAL_LOST
-      GYRO_NUMBER_OF_STATES, // PING
+      fsm_to(EventRelayTask::GYRO_NEW_CLOSURE_RECEIVED), // LID_HAS_NOT_MOVED
+      FSM_IGNORE, // LID_RAISED -- already confirmed
+      fsm_to(EventRelayTask::GYRO_SIGNAL_LOST), // GYROSCOPE_SIGNAL_LOST
+      FSM_IGNORE, // PING
   },
   {  // GYRO_SIGNAL_LOST
-      GYRO_NEW_CLOSURE_RECEIVED, // LID_HAS_NOT_MOVED
-      GYRO_NEW_OPEN_RECEIVED, // LID_RAISED
-      GYRO_NUMBER_OF_STATES, // GYROSCOPE_SIGNAL_LOST
-      GYRO_NUMBER_OF_STATES, // PING
+      fsm_to(EventRelayTask::GYRO_NEW_CLOSURE_RECEIVED), // LID_HAS_NOT_MOVED
+      fsm_to(EventRelayTask::GYRO_NEW_OPEN_RECEIVED), // LID_RAISED
+      FSM_IGNORE, // GYROSCOPE_SIGNAL_LOST
+      FSM_IGNORE, // PING
   },
 };
 
+static_assert(
+    fsm_table_is_complete(TRANSITION_TABLE),
+    "Every relay state must handle every status.");
+static_assert(
+    fsm_all_states_reachable(
+        TRANSITION_TABLE,
+        fsm_state_bit(EventRelayTask::GYRO_CREATED)
+            | fsm_state_bit(EventRelayTask::GYRO_CONFIRMED_CLOSURE)
+            | fsm_state_bit(EventRelayTask::GYRO_CONFIRMED_OPEN)),
+    "Every relay state must be reachable.");
+
 /**
  * Wait time for tilt confirmation. The task notifies the receiver when
  * the the gyroscope task indicates tilt for the specified time. Note
@@ -85,17 +98,20 @@ const EventRelayTask::State EventRelayTask::TRANSITION_TABLE
 #define DISCONNECTED_QUEUE_WAIT_MILLIS pdMS_TO_TICKS(10)
 
 EventRelayTask::EventRelayTask() :
-    Task(
-        "Gyroscope event relay task",
-        2048,
-        ESP_NOW_SEND_PRIORITY),
-    state(GYRO_CREATED),
+    StaticTask("Gyroscope event relay task", TASK_ROLE_EVENT_RELAY),
+    state_machine(GYRO_CREATED),
     connection_state(UNKNOWN),
     h_tilt_notification_queue(0),
     h_send_to_receiver_queue(0),
     tilt_start_time_millis(0),
     tilt_signal_active_millis(0),
-    queue_wait_time_millis(CONNECTED_QUEUE_WAIT_MILLIS) {
+    queue_wait_time_millis(CONNECTED_QUEUE_WAIT_MILLIS),
+    lid_moved_at_milliseconds(0),
+    first_tilt_at_micros(0),
+    last_detection_latency_micros(0),
+    max_detection_latency_micros(0),
+    raises_detected(0),
+    confirmed_status(PING) {
   notification_message.status = LID_HAS_NOT_MOVED;
   notification_message.temperature_celsius = ABSOLUTE_ZERO;
 }
@@ -110,54 +126,112 @@ void EventRelayTask::begin(
   this->h_send_to_receiver_queue = h_send_to_receiver_queue;
 }
 
+bool EventRelayTask::is_confirming(void) const {
+  switch (state_machine.get_state()) {
+    case GYRO_NEW_CLOSURE_RECEIVED:
+    case GYRO_VERIFYING_CLOSURE:
+    case GYRO_NEW_OPEN_RECEIVED:
+    case GYRO_VERIFYING_OPEN:
+      return true;
+    default:
+      return false;
+  }
+}
+
+TickType_t EventRelayTask::ticks_until_confirmation(void) const {
+  if (!is_confirming()) {
+    return CONNECTED_QUEUE_WAIT_MILLIS;
+  }
+  uint32_t waited_ms = millis() - lid_moved_at_milliseconds;
+  if (CONFIRMATION_TIME_MS <= waited_ms) {
+    return 0;
+  }
+  // Round up so that the wait never ends before the deadline.
+  return (CONFIRMATION_TIME_MS - waited_ms + portTICK_PERIOD_MS - 1)
+      / portTICK_PERIOD_MS;
+}
+
+void EventRelayTask::on_enter(State new_state) {
+  switch (new_state) {
+    case GYRO_CREATED:
+      // Should never happen
+      break;
+    case GYRO_NEW_CLOSURE_RECEIVED:
+      lid_moved_at_milliseconds = millis();
+      break;
+    case GYRO_VERIFYING_CLOSURE:
+      if (CONFIRMATION_TIME_MS <=  millis() - lid_moved_at_milliseconds) {
+        state_machine.set_state(GYRO_CONFIRMED_CLOSURE);
+        confirmed_status = LID_HAS_NOT_MOVED;
+      }
+      break;
+    case GYRO_CONFIRMED_CLOSURE:
+      break;
+    case GYRO_NEW_OPEN_RECEIVED:
+      lid_moved_at_milliseconds = millis();
+      first_tilt_at_micros = esp_timer_get_time();
+      break;
+    case GYRO_VERIFYING_OPEN:
+      if (CONFIRMATION_TIME_MS <= millis() - lid_moved_at_milliseconds) {
+        state_machine.set_state(GYRO_CONFIRMED_OPEN);
+        confirmed_status = LID_RAISED;
+        record_detection_latency();
+      }
+      break;
+    case GYRO_CONFIRMED_OPEN:
+      break;
+    case GYRO_SIGNAL_LOST:
+      break;
+    case GYRO_NUMBER_OF_STATES:
+      break;
+  }
+}
+
+MotionStatus EventRelayTask::apply(MotionStatus status) {
+  confirmed_status = PING;
+  state_machine.dispatch(TRANSITION_TABLE, status, *this);
+  return confirmed_status;
+}
+
+void EventRelayTask::record_detection_latency(void) {
+  uint32_t latency_micros =
+      (uint32_t) (esp_timer_get_time() - first_tilt_at_micros);
+  last_detection_latency_micros = latency_micros;
+  if (max_detection_latency_micros < latency_micros) {
+    max_detection_latency_micros = latency_micros;
+  }
+  ++raises_detected;
+  Serial.print("Lid raise confirmed ");
+  Serial.print(latency_micros);
+  Serial.println(" us after the first tilt.");
+}
+
 void EventRelayTask::task_loop() {
   MotionNotificationMessage message;
-  State maybe_next_state;
   MotionStatus motion_status;
-  uint32_t lid_moved_at_milliseconds = 0;
   Serial.print("Initial state: ");
-  Serial.println(state);
+  Serial.println(state_machine.get_state());
   for (;;) {
-    motion_status = PING;
-    if (xQueueReceive(
+    bool received = xQueueReceive(
         h_tilt_notification_queue,
         &message,
-        CONNECTED_QUEUE_WAIT_MILLIS)
-        && message.status != LAST_NOTIFICATION_STATUS) {
-      maybe_next_state = TRANSITION_TABLE[state][message.status];
-      if (maybe_next_state != GYRO_NUMBER_OF_STATES) {
-        switch (state = maybe_next_state) {
-        case GYRO_CREATED:
-          // Should never happen
-          break;
-        case GYRO_NEW_CLOSURE_RECEIVED:
-          lid_moved_at_milliseconds = millis();
-          break;
-        case GYRO_VERIFYING_CLOSURE:
-          if (CONFIRMATION_TIME_MS <=  millis() - lid_moved_at_milliseconds) {
-            state = GYRO_CONFIRMED_CLOSURE;
-            motion_status = LID_HAS_NOT_MOVED;
-          }
-          break;
-        case GYRO_CONFIRMED_CLOSURE:
-          break;
-        case GYRO_NEW_OPEN_RECEIVED:
-          lid_moved_at_milliseconds = millis();
-          break;
-        case GYRO_VERIFYING_OPEN:
-          if (CONFIRMATION_TIME_MS <= millis() - lid_moved_at_milliseconds) {
-            state = GYRO_CONFIRMED_OPEN;
-            motion_status = LID_RAISED;
-          }
-          break;
-        case GYRO_CONFIRMED_OPEN:
-          break;
-        case GYRO_SIGNAL_LOST:
-          break;
-        case GYRO_NUMBER_OF_STATES:
-          break;
-        }
+        ticks_until_confirmation());
+    if (received) {
+      if (message.status == LAST_NOTIFICATION_STATUS) {
+        continue;
       }
+      notification_message = message;
+      motion_status = apply(message.status);
+    } else if (is_confirming()) {
+      // The confirmation deadline passed without news. The tables treat
+      // a PING as "nothing changed", which confirms a pending edge once
+      // it has been held long enough.
+      message = notification_message;
+      motion_status = apply(PING);
+    } else {
+      continue;
+    }
+    if (received || motion_status != PING) {
       message.status = motion_status;
       xQueueSendToBack(
         h_send_to_receiver_queue,
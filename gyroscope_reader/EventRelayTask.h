@@ -19,10 +19,11 @@
 #include "freertos/task.h"
 
 #include "MotionNotificationMessage.h"
-#include "Task.h"
+#include "StateMachine.h"
+#include "StaticTask.h"
 
 class EventRelayTask :
-    public Task {
+    public StaticTask<2048> {
 
   enum ReceiverConnectionState {
     UNKNOWN,
@@ -30,8 +31,7 @@ class EventRelayTask :
     DISCONNECTED,
   };
 
-private:
-
+public:
   enum State {
     GYRO_CREATED,
     GYRO_NEW_CLOSURE_RECEIVED,
@@ -44,20 +44,60 @@ private:
     GYRO_NUMBER_OF_STATES,  // MUST be last.
   };
 
-  static const State TRANSITION_TABLE
-      [GYRO_NUMBER_OF_STATES][LAST_NOTIFICATION_STATUS];
+private:
+  typedef StateMachine<State, GYRO_NUMBER_OF_STATES, LAST_NOTIFICATION_STATUS>
+      RelayStateMachine;
+  friend class StateMachine<
+      State, GYRO_NUMBER_OF_STATES, LAST_NOTIFICATION_STATUS>;
 
-  State state;
+  RelayStateMachine state_machine;
   ReceiverConnectionState connection_state;
   QueueHandle_t h_tilt_notification_queue;
   QueueHandle_t h_send_to_receiver_queue;
   uint32_t tilt_start_time_millis;
   uint32_t tilt_signal_active_millis;
   TickType_t queue_wait_time_millis;
-  MotionNotificationMessage notification_message;
+  MotionNotificationMessage notification_message;  // Most recent received
+  uint32_t lid_moved_at_milliseconds;  // Start of the pending edge
+  int64_t first_tilt_at_micros;  // Start of the pending raise
+  volatile uint32_t last_detection_latency_micros;
+  volatile uint32_t max_detection_latency_micros;
+  volatile uint32_t raises_detected;
+  MotionStatus confirmed_status;  // Set by on_enter()
+
+  /**
+   * Returns true if an edge awaits confirmation.
+   */
+  bool is_confirming(void) const;
+
+  /**
+   * Returns the queue wait: the time until the pending edge can be
+   * confirmed, or the idle wait when nothing is pending.
+   */
+  TickType_t ticks_until_confirmation(void) const;
+
+  /**
+   * Entry actions. Starts the confirmation clock on a new edge and
+   * confirms a verified edge once the clock passes the confirmation
+   * time.
+   */
+  void on_enter(State new_state);
+
+  /**
+   * Runs the transition table on a status. Returns the confirmed status
+   * to send or, if nothing was confirmed, PING.
+   */
+  MotionStatus apply(MotionStatus status);
 
   /**
-   * The send task loop.
+   * Records the time from the first tilt to the confirmed raise.
+   */
+  void record_detection_latency(void);
+
+  /**
+   * The send task loop. Waits for the next sample or the confirmation
+   * deadline, whichever comes first, so a confirmed edge goes out when
+   * the deadline expires even if samples stall.
    */
   virtual void task_loop();
 
@@ -79,6 +119,29 @@ public:
     QueueHandle_t h_tilt_notification_queue,
     QueueHandle_t h_send_to_receiver_queue);
 
+  /**
+   * Returns the time from the first tilt sample to the most recent
+   * confirmed LID_RAISED in microseconds, or 0 if none has been
+   * confirmed. The confirmation time is the floor.
+   */
+  uint32_t get_last_detection_latency_micros(void) const {
+    return last_detection_latency_micros;
+  }
+
+  /**
+   * Returns the longest detection latency seen, in microseconds.
+   */
+  uint32_t get_max_detection_latency_micros(void) const {
+    return max_detection_latency_micros;
+  }
+
+  /**
+   * Returns the number of confirmed LID_RAISED edges.
+   */
+  uint32_t get_raises_detected(void) const {
+    return raises_detected;
+  }
+
   /**
    * Start the send loop
    */
@@ -7,26 +7,49 @@
 
 #include "GyroscopeTask.h"
 #include "PinAssignments.h"
-#include "TaskPriorities.h"
 
-#include <cmath>
+#include "esp_timer.h"
 
-#define MPU6050_INTERRUPT_CONFIGURATION (unsigned char) 0b00011110
-#define MPU6050_INTERRUPT_CONFIG_REGISTER 0x37
+#include "Mpu6050Fifo.h"
+#include "TiltDetector.h"
+
+// Active high, push-pull, 50 microsecond pulse, cleared by any read.
+#define MPU6050_INTERRUPT_CONFIGURATION (unsigned char) 0b00010000
+
+// Largest FIFO burst, a whole number of frames that fits the Wire buffer.
+#define MAX_FIFO_BURST_BYTES (10 * MPU6050_FIFO_FRAME_SIZE)
+
+// Update loop wait before draining the FIFO without an interrupt.
+#define DATA_READY_TIMEOUT_TICKS pdMS_TO_TICKS(100)
+
+// Filter updates per cycle count measurement window.
+#define FILTER_MEASUREMENT_WINDOW 1000
+
+// Motion detection loop period.
+#define MOTION_DETECTION_PERIOD_TICKS 50
+
+// Motion detection loop iterations between orientation reports, 1 minute.
+#define ORIENTATION_REPORT_INTERVAL 1200
 
-#define DEGREES_TO_RADIANS (PI / 180.0)
 #define RADIANS_TO_DEGREES (180.0 / PI)
 #define INCLINATION_THRESHOLD (PI / 6)
 
-GyroscopeTask::GyroscopeTask() :
-    Task(
-        "MPU6050 motion detection loop",
-        2048,
-        MOTION_DETECTION_PRIORITY),
+// Tilt decision kernel. The threshold cosine is computed at compile time,
+// so the motion detection loop runs entirely in integer arithmetic.
+static constexpr TiltDetector tilt_detector(INCLINATION_THRESHOLD);
+
+GyroscopeTask::GyroscopeTask(
+    OrientationFilter *orientation_filter,
+    const LatestValue<TemperatureReading> *temperature) :
+    StaticTask("MPU6050 motion detection loop", TASK_ROLE_MOTION_DETECTION),
     update_task(),
     h_gyro_event_queue(NULL),
     gyroscope(Wire),
-    temperature_sensor(TEMPERATURE_AND_HUMIDITY_PIN) {
+    orientation_filter(orientation_filter),
+    temperature(temperature),
+    previous_wake_us(0),
+    min_period_us(UINT32_MAX),
+    max_period_us(0) {
 }
 
 GyroscopeTask::~GyroscopeTask() {
@@ -45,12 +68,49 @@ boolean GyroscopeTask::begin(QueueHandle_t h_gyro_event_queue) {
     vTaskDelay(pdMS_TO_TICKS(1000));
     gyroscope.calcOffsets(true, true);
     Serial.println("... done!");
+    configure_fifo();
   }
   return result;
 }
 
+void GyroscopeTask::configure_fifo(void) {
+  OrientationFilter::Calibration calibration;
+  calibration.accel_lsb_per_g = 16384.0f;  // +/- 2 g, MPU6050 default
+  calibration.gyro_lsb_per_degree_per_second = 65.5f;  // +/- 500 deg/s
+  calibration.accel_offset_x = gyroscope.getAccXoffset();
+  calibration.accel_offset_y = gyroscope.getAccYoffset();
+  calibration.accel_offset_z = gyroscope.getAccZoffset();
+  calibration.gyro_offset_x = gyroscope.getGyroXoffset();
+  calibration.gyro_offset_y = gyroscope.getGyroYoffset();
+  calibration.gyro_offset_z = gyroscope.getGyroZoffset();
+  orientation_filter->calibrate(calibration);
+
+  uint16_t sample_rate_hz = orientation_filter->get_sample_rate_hz();
+  Serial.print("Configuring FIFO for ");
+  Serial.print(sample_rate_hz);
+  Serial.print(" Hz sampling, ");
+  Serial.print(orientation_filter->get_name());
+  Serial.println(" filter.");
+  gyroscope.writeData(MPU6050_CONFIG_REGISTER, MPU6050_DLPF_44_HZ);
+  gyroscope.writeData(
+      MPU6050_SAMPLE_RATE_DIVIDER_REGISTER,
+      Mpu6050Fifo::sample_rate_divider(sample_rate_hz));
+  gyroscope.writeData(
+      MPU6050_INTERRUPT_CONFIG_REGISTER,
+      MPU6050_INTERRUPT_CONFIGURATION);
+  gyroscope.writeData(
+      MPU6050_FIFO_ENABLE_REGISTER,
+      MPU6050_FIFO_ACCEL_AND_GYRO);
+  gyroscope.writeData(
+      MPU6050_USER_CONTROL_REGISTER,
+      MPU6050_USER_CONTROL_FIFO_RESET);
+  gyroscope.writeData(
+      MPU6050_USER_CONTROL_REGISTER,
+      MPU6050_USER_CONTROL_FIFO_ENABLE);
+}
+
 TaskHandle_t GyroscopeTask::start_update_loop() {
-  return update_task.start(&gyroscope);
+  return update_task.start(&gyroscope, orientation_filter);
 }
 
 void GyroscopeTask::task_loop() {
@@ -60,17 +120,17 @@ void GyroscopeTask::task_loop() {
   Serial.print(" radians, ");
   Serial.print(INCLINATION_THRESHOLD * RADIANS_TO_DEGREES);
   Serial.println(" degrees.");
+  Serial.print("Threshold cosine squared (Q16): ");
+  Serial.println(tilt_detector.get_cosine_squared_q16());
+  uint32_t iterations_until_report = ORIENTATION_REPORT_INTERVAL;
+  TickType_t last_wake_time = xTaskGetTickCount();
   for (;;) {
-    float roll_in_degrees = gyroscope.getAngleX();
-    float pitch_in_degrees = gyroscope.getAngleY();
-    float tan_roll = tan(roll_in_degrees * DEGREES_TO_RADIANS);
-    float tan_pitch = tan(pitch_in_degrees * DEGREES_TO_RADIANS);
-    float inclination = atan(sqrt(tan_roll * tan_roll + tan_pitch * tan_pitch));
-
+    measure_period();
     notification_message.temperature_celsius =
-      temperature_sensor.getTemperature();
+      temperature->read().temperature_celsius;
+    OrientationFilter::Gravity gravity = orientation_filter->get_gravity();
     notification_message.status =
-        INCLINATION_THRESHOLD < inclination
+        tilt_detector.is_tilted(gravity.x, gravity.y, gravity.z)
             ? LID_RAISED
             : LID_HAS_NOT_MOVED;
 
@@ -80,8 +140,41 @@ void GyroscopeTask::task_loop() {
     xQueueSendToBack(
       h_gyro_event_queue,
       &notification_message, pdMS_TO_TICKS(100));
-    vTaskDelay(50);
+    if (!--iterations_until_report) {
+      iterations_until_report = ORIENTATION_REPORT_INTERVAL;
+      Serial.print("Orientation (");
+      Serial.print(orientation_filter->get_name());
+      Serial.print("): roll ");
+      Serial.print(orientation_filter->get_roll_centidegrees() / 100.0);
+      Serial.print(", pitch ");
+      Serial.print(orientation_filter->get_pitch_centidegrees() / 100.0);
+      Serial.print(" degrees, ");
+      Serial.print(update_task.get_cycles_per_update());
+      Serial.println(" cycles per update.");
+      Serial.print("Motion loop period: ");
+      Serial.print(min_period_us);
+      Serial.print(" to ");
+      Serial.print(max_period_us);
+      Serial.println(" microseconds.");
+      min_period_us = UINT32_MAX;
+      max_period_us = 0;
+    }
+    vTaskDelayUntil(&last_wake_time, MOTION_DETECTION_PERIOD_TICKS);
+  }
+}
+
+void GyroscopeTask::measure_period(void) {
+  int64_t now_us = esp_timer_get_time();
+  if (previous_wake_us) {
+    uint32_t period_us = (uint32_t) (now_us - previous_wake_us);
+    if (period_us < min_period_us) {
+      min_period_us = period_us;
+    }
+    if (max_period_us < period_us) {
+      max_period_us = period_us;
+    }
   }
+  previous_wake_us = now_us;
 }
 
 TaskHandle_t GyroscopeTask::start_motion_detection_loop() {
@@ -90,25 +183,116 @@ TaskHandle_t GyroscopeTask::start_motion_detection_loop() {
 }
 
 GyroscopeTask::UpdateTask::UpdateTask() :
-    Task(
-        "MPU6050 update loop",
-        2048,
-        GYROSCOPE_UPDATE_PIORITY),
-        gyroscope(NULL) {
+    StaticTask("MPU6050 update loop", TASK_ROLE_GYROSCOPE_UPDATE),
+        gyroscope(NULL),
+        orientation_filter(NULL),
+        h_task(NULL),
+        window_cycles(0),
+        window_updates(0),
+        cycles_per_update(0) {
 }
 
 GyroscopeTask::UpdateTask::~UpdateTask() {
 }
 
+void IRAM_ATTR GyroscopeTask::UpdateTask::on_data_ready(void *params) {
+  BaseType_t higher_priority_task_woken = pdFALSE;
+  vTaskNotifyGiveFromISR(
+      ((UpdateTask *) params)->h_task, &higher_priority_task_woken);
+  if (higher_priority_task_woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+void GyroscopeTask::UpdateTask::drain_fifo(void) {
+  uint8_t address = gyroscope->getAddress();
+
+  // With MPU6050_INTERRUPT_CONFIGURATION, reading the status also clears
+  // the interrupt.
+  uint8_t interrupt_status =
+      gyroscope->readData(MPU6050_INTERRUPT_STATUS_REGISTER);
+  if (interrupt_status & MPU6050_INTERRUPT_FIFO_OVERFLOW) {
+    gyroscope->writeData(
+        MPU6050_USER_CONTROL_REGISTER,
+        MPU6050_USER_CONTROL_FIFO_RESET);
+    gyroscope->writeData(
+        MPU6050_USER_CONTROL_REGISTER,
+        MPU6050_USER_CONTROL_FIFO_ENABLE);
+    return;
+  }
+
+  uint8_t count_bytes[2];
+  Wire.beginTransmission(address);
+  Wire.write(MPU6050_FIFO_COUNT_REGISTER);
+  Wire.endTransmission(false);
+  if (Wire.requestFrom(address, (uint8_t) sizeof(count_bytes))
+      != sizeof(count_bytes)) {
+    return;
+  }
+  count_bytes[0] = Wire.read();
+  count_bytes[1] = Wire.read();
+  size_t bytes_to_read =
+      Mpu6050Fifo::whole_frames(Mpu6050Fifo::fifo_count(count_bytes))
+          * MPU6050_FIFO_FRAME_SIZE;
+  if (MAX_FIFO_BURST_BYTES < bytes_to_read) {
+    // Whatever remains is picked up on the next wakeup.
+    bytes_to_read = MAX_FIFO_BURST_BYTES;
+  }
+  if (!bytes_to_read) {
+    return;
+  }
+
+  uint8_t fifo_bytes[MAX_FIFO_BURST_BYTES];
+  Wire.beginTransmission(address);
+  Wire.write(MPU6050_FIFO_DATA_REGISTER);
+  Wire.endTransmission(false);
+  size_t bytes_read = Wire.requestFrom(address, (uint8_t) bytes_to_read);
+  for (size_t i = 0; i < bytes_read; ++i) {
+    fifo_bytes[i] = Wire.read();
+  }
+
+  Mpu6050RawSample samples[MAX_FIFO_BURST_BYTES / MPU6050_FIFO_FRAME_SIZE];
+  size_t sample_count = Mpu6050Fifo::parse(
+      fifo_bytes,
+      bytes_read,
+      samples,
+      sizeof(samples) / sizeof(samples[0]));
+  for (size_t i = 0; i < sample_count; ++i) {
+    uint32_t start_cycles = ESP.getCycleCount();
+    orientation_filter->update(samples[i]);
+    window_cycles += ESP.getCycleCount() - start_cycles;
+    if (++window_updates == FILTER_MEASUREMENT_WINDOW) {
+      cycles_per_update = window_cycles / window_updates;
+      window_cycles = 0;
+      window_updates = 0;
+    }
+  }
+}
+
 void GyroscopeTask::UpdateTask::task_loop() {
   Serial.println("GyroscopeTask::UpdateTask::task_loop() started");
   for (;;) {
-    gyroscope->update();
-    taskYIELD();
+    ulTaskNotifyTake(pdTRUE, DATA_READY_TIMEOUT_TICKS);
+    drain_fifo();
   }
 }
 
-TaskHandle_t GyroscopeTask::UpdateTask::start(MPU6050 *gyroscope) {
+TaskHandle_t GyroscopeTask::UpdateTask::start(
+    MPU6050 *gyroscope,
+    OrientationFilter *orientation_filter) {
   this->gyroscope = gyroscope;
-  return create_and_start_task();
+  this->orientation_filter = orientation_filter;
+  h_task = create_and_start_task();
+  if (h_task) {
+    pinMode(MOTION_DETECTED_INTERRUPT_PIN, INPUT);
+    attachInterruptArg(
+        MOTION_DETECTED_INTERRUPT_PIN,
+        on_data_ready,
+        this,
+        RISING);
+    gyroscope->writeData(
+        MPU6050_INTERRUPT_ENABLE_REGISTER,
+        MPU6050_INTERRUPT_DATA_READY);
+  }
+  return h_task;
 }
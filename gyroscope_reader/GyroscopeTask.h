@@ -12,7 +12,6 @@
 #define GYROSCOPETASK_H_
 
 #include "Arduino.h"
-#include "dhtnew.h"
 #include "Wire.h"
 
 #include "MPU6050_light.h"
@@ -22,8 +21,10 @@
 #include "freertos/task.h"
 
 #include "MotionNotificationMessage.h"
+#include "OrientationFilter.h"
 #include "PinAssignments.h"
-#include "Task.h"
+#include "StaticTask.h"
+#include "TemperatureSamplerTask.h"
 
 /**
  * Manages the MPU6050 gyroscope, keeping its data current and detecting
@@ -31,35 +32,66 @@
  * a threshold or returns to the vertical.
  */
 class GyroscopeTask :
-    public Task {
+    public StaticTask<2048> {
 
   /**
    * Runs the update loop that refreshes the gyroscope's position data. The
    * gyroscope integrates acceleration into velocity and position.
    *
-   * The update loop updates the MPU6050 readings every 2 microseconds to keep
-   * its readings up to date. Update is performed on a best efforts basis.
-   * Since the update task has extremely low priority, it might not
-   * honor its update SLA. Assuming the SLA violation occurs infrequently,
-   * this should not pose a problem.
+   * The MPU6050 samples at a fixed output data rate, appends each sample to
+   * its on-chip FIFO, and raises its data ready interrupt. The update loop
+   * sleeps until the interrupt fires, then drains the FIFO in a single I2C
+   * burst and feeds the samples to the orientation filter. The CPU
+   * therefore idles between samples, and samples are evenly spaced
+   * regardless of scheduling.
+   *
+   * The loop also measures the CPU cycles that each filter update costs.
    */
   class UpdateTask :
-      Task {
+      StaticTask<2048> {
     MPU6050 *gyroscope;
+    OrientationFilter *orientation_filter;
+    TaskHandle_t h_task;
+    uint32_t window_cycles;         // Filter cycles in the current window
+    uint32_t window_updates;        // Filter updates in the current window
+    volatile uint32_t cycles_per_update;  // Mean over the last window
+
+    /**
+     * Data ready interrupt handler. Wakes the update loop.
+     */
+    static void IRAM_ATTR on_data_ready(void *params);
+
+    /**
+     * Reads everything that the FIFO holds and filters it. Resets the
+     * FIFO if it has overflowed, since the frame boundaries are lost.
+     */
+    void drain_fifo(void);
 
   public:
     UpdateTask();
     virtual ~UpdateTask();
 
     /**
-     * Starts the gyroscope update task.
+     * Starts the gyroscope update task and enables the data ready
+     * interrupt.
+     */
+    TaskHandle_t start(
+        MPU6050 *gyroscope,
+        OrientationFilter *orientation_filter);
+
+    /**
+     * Returns the mean number of CPU cycles per orientation filter update
+     * over the most recent measurement window, or 0 before the first
+     * window completes.
      */
-    TaskHandle_t start(MPU6050 *gyroscope);
+    uint32_t get_cycles_per_update(void) const {
+      return cycles_per_update;
+    }
 
     /**
-     * The update loop updates the MPU6050 readings every 2 microseconds on a
-     * best efforts basis. Since it has extremely low priority, it might not
-     * make its SLA.
+     * The update loop waits for the data ready interrupt, then drains the
+     * FIFO. If an interrupt goes missing, the loop times out and drains
+     * the FIFO anyway.
      */
     virtual void task_loop();
   };
@@ -67,23 +99,57 @@ class GyroscopeTask :
   UpdateTask update_task;
 	QueueHandle_t h_gyro_event_queue;  // Post motion notification here.
 	MPU6050 gyroscope;  // The MPU6050
-	DHTNEW temperature_sensor;
+	OrientationFilter *orientation_filter;  // Turns FIFO samples into angles
+	const LatestValue<TemperatureReading> *temperature;
+	int64_t previous_wake_us;     // Motion loop jitter measurement
+	uint32_t min_period_us;
+	uint32_t max_period_us;
 	MotionNotificationMessage notification_message;
 
 	/**
-	 * The motion detection loop reads the Z acceleration, which will be 1 g
-	 * when the lid is level, and alerts when it falls to or below .9 g. This
-	 * happens when the lid is raised approximately 26 degrees.
+	 * Copies calcOffsets() results to the orientation filter, sets the
+	 * output data rate to the filter's sample rate, and routes accelerometer
+	 * and gyroscope samples to the FIFO.
+	 */
+	void configure_fifo(void);
+
+	/**
+	 * Records the time since the previous motion detection loop wakeup.
+	 */
+	void measure_period(void);
+
+	/**
+	 * The motion detection loop compares the filtered gravity vector with
+	 * the inclination threshold and alerts when the lid is raised beyond
+	 * it, approximately 30 degrees. It runs at a fixed period and reads
+	 * the temperature from the sampler's cell, so no sensor I/O stretches
+	 * the period. Once a minute, it reports the filter's angles and cost,
+	 * and the shortest and longest loop periods.
 	 */
 	virtual void task_loop(void);
 
 public:
-	GyroscopeTask();
+	/**
+	 * Constructor
+	 *
+	 * Parameters:
+	 *
+	 * Name                Contents
+	 * ------------------- ----------------------------------------------------
+	 * orientation_filter  Fuses the FIFO samples into a gravity vector. Its
+	 *                     sample rate sets the MPU6050 output data rate.
+	 * temperature         Latest temperature, from the temperature sampler
+	 */
+	GyroscopeTask(
+	    OrientationFilter *orientation_filter,
+	    const LatestValue<TemperatureReading> *temperature);
 	virtual ~GyroscopeTask();
 
 	/**
 	 * Configure the gyroscope and bind the task to its queue handle. Note
-	 * that the task sends gyroscope events to the specified queue.
+	 * that the task sends gyroscope events to the specified queue. After
+	 * calibration, switches the MPU6050 to FIFO mode with its data ready
+	 * interrupt enabled.
 	 */
 	boolean begin(QueueHandle_t h_gyro_event_queue);
 
@@ -95,8 +161,8 @@ public:
 
 	/**
 	 * Start the update loop. Invoke this immediately after begin() has run
-	 * successfully. The update loop integrates gyroscope readings into
-	 * offset angles.
+	 * successfully. The update loop feeds gyroscope readings to the
+	 * orientation filter.
 	 */
 
 	TaskHandle_t start_update_loop();
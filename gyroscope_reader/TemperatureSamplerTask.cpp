@@ -0,0 +1,57 @@
+/*
+ * TemperatureSamplerTask.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "TemperatureSamplerTask.h"
+
+#include "MotionNotificationMessage.h"
+#include "PinAssignments.h"
+
+// Time between sensor reads. Temperature changes slowly.
+#define TEMPERATURE_SAMPLE_PERIOD_MS 30000
+
+static const TemperatureReading NO_READING = {
+    (float) ABSOLUTE_ZERO,
+    0.0f
+};
+
+TemperatureSamplerTask::TemperatureSamplerTask() :
+    StaticTask("Temperature sampler", TASK_ROLE_TEMPERATURE_SAMPLER),
+    temperature_sensor(TEMPERATURE_AND_HUMIDITY_PIN),
+    latest_reading(NO_READING),
+    failed_reads(0) {
+}
+
+TemperatureSamplerTask::~TemperatureSamplerTask() {
+}
+
+void TemperatureSamplerTask::task_loop(void) {
+  Serial.println("Temperature sampler started.");
+  TickType_t last_wake_time = xTaskGetTickCount();
+  for (;;) {
+    int status = temperature_sensor.read();
+    if (status == DHTLIB_OK) {
+      TemperatureReading reading;
+      reading.temperature_celsius = temperature_sensor.getTemperature();
+      reading.humidity_percent = temperature_sensor.getHumidity();
+      latest_reading.publish(reading);
+    } else {
+      ++failed_reads;
+      Serial.print("Temperature read failed, status ");
+      Serial.print(status);
+      Serial.print(", ");
+      Serial.print(failed_reads);
+      Serial.println(" failures total.");
+    }
+    vTaskDelayUntil(
+        &last_wake_time,
+        pdMS_TO_TICKS(TEMPERATURE_SAMPLE_PERIOD_MS));
+  }
+}
+
+TaskHandle_t TemperatureSamplerTask::start(void) {
+  return create_and_start_task();
+}
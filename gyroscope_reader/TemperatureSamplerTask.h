@@ -0,0 +1,62 @@
+/*
+ * TemperatureSamplerTask.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Reads the DHT temperature and humidity sensor at a slow, fixed cadence
+ * and publishes the most recent reading in a lock-free cell. The DHT
+ * single wire protocol blocks for several milliseconds per read, so the
+ * sampler runs at low priority, away from the motion detection loop.
+ */
+
+#ifndef TEMPERATURESAMPLERTASK_H_
+#define TEMPERATURESAMPLERTASK_H_
+
+#include "Arduino.h"
+#include "dhtnew.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include "LatestValue.h"
+#include "StaticTask.h"
+
+/**
+ * A temperature and humidity reading.
+ */
+struct TemperatureReading {
+  float temperature_celsius;  // ABSOLUTE_ZERO until the first good read
+  float humidity_percent;
+};
+
+class TemperatureSamplerTask :
+    public StaticTask<2048> {
+  DHTNEW temperature_sensor;
+  LatestValue<TemperatureReading> latest_reading;
+  uint32_t failed_reads;
+
+  /**
+   * Reads the sensor every TEMPERATURE_SAMPLE_PERIOD_MS and publishes
+   * good readings. Failed reads leave the previous reading in place.
+   */
+  virtual void task_loop(void);
+
+public:
+  TemperatureSamplerTask();
+  virtual ~TemperatureSamplerTask();
+
+  /**
+   * Returns the cell that holds the latest reading.
+   */
+  const LatestValue<TemperatureReading>& get_latest_reading(void) const {
+    return latest_reading;
+  }
+
+  /**
+   * Starts the sampling loop.
+   */
+  TaskHandle_t start(void);
+};
+
+#endif /* TEMPERATURESAMPLERTASK_H_ */
@@ -15,52 +15,74 @@
 #include "Wire.h"
 #include "WiFi.h"
 
-#include "BlinkTask.h"
 #include "CommunicationSettings.h"
+#include "ComplementaryOrientationFilter.h"
 #include "EspNowTransmitter.h"
 #include "EventRelayTask.h"
 #include "GyroscopeTask.h"
+#include "LedPatternEngine.h"
+#include "MadgwickOrientationFilter.h"
+#include "Mpu6050AngleIntegrator.h"
 #include "PinAssignments.h"
+#include "StaticQueue.h"
+#include "TaskMonitor.h"
+#include "TemperatureSamplerTask.h"
 
 #include "MotionNotificationMessage.h"
 
 
+StaticQueue<MotionNotificationMessage, 10> gyroscope_event_queue;
+StaticQueue<MotionNotificationMessage, 10> notification_send_queue;
 QueueHandle_t h_gyroscope_event_queue;
 QueueHandle_t h_notification_send_queue;
-TaskHandle_t h_connection_dropped_blink_task;
 TaskHandle_t h_gyroscope_update_task;
 TaskHandle_t h_motion_detection_task;
 TaskHandle_t h_event_relay_task;
 TaskHandle_t h_esp_now_transmit_task;
+TaskHandle_t h_temperature_sampler_task;
 
-BlinkTask connection_dropped_signal(
-  "Receiver connection lost",
-  RED_LED_PIN,
-  3,
-  150,
-  500);
+const uint8_t status_led_pins[] = { RED_LED_PIN, GREEN_LED_PIN };
+#define NUMBER_OF_STATUS_LED_PINS 2
 
-EspNowTransmitter esp_now_transmitter(
-  receiver_address,
-  &connection_dropped_signal);
+LedPatternEngine status_leds(status_led_pins, NUMBER_OF_STATUS_LED_PINS);
 
-GyroscopeTask gyroscope_task;
+// Batching packs notifications into shared frames, adding at most 100 ms
+// of latency. The receiver accepts batched and single message frames.
+EspNowTransmitter esp_now_transmitter(
+  receiver_addresses,
+  RECEIVER_COUNT,
+  &status_leds,
+  EspNowTransmitter::SEND_BATCHED_FRAMES);
+
+// MPU6050 output data rate. The gyroscope update loop wakes once per
+// sample.
+#define ORIENTATION_SAMPLE_RATE_HZ 100
+
+// Orientation filter. Alternatives are
+//
+//   MadgwickOrientationFilter orientation_filter(
+//     ORIENTATION_SAMPLE_RATE_HZ, 0.1f);
+//   Mpu6050AngleIntegrator orientation_filter(
+//     ORIENTATION_SAMPLE_RATE_HZ, 0.98f);
+//
+// The latter is the floating point MPU6050_light reference.
+ComplementaryOrientationFilter orientation_filter(
+  ORIENTATION_SAMPLE_RATE_HZ,
+  0.98f);
+
+TemperatureSamplerTask temperature_sampler;
+
+GyroscopeTask gyroscope_task(
+  &orientation_filter,
+  &temperature_sampler.get_latest_reading());
 
 EventRelayTask event_relay_task;
 
-void start_blink_tasks() {
-  Serial.print("Starting blink task ... ");
-  h_connection_dropped_blink_task =
-    connection_dropped_signal.start_blink_loop("ESP_NOW connection");
-  if (h_connection_dropped_blink_task) {
-    Serial.print("succeeded.");
-    vTaskSuspend(h_connection_dropped_blink_task);
-    Serial.println("Blink task suspended.");
-  } else {
-    Serial.print("failed.");
-  }
-  EspNowTransmitter::set_blink_task(&connection_dropped_signal);
-}
+// Time between task stack and CPU reports. Send any character over
+// serial for a report on demand.
+#define TASK_REPORT_INTERVAL_MS (10 * 60 * 1000)
+
+TaskMonitor task_monitor;
 
 void setup() {
   Serial.begin(115200);
@@ -119,13 +141,11 @@ void setup() {
    */
   Serial.println("Creating event queues.");
   Serial.print("Gyroscope event queue ");
-  h_gyroscope_event_queue =
-    xQueueCreate(10, sizeof(MotionNotificationMessage));
+  h_gyroscope_event_queue = gyroscope_event_queue.create();
   Serial.println(h_gyroscope_event_queue ? "created." : "failed.");
 
   Serial.print("Receiver notification queue ... ");
-  h_notification_send_queue =
-    xQueueCreate(10, sizeof(MotionNotificationMessage));
+  h_notification_send_queue = notification_send_queue.create();
   Serial.println(h_notification_send_queue ? "created." : "failed.");
   Serial.println("Queue setup completed.");
 
@@ -145,7 +165,8 @@ void setup() {
    * Start tasks.
    */
   Serial.println("Starting tasks.");
-  start_blink_tasks();
+  Serial.print("Starting status LEDs ... ");
+  Serial.println(status_leds.begin() ? "succeeded." : "failed.");
 
   Serial.println("Configuring ESP-NOW transmitter.");
   esp_now_transmitter.begin(h_notification_send_queue);
@@ -156,8 +177,12 @@ void setup() {
 
   h_gyroscope_update_task = gyroscope_task.start_update_loop();
 
+  h_temperature_sampler_task = temperature_sampler.start();
+
   h_motion_detection_task = gyroscope_task.start_motion_detection_loop();
 
+  task_monitor.start(TASK_REPORT_INTERVAL_MS);
+
   Serial.println("Setup completed.");
   Serial.flush();
 }
@@ -1,15 +0,0 @@
-/*
- * Action.cpp
- *
- *  Created on: Mar 28, 2023
- *      Author: Eric Mintz
- */
-
-#include "Action.h"
-
-Action::Action() {
-}
-
-Action::~Action() {
-}
-
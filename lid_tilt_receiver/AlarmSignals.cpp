@@ -0,0 +1,69 @@
+/*
+ * AlarmSignals.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "AlarmSignals.h"
+
+static const LedStep silence_levels[] = {
+    { LED_LEVEL_LOW, 0 },
+};
+const LedPattern silent_alarm = {
+    silence_levels,
+    1,
+    LED_PATTERN_ONCE,
+};
+
+
+static const LedStep delivered_levels[] = {
+    { LED_LEVEL_HIGH, 50 },
+    { LED_LEVEL_LOW, 9950 },
+};
+const LedPattern delivered_alarm = {
+    delivered_levels,
+    2,
+    0,
+};
+
+
+static const LedStep disconnected_levels[] = {
+    { LED_LEVEL_HIGH, 500 },
+    { LED_LEVEL_LOW, 500 },
+    { LED_LEVEL_HIGH, 500 },
+    { LED_LEVEL_LOW, 500 },
+    { LED_LEVEL_HIGH, 500 },
+    { LED_LEVEL_LOW, 500 },
+    { LED_LEVEL_LOW, 7000 },
+};
+const LedPattern disconnected_alarm = {
+    disconnected_levels,
+    7,
+    0,
+};
+
+static const LedStep lid_open[] = {
+    { LED_LEVEL_HIGH, 50 },
+    { LED_LEVEL_LOW, 50 },
+    { LED_LEVEL_HIGH, 50 },
+    { LED_LEVEL_LOW, 50 },
+    { LED_LEVEL_HIGH, 50 },
+    { LED_LEVEL_LOW, 1250 },
+};
+const LedPattern lid_open_signal = {
+    lid_open,
+    6,
+    0,
+};
+
+static const LedStep panic_alarm[] = {
+    { LED_LEVEL_HIGH, 950 },
+    { LED_LEVEL_LOW, 50 },
+};
+
+const LedPattern panic_alarm_signal = {
+    panic_alarm,
+    2,
+    0,
+};
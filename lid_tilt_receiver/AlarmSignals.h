@@ -0,0 +1,27 @@
+/*
+ * AlarmSignals.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * The alarm signal library, the beeper and alarm LED waveforms that
+ * AlarmTask plays. Each signal repeats until another replaces it. See
+ * LedSequencer.h for the format.
+ *
+ * The library has no Arduino dependencies, so the level and duration
+ * sequence of each signal can be checked on a host by playing it through
+ * an LedSequencer.
+ */
+
+#ifndef ALARMSIGNALS_H_
+#define ALARMSIGNALS_H_
+
+#include "LedSequencer.h"
+
+extern const LedPattern silent_alarm;  // Silence
+extern const LedPattern delivered_alarm;  // Chirp every 10 seconds
+extern const LedPattern disconnected_alarm;  // Three beeps every 10 seconds
+extern const LedPattern lid_open_signal;  // Three chirps every 1.5 seconds
+extern const LedPattern panic_alarm_signal;  // Nearly continuous tone
+
+#endif /* ALARMSIGNALS_H_ */
@@ -11,70 +11,16 @@
 
 #include "Arduino.h"
 
-const struct AlarmTask::LevelAndDuration silence_levels[] = {
-    { LOW, 60000 },
-};
-const struct AlarmTask::AlarmSignal silent_alarm = {
-    1,
-    silence_levels,
-};
-
-
-const struct AlarmTask::LevelAndDuration delivered_levels[] = {
-    { HIGH, 50 },
-    { LOW, 9950 },
-};
-const struct AlarmTask::AlarmSignal delivered_alarm = {
-    2,
-    delivered_levels,
-};
-
-
-const struct AlarmTask::LevelAndDuration disconnected_levels[] = {
-    { HIGH, 500 },
-    { LOW, 500 },
-    { HIGH, 500 },
-    { LOW, 500 },
-    { HIGH, 500 },
-    { LOW, 500 },
-    { LOW, 7000 },
-};
-const struct AlarmTask::AlarmSignal disconnected_alarm = {
-    7,
-    disconnected_levels,
-};
-
-const struct AlarmTask::LevelAndDuration lid_open[] = {
-    { HIGH, 50 },
-    { LOW, 50 },
-    { HIGH, 50 },
-    { LOW, 50 },
-    { HIGH, 50 },
-    { LOW, 1250 },
-};
-const struct AlarmTask::AlarmSignal lid_open_signal = {
-    6,
-    lid_open,
-};
-
-const struct AlarmTask::LevelAndDuration panic_alarm[] = {
-    { HIGH, 950 },
-    { LOW, 50 },
-};
-
-const AlarmTask::AlarmSignal panic_alarm_signal = {
-    2,
-    panic_alarm,
-};
+#include "AlarmSignals.h"
+#include "ReceiverTopics.h"
 
 AlarmTask::AlarmTask(
+    LedPatternEngine *alarm_outputs,
     uint8_t audio_alert_pin_no,
     uint8_t led_pin_no) :
-    Task(
-        "alarm",
-        2048,
-        5),
-    h_alarm_event_queue(NULL),
+    StaticTask("alarm", TASK_ROLE_ALARM),
+    alarm_events(),
+    alarm_outputs(alarm_outputs),
     audio_alert_pin_no(audio_alert_pin_no),
     led_pin_no(led_pin_no) {
 }
@@ -82,26 +28,16 @@ AlarmTask::AlarmTask(
 AlarmTask::~AlarmTask() {
 }
 
-void AlarmTask::emit_alarm(const AlarmSignal &alarm_signal) {
-  while (!uxQueueMessagesWaiting(h_alarm_event_queue)) {
-    for (
-        size_t i = 0;
-        !uxQueueMessagesWaiting(h_alarm_event_queue)
-            && i < alarm_signal.level_count;
-        ++i) {
-      const LevelAndDuration *level_and_duration = alarm_signal.level + i;
-      digitalWrite(audio_alert_pin_no, level_and_duration->level);
-      digitalWrite(led_pin_no, level_and_duration->level);
-      vTaskDelay(level_and_duration->duration_ms);
-    }
-  }
+void AlarmTask::emit_alarm(const LedPattern &alarm_signal) {
+  alarm_outputs->show(audio_alert_pin_no, alarm_signal);
+  alarm_outputs->show(led_pin_no, alarm_signal);
 }
 
 void AlarmTask::task_loop() {
   AlarmTaskMessage message;
   for (;;) {
     memset(&message, 0, sizeof(message));
-    if (xQueueReceive(h_alarm_event_queue, &message, portMAX_DELAY) ) {
+    if (alarm_events.receive(message, portMAX_DELAY)) {
       switch (message.event) {
       case ALARM_EVENT_CONNECTED:
         emit_alarm(silent_alarm);
@@ -123,7 +59,7 @@ void AlarmTask::task_loop() {
   }
 }
 
-TaskHandle_t AlarmTask::start(QueueHandle_t h_alarm_event_queue) {
-  this->h_alarm_event_queue = h_alarm_event_queue;
+TaskHandle_t AlarmTask::start(void) {
+  alarm_events.subscribe(alarm_topic);
   return create_and_start_task();
 }
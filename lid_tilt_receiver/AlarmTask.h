@@ -4,16 +4,21 @@
  *  Created on: Feb 15, 2023
  *      Author: Eric Mintz
  *
- * Task that manages the alarm, a.k.a. the beeper
+ * Task that manages the alarm, a.k.a. the beeper. The task plays each
+ * requested signal on the beeper and the alarm LED through an
+ * LedPatternEngine, so a signal plays without the task and a new request
+ * replaces it at once.
  */
 
 #ifndef ALARMTASK_H_
 #define ALARMTASK_H_
 
-#include "Task.h"
+#include "LedPatternEngine.h"
+#include "StaticTask.h"
+#include "Topic.h"
 
 class AlarmTask :
-    public Task {
+    public StaticTask<2048> {
 public:
   /**
    * Types of available signal.
@@ -33,36 +38,22 @@ public:
     Event event;
   };
 
-  /**
-   * A component of a signal, a pin level (HIGH or LOW) and the length of
-   * time to maintain it.
-   */
-  struct LevelAndDuration {
-    uint8_t level;   // HIGH or LOW
-    uint16_t duration_ms;  // Milliseconds to hold the pin to the level.
-  };
-
-  /**
-   * An alarm signal, a sequence of levels and durations to emit.
-   */
-  struct AlarmSignal {
-    size_t level_count;  // Number of levels comprising the alarm
-    const LevelAndDuration *level;
-  };
 private:
-  QueueHandle_t h_alarm_event_queue;
+  Subscription<AlarmTaskMessage, 3> alarm_events;  // Incoming requests
+  LedPatternEngine *alarm_outputs;  // Plays the signals
   const uint8_t audio_alert_pin_no;
   const uint8_t led_pin_no;
 
   /**
-   * Emits the specified alarm until a user requests another.
+   * Starts emitting the specified alarm, replacing the current one. The
+   * alarm repeats until a user requests another.
    */
-  void emit_alarm(const AlarmSignal &alarm_signal);
+  void emit_alarm(const LedPattern &alarm_signal);
 
   /**
    * The task loop, which listens for incoming alarm messages and emits
-   * the requested alarms by publishing AlarmTaskMessage instance to the
-   * queue.
+   * the requested alarms. Clients request alarms by publishing
+   * AlarmTaskMessage instances to alarm_topic.
    */
   void task_loop();
 
@@ -74,26 +65,22 @@ public:
    *
    * Name                Contents
    * ------------------  ------------------------------------------------------
+   * alarm_outputs       Drives the beeper and the alarm LED. Must own both
+   *                     pins.
    * audio_alert_pin_no  The GPIO pin that is connected to the alarm beeper.
    * led_pin_no          The GPIO pin that is connected to the alarm LED.
    */
   AlarmTask(
+      LedPatternEngine *alarm_outputs,
       uint8_t audio_alert_pin_no,
       uint8_t led_pin_no);
 
   virtual ~AlarmTask();
 
   /**
-   * Starts the alarm task.
-   *
-   * Parameters:
-   *
-   * Name                Contents
-   * ------------------- ------------------------------------------------------
-   * h_alarm_event_queue The queue that provides alarm request messages.
-   *                     Client tasks enqueue
+   * Subscribes to alarm_topic and starts the alarm task.
    */
-  TaskHandle_t start(QueueHandle_t h_alarm_event_queue);
+  TaskHandle_t start(void);
 };
 
 #endif /* ALARMTASK_H_ */
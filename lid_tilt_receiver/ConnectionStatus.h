@@ -4,12 +4,15 @@
  *  Created on: Feb 20, 2023
  *      Author: Eric Mintz
  *
- * Connection status to the sender, that is, the gyroscope reader.
+ * Connection status to the senders, that is, the gyroscope readers.
+ * Each message reports the status of one sender.
  */
 
 #ifndef CONNECTIONSTATUS_H_
 #define CONNECTIONSTATUS_H_
 
+#include <stdint.h>
+
 enum ConnectionStatus {
   CONNECTION_STATUS_DOWN,  // WIFI disconnected
   CONNECTION_STATUS_UP,  // WIFI connected
@@ -19,6 +22,7 @@ enum ConnectionStatus {
 
 struct ConnectionStatusMessage {
   ConnectionStatus status;
+  uint8_t peer;  // The sender's slot in the receiver's peer table
 };
 
 #endif /* CONNECTIONSTATUS_H_ */
@@ -9,50 +9,74 @@
 
 #include "ConnectionStatus.h"
 #include "DisplayMessage.h"
+#include "ReceiverTopics.h"
 
-const ConnectionStatusTask::State ConnectionStatusTask::TRANSITION_TABLE
-    [NET_STATE_COUNT]
+// Disconnected LED pattern: 100 ms on, 100 ms off.
+static const LedStep DISCONNECTED_BLINK_STEPS[] = {
+  { HIGH, 100 },
+  { LOW, 100 },
+};
+static const LedPattern DISCONNECTED_BLINK = {
+  DISCONNECTED_BLINK_STEPS,
+  2,
+  0,
+};
+
+static constexpr uint8_t TRANSITION_TABLE
+    [ConnectionStatusTask::NET_STATE_COUNT]
     [CONNECTION_STATUS_COUNT] = {
   { // NET_INITIALIZED
-    NET_GOING_DOWN,  // CONNECTION_STATUS_DOWN
-    NET_COMING_UP,  // CONNECTION_STATUS_UP
-    NET_SENDER_PANIC,  // CONNECTION_STATUS_SENDER_FAILED
+    fsm_to(ConnectionStatusTask::NET_GOING_DOWN),  // CONNECTION_STATUS_DOWN
+    fsm_to(ConnectionStatusTask::NET_COMING_UP),  // CONNECTION_STATUS_UP
+    fsm_to(ConnectionStatusTask::NET_SENDER_PANIC),  // CONNECTION_STATUS_SENDER_FAILED
   },
   { // NET_GOING_DOWN
-    NET_DISCONNECTED,  // CONNECTION_STATUS_DOWN
-    NET_COMING_UP,  // CONNECTION_STATUS_UP
-    NET_SENDER_PANIC,  // CONNECTION_STATUS_SENDER_FAILED
+    fsm_to(ConnectionStatusTask::NET_DISCONNECTED),  // CONNECTION_STATUS_DOWN
+    fsm_to(ConnectionStatusTask::NET_COMING_UP),  // CONNECTION_STATUS_UP
+    fsm_to(ConnectionStatusTask::NET_SENDER_PANIC),  // CONNECTION_STATUS_SENDER_FAILED
   },
   { // NET_DISCONNECTED
-    NET_DISCONNECTED,  // CONNECTION_STATUS_DOWN
-    NET_COMING_UP,  // CONNECTION_STATUS_UP
-    NET_SENDER_PANIC,  // CONNECTION_STATUS_SENDER_FAILED
+    fsm_to(ConnectionStatusTask::NET_DISCONNECTED),  // CONNECTION_STATUS_DOWN
+    fsm_to(ConnectionStatusTask::NET_COMING_UP),  // CONNECTION_STATUS_UP
+    fsm_to(ConnectionStatusTask::NET_SENDER_PANIC),  // CONNECTION_STATUS_SENDER_FAILED
   },
   { // NET_GOING_UP
-    NET_GOING_DOWN,  // CONNECTION_STATUS_DOWN
-    NET_CONNECTED, // CONNECTION_STATUS_UP
-    NET_SENDER_PANIC,  // CONNECTION_STATUS_SENDER_FAILED
+    fsm_to(ConnectionStatusTask::NET_GOING_DOWN),  // CONNECTION_STATUS_DOWN
+    fsm_to(ConnectionStatusTask::NET_CONNECTED), // CONNECTION_STATUS_UP
+    fsm_to(ConnectionStatusTask::NET_SENDER_PANIC),  // CONNECTION_STATUS_SENDER_FAILED
   },
   { // NET_CONNECTED
-    NET_GOING_DOWN,  // CONNECTION_STATUS_DOWN
-    NET_CONNECTED,  // CONNECTION_STATUS_UP
-    NET_SENDER_PANIC,  // CONNECTION_STATUS_SENDER_FAILED
+    fsm_to(ConnectionStatusTask::NET_GOING_DOWN),  // CONNECTION_STATUS_DOWN
+    fsm_to(ConnectionStatusTask::NET_CONNECTED),  // CONNECTION_STATUS_UP
+    fsm_to(ConnectionStatusTask::NET_SENDER_PANIC),  // CONNECTION_STATUS_SENDER_FAILED
   },
   { // NET_SENDER_PANIC
-    NET_STATE_COUNT,
-    NET_STATE_COUNT,
-    NET_STATE_COUNT,
+    FSM_IGNORE,
+    FSM_IGNORE,
+    FSM_IGNORE,
   }
 };
 
+static_assert(
+    fsm_table_is_complete(TRANSITION_TABLE),
+    "Every network state must handle every connection status.");
+static_assert(
+    fsm_all_states_reachable(
+        TRANSITION_TABLE,
+        fsm_state_bit(ConnectionStatusTask::NET_INITIALIZED)),
+    "Every network state must be reachable.");
+
 ConnectionStatusTask::ConnectionStatusTask(
-    DisconnectedLedTask *disconnected_led_task,
+    LedPatternEngine *status_leds,
+    uint8_t disconnected_led_pin,
     uint8_t connected_led_pin) :
-    state(NET_INITIALIZED),
-    Task("Network status", 2048, 15),
-    h_communication_event_queue(NULL),
-    h_display_command_queue(NULL),
-    disconnected_led_task(disconnected_led_task),
+    StaticTask("Network status", TASK_ROLE_CONNECTION_STATUS),
+    states(NET_INITIALIZED),
+    peer_count(0),
+    indication(INDICATE_NOTHING),
+    connection_events(),
+    status_leds(status_leds),
+    disconnected_led_pin(disconnected_led_pin),
     connected_led_pin(connected_led_pin) {
 
 }
@@ -60,59 +84,98 @@ ConnectionStatusTask::ConnectionStatusTask(
 ConnectionStatusTask::~ConnectionStatusTask() {
 }
 
-TaskHandle_t ConnectionStatusTask::start(
-    QueueHandle_t h_communications_event_queue,
-    QueueHandle_t h_display_command_queue) {
-  Serial.print("ConnectionStatusTask::start connection event handle: ");
-  Serial.println((uint32_t) h_communications_event_queue, HEX);
-  this->h_communication_event_queue = h_communications_event_queue;
-  this->h_display_command_queue = h_display_command_queue;
+TaskHandle_t ConnectionStatusTask::start(void) {
+  connection_events.subscribe(connection_status_topic);
   return create_and_start_task();
 }
 
+void ConnectionStatusTask::indicate(void) {
+  Indication worst = INDICATE_NOTHING;
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    Indication peer_indication = INDICATE_NOTHING;
+    switch (states.get_state(peer)) {
+      case NET_GOING_DOWN:
+      case NET_DISCONNECTED:
+        peer_indication = INDICATE_DISCONNECTED;
+        break;
+      case NET_COMING_UP:
+      case NET_CONNECTED:
+        peer_indication = INDICATE_CONNECTED;
+        break;
+      case NET_SENDER_PANIC:
+        peer_indication = INDICATE_SENDER_PANIC;
+        break;
+      default:
+        break;
+    }
+    if (worst < peer_indication) {
+      worst = peer_indication;
+    }
+  }
+  if (worst == indication) {
+    return;
+  }
+  indication = worst;
+
+  DisplayMessage display_command;
+  memset(&display_command, 0, sizeof(display_command));
+  switch (indication) {
+  case INDICATE_NOTHING:
+    return;
+  case INDICATE_CONNECTED:
+    status_leds->show(disconnected_led_pin, LED_PATTERN_OFF);
+    status_leds->show(connected_led_pin, LED_PATTERN_ON);
+    display_command.command = LCD_CONNECTED;
+    break;
+  case INDICATE_DISCONNECTED:
+    status_leds->show(connected_led_pin, LED_PATTERN_OFF);
+    status_leds->show(disconnected_led_pin, DISCONNECTED_BLINK);
+    display_command.command = LCD_DISCONNECTED;
+    break;
+  case INDICATE_SENDER_PANIC:
+    status_leds->show(disconnected_led_pin, DISCONNECTED_BLINK);
+    status_leds->show(connected_led_pin, LED_PATTERN_OFF);
+    display_command.command = LCD_TRANSMITTER_PANIC;
+    break;
+  }
+  display_topic.publish(display_command);
+}
+
+void ConnectionStatusTask::on_enter(size_t peer, State new_state) {
+  switch (new_state) {
+  case NET_INITIALIZED:
+    Serial.println("WIFI initializing.");
+    break;
+  case NET_GOING_DOWN:
+    Serial.printf("WIFI signal lost from box %c\n", box_label(peer));
+    break;
+  case NET_DISCONNECTED:
+    break;
+  case NET_COMING_UP:
+    Serial.printf("WIFI connected to box %c.\n", box_label(peer));
+    break;
+  case NET_CONNECTED:
+    break;
+  case NET_SENDER_PANIC:
+    Serial.printf("Box %c failed.\n", box_label(peer));
+    break;
+  default:
+    Serial.println("Default in connection status task.");
+  }
+}
+
 void ConnectionStatusTask::task_loop() {
   ConnectionStatusMessage connection_status_message;
-  DisplayMessage display_command;
-  State maybe_new_state;
   for (;;) {
-    if (xQueueReceive(
-        h_communication_event_queue,
-        &connection_status_message,
-        portMAX_DELAY)) {
-      if (connection_status_message.status != CONNECTION_STATUS_COUNT) {
-        switch (state =
-            TRANSITION_TABLE[state][connection_status_message.status]) {
-        case NET_INITIALIZED:
-          Serial.println("WIFI initializing.");
-          break;
-        case NET_GOING_DOWN:
-          digitalWrite(connected_led_pin, LOW);
-          disconnected_led_task->enable();
-          display_command.command = LCD_DISCONNECTED;
-          xQueueSendToBack(h_display_command_queue, &display_command, 0);
-          Serial.println("WIFI signal lost");
-          break;
-        case NET_DISCONNECTED:
-          break;
-        case NET_COMING_UP:
-          Serial.println("WIFI connected.");
-          disconnected_led_task->disable();
-          digitalWrite(connected_led_pin, HIGH);
-          display_command.command = LCD_CONNECTED;
-          xQueueSendToBack(h_display_command_queue, &display_command, 0);
-          break;
-        case NET_CONNECTED:
-          break;
-        case NET_SENDER_PANIC:
-          disconnected_led_task->enable();
-          digitalWrite(connected_led_pin, LOW);
-          display_command.command = LCD_TRANSMITTER_PANIC;
-          xQueueSendToBack(h_display_command_queue, &display_command, 0);
-          break;
-        default:
-          Serial.println("Default in connection status task.");
-        }
+    if (connection_events.receive(connection_status_message, portMAX_DELAY)
+        && connection_status_message.peer < PEER_TABLE_CAPACITY) {
+      size_t peer = connection_status_message.peer;
+      if (peer_count <= peer) {
+        peer_count = peer + 1;
       }
+      states.dispatch(
+          TRANSITION_TABLE, peer, connection_status_message.status, *this);
+      indicate();
     }
   }
 }
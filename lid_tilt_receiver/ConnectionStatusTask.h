@@ -17,24 +17,30 @@
 #include "freertos/task.h"
 
 #include "ConnectionStatus.h"
-#include "DisconnectedLedTask.h"
-#include "Task.h"
+#include "LedPatternEngine.h"
+#include "PeerTable.h"
+#include "StateMachine.h"
+#include "StaticTask.h"
+#include "Topic.h"
 
 /**
  * A task that responds to connectivity events and indicates when the
  * network comes up and goes down, taking the following actions:
  *
- *   Illuminates the network connection indicator LED when the sender
- *   is connected and extinguishes it when the connection fails.
+ *   Illuminates the network connection indicator LED when the senders
+ *   are connected and extinguishes it when a connection fails.
  *
  *   Directs the LCD task to show network connection status.
  *
- * The task implements a Moore-type finite state machine that transitions among
- * the states specified below in response to ConnectionStatus events.
+ * The task implements a Moore-type finite state machine per sender that
+ * transitions among the states specified below in response to that
+ * sender's ConnectionStatus events. The indicators show the worst sender:
+ * a sender panic outranks a lost connection, which outranks a working
+ * one. Senders that have never been heard from do not count.
  */
 class ConnectionStatusTask :
-  public Task {
-
+  public StaticTask<2048> {
+public:
   /**
    * FSM states
    */
@@ -48,23 +54,64 @@ class ConnectionStatusTask :
     NET_STATE_COUNT,
   };
 
-  static const State TRANSITION_TABLE[NET_STATE_COUNT][CONNECTION_STATUS_COUNT];
+private:
+  friend class StateMachineArray<
+      State, NET_STATE_COUNT, CONNECTION_STATUS_COUNT, PEER_TABLE_CAPACITY>;
+
+  /**
+   * What the indicators show, from least to most severe.
+   */
+  enum Indication {
+    INDICATE_NOTHING,  // No sender heard yet
+    INDICATE_CONNECTED,
+    INDICATE_DISCONNECTED,
+    INDICATE_SENDER_PANIC,
+  };
 
-  State state;  // Machine state
-  QueueHandle_t h_communication_event_queue;  // Provides incoming events
-  QueueHandle_t h_display_command_queue;  // Outgoing display-related commands
-  DisconnectedLedTask *disconnected_led_task;  // Blinks the disconnected LED
+  StateMachineArray<
+      State, NET_STATE_COUNT, CONNECTION_STATUS_COUNT, PEER_TABLE_CAPACITY>
+      states;  // Machine states, indexed by peer table slot
+  size_t peer_count;  // Highest slot heard from plus one
+  Indication indication;  // What the indicators show
+  Subscription<ConnectionStatusMessage, 8> connection_events;  // Incoming
+  LedPatternEngine *status_leds;  // Drives the connection LEDs
+  uint8_t disconnected_led_pin;
   uint8_t connected_led_pin;
 
+  /**
+   * Drives the connection LEDs and the display to show the worst
+   * sender's state, if it has changed.
+   */
+  void indicate(void);
+
+  /**
+   * Entry actions: log the sender's connection changes.
+   */
+  void on_enter(size_t peer, State new_state);
+
 public:
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                 Contents
+   * -------------------- -----------------------------------------------
+   * status_leds          Drives both LEDs
+   * disconnected_led_pin Blinks while any sender is disconnected
+   * connected_led_pin    Lit while every sender is connected
+   */
   ConnectionStatusTask(
-      DisconnectedLedTask *disconnected_led_task,
+      LedPatternEngine *status_leds,
+      uint8_t disconnected_led_pin,
       uint8_t connected_led_pin);
   virtual ~ConnectionStatusTask();
 
-  TaskHandle_t start(
-    QueueHandle_t h_connection_status_queue,
-    QueueHandle_t h_display_message_queue);
+  /**
+   * Subscribes to connection_status_topic and starts the task, which
+   * publishes to display_topic.
+   */
+  TaskHandle_t start(void);
 
   virtual void task_loop();
 };
@@ -7,6 +7,15 @@
  * LCD Display Commands. Each command causes the LCD Display Task to write
  * a predefined message to the display. Please see LCDDisplayTask.cpp for
  * details.
+ *
+ * The arrival commands, LCD_DELIVERED, LCD_DELIVERY_IN_PROGRESS, and
+ * LCD_TAMPER_ALERT, carry the label of the box that they describe in
+ * text, or an empty string while the receiver has heard from only one
+ * box.
+ *
+ * LCD_LINK_QUALITY carries a three character summary of the weakest
+ * link, which replaces "OK " in the network status field while the
+ * network is up.
  */
 
 #ifndef DISPLAYMESSAGE_H_
@@ -29,6 +38,7 @@ enum DisplayCommand {
   LCD_TRANSMITTER_PANIC,    // Transmitter failure, e.g. gyroscope down
   LCD_TAMPER_ALERT,         // Milk box accessed 2 or more times.
   LCD_DELIVERY_IN_PROGRESS, // Milk is being delivered
+  LCD_LINK_QUALITY,         // Weakest link summary, e.g. "-67"
 };
 
 struct DisplayMessage {
@@ -36,4 +46,12 @@ struct DisplayMessage {
   char text[MAX_LCD_TEXT_LENGTH+1];  // NULL terminated string
 };
 
+/**
+ * Returns the label that identifies a milk box on the display: 'A' for
+ * the box in peer table slot 0, 'B' for slot 1, and so on.
+ */
+inline char box_label(uint8_t peer) {
+  return 'A' + peer;
+}
+
 #endif /* DISPLAYMESSAGE_H_ */
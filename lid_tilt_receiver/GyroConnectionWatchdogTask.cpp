@@ -8,134 +8,185 @@
 #include "GyroConnectionWatchdogTask.h"
 
 #include "ConnectionStatus.h"
+#include "DisplayMessage.h"
+#include "ReceiverTopics.h"
 
-static ConnectionStatusMessage CONNECTION_DOWN = { CONNECTION_STATUS_DOWN };
-static ConnectionStatusMessage CONNECTION_UP = { CONNECTION_STATUS_UP };
+// Messages from one reader that arrive closer together than this came
+// in the same frame.
+#define WATCHDOG_SAME_FRAME_MS 10
 
-#define STACK_DEPTH 2048
-#define PRIORITY 2
-
-GyroConnectionWatchdogTask::EventMessage_t
-    GyroConnectionWatchdogTask::EXPIRE_MESSAGE = {
-        GyroConnectionWatchdogTask::EXPIRE,
-};
-GyroConnectionWatchdogTask::EventMessage_t
-    GyroConnectionWatchdogTask::RESET_MESSAGE = {
-        GyroConnectionWatchdogTask::RESET,
+// How long a reader may be silent before it is disconnected. The
+// shortest timeout must exceed twice the sender's longest broadcast
+// heartbeat interval, 500 ms, and the initial one covers a lost
+// heartbeat at its longest unicast interval, 1000 ms.
+static const ArrivalTimeoutSettings TIMEOUT_SETTINGS = {
+  99,    // percent
+  250,   // margin_ms
+  1100,  // min_ms
+  5000,  // max_ms
+  2250,  // initial_ms
 };
 
-static const GyroConnectionWatchdogTask::State TRANSITION_TABLE
+static constexpr uint8_t TRANSITION_TABLE
     [GyroConnectionWatchdogTask::GYRO_WATCHDOG_NUMBER_OF_STATES]
     [GyroConnectionWatchdogTask::GYRO_WATCHDOG_NUMBER_OF_EVENTS] =
   {
     {  // CRREATED
-      GyroConnectionWatchdogTask::STARTING,  // RESET
-      GyroConnectionWatchdogTask::EXPIRING,  // EXPIRED, should not happen
+      fsm_to(GyroConnectionWatchdogTask::STARTING),  // RESET
+      fsm_to(GyroConnectionWatchdogTask::EXPIRING),  // EXPIRED, should not happen
     },
     { // STARTING
-      GyroConnectionWatchdogTask::RESETTING,  // RESET
-      GyroConnectionWatchdogTask::EXPIRING,   // EXPIRED
+      fsm_to(GyroConnectionWatchdogTask::RESETTING),  // RESET
+      fsm_to(GyroConnectionWatchdogTask::EXPIRING),   // EXPIRED
     },
     {  // RESETTING
-      GyroConnectionWatchdogTask::HAS_RESET,  // RESET
-      GyroConnectionWatchdogTask::EXPIRING,   // EXPIRE
+      fsm_to(GyroConnectionWatchdogTask::HAS_RESET),  // RESET
+      fsm_to(GyroConnectionWatchdogTask::EXPIRING),   // EXPIRE
     },
     {  // HAS_RESET
-      GyroConnectionWatchdogTask::HAS_RESET,  // RESET
-      GyroConnectionWatchdogTask::EXPIRING,   // EXPIRE
+      fsm_to(GyroConnectionWatchdogTask::HAS_RESET),  // RESET
+      fsm_to(GyroConnectionWatchdogTask::EXPIRING),   // EXPIRE
     },
     {  //  EXPIRING
-      GyroConnectionWatchdogTask::RESETTING,    // RESET
-      GyroConnectionWatchdogTask::HAS_EXPIRED,  // EXPIRE
+      fsm_to(GyroConnectionWatchdogTask::RESETTING),    // RESET
+      fsm_to(GyroConnectionWatchdogTask::HAS_EXPIRED),  // EXPIRE
     },
     {  // HAS_EXPIRED
-      GyroConnectionWatchdogTask::RESETTING,    // RESET
-      GyroConnectionWatchdogTask::HAS_EXPIRED,  // EXPIRE
+      fsm_to(GyroConnectionWatchdogTask::RESETTING),    // RESET
+      fsm_to(GyroConnectionWatchdogTask::HAS_EXPIRED),  // EXPIRE
     },
   };
 
+static_assert(
+    fsm_table_is_complete(TRANSITION_TABLE),
+    "Every watchdog state must handle every event.");
+static_assert(
+    fsm_all_states_reachable(
+        TRANSITION_TABLE,
+        fsm_state_bit(GyroConnectionWatchdogTask::CREATED)),
+    "Every watchdog state must be reachable.");
 
-GyroConnectionWatchdogTask::GyroConnectionWatchdogTask() :
-        Task(
-            "ESP32 Watchdog",
-            STACK_DEPTH,
-            PRIORITY),
-      state(CREATED),
-      h_timer(NULL),
-      h_connection_status_queue(NULL),
+GyroConnectionWatchdogTask::GyroConnectionWatchdogTask(
+    TimerService *timer_service) :
+      StaticTask("ESP32 Watchdog", TASK_ROLE_CONNECTION_WATCHDOG),
+      states(CREATED),
+      timer_service(timer_service),
+      peer_count(0),
+      timer_event_queue(),
       h_timer_event_queue(NULL) {
+  memset(last_heard, 0, sizeof(last_heard));
+  for (size_t peer = 0; peer < PEER_TABLE_CAPACITY; ++peer) {
+    timeouts[peer].configure(&TIMEOUT_SETTINGS);
+    expiries[peer].event = EXPIRE;
+    expiries[peer].peer = peer;
+  }
 }
 
 GyroConnectionWatchdogTask::~GyroConnectionWatchdogTask(void) {
 }
 
-void GyroConnectionWatchdogTask::on_timer_expired(TimerHandle_t h_timer) {
-  (static_cast<GyroConnectionWatchdogTask *>(pvTimerGetTimerID(h_timer)))
-      ->expire();
+void GyroConnectionWatchdogTask::reset(uint8_t peer) {
+  // Only the receiver task resets, so the room cannot vanish between
+  // the check and the send. A dropped reset is followed by another.
+  if (PEER_TABLE_CAPACITY < uxQueueSpacesAvailable(h_timer_event_queue)) {
+    EventMessage_t reset_message = { RESET, peer };
+    xQueueSendToBack(h_timer_event_queue, &reset_message, 0);
+  }
+}
+
+TaskHandle_t GyroConnectionWatchdogTask::start(void) {
+  h_timer_event_queue = timer_event_queue.create();
+  for (size_t peer = 0; peer < PEER_TABLE_CAPACITY; ++peer) {
+    TimerService::init_timer(
+        &timers[peer], h_timer_event_queue, &expiries[peer]);
+  }
+  TaskHandle_t h_task = create_and_start_task();
+  Serial.println("Gyroscope connection task started.");
+  return h_task;
+}
+
+void GyroConnectionWatchdogTask::learn_interval(size_t peer) {
+  TickType_t now = xTaskGetTickCount();
+  if (states.get_state(peer) != CREATED) {
+    uint32_t interval_ms = (now - last_heard[peer]) * portTICK_PERIOD_MS;
+    if (interval_ms < WATCHDOG_SAME_FRAME_MS) {
+      return;
+    }
+    timeouts[peer].record(interval_ms);
+  }
+  last_heard[peer] = now;
 }
 
-void GyroConnectionWatchdogTask::expire(void) {
-  xQueueSendToBack(h_timer_event_queue, &EXPIRE_MESSAGE, 0);
+void GyroConnectionWatchdogTask::start_timer(size_t peer) {
+  timer_service->start_timer(&timers[peer], timeouts[peer].get_timeout_ms());
 }
 
-void GyroConnectionWatchdogTask::reset(void) {
-  xQueueSendToBack(h_timer_event_queue, &RESET_MESSAGE, 0);
+void GyroConnectionWatchdogTask::on_enter(size_t peer, State new_state) {
+  ConnectionStatusMessage status_message;
+  status_message.peer = peer;
+  switch (new_state) {
+    case CREATED:
+      // Assume connection down until shown otherwise.
+      status_message.status = CONNECTION_STATUS_DOWN;
+      connection_status_topic.publish(status_message, 0);
+      break;
+    case STARTING:
+      start_timer(peer);
+      break;
+    case RESETTING:
+      start_timer(peer);
+      status_message.status = CONNECTION_STATUS_UP;
+      connection_status_topic.publish(status_message, pdMS_TO_TICKS(10));
+      break;
+    case HAS_RESET:
+      start_timer(peer);
+      break;
+    case EXPIRING:
+      // Expire once more to settle in HAS_EXPIRED.
+      start_timer(peer);
+      status_message.status = CONNECTION_STATUS_DOWN;
+      connection_status_topic.publish(status_message, 0);
+      break;
+    case HAS_EXPIRED:
+      // The timer has stopped; the next reset restarts it.
+      break;
+    case GYRO_WATCHDOG_NUMBER_OF_STATES:
+      // Should never happen
+      break;
+  }
 }
 
-TaskHandle_t GyroConnectionWatchdogTask::start(
-    QueueHandle_t h_communications_event_queue) {
-  this->h_connection_status_queue = h_communications_event_queue;
-  h_timer_event_queue = xQueueCreate(sizeof(EventMessage_t), 10);
-  h_timer = xTimerCreate(
-      "Gyro Disconnect",
-      1510,
-      pdTRUE,
-      this,
-      on_timer_expired);
-  TaskHandle_t h_task = create_and_start_task();
-  Serial.println("Gyroscope connection task started.");
-  return h_task;
+void GyroConnectionWatchdogTask::print_timeouts(void) const {
+  for (size_t peer = 0; peer < peer_count; ++peer) {
+    const ArrivalTimeout &timeout = timeouts[peer];
+    Serial.printf(
+        "  %c timeout %u ms, %u%% of intervals <= %u ms, %u learned\n",
+        box_label(peer),
+        (unsigned) timeout.get_timeout_ms(),
+        (unsigned) TIMEOUT_SETTINGS.percent,
+        (unsigned) timeout.percentile_ms(),
+        (unsigned) timeout.get_samples());
+  }
 }
 
 void GyroConnectionWatchdogTask::task_loop(void) {
   EventMessage_t event_message;
   for (;;) {
-    if (
-        xQueueReceive(h_timer_event_queue, &event_message, portMAX_DELAY)
-            == pdPASS
-        && event_message.event != GYRO_WATCHDOG_NUMBER_OF_STATES) {
-      state = TRANSITION_TABLE[state][event_message.event];
-      switch (state) {
-        case CREATED:
-          // Assume connection down until shown otherwise.
-          xQueueSendToBack(
-              h_connection_status_queue,
-              &CONNECTION_DOWN,
-              0);
-          break;
-        case STARTING:
-          xTimerStart(h_timer, 0);
-          break;
-        case RESETTING:
-          xTimerReset(h_timer, 0);
-          xQueueSendToBack(
-              h_connection_status_queue,
-              &CONNECTION_UP,
-              pdMS_TO_TICKS(10));
-          break;
-        case HAS_RESET:
-          xTimerReset(h_timer, 0);
-          break;
-        case EXPIRING:
-          xQueueSendToBack(
-              h_connection_status_queue,
-              &CONNECTION_DOWN,
-              0);
-          break;
-        case HAS_EXPIRED:
-          // Nothing to do
-          break;
+    if (xQueueReceive(h_timer_event_queue, &event_message, portMAX_DELAY)
+        == pdPASS
+        && event_message.peer < PEER_TABLE_CAPACITY) {
+      if (peer_count <= event_message.peer) {
+        peer_count = event_message.peer + 1;
+      }
+      if (event_message.event == RESET) {
+        learn_interval(event_message.peer);
+      } else if (timer_service->is_timer_running(
+          &timers[event_message.peer])) {
+        // A reset restarted the timer after this expiry was posted.
+        continue;
       }
+      states.dispatch(
+          TRANSITION_TABLE, event_message.peer, event_message.event, *this);
     }
   }
 }
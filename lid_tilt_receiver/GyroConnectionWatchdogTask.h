@@ -4,25 +4,41 @@
  *  Created on: May 21, 2023
  *      Author: Eric Mintz
  *
- * Timeout task for the ESPNow connection, a free running timer that sends a
- * timeout notification when it expires. The ESPNow handler resets the timer
- * whenever it receives a command, so if the gyroscope reader is connected,
- * the timer never expires.
+ * Timeout task for the ESPNow connections. Every gyroscope reader,
+ * identified by its peer table slot, has a timer that expires, and
+ * reports the connection down, when the reader falls silent. The ESPNow
+ * handler resets a reader's timer whenever it receives a command from
+ * it, so while the reader is connected, the timer never expires.
+ *
+ * The timers run on the shared TimerService, which posts expiries to
+ * the same queue as the resets, and the watchdog states live in arrays
+ * indexed by slot, so readers cost no tasks. The timer stops once a
+ * silent reader has been reported down.
+ *
+ * Each reader's timeout is learned from the intervals between its
+ * messages: twice a high percentile plus a margin, within bounds, so one
+ * lost message never reports a reader down. See ArrivalTimeout.h. A
+ * reader heard often is declared down quickly, and a jittery one is
+ * given the slack it needs. print_timeouts() reports the
+ * current timeouts.
  */
 
 #ifndef GYROCONNECTIONWATCHDOGTASK_H_
 #define GYROCONNECTIONWATCHDOGTASK_H_
 
 #include "Arduino.h"
-#include "Resettable.h"
-#include "Task.h"
+#include "ArrivalTimeout.h"
+#include "PeerTable.h"
+#include "StateMachine.h"
+#include "StaticQueue.h"
+#include "StaticTask.h"
+#include "TimerService.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
 
-class GyroConnectionWatchdogTask : public Task, public Resettable {
+class GyroConnectionWatchdogTask : public StaticTask<2048> {
   public:
   enum State {
     CREATED,
@@ -41,29 +57,86 @@ class GyroConnectionWatchdogTask : public Task, public Resettable {
   };
 
 private:
+  friend class StateMachineArray<
+      State,
+      GYRO_WATCHDOG_NUMBER_OF_STATES,
+      GYRO_WATCHDOG_NUMBER_OF_EVENTS,
+      PEER_TABLE_CAPACITY>;
+
   typedef struct {
     Event event;
+    uint8_t peer;
   } EventMessage_t;
 
-  State state;
-  TimerHandle_t h_timer;
-  QueueHandle_t h_connection_status_queue;
+  // Per reader state, indexed by peer table slot
+  StateMachineArray<
+      State,
+      GYRO_WATCHDOG_NUMBER_OF_STATES,
+      GYRO_WATCHDOG_NUMBER_OF_EVENTS,
+      PEER_TABLE_CAPACITY> states;
+  TickType_t last_heard[PEER_TABLE_CAPACITY];  // Tick counts
+  ArrivalTimeout timeouts[PEER_TABLE_CAPACITY];
+  WheelTimer timers[PEER_TABLE_CAPACITY];
+  EventMessage_t expiries[PEER_TABLE_CAPACITY];  // What the timers post
+
+  TimerService *timer_service;
+
+  size_t peer_count;  // Highest slot reset plus one
+  // Resets leave room for one expiry per reader, so expiries are never
+  // lost. See reset().
+  StaticQueue<EventMessage_t, 2 * PEER_TABLE_CAPACITY> timer_event_queue;
   QueueHandle_t h_timer_event_queue;
 
-  static EventMessage_t EXPIRE_MESSAGE;
-  static EventMessage_t RESET_MESSAGE;
+  /**
+   * Learns the interval since the reader was last heard. Messages that
+   * arrive together, in one frame, count as one.
+   */
+  void learn_interval(size_t peer);
+
+  /**
+   * Entry actions: run the reader's timer and report connection
+   * changes.
+   */
+  void on_enter(size_t peer, State new_state);
 
-  static void on_timer_expired(TimerHandle_t h_timer);
+  /**
+   * Starts or restarts the reader's timer with its current timeout.
+   */
+  void start_timer(size_t peer);
 
 public:
-  GyroConnectionWatchdogTask();
+  /**
+   * Constructor
+   *
+   * Parameters     Contents
+   * -------------- -------------------------------------
+   * timer_service  Runs the readers' timers
+   */
+  GyroConnectionWatchdogTask(TimerService *timer_service);
   virtual ~GyroConnectionWatchdogTask();
 
-  void expire(void);
+  /**
+   * Restarts a reader's timer. Call whenever the reader is heard.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * peer                The reader's peer table slot
+   */
+  void reset(uint8_t peer);
 
-  virtual void reset(void);
+  /**
+   * Prints each reader's timeout and what it was learned from over
+   * serial.
+   */
+  void print_timeouts(void) const;
 
-  TaskHandle_t start(QueueHandle_t h_communications_event_queue);
+  /**
+   * Starts the watchdog, which publishes connection changes to
+   * connection_status_topic.
+   */
+  TaskHandle_t start(void);
 
   virtual void task_loop(void);
 };
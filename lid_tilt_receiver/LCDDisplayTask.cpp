@@ -7,111 +7,142 @@
 
 #include "LCDDisplayTask.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #include "DisplayMessage.h"
+#include "ReceiverTopics.h"
 #include "TimeTask.h"
 
 LCDDisplayTask::LCDDisplayTask(
-    LiquidCrystal_I2C display,
+    BufferedI2cLcd *display,
     TimeTask *time_task) :
-      Task(
-          "LCD Display",
-          4096,
-          3),
+      StaticTask("LCD Display", TASK_ROLE_LCD_DISPLAY),
       display(display),
-      h_display_command_queue(NULL),
-      time_task(time_task) {
+      framebuffer(),
+      display_commands(),
+      time_task(time_task),
+      network_up(false) {
+  strcpy(link_quality, "OK ");
 }
 
 LCDDisplayTask::~LCDDisplayTask() {
 }
 
+void LCDDisplayTask::box(const char *label) {
+  framebuffer.set_cursor(3, 1);
+  framebuffer.print(label[0] ? label : " ");
+}
+
 void LCDDisplayTask::connected() {
-  display.setCursor(0, 1);
-  display.print("OK ");
+  network_up = true;
+  framebuffer.set_cursor(0, 1);
+  framebuffer.print(link_quality);
 }
 
 void LCDDisplayTask::disconnected() {
-  display.setCursor(0, 1);
-  display.print("NET");
+  network_up = false;
+  framebuffer.set_cursor(0, 1);
+  framebuffer.print("NET");
+}
+
+void LCDDisplayTask::draw(const DisplayMessage &command_message) {
+  switch (command_message.command) {
+    case LCD_CLEAR:
+      framebuffer.clear();
+      break;
+    case LCD_CONNECTED:
+      connected();
+      break;
+    case LCD_DELIVERED:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("Delivered       ");
+      connected();
+      box(command_message.text);
+      {
+        char formatted_time[6];
+        memset(formatted_time, 0, sizeof(formatted_time));
+        tm broken_down_time;
+        memset(&broken_down_time, 0, sizeof(broken_down_time));
+        time_t current_time = time_task->now();
+        gmtime_r(&current_time, &broken_down_time);
+        char * buffer =
+            time_task->to_two_chars(broken_down_time.tm_hour, formatted_time);
+        *buffer++ = ':';
+        buffer = time_task->to_two_chars(broken_down_time.tm_min, buffer);
+        framebuffer.set_cursor(16 - strlen(formatted_time), 0);
+        framebuffer.print(formatted_time);
+      }
+      break;
+    case LCD_DISCONNECTED:
+      disconnected();
+      break;
+    case LCD_ELAPSED:
+      framebuffer.set_cursor(4, 1);
+      framebuffer.print(command_message.text);
+      break;
+    case LCD_LINK_QUALITY:
+      // Pad or truncate to the width of the field.
+      snprintf(
+          link_quality,
+          sizeof(link_quality),
+          "%-3.3s",
+          command_message.text);
+      if (network_up) {
+        connected();
+      }
+      break;
+    case LCD_INIT:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("Starting        ");
+      break;
+    case LCD_NOOP:
+      break;
+    case LCD_RUN:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("Listening       ");
+      break;
+    case LCD_TIME_OF_DAY:
+      framebuffer.set_cursor(MAX_LCD_TEXT_LENGTH-strlen(command_message.text), 1);
+      framebuffer.print(command_message.text);
+      break;
+    case LCD_TRANSMITTER_PANIC:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("XMIT FAIL       ");
+      break;
+    case LCD_TAMPER_ALERT:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("Tamper Alert    ");
+      box(command_message.text);
+      break;
+    case LCD_DELIVERY_IN_PROGRESS:
+      framebuffer.set_cursor(0, 0);
+      framebuffer.print("Milk Arriving   ");
+      box(command_message.text);
+      break;
+  }
 }
 
 void LCDDisplayTask::task_loop() {
   DisplayMessage command_message;
   for (;;) {
     memset(&command_message, 0, sizeof(command_message));
-    if (xQueueReceive(
-        h_display_command_queue, &command_message, portMAX_DELAY) == pdTRUE) {
-      switch (command_message.command) {
-        case LCD_CLEAR:
-          display.clear();
-          display.setCursor(0, 0);
-          break;
-        case LCD_CONNECTED:
-          connected();
-          break;
-        case LCD_DELIVERED:
-          display.setCursor(0, 0);
-          display.print("Delivered       ");
-          connected();
-          {
-            char formatted_time[6];
-            memset(formatted_time, 0, sizeof(formatted_time));
-            tm broken_down_time;
-            memset(&broken_down_time, 0, sizeof(broken_down_time));
-            time_t current_time = time_task->now();
-            gmtime_r(&current_time, &broken_down_time);
-            char * buffer =
-                time_task->to_two_chars(broken_down_time.tm_hour, formatted_time);
-            *buffer++ = ':';
-            buffer = time_task->to_two_chars(broken_down_time.tm_min, buffer);
-            display.setCursor(16 - strlen(formatted_time), 0);
-            display.print(formatted_time);
-          }
-          break;
-        case LCD_DISCONNECTED:
-          disconnected();
-          break;
-        case LCD_ELAPSED:
-          display.setCursor(4, 1);
-          display.print(command_message.text);
-          break;
-        case LCD_INIT:
-          display.setCursor(0, 0);
-          display.print("Starting        ");
-          break;
-        case LCD_NOOP:
-          break;
-        case LCD_RUN:
-          display.setCursor(0, 0);
-          display.print("Listening       ");
-          break;
-        case LCD_TIME_OF_DAY:
-          display.setCursor(MAX_LCD_TEXT_LENGTH-strlen(command_message.text), 1);
-          display.print(command_message.text);
-          break;
-        case LCD_TRANSMITTER_PANIC:
-          display.setCursor(0, 0);
-          display.print("XMIT FAIL       ");
-          break;
-        case LCD_TAMPER_ALERT:
-          display.setCursor(0, 0);
-          display.print("Tamper Alert    ");
-          break;
-        case LCD_DELIVERY_IN_PROGRESS:
-          display.setCursor(0, 0);
-          display.print("Milk Arriving   ");
-          break;
+    if (display_commands.receive(command_message, portMAX_DELAY)) {
+      draw(command_message);
+      // Draw whatever else is waiting before touching the bus.
+      memset(&command_message, 0, sizeof(command_message));
+      while (display_commands.receive(command_message, 0)) {
+        draw(command_message);
+        memset(&command_message, 0, sizeof(command_message));
       }
+      framebuffer.flush(*display);
     }
   }
 }
 
-TaskHandle_t LCDDisplayTask::start(QueueHandle_t h_display_command) {
-  display.init();
-  display.backlight();
-  display.setContrast(255);
-  this->h_display_command_queue = h_display_command;
+TaskHandle_t LCDDisplayTask::start(void) {
+  display->init();
+  framebuffer.reset();
+  display_commands.subscribe(display_topic);
   return create_and_start_task();
 }
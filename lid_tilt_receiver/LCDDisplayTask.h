@@ -5,6 +5,14 @@
  *      Author: Eric Mintz
  *
  * Displays delivery and network status on a 2 x 16 liquid crystal display.
+ * When the receiver serves several boxes, column 3 of the bottom line
+ * shows the label of the box that the top line describes.
+ * While the network is up, the status field in columns 0 - 2 of the
+ * bottom line shows the latest LCD_LINK_QUALITY summary, or "OK " until
+ * one arrives.
+ * Commands draw into a shadow framebuffer; once the task has drained its
+ * pending commands, it sends only the changed cells to the display. See
+ * LcdFramebuffer.h.
  */
 
 #ifndef LCDDISPLAYTASK_H_
@@ -14,19 +22,31 @@
 #include "freertos/queue.h"
 #include "freertos/task.h"
 
-#include "LiquidCrystal_I2C.h"
-#include "Task.h"
+#include "BufferedI2cLcd.h"
+#include "DisplayMessage.h"
+#include "Hd44780Encoder.h"
+#include "LcdFramebuffer.h"
+#include "StaticTask.h"
 #include "TimeTask.h"
-
+#include "Topic.h"
 
 class LCDDisplayTask :
-    public Task {
-  LiquidCrystal_I2C display;
-  QueueHandle_t h_display_command_queue;
+    public StaticTask<4096> {
+  BufferedI2cLcd *display;
+  LcdFramebuffer framebuffer;
+  Subscription<DisplayMessage, 8> display_commands;  // From display_topic
   TimeTask *time_task;
+  char link_quality[4];  // Network status field while connected
+  bool network_up;
+
+  /**
+   * Display the label of the box that the top line describes, in the
+   * gap between the network status and the elapsed time.
+   */
+  void box(const char *label);
 
   /**
-   * Display "Network Connected" status
+   * Display "Network Connected" status, i.e. the link quality summary
    */
   void connected();
 
@@ -35,6 +55,11 @@ class LCDDisplayTask :
    */
   void disconnected();
 
+  /**
+   * Draws a command into the framebuffer.
+   */
+  void draw(const DisplayMessage &command_message);
+
   /**
    * Task run loop
    */
@@ -50,19 +75,23 @@ public:
    * time_task      Timer task, provides delivery time
    */
   LCDDisplayTask(
-      LiquidCrystal_I2C display,
+      BufferedI2cLcd *display,
       TimeTask *time_task);
   virtual ~LCDDisplayTask();
 
   /**
-   *
-   *
-   * Parameters         Contents
-   * -----------------  -------------------------------------
-   * h_display_command  LCD command queue. The queue carries
-   *                    commands to write information to the LCD.
+   * Initializes the display, subscribes to display_topic, which carries
+   * commands to write information to the LCD, and starts the task.
+   */
+  TaskHandle_t start(void);
+
+  /**
+   * Returns the number of I2C bytes that the framebuffer saved compared
+   * with writing every command straight to the display.
    */
-  TaskHandle_t start(QueueHandle_t h_display_command);
+  uint32_t get_i2c_bytes_saved(void) const {
+    return framebuffer.get_saved_transfers() * HD44780_BYTES_PER_TRANSFER;
+  }
 };
 
 #endif /* LCDDISPLAYTASK_H_ */
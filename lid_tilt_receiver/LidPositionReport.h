@@ -11,6 +11,8 @@
 #ifndef LIDPOSITIONREPORT_H_
 #define LIDPOSITIONREPORT_H_
 
+#include <stdint.h>
+
 /**
  * A message that reports position-related events.
  */
@@ -27,6 +29,7 @@ public:
   };
 
   PositionValue lid_position;
+  uint8_t peer;  // The box's slot in the receiver's peer table
 };
 
 #endif /* LIDPOSITIONREPORT_H_ */
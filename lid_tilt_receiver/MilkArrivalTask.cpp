@@ -10,9 +10,9 @@
 #include "LidPositionReport.h"
 
 #include "AlarmTask.h"
-#include "DeliveryLEDIlluminationStatus.h"
 #include "DisplayMessage.h"
 #include "PinAssignments.h"
+#include "ReceiverTopics.h"
 #include "WhiteLedPin.h"
 
 // Lid open confirmation time in milliseconds. When the lid is held open
@@ -23,9 +23,6 @@
 // specified time, delivery has definitely ended.
 #define CONFIRM_CLOSURE_TIMEOUT_TICKS pdMS_TO_TICKS(5000)
 
-static const AlarmTask::AlarmTaskMessage CONNECTED_ALARM =
-    { AlarmTask::ALARM_EVENT_CONNECTED
-};
 static const AlarmTask::AlarmTaskMessage DELIVERED_ALARM = {
     AlarmTask::ALARM_EVENT_DELIVERED
 };
@@ -33,187 +30,299 @@ static const AlarmTask::AlarmTaskMessage LID_OPEN_ALARM = {
     AlarmTask::ALARM_EVENT_LID_OPEN
 };
 
-static const LedIlluminationMessage LED_OFF = { DELIVERY_LED_OFF };
-static const LedIlluminationMessage LED_BLINK = { DELIVERY_LED_BLINK };
-static const LedIlluminationMessage LED_ON = { DELIVERY_LED_ON };
+// Delivery LED pattern while delivery is in progress: 100 ms on, 100 ms
+// off.
+static const LedStep DELIVERY_BLINK_STEPS[] = {
+  { HIGH, 100 },
+  { LOW, 100 },
+};
+static const LedPattern DELIVERY_BLINK = {
+  DELIVERY_BLINK_STEPS,
+  2,
+  0,
+};
 
-MilkArrivalTask::ArrivalState MilkArrivalTask::STATE_TRANSITION_TABLE
+static constexpr uint8_t STATE_TRANSITION_TABLE
     [MilkArrivalTask::MILK_ARRIVAL_NUMBER_OF_STATES]
     [LidPositionReport::LID_POS_NUMBER_OF_VALUES] = {
       { // MILK_ARRIVAL_CRREATED
-        MILK_ARRIVAL_NUMBER_OF_STATES,   // LID_POS_UNCHANGED
-        MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN, // LID_POS_OPEN
-        MILK_ARRIVAL_WAITING_FOR_ARRIVAL, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES,  // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE,   // LID_POS_UNCHANGED
+        // LID_POS_OPEN
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN),
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_WAITING_FOR_ARRIVAL), // LID_POS_CLOSED
+        FSM_IGNORE, // LID_POS_OPEN_TIMEOUT
+        FSM_IGNORE,  // LID_POS_CLOSE_TIMEOUT
       },
       { // MILK_ARRIVAL_WAITING_FOR_ARRIVAL
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN, // LID_POS_OPEN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        // LID_POS_OPEN
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN),
+        FSM_IGNORE, // LID_POS_CLOSED
+        FSM_IGNORE, // LID_POS_OPEN TIMEOUT
+        FSM_IGNORE, // LID_POS_CLOSE TIMEOUT
       },
       { // MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_NUMBER_OF_STATES,  // LID_POS_OPEN
-        MILK_ARRIVAL_WAITING_FOR_ARRIVAL,  // LID_POS_CLOSED
-        MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN,  // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        FSM_IGNORE,  // LID_POS_OPEN
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_WAITING_FOR_ARRIVAL),  // LID_POS_CLOSED
+        // LID_POS_OPEN_TIMEOUT
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN),
+        FSM_IGNORE, // LID_POS_CLOSE TIMEOUT
       },
       { // MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN
-        MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        FSM_IGNORE, // LID_POS_OPEN
+        // LID_POS_CLOSED
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE),
+        FSM_IGNORE, // LID_POS_OPEN_TIMEOUT
+        FSM_IGNORE, // LID_POS_CLOSE_TIMEOUT
       },
       { // MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE, // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        FSM_IGNORE, // LID_POS_OPEN
+        FSM_IGNORE, // LID_POS_CLOSED
+        FSM_IGNORE, // LID_POS_OPEN_TIMEOUT
+        // LID_POS_CLOSE_TIMEOUT
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE),
       },
       { // MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_SUSPECT_TAMPERING, // LID_POS_OPEN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_SUSPECT_TAMPERING), // LID_POS_OPEN
+        FSM_IGNORE, // LID_POS_CLOSED
+        FSM_IGNORE, // LID_POS_OPEN_TIMEOUT
+        FSM_IGNORE, // LID_POS_CLOSE_TIMEOUT
       },
       { // MILK_ARRIVAL_SUSPECT_TAMPERING
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN
-        MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE, // LID_POS_CLOSED
-        MILK_ARRIVAL_CONFIRMED_TAMPERING, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        FSM_IGNORE, // LID_POS_OPEN
+        // LID_POS_CLOSED
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE),
+        // LID_POS_OPEN_TIMEOUT
+        fsm_to(MilkArrivalTask::MILK_ARRIVAL_CONFIRMED_TAMPERING),
+        FSM_IGNORE, // LID_POS_CLOSE_TIMEOUT
       },
       { // MILK_ARRIVAL_CONFIRMED_TAMPERING
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_UNCHANGED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSED
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_OPEN_TIMEOUT
-        MILK_ARRIVAL_NUMBER_OF_STATES, // LID_POS_CLOSE_TIMEOUT
+        FSM_IGNORE, // LID_POS_UNCHANGED
+        FSM_IGNORE, // LID_POS_OPEN
+        FSM_IGNORE, // LID_POS_CLOSED
+        FSM_IGNORE, // LID_POS_OPEN_TIMEOUT
+        FSM_IGNORE, // LID_POS_CLOSE_TIMEOUT
        },
     };
 
-MilkArrivalTask::MilkArrivalTask(TimeTask *time_task) :
-  Task(
-      "Milk Arrival",
-      2048,
-      9),
+static_assert(
+    fsm_table_is_complete(STATE_TRANSITION_TABLE),
+    "Every arrival state must handle every lid position.");
+static_assert(
+    fsm_all_states_reachable(
+        STATE_TRANSITION_TABLE,
+        fsm_state_bit(MilkArrivalTask::MILK_ARRIVAL_CRREATED)),
+    "Every arrival state must be reachable.");
+
+MilkArrivalTask::MilkArrivalTask(
+    TimeTask *time_task,
+    LedPatternEngine *indicator_leds,
+    uint8_t delivery_led_pin) :
+  StaticTask("Milk Arrival", TASK_ROLE_MILK_ARRIVAL),
   time_task(time_task),
-  h_lid_position_report_queue(NULL),
-  h_delivery_led_illumination_queue(NULL),
-  h_alarm_event_queue(NULL),
-  h_display_command_queue(NULL),
-  state(ArrivalState::MILK_ARRIVAL_CRREATED),
-  timeout_action(),
-  timer("Milk Arrival Timer", &timeout_action) {
+  indicator_leds(indicator_leds),
+  delivery_led_pin(delivery_led_pin),
+  lid_position_reports(),
+  states(MILK_ARRIVAL_CRREATED),
+  box_count(0),
+  displayed_box(0),
+  delivery_led(DELIVERY_LED_UNCHANGED) {
+  memset(countdown_deadlines, 0, sizeof(countdown_deadlines));
+  memset(
+      countdown_reports,
+      LidPositionReport::LID_POS_UNCHANGED,
+      sizeof(countdown_reports));
 }
 
 MilkArrivalTask::~MilkArrivalTask() {
 }
 
-TaskHandle_t MilkArrivalTask::start(
-    QueueHandle_t h_lid_position_report_queue,
-    QueueHandle_t h_delivery_led_illumination_queue,
-    QueueHandle_t h_alarm_event_queue,
-    QueueHandle_t h_display_command_queue) {
-  this-> h_lid_position_report_queue = h_lid_position_report_queue;
-  this->h_delivery_led_illumination_queue = h_delivery_led_illumination_queue;
-  this->h_alarm_event_queue = h_alarm_event_queue;
-  this->h_display_command_queue = h_display_command_queue;
-  timeout_action.begin(h_lid_position_report_queue);
-
+TaskHandle_t MilkArrivalTask::start(void) {
+  lid_position_reports.subscribe(lid_position_topic);
   return create_and_start_task();
 };
 
-void MilkArrivalTask::halt_countdown() {
-  timeout_action.set_timeout_report(LidPositionReport::LID_POS_UNCHANGED);
-  timer.stop();
+void MilkArrivalTask::alarm(const AlarmTask::AlarmTaskMessage &message) {
+  if (!alarm_topic.publish(message)) {
+    Serial.println("Milk arrival: alarm request dropped.");
+  }
+}
+
+void MilkArrivalTask::display(size_t box, DisplayCommand command) {
+  if (box != displayed_box
+      && rank(states.get_state(box))
+          < rank(states.get_state(displayed_box))) {
+    return;
+  }
+  displayed_box = box;
+  DisplayMessage display_message;
+  memset(&display_message, 0, sizeof(display_message));
+  display_message.command = command;
+  if (1 < box_count) {
+    display_message.text[0] = box_label(box);
+  }
+  if (!display_topic.publish(display_message)) {
+    Serial.println("Milk arrival: display command dropped.");
+  }
+}
+
+void MilkArrivalTask::expire_countdowns(void) {
+  TickType_t now = xTaskGetTickCount();
+  for (size_t box = 0; box < box_count; ++box) {
+    uint8_t report = countdown_reports[box];
+    if (report != LidPositionReport::LID_POS_UNCHANGED
+        && 0 <= (int32_t) (now - countdown_deadlines[box])) {
+      countdown_reports[box] = LidPositionReport::LID_POS_UNCHANGED;
+      states.dispatch(STATE_TRANSITION_TABLE, box, report, *this);
+    }
+  }
+}
+
+void MilkArrivalTask::halt_countdown(size_t box) {
+  countdown_reports[box] = LidPositionReport::LID_POS_UNCHANGED;
 }
 
-void MilkArrivalTask::lid_is_open() {
-  xQueueSendToBack(h_delivery_led_illumination_queue, &LED_BLINK, 0);
-  xQueueSendToBack(h_alarm_event_queue, &LID_OPEN_ALARM, 0);
+uint8_t MilkArrivalTask::rank(ArrivalState state) {
+  switch (state) {
+    case MILK_ARRIVAL_CONFIRMED_TAMPERING:
+      return 3;
+    case MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN:
+    case MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE:
+      return 2;
+    case MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE:
+    case MILK_ARRIVAL_SUSPECT_TAMPERING:
+      return 1;
+    default:
+      return 0;
+  }
 }
 
-void MilkArrivalTask::quiesce() {
-  xQueueSendToBack(h_delivery_led_illumination_queue, &LED_OFF, 0);
-  xQueueSendToBack(h_alarm_event_queue, &CONNECTED_ALARM, 0);
+void MilkArrivalTask::show_indicators(void) {
+  uint8_t highest_rank = 0;
+  uint8_t white_led_level = LOW;
+  for (size_t box = 0; box < box_count; ++box) {
+    ArrivalState state = states.get_state(box);
+    if (highest_rank < rank(state)) {
+      highest_rank = rank(state);
+    }
+    switch (state) {
+      case MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN:
+      case MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN:
+      case MILK_ARRIVAL_SUSPECT_TAMPERING:
+      case MILK_ARRIVAL_CONFIRMED_TAMPERING:
+        white_led_level = HIGH;
+        break;
+      default:
+        break;
+    }
+  }
+  digitalWrite(WHITE_LED_PIN, white_led_level);
+
+  // Restarting a pattern would break its rhythm, so change it only when
+  // it differs.
+  DeliveryLed wanted =
+      1 < highest_rank ? DELIVERY_LED_BLINKING
+      : highest_rank ? DELIVERY_LED_ON
+      : delivery_led;
+  if (wanted != delivery_led) {
+    delivery_led = wanted;
+    indicator_leds->show(
+        delivery_led_pin,
+        wanted == DELIVERY_LED_BLINKING ? DELIVERY_BLINK : LED_PATTERN_ON);
+  }
 }
 
 void MilkArrivalTask::start_countdown(
+    size_t box,
     TickType_t timeout,
     LidPositionReport::PositionValue notification_on_expiration) {
-  halt_countdown();
-  timeout_action.set_timeout_report(notification_on_expiration);
-  timer.start(timeout);
+  countdown_deadlines[box] = xTaskGetTickCount() + timeout;
+  countdown_reports[box] = notification_on_expiration;
+}
+
+TickType_t MilkArrivalTask::ticks_until_next_countdown(void) const {
+  TickType_t now = xTaskGetTickCount();
+  TickType_t wait = portMAX_DELAY;
+  for (size_t box = 0; box < box_count; ++box) {
+    if (countdown_reports[box] != LidPositionReport::LID_POS_UNCHANGED) {
+      int32_t remaining = (int32_t) (countdown_deadlines[box] - now);
+      if (remaining <= 0) {
+        return 0;
+      }
+      if ((TickType_t) remaining < wait) {
+        wait = remaining;
+      }
+    }
+  }
+  return wait;
+}
+
+void MilkArrivalTask::on_enter(size_t box, ArrivalState new_state) {
+  switch (new_state) {
+  case ArrivalState::MILK_ARRIVAL_CRREATED:
+    // For the sake of completeness, as there are no transitions
+    // into this state.
+    break;
+  case ArrivalState::MILK_ARRIVAL_WAITING_FOR_ARRIVAL:
+    halt_countdown(box);
+    break;
+  case ArrivalState::MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN:
+    start_countdown(
+        box,
+        CONFIRM_OPEN_TIMEOUT_TICKS,
+        LidPositionReport::LID_POS_OPEN_TIMEOUT);
+    break;
+  case ArrivalState::MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN:
+    alarm(LID_OPEN_ALARM);
+    display(box, LCD_DELIVERY_IN_PROGRESS);
+    break;
+  case ArrivalState::MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE:
+    start_countdown(
+        box,
+        CONFIRM_CLOSURE_TIMEOUT_TICKS,
+        LidPositionReport::LID_POS_CLOSE_TIMEOUT);
+    break;
+  case ArrivalState::MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE:
+    time_task->start_stopwatch();
+    alarm(DELIVERED_ALARM);
+    display(box, LCD_DELIVERED);
+    break;
+  case ArrivalState::MILK_ARRIVAL_SUSPECT_TAMPERING:
+    start_countdown(
+        box,
+        CONFIRM_OPEN_TIMEOUT_TICKS,
+        LidPositionReport::LID_POS_OPEN_TIMEOUT);
+    break;
+  case ArrivalState::MILK_ARRIVAL_CONFIRMED_TAMPERING:
+    alarm(LID_OPEN_ALARM);
+    display(box, LCD_TAMPER_ALERT);
+    break;
+  case ArrivalState::MILK_ARRIVAL_NUMBER_OF_STATES:
+    break;
+  }
+  show_indicators();
 }
 
 void MilkArrivalTask::task_loop() {
   LidPositionReport position_report;
-  DisplayMessage display_message;
-  uint8_t led_level = LOW;
   Serial.println("Milk arrival task started.");
   for (;;) {
-    if (xQueueReceive(
-        h_lid_position_report_queue, &position_report, portMAX_DELAY)) {
-      ArrivalState maybe_new_state =
-          STATE_TRANSITION_TABLE[state][position_report.lid_position];
-      if (maybe_new_state != MILK_ARRIVAL_NUMBER_OF_STATES) {
-        led_level = LOW;
-        switch (state = maybe_new_state) {
-        case ArrivalState::MILK_ARRIVAL_CRREATED:
-          // For the sake of completeness, as there are no transitions
-          // into this state.
-          break;
-        case ArrivalState::MILK_ARRIVAL_WAITING_FOR_ARRIVAL:
-          halt_countdown();
-          break;
-        case ArrivalState::MILK_ARRIVAL_SUSPECT_DELIVERY_HAS_BEGUN:
-          led_level = HIGH;
-          start_countdown(
-              CONFIRM_OPEN_TIMEOUT_TICKS,
-              LidPositionReport::LID_POS_OPEN_TIMEOUT);
-          break;
-        case ArrivalState::MILK_ARRIVAL_CONFIRMED_DELEVERY_HAS_BEGUN:
-          led_level = HIGH;
-          lid_is_open();
-          display_message.command = LCD_DELIVERY_IN_PROGRESS;
-          xQueueSendToBack(h_display_command_queue, &display_message, 0);
-          break;
-        case ArrivalState::MILK_ARRIVAL_SUSPECT_DELIVERY_IS_COMPLETE:
-          start_countdown(
-              CONFIRM_CLOSURE_TIMEOUT_TICKS,
-              LidPositionReport::LID_POS_CLOSE_TIMEOUT);
-          break;
-        case ArrivalState::MILK_ARRIVAL_CONFIRMED_DELIVERY_IS_COMPLETE:
-          time_task->start_stopwatch();
-          xQueueSendToBack(h_delivery_led_illumination_queue, &LED_ON, 0);
-          xQueueSendToBack(h_alarm_event_queue, &DELIVERED_ALARM, 0);
-          display_message.command = LCD_DELIVERED;
-          xQueueSendToBack(h_display_command_queue, &display_message, 0);
-          break;
-        case ArrivalState::MILK_ARRIVAL_SUSPECT_TAMPERING:
-          led_level = HIGH;
-          start_countdown(
-              CONFIRM_OPEN_TIMEOUT_TICKS,
-              LidPositionReport::LID_POS_OPEN_TIMEOUT);
-          break;
-        case ArrivalState::MILK_ARRIVAL_CONFIRMED_TAMPERING:
-          led_level = HIGH;
-          lid_is_open();
-          display_message.command = LCD_TAMPER_ALERT;
-          xQueueSendToBack(h_display_command_queue, &display_message, 0);
-          break;
-        case ArrivalState::MILK_ARRIVAL_NUMBER_OF_STATES:
-          break;
+    if (lid_position_reports.receive(
+        position_report, ticks_until_next_countdown())) {
+      size_t box = position_report.peer;
+      if (box < PEER_TABLE_CAPACITY) {
+        if (box_count <= box) {
+          box_count = box + 1;
         }
-        digitalWrite(WHITE_LED_PIN, led_level);
+        states.dispatch(
+            STATE_TRANSITION_TABLE, box, position_report.lid_position, *this);
       }
     }
+    expire_countdowns();
   }
 }
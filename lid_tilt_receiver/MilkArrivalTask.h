@@ -4,7 +4,27 @@
  *  Created on: Apr 4, 2023
  *      Author: Eric Mintz
  *
- * Task that tracks milk arrival.
+ * Task that tracks milk arrival at every box that the receiver serves.
+ * Each box, identified by its peer table slot, has its own arrival state
+ * machine and confirmation countdown, kept in arrays indexed by slot.
+ * The task waits for lid reports until the earliest countdown ends, then
+ * expires every countdown that is due, so boxes cost no tasks or timers.
+ *
+ * The boxes share one set of indicators:
+ *
+ *   Alarms sound for every confirmed opening and delivery at any box.
+ *
+ *   The delivery LED blinks while any box is being opened, lights while
+ *   any box holds a delivery, and is otherwise left alone.
+ *
+ *   The white LED lights while any box's lid is up.
+ *
+ *   The top line of the display describes the most urgent box: tampering
+ *   outranks a delivery in progress, which outranks a completed
+ *   delivery. A box replaces the one shown when it reaches an equal or
+ *   higher rank. Its label accompanies it once a second box is heard.
+ *
+ *   The stopwatch times the latest delivery.
  */
 
 #ifndef MILKARRIVALTASK_H_
@@ -16,16 +36,18 @@
 #include "freertos/queue.h"
 #include "freertos/task.h"
 
-#include "Action.h"
-
+#include "AlarmTask.h"
+#include "DisplayMessage.h"
+#include "LedPatternEngine.h"
 #include "LidPositionReport.h"
-#include "MilkArrivalAction.h"
-#include "OneShotTimerWithAction.h"
-#include "Task.h"
+#include "PeerTable.h"
+#include "StateMachine.h"
+#include "StaticTask.h"
 #include "TimeTask.h"
+#include "Topic.h"
 
-class MilkArrivalTask : public Task {
-
+class MilkArrivalTask : public StaticTask<2048> {
+public:
   enum ArrivalState {
     MILK_ARRIVAL_CRREATED,  // Creation state
     MILK_ARRIVAL_WAITING_FOR_ARRIVAL,
@@ -38,40 +60,108 @@ class MilkArrivalTask : public Task {
     MILK_ARRIVAL_NUMBER_OF_STATES,
   };
 
-  static ArrivalState STATE_TRANSITION_TABLE
-      [MILK_ARRIVAL_NUMBER_OF_STATES]
-      [LidPositionReport::LID_POS_NUMBER_OF_VALUES];
+private:
+  friend class StateMachineArray<
+      ArrivalState,
+      MILK_ARRIVAL_NUMBER_OF_STATES,
+      LidPositionReport::LID_POS_NUMBER_OF_VALUES,
+      PEER_TABLE_CAPACITY>;
+
+  enum DeliveryLed {
+    DELIVERY_LED_UNCHANGED,
+    DELIVERY_LED_BLINKING,
+    DELIVERY_LED_ON,
+  };
 
   TimeTask *time_task;
 
-  QueueHandle_t h_lid_position_report_queue;
-  QueueHandle_t h_delivery_led_illumination_queue;
-  QueueHandle_t h_alarm_event_queue;
-  QueueHandle_t h_display_command_queue;
-  ArrivalState state;
-  MilkArrivalAction timeout_action;
-  OneShotTimerWithAction timer;
-
-
-  void halt_countdown(void);
-
-  void lid_is_open(void);
-
-  void quiesce(void);
+  LedPatternEngine *indicator_leds;
+  const uint8_t delivery_led_pin;
+  Subscription<LidPositionReport, 8> lid_position_reports;
+
+  // Per box state, indexed by peer table slot
+  StateMachineArray<
+      ArrivalState,
+      MILK_ARRIVAL_NUMBER_OF_STATES,
+      LidPositionReport::LID_POS_NUMBER_OF_VALUES,
+      PEER_TABLE_CAPACITY> states;
+  TickType_t countdown_deadlines[PEER_TABLE_CAPACITY];  // Tick counts
+  uint8_t countdown_reports[PEER_TABLE_CAPACITY];  // LID_POS_UNCHANGED: idle
+
+  size_t box_count;  // Highest slot heard from plus one
+  size_t displayed_box;  // The box that the top line describes
+  DeliveryLed delivery_led;  // What the delivery LED shows
+
+  /**
+   * Requests an alarm and reports a failed request.
+   */
+  void alarm(const AlarmTask::AlarmTaskMessage &message);
+
+  /**
+   * Shows a box's arrival state on the top line of the display if no
+   * other box is more urgent, and reports a failed send.
+   */
+  void display(size_t box, DisplayCommand command);
+
+  /**
+   * Fires the countdowns that are due, dispatching their reports.
+   */
+  void expire_countdowns(void);
+
+  void halt_countdown(size_t box);
+
+  /**
+   * Entry actions: run the box's confirmation countdowns, request alarms
+   * and update the display, then bring the shared LEDs up to date.
+   */
+  void on_enter(size_t box, ArrivalState new_state);
+
+  /**
+   * Returns a state's precedence on the display, 0 for states that the
+   * display does not show.
+   */
+  static uint8_t rank(ArrivalState state);
+
+  /**
+   * Sets the delivery and white LEDs from the states of all boxes.
+   */
+  void show_indicators(void);
 
   void start_countdown(
+      size_t box,
       TickType_t timeout,
       LidPositionReport::PositionValue notification_on_expiration);
 
+  /**
+   * Returns the number of ticks until the earliest countdown ends, or
+   * portMAX_DELAY if none is running.
+   */
+  TickType_t ticks_until_next_countdown(void) const;
+
 public:
-  MilkArrivalTask(TimeTask * time_task);
+  /**
+   * Constructor.
+   *
+   * Parameters:
+   *
+   * Name                Contents
+   * ------------------- ----------------------------------------------------
+   * time_task           Times the delivery
+   * indicator_leds      Drives the delivery LED
+   * delivery_led_pin    Blinks while delivery is in progress and lights
+   *                     once it is complete
+   */
+  MilkArrivalTask(
+      TimeTask *time_task,
+      LedPatternEngine *indicator_leds,
+      uint8_t delivery_led_pin);
   virtual ~MilkArrivalTask();
 
-  TaskHandle_t start(
-      QueueHandle_t h_lid_position_report_queue,
-      QueueHandle_t h_delivery_led_illumination_queue,
-      QueueHandle_t h_alarm_event_queue,
-      QueueHandle_t h_display_command_queue);
+  /**
+   * Subscribes to lid_position_topic and starts the task, which
+   * publishes to alarm_topic and display_topic.
+   */
+  TaskHandle_t start(void);
   virtual void task_loop();
 };
 
@@ -11,25 +11,135 @@
 
 #include "esp_now.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
-#include "CommunicationEvent.h"
 #include "DisplayMessage.h"
+#include "DuplicateFilter.h"
 #include "LidPositionReport.h"
+#include "LinkQuality.h"
+#include "NotificationBatch.h"
+#include "PeerTable.h"
 #include "PinAssignments.h"
+#include "ReceiverTopics.h"
+#include "StaticQueue.h"
+#include "WireFormat.h"
 
+// Time between LCD link quality updates, so that the RSSI does not
+// flicker.
+#define LINK_QUALITY_DISPLAY_INTERVAL_MS 5000
+
+// Boxes not heard from for this long drop out of the LCD summary; the
+// watchdog reports them instead.
+#define LINK_QUALITY_STALE_MS 10000
+
+// Recent loss at or above which the LCD shows loss instead of RSSI.
+#define LINK_LOSS_ALERT_PERMILLE 50
+
+// 802.11 fields that identify an ESP-NOW frame: a vendor specific action
+// frame from Espressif.
+#define IEEE80211_ACTION_FRAME_CONTROL 0xD0
+#define IEEE80211_SOURCE_OFFSET 10
+#define IEEE80211_BODY_OFFSET 24
+#define IEEE80211_VENDOR_SPECIFIC_CATEGORY 0x7F
+static const uint8_t ESPRESSIF_OUI[] = { 0x18, 0xFE, 0x34 };
+
+/**
+ * A notification and the slot of the box that sent it.
+ */
+struct PeerNotification {
+  uint8_t peer;
+  MotionNotificationMessage message;
+};
+
+static StaticQueue<PeerNotification, NOTIFICATION_BATCH_MAX_ENTRIES>
+    motion_notification_queue;
 static QueueHandle_t h_the_motion_notification_queue;
 
+// The milk boxes, added as they are heard from. Only the ESP-NOW handler
+// adds to it.
+static PeerTable milk_boxes;
+
+// Frames already delivered, per box. Senders retransmit frames whose
+// acknowledgment was lost, so the same frame can arrive more than once.
+static DuplicateFilter duplicate_filters[PEER_TABLE_CAPACITY];
+
+// Link quality, per box. Both radio callbacks run in the Wi-Fi task,
+// which is the only writer.
+static LinkQuality link_qualities[PEER_TABLE_CAPACITY];
+
+/**
+ * Writes a three character summary of the weakest link that has been
+ * heard from recently: "Lnn" if its recent loss is nn% and at least
+ * LINK_LOSS_ALERT_PERMILLE, otherwise the lowest RSSI in dBm, e.g.
+ * "-67", or "OK " if no RSSI has been measured.
+ */
+static void summarize_link_quality(uint32_t now_ms, char *text) {
+  uint32_t worst_loss_permille = 0;
+  bool has_rssi = false;
+  int worst_rssi_dbm = 0;
+  size_t peer_count = milk_boxes.get_peer_count();
+  for (size_t slot = 0; slot < peer_count; ++slot) {
+    const LinkQuality &link = link_qualities[slot];
+    if (!link.get_frames_received()
+        || LINK_QUALITY_STALE_MS
+            < (int32_t) (now_ms - link.get_last_arrival_ms())) {
+      continue;
+    }
+    uint32_t loss_permille = link.get_recent_loss_permille();
+    if (worst_loss_permille < loss_permille) {
+      worst_loss_permille = loss_permille;
+    }
+    if (link.get_has_rssi()
+        && (!has_rssi || link.get_rssi_dbm() < worst_rssi_dbm)) {
+      worst_rssi_dbm = link.get_rssi_dbm();
+      has_rssi = true;
+    }
+  }
+  if (LINK_LOSS_ALERT_PERMILLE <= worst_loss_permille) {
+    uint32_t loss_percent = (worst_loss_permille + 5) / 10;
+    snprintf(
+        text,
+        4,
+        "L%02u",
+        (unsigned) (loss_percent < 99 ? loss_percent : 99));
+  } else if (has_rssi) {
+    snprintf(text, 4, "%3d", worst_rssi_dbm < -99 ? -99 : worst_rssi_dbm);
+  } else {
+    strcpy(text, "OK ");
+  }
+}
+
+/**
+ * Acknowledges a frame, adding its sender as a peer on first contact.
+ */
+static void acknowledge(const uint8_t *mac, uint16_t sequence) {
+  if (!esp_now_is_peer_exist(mac)) {
+    esp_now_peer_info_t peer_info;
+    memset(&peer_info, 0, sizeof(peer_info));
+    memcpy(peer_info.peer_addr, mac, sizeof(peer_info.peer_addr));
+    peer_info.channel = 0;
+    peer_info.ifidx = WIFI_IF_STA;
+    peer_info.encrypt = false;
+    if (esp_now_add_peer(&peer_info) != ESP_OK) {
+      return;
+    }
+  }
+  uint8_t ack[WIRE_FORMAT_ACK_SIZE];
+  WireFormat::encode_ack(ack, sequence);
+  esp_now_send(mac, ack, sizeof(ack));
+}
+
 static uint8_t builtin_pin_state = LOW;
 
 ReceiverTask::ReceiverTask(
     TimeTask *time_task,
-    Resettable *watchdog_timer) :
-      Task("Receiver", 2048, 4),
-      h_communications_queue(NULL),
-      h_lid_position_report_queue(NULL),
+    GyroConnectionWatchdogTask *watchdog_timer) :
+      StaticTask("Receiver", TASK_ROLE_ESP_NOW_RECEIVE),
       watchdog_timer(watchdog_timer),
-      time_task(time_task) {
+      time_task(time_task),
+      link_quality_published_ms(0) {
+  strcpy(link_quality_text, "OK ");
 }
 
 ReceiverTask::~ReceiverTask() {
@@ -45,49 +155,166 @@ bool ReceiverTask::begin() {
   return status;
 }
 
+void ReceiverTask::print_peers(void) {
+  size_t peer_count = milk_boxes.get_peer_count();
+  Serial.printf(
+      "%u milk boxes, %u turned away\n",
+      (unsigned) peer_count,
+      (unsigned) milk_boxes.get_rejected());
+  for (size_t slot = 0; slot < peer_count; ++slot) {
+    const uint8_t *mac = milk_boxes.get_mac(slot);
+    Serial.printf(
+        "  %c %02x:%02x:%02x:%02x:%02x:%02x %u duplicates\n",
+        box_label(slot),
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5],
+        (unsigned) duplicate_filters[slot].get_duplicates());
+    const LinkQuality &link = link_qualities[slot];
+    if (link.get_has_rssi()) {
+      Serial.printf(
+          "    RSSI %d dBm, %d to %d\n",
+          link.get_rssi_dbm(),
+          link.get_rssi_min_dbm(),
+          link.get_rssi_max_dbm());
+    }
+    uint32_t loss_permille = link.get_recent_loss_permille();
+    Serial.printf(
+        "    %u frames, %u lost, recent loss %u.%u%%\n",
+        (unsigned) link.get_frames_received(),
+        (unsigned) link.get_frames_lost(),
+        (unsigned) (loss_permille / 10),
+        (unsigned) (loss_permille % 10));
+    const LatencyHistogram &jitter = link.get_jitter_histogram();
+    Serial.printf(
+        "    Jitter %u ms, 50%% <= %u ms, 99%% <= %u ms, max %u ms\n",
+        (unsigned) link.get_jitter_ms(),
+        (unsigned) jitter.percentile_ms(50),
+        (unsigned) jitter.percentile_ms(99),
+        (unsigned) jitter.get_max_ms());
+  }
+}
+
+void ReceiverTask::on_promiscuous_received(
+    void *buffer,
+    wifi_promiscuous_pkt_type_t type) {
+  const wifi_promiscuous_pkt_t *packet =
+      (const wifi_promiscuous_pkt_t *) buffer;
+  const uint8_t *frame = packet->payload;
+  // Beacons from nearby access points arrive here too, so reject them
+  // on the first byte.
+  if (type != WIFI_PKT_MGMT
+      || frame[0] != IEEE80211_ACTION_FRAME_CONTROL
+      || packet->rx_ctrl.sig_len
+          < IEEE80211_BODY_OFFSET + 1 + sizeof(ESPRESSIF_OUI)
+      || frame[IEEE80211_BODY_OFFSET] != IEEE80211_VENDOR_SPECIFIC_CATEGORY
+      || memcmp(
+          frame + IEEE80211_BODY_OFFSET + 1,
+          ESPRESSIF_OUI,
+          sizeof(ESPRESSIF_OUI))) {
+    return;
+  }
+  // Boxes are added when their first valid frame is delivered, just
+  // after this, so a box's first frame goes unmeasured.
+  int peer = milk_boxes.find(frame + IEEE80211_SOURCE_OFFSET);
+  if (peer != PEER_TABLE_NOT_FOUND) {
+    link_qualities[peer].on_rssi(packet->rx_ctrl.rssi);
+  }
+}
+
 void ReceiverTask::on_esp_now_received(
   const uint8_t *mac,
   const uint8_t *received_data,
   int len) {
-  MotionNotificationMessage *message =
-    (MotionNotificationMessage*) received_data;
-  CommunicationEvent comm_event;
-  memset(&comm_event, 0, sizeof(comm_event));
-  comm_event.event_type = *message;
-  xQueueSendToBack(
-      h_the_motion_notification_queue, &comm_event, pdMS_TO_TICKS(10));
+  TimestampedNotification notifications[NOTIFICATION_BATCH_MAX_ENTRIES];
+  ReceivedFrameInfo frame_info;
+  size_t count = NotificationBatchDecoder::decode(
+      received_data,
+      len < 0 ? 0 : len,
+      notifications,
+      NOTIFICATION_BATCH_MAX_ENTRIES,
+      &frame_info);
+  if (!frame_info.has_sequence && !count) {
+    // Not from a box, e.g. another ESP-NOW device nearby. It must not
+    // take a slot.
+    return;
+  }
+  int peer = milk_boxes.add(mac);
+  if (peer == PEER_TABLE_NOT_FOUND) {
+    // Too many boxes. Without an acknowledgment, the box will report
+    // its frames as lost.
+    return;
+  }
+  if (frame_info.ack_requested) {
+    // Acknowledge duplicates too: the first acknowledgment was lost.
+    acknowledge(mac, frame_info.sequence);
+  }
+  if (frame_info.has_sequence
+      && !duplicate_filters[peer].is_new(
+          frame_info.sequence,
+          frame_info.boot_id)) {
+    return;
+  }
+  if (frame_info.has_sequence) {
+    link_qualities[peer].on_frame(
+        frame_info.sequence,
+        frame_info.boot_id,
+        frame_info.sent_ms,
+        millis());
+  }
+  PeerNotification peer_notification;
+  memset(&peer_notification, 0, sizeof(peer_notification));
+  peer_notification.peer = peer;
+  for (size_t i = 0; i < count; ++i) {
+    peer_notification.message = notifications[i].message;
+    xQueueSendToBack(
+        h_the_motion_notification_queue,
+        &peer_notification,
+        pdMS_TO_TICKS(10));
+  }
+}
+
+void ReceiverTask::publish_link_quality(void) {
+  uint32_t now_ms = millis();
+  if (now_ms - link_quality_published_ms < LINK_QUALITY_DISPLAY_INTERVAL_MS) {
+    return;
+  }
+  link_quality_published_ms = now_ms;
+  char text[sizeof(link_quality_text)];
+  summarize_link_quality(now_ms, text);
+  if (strcmp(text, link_quality_text)) {
+    strcpy(link_quality_text, text);
+    DisplayMessage display_message;
+    memset(&display_message, 0, sizeof(display_message));
+    display_message.command = LCD_LINK_QUALITY;
+    strcpy(display_message.text, text);
+    display_topic.publish(display_message);
+  }
 }
 
 void ReceiverTask::task_loop() {
-  MotionNotificationMessage motion_notification_message;
-  memset(&motion_notification_message, 0, sizeof(motion_notification_message));
-  CommunicationEvent event;
+  PeerNotification peer_notification;
+  memset(&peer_notification, 0, sizeof(peer_notification));
   LidPositionReport lid_position_report;
 
   memset(&lid_position_report, 0, sizeof(lid_position_report));
 
   for(;;) {
-    memset(&event, 0, sizeof(event));
     if (xQueueReceive(
         h_the_motion_notification_queue,
-        &motion_notification_message,
+        &peer_notification,
         portMAX_DELAY) == pdTRUE) {
-      uint8_t yellow = LOW;
-      uint8_t green = LOW;
-      watchdog_timer->reset();
+      watchdog_timer->reset(peer_notification.peer);
       builtin_pin_state = (builtin_pin_state == LOW) ? HIGH : LOW;
       digitalWrite(BUILTIN_LED_PIN, builtin_pin_state);
 
-      switch (motion_notification_message.status) {
+      lid_position_report.peer = peer_notification.peer;
+      switch (peer_notification.message.status) {
         case LID_HAS_NOT_MOVED:
           lid_position_report.lid_position = LidPositionReport::LID_POS_CLOSED;
-          xQueueSendToBack(
-              h_lid_position_report_queue, &lid_position_report, 0);
+          lid_position_topic.publish(lid_position_report);
           break;
         case LID_RAISED:
           lid_position_report.lid_position = LidPositionReport::LID_POS_OPEN;
-          xQueueSendToBack(
-              h_lid_position_report_queue, &lid_position_report, 0);
+          lid_position_topic.publish(lid_position_report);
           break;
         case GYROSCOPE_SIGNAL_LOST:
           // TODO: support or remove. The transmitter does not send this
@@ -98,18 +325,13 @@ void ReceiverTask::task_loop() {
         case LAST_NOTIFICATION_STATUS:  // Should not happen
           break;
       }
+      publish_link_quality();
     }
   }
 }
 
-TaskHandle_t ReceiverTask::start(
-    QueueHandle_t h_communications_event_queue,
-    QueueHandle_t h_lid_position_report_queue) {
-  h_the_motion_notification_queue =
-      xQueueCreate(3, sizeof(MotionNotificationMessage));
-
-  this->h_communications_queue = h_communications_event_queue;
-  this->h_lid_position_report_queue = h_lid_position_report_queue;
+TaskHandle_t ReceiverTask::start(void) {
+  h_the_motion_notification_queue = motion_notification_queue.create();
 
   if (!esp_now_register_recv_cb(on_esp_now_received) == ESP_OK) {
     Serial.println("Receive callback registration failed.");
@@ -119,5 +341,16 @@ TaskHandle_t ReceiverTask::start(
 
  }
 
+  // ESP-NOW does not report RSSI; promiscuous mode does, for every
+  // frame, in the same task as the receive callback.
+  wifi_promiscuous_filter_t filter;
+  memset(&filter, 0, sizeof(filter));
+  filter.filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT;
+  if (esp_wifi_set_promiscuous_filter(&filter) != ESP_OK
+      || esp_wifi_set_promiscuous_rx_cb(on_promiscuous_received) != ESP_OK
+      || esp_wifi_set_promiscuous(true) != ESP_OK) {
+    Serial.println("RSSI monitoring unavailable.");
+  }
+
   return create_and_start_task();
 }
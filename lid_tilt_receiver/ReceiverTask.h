@@ -6,6 +6,17 @@
  *
  * Listens to the communications queue and drives the user interface. The
  * user interface includes the alarm (a.k.a.) beeper, LCD, and LEDS.
+ *
+ * Serves up to PEER_TABLE_CAPACITY milk boxes. The ESP-NOW handler looks
+ * each sender up in a peer table, adding it on first contact, and tags
+ * its notifications with the sender's slot, which every downstream
+ * message carries.
+ *
+ * Also measures each box's link quality: RSSI from the radio metadata,
+ * which promiscuous mode exposes, loss from sequence gaps, and jitter
+ * from the frame timestamps. See LinkQuality.h. The task publishes a
+ * summary of the weakest link to the LCD's network status field, and
+ * print_peers() reports every link over serial.
  */
 
 #ifndef RECEIVERTASK_H_
@@ -14,42 +25,65 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 
-#include "Resettable.h"
-#include "Task.h"
+#include "esp_wifi.h"
+
+#include "GyroConnectionWatchdogTask.h"
+#include "StaticTask.h"
 #include "TimeTask.h"
 
 class ReceiverTask :
-    public Task {
+    public StaticTask<2048> {
   enum LidPosition {
     OPEN,
     CLOSED,
     RCV_LID_POSITION_COUNT,
   };
 
-  QueueHandle_t h_communications_queue;  // Incoming communications events
-  QueueHandle_t h_lid_position_report_queue;  // Delivery events for MilkArrivalTask
-
   const TimeTask *time_task;
-  Resettable * watchdog_timer;
+  GyroConnectionWatchdogTask *watchdog_timer;
+  uint32_t link_quality_published_ms;
+  char link_quality_text[4];  // Last summary published
 
   static void on_esp_now_received(
       const uint8_t *mac,
       const uint8_t *received_data,
       int len);
 
+  /**
+   * Records the RSSI of ESP-NOW frames from known boxes. Runs in the
+   * Wi-Fi task for every management frame that the radio hears.
+   */
+  static void on_promiscuous_received(
+      void *buffer,
+      wifi_promiscuous_pkt_type_t type);
+
+  /**
+   * Publishes a summary of the weakest link to the LCD, at most once
+   * per LINK_QUALITY_DISPLAY_INTERVAL_MS and only when it changes.
+   */
+  void publish_link_quality(void);
+
   virtual void task_loop();
 
 public:
   ReceiverTask(
       TimeTask *time_task,
-      Resettable *watchdog_timer);
+      GyroConnectionWatchdogTask *watchdog_timer);
   virtual ~ReceiverTask();
 
   static bool begin();
 
-  TaskHandle_t start(
-      QueueHandle_t h_communications_queue,
-      QueueHandle_t h_lid_position_report_queue);
+  /**
+   * Prints each milk box's label, MAC address, and link quality over
+   * serial.
+   */
+  static void print_peers(void);
+
+  /**
+   * Registers the ESP-NOW receive callback and starts the task, which
+   * publishes lid movements to lid_position_topic.
+   */
+  TaskHandle_t start(void);
 };
 
 #endif /* RECEIVERTASK_H_ */
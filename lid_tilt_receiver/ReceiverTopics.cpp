@@ -0,0 +1,13 @@
+/*
+ * ReceiverTopics.cpp
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ */
+
+#include "ReceiverTopics.h"
+
+Topic<AlarmTask::AlarmTaskMessage, 1> alarm_topic("Alarm");
+Topic<ConnectionStatusMessage, 1> connection_status_topic("Connection");
+Topic<DisplayMessage, 1> display_topic("Display");
+Topic<LidPositionReport, 1> lid_position_topic("Lid position");
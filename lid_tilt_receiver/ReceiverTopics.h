@@ -0,0 +1,37 @@
+/*
+ * ReceiverTopics.h
+ *
+ *  Created on: Oct 17, 2026
+ *      Author: Eric Mintz
+ *
+ * Event bus topics that connect the receiver's tasks. Producers publish
+ * to a topic by name; consumers subscribe when they start. See Topic.h.
+ *
+ * Topic                    Publishers                 Subscribers
+ * ------------------------ -------------------------- -------------------
+ * alarm_topic              MilkArrivalTask            AlarmTask
+ * connection_status_topic  GyroConnectionWatchdogTask ConnectionStatusTask
+ * display_topic            setup(), TimeTask,         LCDDisplayTask
+ *                          ConnectionStatusTask,
+ *                          MilkArrivalTask
+ * lid_position_topic       ReceiverTask               MilkArrivalTask
+ *
+ * Lid position and connection status messages carry the slot of the box
+ * that they describe. See ReceiverTask.h.
+ */
+
+#ifndef RECEIVERTOPICS_H_
+#define RECEIVERTOPICS_H_
+
+#include "AlarmTask.h"
+#include "ConnectionStatus.h"
+#include "DisplayMessage.h"
+#include "LidPositionReport.h"
+#include "Topic.h"
+
+extern Topic<AlarmTask::AlarmTaskMessage, 1> alarm_topic;
+extern Topic<ConnectionStatusMessage, 1> connection_status_topic;
+extern Topic<DisplayMessage, 1> display_topic;
+extern Topic<LidPositionReport, 1> lid_position_topic;
+
+#endif /* RECEIVERTOPICS_H_ */
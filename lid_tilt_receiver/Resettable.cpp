@@ -1,18 +0,0 @@
-/*
- * Resettable.cpp
- *
- *  Created on: May 21, 2023
- *      Author: eric
- */
-
-#include "Resettable.h"
-
-Resettable::Resettable() {
-  // TODO Auto-generated constructor stub
-
-}
-
-Resettable::~Resettable() {
-  // TODO Auto-generated destructor stub
-}
-
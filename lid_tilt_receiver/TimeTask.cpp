@@ -14,6 +14,42 @@
 #include "RTClib.h"
 
 #include "DisplayMessage.h"
+#include "ReceiverTopics.h"
+
+#define DS3231_I2C_ADDRESS 0x68
+#define DS3231_TIME_REGISTER 0x00  // Seconds, then six more time registers
+#define DS3231_TIME_SIZE 7
+
+// Clock reads feed the once a second display, so a read that has not
+// started by then is useless.
+#define CLOCK_READ_DEADLINE_MS 500
+
+/**
+ * Starts the DS3231 and sets its square wave output to 1 Hz.
+ */
+class StartClockOperation : public I2cOperation {
+  RTC_DS3231 *time_keeper;
+
+public:
+  StartClockOperation(RTC_DS3231 *time_keeper) :
+      time_keeper(time_keeper) {
+  }
+
+  virtual I2cStatus run(TwoWire *wire, uint8_t) {
+    if (!time_keeper->begin(wire)) {
+      return I2C_NACK;
+    }
+    time_keeper->writeSqwPinMode(Ds3231SqwPinMode::DS3231_SquareWave1Hz);
+    return I2C_OK;
+  }
+};
+
+/**
+ * Converts a DS3231 binary coded decimal register value to binary.
+ */
+static uint8_t from_bcd(uint8_t value) {
+  return (value >> 4) * 10 + (value & 0x0F);
+}
 
 char * TimeTask::to_two_chars(uint8_t value, char *string) {
   *string++ = '0' + value/10;
@@ -32,10 +68,13 @@ void IRAM_ATTR TimeTask::second_tick_handler(void *params) {
 
 TimeTask::TimeTask(
     RTC_DS3231 *time_keeper,
-    Timezone *time_zone) :
+    Timezone *time_zone,
+    I2cBusManager *i2c_bus) :
+  StaticTask("Time keeper", TASK_ROLE_TIME_KEEPER),
   time_keeper(time_keeper),
   time_zone(time_zone),
-  h_lcd_display(NULL),
+  i2c_bus(i2c_bus),
+  clock_device("DS3231", DS3231_I2C_ADDRESS, I2C_FAST_MODE_HZ, false),
   h_gpio_isr(NULL),
   stopwatch_state(STOPPED),
   elapsed_time_seconds(0) {
@@ -46,19 +85,41 @@ TimeTask::TimeTask(
 TimeTask::~TimeTask() {
 }
 
-void TimeTask::time_keeper_task(void *params) {
-  ((TimeTask *) params)->run();
-}
-
 time_t TimeTask::now() {
-  time_t current_time;
-  DateTime now = time_keeper->now();
-  current_time = now.unixtime();
-  time_t local_time = time_zone->toLocal(current_time);
+  time_t local_time = time_zone->toLocal(utc_now());
   return local_time;
 }
 
-void TimeTask::run() {
+time_t TimeTask::utc_now() {
+  // Read the registers directly rather than through RTClib, which
+  // ignores bus errors, so that a failed read falls back to the system
+  // clock and lets the bus manager recover the bus.
+  static const uint8_t time_register = DS3231_TIME_REGISTER;
+  uint8_t registers[DS3231_TIME_SIZE];
+  if (i2c_bus->write_read(
+      clock_device,
+      &time_register,
+      sizeof(time_register),
+      registers,
+      sizeof(registers),
+      I2C_PRIORITY_HIGH,
+      CLOCK_READ_DEADLINE_MS) == I2C_OK) {
+    // RTClib runs the DS3231 in 24 hour mode. Register 3 holds the day
+    // of the week, and bit 7 of the month is the century flag.
+    DateTime utc(
+        2000 + from_bcd(registers[6]),
+        from_bcd(registers[5] & 0x1F),
+        from_bcd(registers[4]),
+        from_bcd(registers[2] & 0x3F),
+        from_bcd(registers[1]),
+        from_bcd(registers[0] & 0x7F));
+    return utc.unixtime();
+  }
+  // The system clock, which setup() sets from the DS3231.
+  return time(NULL);
+}
+
+void TimeTask::task_loop() {
   DisplayMessage message;
   for (;;) {
     memset(&message, 0, sizeof(message));
@@ -72,7 +133,7 @@ void TimeTask::run() {
     buffer = to_two_chars(broken_down_time.tm_min, buffer);
     *buffer++ = ':';
     to_two_chars(broken_down_time.tm_sec, buffer);
-    xQueueSendToBack(h_lcd_display, &message, pdMS_TO_TICKS(1));
+    display_topic.publish(message, pdMS_TO_TICKS(1));
 
     switch (stopwatch_state) {
     case STOPPED:
@@ -83,7 +144,7 @@ void TimeTask::run() {
         memset(&message, 0, sizeof(message));
         message.command = LCD_ELAPSED;
         itoa(elapsed_time_seconds/60, message.text, DEC);
-        xQueueSendToBack(h_lcd_display, &message, pdMS_TO_TICKS(1));
+        display_topic.publish(message, pdMS_TO_TICKS(1));
       }
       break;
     }
@@ -95,21 +156,16 @@ void TimeTask::reset_stopwatch() {
   elapsed_time_seconds = 0;
 }
 
-TaskHandle_t TimeTask::start(
-    QueueHandle_t h_lcd_display,
-    gpio_num_t interrupt_pin) {
-  this->h_lcd_display = h_lcd_display;
-  bool status = time_keeper->begin();
+TaskHandle_t TimeTask::start(gpio_num_t interrupt_pin) {
+  StartClockOperation start_clock(time_keeper);
+  bool status = i2c_bus->perform(
+      clock_device,
+      start_clock,
+      I2C_PRIORITY_HIGH,
+      I2C_NO_DEADLINE) == I2C_OK;
   if (status) {
-    time_keeper->writeSqwPinMode(Ds3231SqwPinMode::DS3231_SquareWave1Hz);
     // TODO: Error handling
-    xTaskCreate(
-        time_keeper_task,
-        "Time keeper",
-        4096,
-        this,
-        10,
-        &isr_params.h_time_task);
+    isr_params.h_time_task = create_and_start_task();
     pinMode(interrupt_pin, INPUT_PULLUP);
     gpio_set_intr_type(interrupt_pin, GPIO_INTR_POSEDGE);
     gpio_isr_handler_add(
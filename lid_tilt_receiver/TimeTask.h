@@ -4,7 +4,8 @@
  *  Created on: Feb 8, 2023
  *      Author: Eric Mintz
  *
- * Tracks the current time using a DS3231 time source.
+ * Tracks the current time using a DS3231 time source. All clock access
+ * goes through the I2C bus manager, which the task shares with the LCD.
  */
 
 #ifndef TIMETASK_H_
@@ -21,11 +22,13 @@
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
+#include "I2cBusManager.h"
+#include "StaticTask.h"
 #include "Timezone.h"
 
 class RTC_DS3231;
 
-class TimeTask {
+class TimeTask : public StaticTask<4096> {
   enum State {
     STOPPED,
     RUNNING,
@@ -38,7 +41,8 @@ class TimeTask {
 
   RTC_DS3231 *time_keeper;
   Timezone *time_zone;
-  QueueHandle_t h_lcd_display;
+  I2cBusManager *i2c_bus;
+  I2cDevice clock_device;
   gpio_isr_handle_t h_gpio_isr;
   IsrParams isr_params;
   State stopwatch_state;
@@ -46,40 +50,51 @@ class TimeTask {
 
   static void IRAM_ATTR second_tick_handler(void *params);
 
+public:
   /**
-   * Task start function.
+   * Constructor.
    *
    * Parameters:
-   * ----------
    *
    * Name                Contents
    * ------------------- ----------------------------------------------------
-   * params              Pointer to the TimeTask to start
-   */
-  static void time_keeper_task(void *params);
-
-  /**
-   * Task run loop.
+   * time_keeper         The DS3231, which keeps UTC
+   * time_zone           Converts UTC to local time
+   * i2c_bus             The bus that the DS3231 is on
    */
-  void run();
-
-public:
   TimeTask(
       RTC_DS3231 *time_keeper,
-      Timezone *time_zone);
+      Timezone *time_zone,
+      I2cBusManager *i2c_bus);
   virtual ~TimeTask();
 
+  /**
+   * Returns the local time.
+   */
   time_t now();
 
+  /**
+   * Returns UTC from the DS3231, or from the system clock if the DS3231
+   * cannot be read in time.
+   */
+  time_t utc_now();
+
   void reset_stopwatch();
 
-  TaskHandle_t start(
-      QueueHandle_t h_lcd_display,
-      gpio_num_t interrupt_pin);
+  /**
+   * Starts the DS3231's 1 Hz output and the task, which publishes the time of day and the time since
+   * delivery to display_topic.
+   */
+  TaskHandle_t start(gpio_num_t interrupt_pin);
 
   void start_stopwatch();
 
   char * to_two_chars(uint8_t value, char *string);
+
+  /**
+   * Task run loop.
+   */
+  virtual void task_loop();
 };
 
 #endif /* TIMETASK_H_ */
@@ -15,11 +15,11 @@
 #include "esp_now.h"
 #include "Wire.h"
 #include "RTClib.h"
-#include "LiquidCrystal_I2C.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
+#include "freertos/timers.h"
 
 #include "soc/rtc.h"
 
@@ -27,71 +27,110 @@
 #include <sys/time.h>
 
 #include "AlarmTask.h"
-#include "CommunicationEvent.h"
+#include "BufferedI2cLcd.h"
 #include "ConnectionStatusTask.h"
-#include "DeliveryLEDIlluminationStatus.h"
-#include "DeliveryLedTask.h"
-#include "DisconnectedLedTask.h"
 #include "DisplayMessage.h"
 #include "GyroConnectionWatchdogTask.h"
+#include "I2cBusManager.h"
+#include "LedPatternEngine.h"
 #include "LidPositionReport.h"
 #include "LCDDisplayTask.h"
 #include "MilkArrivalTask.h"
 #include "PinAssignments.h"
 #include "ReceiverTask.h"
-#include "RippleTask.h"
+#include "ReceiverTopics.h"
+#include "TaskMonitor.h"
+#include "TimerService.h"
 #include "TimeTask.h"
 #include "Timezone.h"
 #include "WhiteLedPin.h"
 
 #define I2C_LCD_ADDRESS 0x27
-#define LCD_ROWS 2
-#define LCD_COLUMNS 16
 
-QueueHandle_t h_alarm_event_queue;
-QueueHandle_t h_communications_event_queue;
-QueueHandle_t h_delivery_led_illumination_queue;
-QueueHandle_t h_display_command_queue;
-QueueHandle_t h_lid_position_report_queue;
+// Time between task stack, CPU and event bus reports. Send any character
+// over serial for a report on demand.
+#define TASK_REPORT_INTERVAL_MS (10 * 60 * 1000)
 
 TaskHandle_t h_connection_status_task;
-TaskHandle_t h_disconnected_led_task;
 TaskHandle_t h_lid_position_report_task;
 TaskHandle_t h_lcd_display_task;
-TaskHandle_t h_delivery_led_illumination_task;
 TaskHandle_t h_milk_arrival_task;
 TaskHandle_t h_time_task;
 
+// Owns Wire; the DS3231 and the LCD share it.
+I2cBusManager i2c_bus(&Wire, I2C_SDA_PIN, I2C_SCL_PIN);
+
 // TODO: store the timezone in eeprom.
 TimeChangeRule usEDT = {"EDT", Second, Sun, Mar, 2, -240};  //UTC - 4 hours
 TimeChangeRule usEST = {"EST", First, Sun, Nov, 2, -300};   //UTC - 5 hours
 Timezone usEastern(usEDT, usEST);
 
-AlarmTask alarm_task(ALARM_PIN, YELLOW_LED_PIN);
-
 RTC_DS3231 time_keeper;
-TimeTask time_task(&time_keeper, &usEastern);
-
-MilkArrivalTask milk_arrival_task(&time_task);
-
-LiquidCrystal_I2C display(I2C_LCD_ADDRESS, LCD_COLUMNS, LCD_ROWS);
-LCDDisplayTask display_task(display, &time_task);
+TimeTask time_task(&time_keeper, &usEastern, &i2c_bus);
 
 const uint8_t led_pins[] =
 	{RED_LED_PIN, YELLOW_LED_PIN, GREEN_LED_PIN, BLUE_LED_PIN};
 #define NUMBER_OF_LED_PINS 4
 
-RippleTask ripple_task(led_pins, NUMBER_OF_LED_PINS, 100);
-
-GyroConnectionWatchdogTask gyro_connection_watchdog;
+// The pattern engine drives the LEDs and the beeper.
+const uint8_t indicator_pins[] =
+	{RED_LED_PIN, YELLOW_LED_PIN, GREEN_LED_PIN, BLUE_LED_PIN, ALARM_PIN};
+#define NUMBER_OF_INDICATOR_PINS 5
+
+LedPatternEngine indicators(indicator_pins, NUMBER_OF_INDICATOR_PINS);
+
+// Boot ripple: each LED lights for 100 ms in turn. The patterns differ
+// only in their lead-in, which sets each LED's place in the ripple.
+static const LedStep RIPPLE_STEPS[NUMBER_OF_LED_PINS][3] = {
+  { { LOW, 0 }, { HIGH, 100 }, { LOW, 300 } },
+  { { LOW, 100 }, { HIGH, 100 }, { LOW, 300 } },
+  { { LOW, 200 }, { HIGH, 100 }, { LOW, 300 } },
+  { { LOW, 300 }, { HIGH, 100 }, { LOW, 300 } },
+};
+static const LedPattern RIPPLE[NUMBER_OF_LED_PINS] = {
+  { RIPPLE_STEPS[0], 3, 1 },
+  { RIPPLE_STEPS[1], 3, 1 },
+  { RIPPLE_STEPS[2], 3, 1 },
+  { RIPPLE_STEPS[3], 3, 1 },
+};
+
+// Boot beeps: five 10 ms chirps.
+static const LedStep BOOT_BEEP_STEPS[] = {
+  { HIGH, 10 },
+  { LOW, 20 },
+  { HIGH, 10 },
+  { LOW, 20 },
+  { HIGH, 10 },
+  { LOW, 20 },
+  { HIGH, 10 },
+  { LOW, 20 },
+  { HIGH, 10 },
+  { LOW, 20 },
+};
+static const LedPattern BOOT_BEEPS = {
+  BOOT_BEEP_STEPS,
+  10,
+  LED_PATTERN_ONCE,
+};
+
+AlarmTask alarm_task(&indicators, ALARM_PIN, YELLOW_LED_PIN);
+
+MilkArrivalTask milk_arrival_task(&time_task, &indicators, BLUE_LED_PIN);
+
+BufferedI2cLcd display(&i2c_bus, I2C_LCD_ADDRESS, I2C_FAST_MODE_HZ);
+LCDDisplayTask display_task(&display, &time_task);
+
+// Runs every timer in the receiver.
+TimerService timer_service;
+
+GyroConnectionWatchdogTask gyro_connection_watchdog(&timer_service);
 
 ReceiverTask receiver_task(&time_task, &gyro_connection_watchdog);
 
-DeliveryLedTask delivery_led_task(BLUE_LED_PIN, 100, 100);
-
-DisconnectedLedTask disconnected_led_task(RED_LED_PIN);
 ConnectionStatusTask connection_status_task(
-    &disconnected_led_task, GREEN_LED_PIN);
+    &indicators, RED_LED_PIN, GREEN_LED_PIN);
+
+TaskMonitor task_monitor;
 
 /**
  * Receives notification of lid tilt, which indicates that milk has been
@@ -110,26 +149,22 @@ void setup() {
 
   digitalWrite(BUILTIN_LED_PIN, LOW);
 
-  h_alarm_event_queue = xQueueCreate(3, sizeof(AlarmTask::AlarmTaskMessage));
-  h_communications_event_queue = xQueueCreate(3, sizeof(CommunicationEvent));
-  h_delivery_led_illumination_queue =
-      xQueueCreate(3, sizeof(LedIlluminationMessage));
-  h_display_command_queue = xQueueCreate(3, sizeof(DisplayMessage));
-  h_lid_position_report_queue = xQueueCreate(3, sizeof(LidPositionReport));
-
-  h_lcd_display_task = display_task.start(h_display_command_queue);
+  i2c_bus.start();
+  h_lcd_display_task = display_task.start();
   DisplayMessage display_message;
   memset(&display_message, 0, sizeof(display_message));
   display_message.command = LCD_INIT;
-  xQueueSendToBack(h_display_command_queue, &display_message, 0);
+  display_topic.publish(display_message);
   memset(&display_message, 0, sizeof(display_message));
 
   display_message.command = LCD_DISCONNECTED;
-  xQueueSendToBack(h_display_command_queue, &display_message, 0);
+  display_topic.publish(display_message);
 
   digitalWrite(WHITE_LED_PIN, HIGH);
-  ripple_task.start();
-  ripple_task.resume();
+  indicators.begin();
+  for (size_t i = 0; i < NUMBER_OF_LED_PINS; ++i) {
+    indicators.show(led_pins[i], RIPPLE[i]);
+  }
   Serial.begin(115200);
   Serial.print("Milk minder receiver compiled on ");
   Serial.print(__DATE__);
@@ -139,8 +174,6 @@ void setup() {
   Serial.println(rtc_clk_apb_freq_get());
   Serial.println("Test receiver is booting.");
 
-  Wire.begin();
-
   if (!WiFi.mode(WIFI_STA)) {
     Serial.println("Could not configure WIFI.");
     // TODO: display a error and halt.
@@ -154,35 +187,23 @@ void setup() {
     Serial.println("ESP_NOW initialized and ready to start.");
   }
 
-  for (int beep_count = 0; beep_count < 5; ++beep_count) {
-    digitalWrite(ALARM_PIN, HIGH);
-    vTaskDelay(pdMS_TO_TICKS(10));
-    digitalWrite(ALARM_PIN, LOW);
-    vTaskDelay(pdMS_TO_TICKS(20));
-  }
+  indicators.show(ALARM_PIN, BOOT_BEEPS);
 
   vTaskDelay(pdMS_TO_TICKS(10000));
-  ripple_task.suspend();
+  indicators.all_off();
   digitalWrite(WHITE_LED_PIN, LOW);
 
-  h_delivery_led_illumination_task =
-      delivery_led_task.start(h_delivery_led_illumination_queue);
+  h_connection_status_task = connection_status_task.start();
 
-  h_disconnected_led_task = disconnected_led_task.start(h_alarm_event_queue);
+  alarm_task.start();
 
-  h_connection_status_task = connection_status_task.start(
-      h_communications_event_queue,
-      h_display_command_queue);
-
-  alarm_task.start(h_alarm_event_queue);
-
-  // watchdog_timer.start(h_communications_event_queue);
-  gyro_connection_watchdog.start(h_communications_event_queue);
+  timer_service.start();
+  gyro_connection_watchdog.start();
   Serial.println("Watchdog timer started.");
-  h_time_task = time_task.start(h_display_command_queue, GPIO_NUM_17);
+  h_time_task = time_task.start(GPIO_NUM_17);
 
   timeval tv;
-  tv.tv_sec = time_keeper.now().unixtime();
+  tv.tv_sec = time_task.utc_now();
   tv.tv_usec = 0;
   Serial.println("Setting time of day.");
   settimeofday(&tv, NULL);
@@ -190,21 +211,36 @@ void setup() {
 
   ReceiverTask::begin();
 
-  h_milk_arrival_task = milk_arrival_task.start(
-      h_lid_position_report_queue,
-      h_delivery_led_illumination_queue,
-      h_alarm_event_queue,
-      h_display_command_queue);
+  h_milk_arrival_task = milk_arrival_task.start();
 
-  receiver_task.start(
-      h_communications_event_queue,
-      h_lid_position_report_queue);
+  receiver_task.start();
   Serial.println("Receiver task started.");
   memset(&display_message, 0, sizeof(display_message));
   display_message.command = LCD_RUN;
-  xQueueSendToBack(h_display_command_queue, &display_message, 0);
+  display_topic.publish(display_message);
+
+  // Tasks that are not Task instances.
+  TaskMonitor::watch(
+      xTaskGetCurrentTaskHandle(),
+      "Arduino loop",
+      getArduinoLoopTaskStackSize());
+  TaskMonitor::watch(
+      xTimerGetTimerDaemonTaskHandle(),
+      "Timer service",
+      configTIMER_TASK_STACK_DEPTH);
+  task_monitor.start(TASK_REPORT_INTERVAL_MS);
 }
 
 void loop() {
-  vTaskDelay(pdMS_TO_TICKS(10000));
+  vTaskDelay(pdMS_TO_TICKS(TASK_REPORT_INTERVAL_MS));
+  Serial.printf(
+      "LCD framebuffer saved %u I2C bytes\n",
+      (unsigned) display_task.get_i2c_bytes_saved());
+  i2c_bus.print_report();
+  Serial.printf(
+      "Timer service posted %u expiries, dropped %u\n",
+      (unsigned) timer_service.get_posted(),
+      (unsigned) timer_service.get_dropped());
+  ReceiverTask::print_peers();
+  gyro_connection_watchdog.print_timeouts();
 }